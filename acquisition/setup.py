@@ -26,7 +26,8 @@ setup(
     packages=find_packages(),
     extras_require={
         'tiff': ['Pillow'],
-        'test': ['requests', 'Pillow', 'mock', 'diskcache']
+        'passive': ['watchdog'],
+        'test': ['requests', 'Pillow', 'mock', 'diskcache', 'watchdog']
     },
     entry_points={
         'console_scripts': [
@@ -2,7 +2,7 @@ import pytest
 import requests
 import time
 from threading import Thread
-from bottle import default_app, WSGIRefServer
+from bottle import default_app
 
 from tomviz.acquisition import server
 from .mock.tiltseries import TIFFWriter, DM3Writer
@@ -16,7 +16,8 @@ class Server(Thread):
         self.base_url = 'http://%s:%d' % (self.host, self.port)
         self.url = '%s/acquisition' % self.base_url
         self.dev = dev
-        self._server = WSGIRefServer(host=self.host, port=self.port)
+        self._server = server.ThreadingWSGIRefServer(host=self.host,
+                                                     port=self.port)
 
     def run(self):
         self.setup()
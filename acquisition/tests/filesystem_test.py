@@ -0,0 +1,168 @@
+import os
+import time
+from threading import Thread
+
+import pytest
+
+from tomviz.acquisition.vendors.passive import filesystem
+
+FILE_COUNT = 50000
+
+
+class ManyFilesWriter(Thread):
+    def __init__(self, path, count=FILE_COUNT):
+        """
+        Thread to write a large number of small files to a particular path,
+        simulating a long acquisition session. Every tenth file doesn't match
+        the file name regex used by the tests.
+
+        :param path: The path to write the files to.
+        :type path: str
+        :param count: The number of files to write.
+        :type count: int
+        """
+        super(ManyFilesWriter, self).__init__()
+        self.daemon = True
+
+        self._path = path
+        self._count = count
+        self.expected = []
+
+    def run(self):
+        for i in range(self._count):
+            ext = 'txt' if i % 10 == 0 else 'tif'
+            filename = 'image_%06d.%s' % (i, ext)
+            file_path = os.path.join(self._path, filename)
+            with open(file_path, 'wb') as fp:
+                fp.write(b'%d' % i)
+            if ext == 'tif':
+                self.expected.append(file_path)
+
+
+class CountingCheck(object):
+    def __init__(self):
+        self.calls = {}
+
+    def __call__(self, filepath):
+        self.calls[filepath] = self.calls.get(filepath, 0) + 1
+        return True
+
+
+def _drain(monitor, count, timeout=120):
+    files = []
+    start = time.time()
+    while len(files) < count and time.time() - start < timeout:
+        f = monitor.get()
+        if f is None:
+            time.sleep(0.01)
+        else:
+            files.append(f)
+
+    return files
+
+
+def test_polling_monitor_many_files(tmpdir):
+    writer = ManyFilesWriter(tmpdir.strpath)
+    writer.start()
+    writer.join()
+
+    check = CountingCheck()
+    monitor = filesystem.Monitor(tmpdir.strpath, filename_regex=r'.*\.tif$',
+                                 valid_file_check=check)
+    files = _drain(monitor, len(writer.expected))
+
+    assert sorted(files) == writer.expected
+    assert monitor.get() is None
+    # Each file is validated once, not on every poll.
+    assert all(c == 1 for c in check.calls.values())
+    assert len(check.calls) == len(writer.expected)
+
+    # A poll with no new files is just a directory listing.
+    start = time.time()
+    for _ in range(10):
+        assert monitor.get() is None
+    assert time.time() - start < 5
+
+
+def test_polling_monitor_retries_invalid_files(tmpdir):
+    valid = set()
+    monitor = filesystem.Monitor(tmpdir.strpath,
+                                 valid_file_check=lambda f: f in valid)
+    file_path = tmpdir.join('image.tif')
+    file_path.write('partial')
+
+    assert monitor.get() is None
+    valid.add(file_path.strpath)
+    assert monitor.get() == file_path.strpath
+    assert monitor.get() is None
+
+
+def test_event_monitor_many_files(tmpdir):
+    pytest.importorskip('watchdog')
+
+    # Files present before the monitor starts are picked up too.
+    existing = tmpdir.join('existing.tif')
+    existing.write('0')
+
+    check = CountingCheck()
+    monitor = filesystem.create_monitor(tmpdir.strpath,
+                                        filename_regex=r'.*\.tif$',
+                                        valid_file_check=check)
+    assert isinstance(monitor, filesystem.EventMonitor)
+    try:
+        assert monitor.get() == existing.strpath
+
+        writer = ManyFilesWriter(tmpdir.strpath)
+        writer.start()
+        files = _drain(monitor, FILE_COUNT - FILE_COUNT // 10)
+        writer.join()
+
+        assert len(files) == len(writer.expected)
+        assert set(files) == set(writer.expected)
+        # Arrival order, the writer writes the files in name order.
+        if monitor._close_events:
+            assert files == writer.expected
+        assert monitor.get() is None
+        assert len(check.calls) == len(writer.expected) + 1
+    finally:
+        monitor.stop()
+
+
+def test_polling_monitor_file_written_again(tmpdir):
+    monitor = filesystem.Monitor(tmpdir.strpath)
+    file_path = tmpdir.join('image.tif')
+    file_path.write('0')
+    assert monitor.get() == file_path.strpath
+
+    # Once removed, a file of the same name is a new one.
+    file_path.remove()
+    assert monitor.get() is None
+    file_path.write('1')
+    assert monitor.get() == file_path.strpath
+    assert monitor.get() is None
+
+
+def test_event_monitor_file_written_again(tmpdir):
+    pytest.importorskip('watchdog')
+
+    monitor = filesystem.create_monitor(tmpdir.strpath,
+                                        filename_regex=r'.*\.tif$')
+    assert isinstance(monitor, filesystem.EventMonitor)
+    try:
+        file_path = tmpdir.join('image.tif')
+        file_path.write('0')
+        assert _drain(monitor, 1, timeout=10) == [file_path.strpath]
+
+        # Removed, or moved away, then written again.
+        file_path.remove()
+        time.sleep(0.5)
+        file_path.write('1')
+        assert _drain(monitor, 1, timeout=10) == [file_path.strpath]
+
+        file_path.rename(tmpdir.join('moved.txt'))
+        time.sleep(0.5)
+        file_path.write('2')
+        assert _drain(monitor, 1, timeout=10) == [file_path.strpath]
+        assert monitor.get() is None
+    finally:
+        monitor.stop()
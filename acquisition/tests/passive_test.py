@@ -4,6 +4,8 @@ import hashlib
 import sys
 import os
 import re
+import struct
+import json
 from PIL import Image
 import dm3_lib as dm3
 
@@ -245,3 +247,59 @@ def test_dm3_stem_acquire(passive_acquisition_server, tmpdir,
         expected_md5.update(tiff_image_data)
 
         assert md5.hexdigest() == expected_md5.hexdigest()
+
+
+def _read_stream_frame(response):
+    (header_size,) = struct.unpack('>I', response.raw.read(4))
+    header = json.loads(response.raw.read(header_size).decode('utf8'))
+    data = response.raw.read(header['size'])
+    assert len(data) == header['size']
+
+    return (header, data)
+
+
+def test_tiff_stream(passive_acquisition_server, tmpdir,
+                     mock_tiff_tiltseries_writer):
+    id = 1234
+    request = jsonrpc_message({
+        'id': id,
+        'method': 'connect',
+        'params': {
+            'path': tmpdir.strpath,
+            'fileNameRegex': r'.*\.tif'
+        }
+    })
+    response = requests.post(passive_acquisition_server.url, json=request)
+    assert response.status_code == 200, response.content
+
+    describe_request = jsonrpc_message({
+        'id': id,
+        'method': 'describe'
+    })
+
+    stream_url = '%s/stream' % passive_acquisition_server.base_url
+    tilt_series = []
+    with requests.get(stream_url, stream=True) as response:
+        assert response.status_code == 200
+        assert response.headers['Content-Type'] == \
+            'application/x-tomviz-stream'
+
+        while len(tilt_series) < mock_tiff_tiltseries_writer.series_size:
+            (header, data) = _read_stream_frame(response)
+            # Skip the heartbeats
+            if header['size'] == 0:
+                continue
+
+            assert header['mimeType'] == 'image/tiff'
+            tilt_series.append(data)
+
+            # The JSON-RPC endpoint is still served while streaming
+            response_rpc = requests.post(passive_acquisition_server.url,
+                                         json=describe_request)
+            assert response_rpc.status_code == 200
+
+    # Check we got the images in order
+    with Image.open(test_image()) as image_stack:
+        for i in range(0, image_stack.n_frames):
+            image_stack.seek(i)
+            assert tilt_series[i] == tobytes(image_stack)
@@ -1,12 +1,18 @@
 import os
 import sys
+import collections
+import json
+import struct
 import tempfile
+import threading
+import time
 import importlib
 import inspect
 import logging
 import logging.handlers
 import bottle
-from bottle import run, route, request, HTTPResponse, Bottle
+from bottle import run, route, request, HTTPResponse, Bottle, WSGIRefServer
+from wsgiref.simple_server import WSGIServer
 
 import tomviz
 from tomviz import jsonrpc
@@ -20,16 +26,60 @@ try:
 except ImportError:
     pass
 
+try:
+    from SocketServer import ThreadingMixIn
+except ImportError:
+    # py3
+    from socketserver import ThreadingMixIn
+
 
 ADAPTER = 'tests.mock.source.ApiAdapter'
 HOST = 'localhost'
 PORT = 8080
 LOG_BUF_SIZE = 65536
+STREAM_MIME_TYPE = 'application/x-tomviz-stream'
+# How often the source adapter is polled while it has no image, and how long
+# the stream can stay idle before a heartbeat frame is sent, in seconds.
+STREAM_POLL_INTERVAL = 0.02
+STREAM_HEARTBEAT_INTERVAL = 5.0
 
 logger = logging.getLogger('tomviz')
 app = Bottle()
 
 
+class ThreadingWSGIRefServer(WSGIRefServer):
+    """
+    WSGIRefServer handling each request in its own thread, so that a client
+    reading the image stream doesn't block the JSON-RPC requests.
+    """
+    def run(self, app):
+        class _ThreadingWSGIServer(ThreadingMixIn, WSGIServer):
+            daemon_threads = True
+
+        self.options.setdefault('server_class', _ThreadingWSGIServer)
+        super(ThreadingWSGIRefServer, self).run(app)
+
+
+def _stream_frame(mimetype, metadata, data):
+    """
+    Generate the chunks of a frame of the image stream. A frame is the length
+    of the header as a 32-bit big endian integer, the header, UTF-8 encoded
+    JSON, and then the image data. The header contains the image mime type,
+    the size of the image data and the image metadata, if any.
+    """
+    header = {
+        'mimeType': mimetype,
+        'size': len(data)
+    }
+    if metadata is not None:
+        header['meta'] = metadata
+    header = json.dumps(header).encode('utf8')
+
+    yield struct.pack('>I', len(header)) + header
+    if len(data) > 0:
+        yield data
+
+
 def _load_source_adapter(source_adapter):
     logger.info('Loading source_adapter: %s', source_adapter)
     # First load the chosen source_adapter
@@ -67,6 +117,26 @@ def _setup_adapter(source_adapter): # noqa
 
     source_adapter = cls()
     slices = {}
+    # stem_acquire() is called from the JSON-RPC endpoint and from the stream
+    acquire_lock = threading.Lock()
+    # Images acquired for a stream whose client disconnected, they are
+    # returned first by the next acquisition.
+    undelivered = collections.deque()
+
+    def _acquire():
+        with acquire_lock:
+            if undelivered:
+                return undelivered.popleft()
+            data = source_adapter.stem_acquire()
+
+        if data is None:
+            return (None, None)
+
+        # Do we have any meta data
+        if isinstance(data, tuple):
+            return data
+
+        return (None, data)
 
     @jsonrpc.endpoint(path='/acquisition')
     @inject(source_adapter)
@@ -124,15 +194,11 @@ def _setup_adapter(source_adapter): # noqa
     @inject(source_adapter)
     def stem_acquire(source_adapter):
         id = 'stem_acquire_slice'
-        data = source_adapter.stem_acquire()
+        (metadata, data) = _acquire()
 
         if data is None:
             return None
 
-        metadata = None
-        # Do we have any meta data
-        if isinstance(data, tuple):
-            (metadata, data) = data
         slices[id] = data
 
         image_data_url = '%s/data/%s' % (_base_url(), id)
@@ -158,6 +224,46 @@ def _setup_adapter(source_adapter): # noqa
 
         return slices[id]
 
+    @route('/stream')
+    @inject(source_adapter)
+    def stream(source_adapter):
+        """
+        Push the acquired images to the client as they become available, on a
+        single response that stays open until the client disconnects. An
+        empty frame is sent when no image was acquired for a while, this is
+        how a disconnected client is detected.
+
+        The server closes the generator when writing to a disconnected client
+        fails. The image being written is then kept for the next acquisition
+        rather than lost.
+        """
+        bottle.response.headers['Content-Type'] = STREAM_MIME_TYPE
+        mimetype = getattr(source_adapter, 'image_data_mimetype',
+                           'image/tiff')
+
+        def frames():
+            last_frame = time.time()
+            while True:
+                (metadata, data) = _acquire()
+                if data is None:
+                    if time.time() - last_frame < STREAM_HEARTBEAT_INTERVAL:
+                        time.sleep(STREAM_POLL_INTERVAL)
+                        continue
+                    data = b''
+
+                try:
+                    for chunk in _stream_frame(mimetype, metadata, data):
+                        yield chunk
+                except GeneratorExit:
+                    logger.info('Image stream client disconnected.')
+                    if len(data) > 0:
+                        with acquire_lock:
+                            undelivered.appendleft((metadata, data))
+                    raise
+                last_frame = time.time()
+
+        return frames()
+
 
 def _log(log):
     bottle.response.headers['Content-Type'] = 'text/plain'
@@ -247,4 +353,4 @@ def start(host=HOST, port=PORT, debug=True, dev=False, adapter=ADAPTER):
     with app:
         setup(adapter, dev)
         logger.info('Starting HTTP server')
-        run(host=host, port=port, debug=debug)
+        run(host=host, port=port, debug=debug, server=ThreadingWSGIRefServer)
@@ -8,7 +8,7 @@ import dm3_lib as dm3
 from tomviz.acquisition import AbstractSource
 from tomviz.acquisition import describe
 from tomviz.acquisition.utility import tobytes
-from .filesystem import Monitor
+from .filesystem import create_monitor
 
 try:
     dict.iteritems
@@ -108,7 +108,7 @@ class PassiveWatchSource(AbstractSource):
     """
 
     def __init__(self):
-        self._watcher = None
+        self._monitor = None
         self.image_data_mimetype = TIFF_MIME_TYPE
         # Register the dm3 mime type.
         mimetypes.add_type(DM3_MIME_TYPE, '.dm3')
@@ -183,15 +183,19 @@ class PassiveWatchSource(AbstractSource):
         self._filename_regex = fileNameRegex
         self._filename_regex_groups = fileNameRegexGroups
         self._group_regex_substitutions = groupRegexSubstitutions
-        self._monitor = Monitor(path, filename_regex=fileNameRegex,
-                                valid_file_check=_valid_file_check)
+        if self._monitor is not None:
+            self._monitor.stop()
+        self._monitor = create_monitor(path, filename_regex=fileNameRegex,
+                                       valid_file_check=_valid_file_check)
 
     def disconnect(self, **params):
         """
         :param params: The disconnect parameters.
         :type params: dict
         """
-        pass
+        if self._monitor is not None:
+            self._monitor.stop()
+            self._monitor = None
 
     def tilt_params(self, **params):
         """
@@ -246,6 +250,9 @@ class PassiveWatchSource(AbstractSource):
         there is one
         :returns: The 2D tiff generate by the scan along with its meta data.
         """
+        if self._monitor is None:
+            return None
+
         file = self._monitor.get()
 
         # We currently don't have a new image
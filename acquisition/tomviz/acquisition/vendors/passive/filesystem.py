@@ -1,13 +1,37 @@
 import os
 import re
+import threading
+import time
+from collections import OrderedDict
 try:
     import Queue as queue
 except ImportError:
     # py3
     import queue
 
+try:
+    from watchdog.observers import Observer
+    try:
+        from watchdog.observers.inotify import InotifyObserver
+    except ImportError:
+        InotifyObserver = None
+except ImportError:
+    Observer = None
+
+# Interval, in seconds, between the full rescans done by the EventMonitor to
+# pick up files whose events were dropped, for example if the kernel's event
+# queue overflowed.
+RESCAN_INTERVAL = 60.0
+
 
 class Monitor(object):
+    """
+    Polls a directory for new files. Each file is matched and validated once,
+    files that fail validation (because they are still being written for
+    example) are retried on the next check, so once files have been queued
+    the cost of a check is a directory listing.
+    """
+
     def __init__(self, path, filename_regex=None,
                  valid_file_check=lambda f: True):
         super(Monitor, self).__init__()
@@ -15,33 +39,61 @@ class Monitor(object):
         self._files = queue.Queue()
         self._filename_regex \
             = re.compile(filename_regex) if filename_regex else None
-        self._listing = set()
         self._valid_file_check = valid_file_check
+        # The names of the files that have been queued or don't match the
+        # regex. Names are forgotten once their file is gone, so that a file
+        # written again under the same name is picked up.
+        self._seen = set()
+        self._lock = threading.Lock()
 
-    def _check(self):
+    def _match(self, name):
+        return self._filename_regex is None or \
+            self._filename_regex.match(name) is not None
+
+    def _valid(self, filepath):
+        return self._valid_file_check is None or \
+            self._valid_file_check(filepath)
+
+    def _enqueue(self, name):
+        with self._lock:
+            if name in self._seen:
+                return
+            self._seen.add(name)
+
+        self._files.put(os.path.join(self._path, name))
+
+    def _scan(self):
+        # Listed under the lock so that no file queued meanwhile is forgotten.
+        with self._lock:
+            names = os.listdir(self._path)
+            self._seen.intersection_update(names)
+
+        new_files = []
+        for name in names:
+            if name in self._seen:
+                continue
+
+            if not self._match(name):
+                with self._lock:
+                    self._seen.add(name)
+                continue
 
-        new_listing = os.listdir(self._path)
-        # If we have a regex filter use it
-        if self._filename_regex:
-            new_listing = filter(lambda f: self._filename_regex.match(f),
-                                 new_listing)
-
-        # if we have a valid_file_check use it
-        if self._valid_file_check:
-            new_listing = filter(lambda f: self._valid_file_check(
-                os.path.join(self._path, f)), new_listing)
-
-        # sort by m_time
-        new_listing = sorted(new_listing,
-                             key=lambda f: os.path.getmtime(
-                                 os.path.join(self._path, f)))
-
-        # enqueue an new files
-        for f in new_listing:
-            if f not in self._listing:
-                absolute_path = os.path.join(self._path, f)
-                self._files.put(absolute_path)
-        self._listing = set(new_listing)
+            filepath = os.path.join(self._path, name)
+            if not self._valid(filepath):
+                continue
+
+            try:
+                new_files.append((os.path.getmtime(filepath), name))
+            except OSError:
+                # The file has been removed
+                continue
+
+        # enqueue the new files by m_time
+        for (_, name) in sorted(new_files):
+            self._enqueue(name)
+
+    def _check(self):
+        self._scan()
 
     def get(self):
         """
@@ -61,3 +113,131 @@ class Monitor(object):
             pass
 
         return None
+
+    def stop(self):
+        """
+        Stop monitoring the path.
+        """
+        pass
+
+
+class _EventHandler(object):
+    """
+    Forwards the events of a watchdog observer to an EventMonitor.
+    """
+
+    def __init__(self, monitor):
+        self._monitor = monitor
+
+    def dispatch(self, event):
+        self._monitor._on_event(event)
+
+
+class EventMonitor(Monitor):
+    """
+    A monitor driven by file system events, using watchdog. Where the observer
+    reports files being closed after writing (inotify), a file is validated
+    when that event arrives and queued in arrival order. Elsewhere created and
+    modified files are validated on the next call to get().
+    """
+
+    def __init__(self, path, filename_regex=None,
+                 valid_file_check=lambda f: True,
+                 rescan_interval=RESCAN_INTERVAL):
+        super(EventMonitor, self).__init__(path, filename_regex,
+                                           valid_file_check)
+        self._dir = os.path.normpath(os.path.abspath(path))
+        self._rescan_interval = rescan_interval
+        # The names of the files waiting for validation, when there are no
+        # close events.
+        self._pending = OrderedDict()
+
+        self._observer = Observer()
+        self._close_events = InotifyObserver is not None and \
+            isinstance(self._observer, InotifyObserver)
+        self._observer.daemon = True
+        self._observer.schedule(_EventHandler(self), path, recursive=False)
+        self._observer.start()
+
+        # Pick up the files that are already there, the observer is started
+        # first so nothing is missed in between.
+        self._last_scan = time.time()
+        self._scan()
+
+    def _forget(self, filepath):
+        if os.path.normpath(os.path.dirname(filepath)) != self._dir:
+            return
+
+        name = os.path.basename(filepath)
+        with self._lock:
+            self._seen.discard(name)
+            self._pending.pop(name, None)
+
+    def _on_event(self, event):
+        if event.is_directory:
+            return
+
+        if event.event_type in ('deleted', 'moved'):
+            self._forget(event.src_path)
+
+        if event.event_type == 'moved':
+            filepath = event.dest_path
+        elif event.event_type == 'closed' or (
+                not self._close_events and
+                event.event_type in ('created', 'modified')):
+            filepath = event.src_path
+        else:
+            return
+
+        if os.path.normpath(os.path.dirname(filepath)) != self._dir:
+            return
+
+        name = os.path.basename(filepath)
+        if name in self._seen:
+            return
+
+        if not self._match(name):
+            with self._lock:
+                self._seen.add(name)
+            return
+
+        if event.event_type in ('closed', 'moved') and \
+                self._valid(os.path.join(self._path, name)):
+            self._enqueue(name)
+        else:
+            with self._lock:
+                self._pending[name] = None
+
+    def _check(self):
+        with self._lock:
+            pending = list(self._pending.keys())
+
+        for name in pending:
+            if self._valid(os.path.join(self._path, name)):
+                with self._lock:
+                    self._pending.pop(name, None)
+                self._enqueue(name)
+
+        if time.time() - self._last_scan > self._rescan_interval:
+            self._last_scan = time.time()
+            self._scan()
+
+    def stop(self):
+        self._observer.stop()
+        self._observer.join()
+
+
+def create_monitor(path, filename_regex=None,
+                   valid_file_check=lambda f: True):
+    """
+    Create a monitor for path, an EventMonitor if watchdog is available and
+    can watch the path, a polling Monitor otherwise.
+    """
+    if Observer is not None:
+        try:
+            return EventMonitor(path, filename_regex, valid_file_check)
+        except OSError:
+            # For example if the inotify watch limit has been reached.
+            pass
+
+    return Monitor(path, filename_regex, valid_file_check)
@@ -0,0 +1,343 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <benchmark/benchmark.h>
+
+#include <vtkDoubleArray.h>
+#include <vtkFieldData.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+#include "ComputeHistogram.h"
+#include "EmdFormat.h"
+#include "GenericHDF5Format.h"
+#include "TomographyReconstruction.h"
+#include "TomographyTiltSeries.h"
+#include "vtkOMETiffReader.h"
+
+#include <QDir>
+#include <QFile>
+
+extern "C" {
+#include "vtk_tiff.h"
+}
+
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace tomviz;
+
+// Synthetic data sets, all benchmarks run on the same data so that the results
+// of different kernels can be compared.
+namespace {
+
+int volumeSize = 128;
+int numberOfTilts = 61;
+
+// A noisy sphere in a volume of edge volumeSize, like a reconstruction.
+vtkSmartPointer<vtkImageData> makeVolume(int type)
+{
+  auto image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(volumeSize, volumeSize, volumeSize);
+  image->AllocateScalars(type, 1);
+  auto scalars = image->GetPointData()->GetScalars();
+  scalars->SetName("scalars");
+
+  std::mt19937 generator(12345);
+  std::normal_distribution<double> noise(0.0, 10.0);
+  const double center = (volumeSize - 1) / 2.0;
+  const double radius = volumeSize / 3.0;
+  vtkIdType index = 0;
+  for (int k = 0; k < volumeSize; ++k) {
+    for (int j = 0; j < volumeSize; ++j) {
+      for (int i = 0; i < volumeSize; ++i, ++index) {
+        double r = std::sqrt((i - center) * (i - center) +
+                             (j - center) * (j - center) +
+                             (k - center) * (k - center));
+        double value = (r < radius ? 200.0 : 40.0) + noise(generator);
+        scalars->SetTuple1(index, std::min(std::max(value, 0.0), 255.0));
+      }
+    }
+  }
+  return image;
+}
+
+// A float tilt series of numberOfTilts projections over +/- 60 degrees, with
+// the tilt angles the reconstruction expects.
+vtkSmartPointer<vtkImageData> makeTiltSeries()
+{
+  auto image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(volumeSize, volumeSize, numberOfTilts);
+  image->AllocateScalars(VTK_FLOAT, 1);
+  auto data = static_cast<float*>(image->GetScalarPointer());
+
+  std::mt19937 generator(54321);
+  std::uniform_real_distribution<float> noise(0.0f, 1.0f);
+  const vtkIdType numPoints = image->GetNumberOfPoints();
+  for (vtkIdType i = 0; i < numPoints; ++i) {
+    data[i] = noise(generator);
+  }
+
+  vtkNew<vtkDoubleArray> angles;
+  angles->SetName("tilt_angles");
+  angles->SetNumberOfTuples(numberOfTilts);
+  for (int i = 0; i < numberOfTilts; ++i) {
+    angles->SetValue(i, numberOfTilts > 1
+                          ? -60.0 + 120.0 * i / (numberOfTilts - 1)
+                          : 0.0);
+  }
+  image->GetFieldData()->AddArray(angles);
+  return image;
+}
+
+// Writes a single channel uint16 OME-TIFF with one page per z slice.
+bool writeOMETiff(const std::string& fileName, vtkImageData* image)
+{
+  int dims[3];
+  image->GetDimensions(dims);
+
+  std::ostringstream xml;
+  xml << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+      << "<OME xmlns=\"http://www.openmicroscopy.org/Schemas/OME/2016-06\">"
+      << "<Image ID=\"Image:0\"><Pixels ID=\"Pixels:0\" "
+      << "DimensionOrder=\"XYZCT\" Type=\"uint16\" BigEndian=\"false\" "
+      << "SizeX=\"" << dims[0] << "\" SizeY=\"" << dims[1] << "\" "
+      << "SizeZ=\"" << dims[2] << "\" SizeC=\"1\" SizeT=\"1\"/>"
+      << "</Image></OME>";
+  const std::string description = xml.str();
+
+  TIFF* tiff = TIFFOpen(fileName.c_str(), "w");
+  if (!tiff) {
+    return false;
+  }
+
+  auto data = static_cast<unsigned short*>(image->GetScalarPointer());
+  for (int k = 0; k < dims[2]; ++k) {
+    TIFFSetField(tiff, TIFFTAG_IMAGEWIDTH, dims[0]);
+    TIFFSetField(tiff, TIFFTAG_IMAGELENGTH, dims[1]);
+    TIFFSetField(tiff, TIFFTAG_BITSPERSAMPLE, 16);
+    TIFFSetField(tiff, TIFFTAG_SAMPLESPERPIXEL, 1);
+    TIFFSetField(tiff, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_UINT);
+    TIFFSetField(tiff, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_MINISBLACK);
+    TIFFSetField(tiff, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+    TIFFSetField(tiff, TIFFTAG_ROWSPERSTRIP, dims[1]);
+    if (k == 0) {
+      TIFFSetField(tiff, TIFFTAG_IMAGEDESCRIPTION, description.c_str());
+    }
+    for (int j = 0; j < dims[1]; ++j) {
+      auto row = data + (static_cast<vtkIdType>(k) * dims[1] + j) * dims[0];
+      TIFFWriteScanline(tiff, row, j, 0);
+    }
+    TIFFWriteDirectory(tiff);
+  }
+  TIFFClose(tiff);
+  return true;
+}
+
+std::string tempFileName(const char* name)
+{
+  return QDir::temp().filePath(name).toStdString();
+}
+
+int64_t volumeBytes(vtkImageData* image)
+{
+  auto scalars = image->GetPointData()->GetScalars();
+  return static_cast<int64_t>(scalars->GetNumberOfValues()) *
+         scalars->GetDataTypeSize();
+}
+
+void registerBenchmarks()
+{
+  auto floatVolume = makeVolume(VTK_FLOAT);
+  auto ucharVolume = makeVolume(VTK_UNSIGNED_CHAR);
+  auto ushortVolume = makeVolume(VTK_UNSIGNED_SHORT);
+  auto tiltSeries = makeTiltSeries();
+
+  // Histograms, with the binning of HistogramManager.
+  benchmark::RegisterBenchmark(
+    "CalculateHistogram/float", [floatVolume](benchmark::State& state) {
+      const int numberOfBins = 256;
+      auto scalars = floatVolume->GetPointData()->GetScalars();
+      double range[2];
+      scalars->GetFiniteRange(range, -1);
+      const double inc = (range[1] - range[0]) / (numberOfBins - 1);
+      std::vector<uint64_t> pops(numberOfBins);
+      for (auto _ : state) {
+        std::fill(pops.begin(), pops.end(), 0);
+        int invalid = 0;
+        CalculateHistogram(static_cast<float*>(scalars->GetVoidPointer(0)),
+                           scalars->GetNumberOfTuples(), 1, range[0],
+                           range[1], pops.data(), 1.0 / inc, invalid);
+        benchmark::DoNotOptimize(pops.data());
+      }
+      state.SetBytesProcessed(state.iterations() * volumeBytes(floatVolume));
+    });
+
+  benchmark::RegisterBenchmark(
+    "CalculateHistogram/uchar", [ucharVolume](benchmark::State& state) {
+      auto scalars = ucharVolume->GetPointData()->GetScalars();
+      std::vector<uint64_t> pops(256);
+      for (auto _ : state) {
+        std::fill(pops.begin(), pops.end(), 0);
+        int invalid = 0;
+        CalculateHistogram(
+          static_cast<unsigned char*>(scalars->GetVoidPointer(0)),
+          scalars->GetNumberOfTuples(), 1, 0.f, 255.f, pops.data(), 1.f,
+          invalid);
+        benchmark::DoNotOptimize(pops.data());
+      }
+      state.SetBytesProcessed(state.iterations() * volumeBytes(ucharVolume));
+    });
+
+  benchmark::RegisterBenchmark(
+    "Calculate2DHistogram/float", [floatVolume](benchmark::State& state) {
+      auto scalars = floatVolume->GetPointData()->GetScalars();
+      double range[2];
+      scalars->GetFiniteRange(range, -1);
+      int dims[3];
+      double spacing[3];
+      floatVolume->GetDimensions(dims);
+      floatVolume->GetSpacing(spacing);
+      vtkNew<vtkImageData> histogram;
+      histogram->SetDimensions(256, 256, 1);
+      histogram->AllocateScalars(VTK_DOUBLE, 1);
+      for (auto _ : state) {
+        Calculate2DHistogram(static_cast<float*>(scalars->GetVoidPointer(0)),
+                             dims, 1, range, histogram, spacing);
+      }
+      state.SetBytesProcessed(state.iterations() * volumeBytes(floatVolume));
+    });
+
+  // Reconstruction.
+  benchmark::RegisterBenchmark(
+    "getSinogram", [tiltSeries](benchmark::State& state) {
+      int dims[3];
+      tiltSeries->GetDimensions(dims);
+      std::vector<float> sinogram(static_cast<size_t>(dims[1]) * dims[2]);
+      for (auto _ : state) {
+        // Extract every sinogram, as a reconstruction does.
+        for (int s = 0; s < dims[0]; ++s) {
+          TomographyTiltSeries::getSinogram(tiltSeries, s, sinogram.data());
+        }
+        benchmark::DoNotOptimize(sinogram.data());
+      }
+      state.SetItemsProcessed(state.iterations() * dims[0]);
+    });
+
+  benchmark::RegisterBenchmark(
+    "weightedBackProjection3", [tiltSeries](benchmark::State& state) {
+      vtkNew<vtkImageData> recon;
+      for (auto _ : state) {
+        TomographyReconstruction::weightedBackProjection3(tiltSeries, recon);
+      }
+      state.SetBytesProcessed(state.iterations() * volumeBytes(tiltSeries));
+    })
+    ->Unit(benchmark::kMillisecond);
+
+  // Memory layout conversion.
+  auto reorder = [floatVolume](benchmark::State& state, ReorderMode mode) {
+    int dims[3];
+    floatVolume->GetDimensions(dims);
+    auto scalars = floatVolume->GetPointData()->GetScalars();
+    vtkNew<vtkFloatArray> out;
+    for (auto _ : state) {
+      GenericHDF5Format::reorderDataArray(scalars, out, dims, mode);
+      benchmark::DoNotOptimize(out->GetVoidPointer(0));
+    }
+    state.SetBytesProcessed(state.iterations() * volumeBytes(floatVolume));
+  };
+  benchmark::RegisterBenchmark("ReorderArrayC", reorder,
+                               ReorderMode::FortranToC);
+  benchmark::RegisterBenchmark("ReorderArrayF", reorder,
+                               ReorderMode::CToFortran);
+
+  // File formats.
+  benchmark::RegisterBenchmark(
+    "EmdFormat/write", [floatVolume](benchmark::State& state) {
+      auto fileName = tempFileName("tomviz_benchmark_write.emd");
+      for (auto _ : state) {
+        if (!EmdFormat::write(fileName, floatVolume)) {
+          state.SkipWithError("Failed to write the EMD file");
+          break;
+        }
+      }
+      QFile::remove(QString::fromStdString(fileName));
+      state.SetBytesProcessed(state.iterations() * volumeBytes(floatVolume));
+    })
+    ->Unit(benchmark::kMillisecond);
+
+  benchmark::RegisterBenchmark(
+    "EmdFormat/read", [floatVolume](benchmark::State& state) {
+      auto fileName = tempFileName("tomviz_benchmark_read.emd");
+      if (!EmdFormat::write(fileName, floatVolume)) {
+        state.SkipWithError("Failed to write the EMD file");
+        return;
+      }
+      for (auto _ : state) {
+        vtkNew<vtkImageData> image;
+        if (!EmdFormat::read(fileName, image)) {
+          state.SkipWithError("Failed to read the EMD file");
+          break;
+        }
+      }
+      QFile::remove(QString::fromStdString(fileName));
+      state.SetBytesProcessed(state.iterations() * volumeBytes(floatVolume));
+    })
+    ->Unit(benchmark::kMillisecond);
+
+  benchmark::RegisterBenchmark(
+    "vtkOMETiffReader", [ushortVolume](benchmark::State& state) {
+      auto fileName = tempFileName("tomviz_benchmark.ome.tif");
+      if (!writeOMETiff(fileName, ushortVolume)) {
+        state.SkipWithError("Failed to write the OME-TIFF file");
+        return;
+      }
+      for (auto _ : state) {
+        vtkNew<vtkOMETiffReader> reader;
+        reader->SetFileName(fileName.c_str());
+        reader->Update();
+        benchmark::DoNotOptimize(reader->GetOutput());
+      }
+      QFile::remove(QString::fromStdString(fileName));
+      state.SetBytesProcessed(state.iterations() * volumeBytes(ushortVolume));
+    })
+    ->Unit(benchmark::kMillisecond);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+  // Pick up our own options, the remaining ones go to Google Benchmark.
+  std::vector<char*> args;
+  for (int i = 0; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.compare(0, 7, "--size=") == 0) {
+      volumeSize = std::max(std::stoi(arg.substr(7)), 2);
+    } else if (arg.compare(0, 8, "--tilts=") == 0) {
+      numberOfTilts = std::max(std::stoi(arg.substr(8)), 1);
+    } else {
+      args.push_back(argv[i]);
+    }
+  }
+  int count = static_cast<int>(args.size());
+
+  // Recorded in the JSON context so runs on different data are not compared.
+  benchmark::AddCustomContext("tomviz_volume_size",
+                              std::to_string(volumeSize));
+  benchmark::AddCustomContext("tomviz_number_of_tilts",
+                              std::to_string(numberOfTilts));
+
+  registerBenchmarks();
+  benchmark::Initialize(&count, args.data());
+  if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,263 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <gtest/gtest.h>
+
+#include <vtkDoubleArray.h>
+#include <vtkNew.h>
+#include <vtkShortArray.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnsignedCharArray.h>
+
+#include "ArrayConversion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using namespace tomviz;
+
+namespace {
+
+// Enough tuples to span several chunks.
+const vtkIdType numTuples = 3 * ArrayConversion::ChunkSize + 17;
+
+double value(vtkIdType i, int component)
+{
+  return std::sin(i * 0.001 + component) * 1000.0 + component * 10.0;
+}
+
+template <typename Out>
+Out rescaled(double value, const double range[2])
+{
+  const double multiplier =
+    std::numeric_limits<Out>::max() / (range[1] - range[0]);
+  return static_cast<Out>((value - range[0]) * multiplier + 0.5);
+}
+} // namespace
+
+TEST(ArrayConversionTest, convert)
+{
+  std::vector<double> input(numTuples);
+  for (vtkIdType i = 0; i < numTuples; ++i) {
+    input[i] = value(i, 0);
+  }
+
+  std::vector<float> output(numTuples);
+  ArrayConversion::convert(input.data(), output.data(), numTuples);
+  for (vtkIdType i = 0; i < numTuples; ++i) {
+    ASSERT_EQ(output[i], static_cast<float>(input[i]));
+  }
+
+  // The output overwrites the input.
+  auto values = reinterpret_cast<float*>(input.data());
+  ArrayConversion::convert(input.data(), values, numTuples);
+  for (vtkIdType i = 0; i < numTuples; ++i) {
+    ASSERT_EQ(values[i], output[i]);
+  }
+}
+
+TEST(ArrayConversionTest, finiteRange)
+{
+  const int numComponents = 3;
+  std::vector<float> values(numTuples * numComponents);
+  for (vtkIdType i = 0; i < numTuples; ++i) {
+    for (int c = 0; c < numComponents; ++c) {
+      values[i * numComponents + c] = static_cast<float>(value(i, c));
+    }
+  }
+  values[5 * numComponents + 1] = std::numeric_limits<float>::quiet_NaN();
+  values[numTuples * numComponents - 2] =
+    -std::numeric_limits<float>::infinity();
+
+  for (int c = 0; c < numComponents; ++c) {
+    double expected[2] = { std::numeric_limits<double>::infinity(),
+                           -std::numeric_limits<double>::infinity() };
+    for (vtkIdType i = 0; i < numTuples; ++i) {
+      double v = values[i * numComponents + c];
+      if (std::isfinite(v)) {
+        expected[0] = std::min(expected[0], v);
+        expected[1] = std::max(expected[1], v);
+      }
+    }
+
+    double range[2];
+    ASSERT_TRUE(ArrayConversion::finiteRange(values.data(), numTuples,
+                                             numComponents, c, range));
+    EXPECT_EQ(range[0], expected[0]);
+    EXPECT_EQ(range[1], expected[1]);
+  }
+
+  std::vector<double> nans(10, std::numeric_limits<double>::quiet_NaN());
+  double range[2];
+  EXPECT_FALSE(ArrayConversion::finiteRange(nans.data(), 10, 1, 0, range));
+  EXPECT_EQ(range[0], 0.0);
+  EXPECT_EQ(range[1], 0.0);
+}
+
+TEST(ArrayConversionTest, rescale)
+{
+  const int numComponents = 2;
+  std::vector<short> values(numTuples * numComponents);
+  for (vtkIdType i = 0; i < numTuples; ++i) {
+    for (int c = 0; c < numComponents; ++c) {
+      values[i * numComponents + c] = static_cast<short>(value(i, c));
+    }
+  }
+
+  double range[2];
+  ASSERT_TRUE(ArrayConversion::finiteRange(values.data(), numTuples,
+                                           numComponents, 1, range));
+  std::vector<unsigned char> output(numTuples);
+  ArrayConversion::rescale(values.data(), numTuples, numComponents, 1, range,
+                           output.data());
+  std::vector<unsigned char> expected(numTuples);
+  for (vtkIdType i = 0; i < numTuples; ++i) {
+    expected[i] =
+      rescaled<unsigned char>(values[i * numComponents + 1], range);
+  }
+  EXPECT_EQ(output, expected);
+  EXPECT_EQ(*std::min_element(output.begin(), output.end()), 0);
+  EXPECT_EQ(*std::max_element(output.begin(), output.end()), 255);
+
+  // In place, the output is narrower than the tuples.
+  auto narrowed = reinterpret_cast<unsigned char*>(values.data());
+  ArrayConversion::rescale(values.data(), numTuples, numComponents, 1, range,
+                           narrowed);
+  EXPECT_EQ(std::memcmp(narrowed, expected.data(), numTuples), 0);
+}
+
+TEST(ArrayConversionTest, rescaleWiderInPlace)
+{
+  // RGB bytes to 16 bit values, the output values are wider than the input
+  // values but narrower than the input tuples.
+  const int numComponents = 3;
+  std::vector<unsigned char> values(numTuples * numComponents);
+  for (vtkIdType i = 0; i < numTuples * numComponents; ++i) {
+    values[i] = static_cast<unsigned char>((i * 37) % 251);
+  }
+
+  const double range[2] = { 0.0, 250.0 };
+  std::vector<unsigned short> expected(numTuples);
+  ArrayConversion::rescale(values.data(), numTuples, numComponents, 2, range,
+                           expected.data());
+
+  auto widened = reinterpret_cast<unsigned short*>(values.data());
+  ArrayConversion::rescale(values.data(), numTuples, numComponents, 2, range,
+                           widened);
+  EXPECT_EQ(std::memcmp(widened, expected.data(),
+                        numTuples * sizeof(unsigned short)),
+            0);
+}
+
+TEST(ArrayConversionTest, rescaleOutOfRange)
+{
+  const double values[4] = { -1.0, 2.0,
+                             std::numeric_limits<double>::quiet_NaN(),
+                             std::numeric_limits<double>::infinity() };
+  const double range[2] = { 0.0, 1.0 };
+  unsigned short output[4];
+  ArrayConversion::rescale(values, 4, 1, 0, range, output);
+  EXPECT_EQ(output[0], 0);
+  EXPECT_EQ(output[1], 65535);
+  EXPECT_EQ(output[2], 0);
+  EXPECT_EQ(output[3], 65535);
+
+  // A constant component is sent to 0.
+  const double constant[2] = { 3.0, 3.0 };
+  const double flat[2] = { 3.0, 3.0 };
+  ArrayConversion::rescale(constant, 2, 1, 0, flat, output);
+  EXPECT_EQ(output[0], 0);
+  EXPECT_EQ(output[1], 0);
+}
+
+TEST(ArrayConversionTest, toFloat)
+{
+  auto array = vtkSmartPointer<vtkDoubleArray>::New();
+  array->SetName("scalars");
+  array->SetNumberOfComponents(2);
+  array->SetNumberOfTuples(numTuples);
+  for (vtkIdType i = 0; i < numTuples; ++i) {
+    array->SetTypedComponent(i, 0, value(i, 0));
+    array->SetTypedComponent(i, 1, value(i, 1));
+  }
+
+  auto copy = ArrayConversion::toFloat(array);
+  ASSERT_NE(copy.Get(), nullptr);
+  EXPECT_EQ(copy->GetDataType(), VTK_FLOAT);
+  EXPECT_STREQ(copy->GetName(), "scalars");
+  EXPECT_EQ(copy->GetNumberOfComponents(), 2);
+  EXPECT_EQ(copy->GetNumberOfTuples(), numTuples);
+  EXPECT_NE(copy->GetVoidPointer(0), array->GetVoidPointer(0));
+
+  // The buffer of the array is reused, and outlives it.
+  void* buffer = array->GetVoidPointer(0);
+  auto converted = ArrayConversion::toFloat(array, true);
+  array = nullptr;
+  ASSERT_NE(converted.Get(), nullptr);
+  EXPECT_EQ(converted->GetVoidPointer(0), buffer);
+  for (vtkIdType i = 0; i < numTuples; ++i) {
+    ASSERT_EQ(converted->GetComponent(i, 0), copy->GetComponent(i, 0));
+    ASSERT_EQ(converted->GetComponent(i, 1), copy->GetComponent(i, 1));
+  }
+
+  // Float arrays are left as they are.
+  EXPECT_EQ(ArrayConversion::toFloat(converted, true).Get(), converted.Get());
+}
+
+TEST(ArrayConversionTest, rescaleComponent)
+{
+  vtkNew<vtkShortArray> array;
+  array->SetNumberOfTuples(numTuples);
+  for (vtkIdType i = 0; i < numTuples; ++i) {
+    array->SetValue(i, static_cast<short>(value(i, 0)));
+  }
+
+  // The buffer is not reused while another reference to the array is held.
+  vtkSmartPointer<vtkShortArray> reference = array.Get();
+  auto output =
+    ArrayConversion::rescaleComponent(array, 0, VTK_TYPE_UINT16, true);
+  ASSERT_NE(output.Get(), nullptr);
+  EXPECT_EQ(output->GetDataType(), VTK_TYPE_UINT16);
+  EXPECT_EQ(output->GetNumberOfComponents(), 1);
+  EXPECT_NE(output->GetVoidPointer(0), array->GetVoidPointer(0));
+  double range[2];
+  output->GetRange(range);
+  EXPECT_EQ(range[0], 0.0);
+  EXPECT_EQ(range[1], 65535.0);
+
+  EXPECT_FALSE(ArrayConversion::rescaleComponent(array, 1, VTK_TYPE_UINT8));
+  EXPECT_FALSE(ArrayConversion::rescaleComponent(array, 0, VTK_FLOAT));
+}
+
+TEST(ArrayConversionTest, rescaleComponentInPlace)
+{
+  const int numComponents = 3;
+  auto array = vtkSmartPointer<vtkUnsignedCharArray>::New();
+  array->SetNumberOfComponents(numComponents);
+  array->SetNumberOfTuples(numTuples);
+  for (vtkIdType i = 0; i < numTuples; ++i) {
+    for (int c = 0; c < numComponents; ++c) {
+      array->SetTypedComponent(
+        i, c, static_cast<unsigned char>((i * 7 + c * 50) % 256));
+    }
+  }
+  auto copy =
+    ArrayConversion::rescaleComponent(array, 1, VTK_TYPE_UINT16, false);
+  ASSERT_NE(copy.Get(), nullptr);
+
+  // The array has no other reference, its buffer holds the output.
+  void* buffer = array->GetVoidPointer(0);
+  auto output =
+    ArrayConversion::rescaleComponent(array, 1, VTK_TYPE_UINT16, true);
+  array = nullptr;
+  ASSERT_NE(output.Get(), nullptr);
+  EXPECT_EQ(output->GetVoidPointer(0), buffer);
+  EXPECT_EQ(output->GetNumberOfComponents(), 1);
+  ASSERT_EQ(output->GetNumberOfTuples(), numTuples);
+  for (vtkIdType i = 0; i < numTuples; ++i) {
+    ASSERT_EQ(output->GetComponent(i, 0), copy->GetComponent(i, 0));
+  }
+}
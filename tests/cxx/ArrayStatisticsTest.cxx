@@ -0,0 +1,108 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <gtest/gtest.h>
+
+#include <vtkFloatArray.h>
+#include <vtkNew.h>
+#include <vtkUnsignedCharArray.h>
+
+#include "ArrayStatistics.h"
+
+#include <cmath>
+#include <limits>
+
+using namespace tomviz;
+
+class ArrayStatisticsTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // 0, 1, ..., 199999 followed by a NaN and an infinity, spanning several
+    // chunks so that the merging of the partial results is exercised.
+    array->SetNumberOfTuples(200002);
+    for (vtkIdType i = 0; i < 200000; ++i) {
+      array->SetValue(i, static_cast<float>(i));
+    }
+    array->SetValue(200000, std::numeric_limits<float>::quiet_NaN());
+    array->SetValue(200001, std::numeric_limits<float>::infinity());
+  }
+
+  vtkNew<vtkFloatArray> array;
+};
+
+TEST_F(ArrayStatisticsTest, ranges)
+{
+  ArrayStatistics stats(array);
+  ASSERT_TRUE(stats.isValid());
+  EXPECT_EQ(stats.arrayMTime(), array->GetMTime());
+
+  double range[2];
+  stats.range(range);
+  EXPECT_EQ(range[0], 0.0);
+  EXPECT_TRUE(std::isinf(range[1]));
+
+  stats.finiteRange(range);
+  EXPECT_EQ(range[0], 0.0);
+  EXPECT_EQ(range[1], 199999.0);
+
+  double expected[2];
+  array->GetFiniteRange(expected);
+  EXPECT_EQ(range[0], expected[0]);
+  EXPECT_EQ(range[1], expected[1]);
+}
+
+TEST_F(ArrayStatisticsTest, moments)
+{
+  ArrayStatistics stats(array);
+  const double n = 200000.0;
+  EXPECT_EQ(stats.finiteCount(), 200000);
+  EXPECT_EQ(stats.nanCount(), 1);
+  EXPECT_DOUBLE_EQ(stats.mean(), (n - 1) / 2);
+  EXPECT_NEAR(stats.variance(), (n * n - 1) / 12, 1e-6 * n * n);
+}
+
+TEST_F(ArrayStatisticsTest, percentiles)
+{
+  ArrayStatistics stats(array);
+  EXPECT_EQ(stats.percentile(0), 0.0);
+  EXPECT_EQ(stats.percentile(100), 199999.0);
+  // Exact, the array is smaller than the sample size.
+  EXPECT_DOUBLE_EQ(stats.percentile(50), 99999.5);
+  EXPECT_DOUBLE_EQ(stats.percentile(25), 49999.75);
+}
+
+TEST_F(ArrayStatisticsTest, components)
+{
+  // Tuples (3, 4), (0, 0) and (6, 8).
+  vtkNew<vtkUnsignedCharArray> vectors;
+  vectors->SetNumberOfComponents(2);
+  vectors->SetNumberOfTuples(3);
+  unsigned char values[] = { 3, 4, 0, 0, 6, 8 };
+  for (int i = 0; i < 6; ++i) {
+    vectors->SetValue(i, values[i]);
+  }
+
+  ArrayStatistics stats(vectors);
+  ASSERT_TRUE(stats.isValid());
+  EXPECT_EQ(stats.numberOfComponents(), 2);
+
+  double range[2];
+  stats.range(range, 1);
+  EXPECT_EQ(range[0], 0.0);
+  EXPECT_EQ(range[1], 8.0);
+  EXPECT_DOUBLE_EQ(stats.mean(0), 3.0);
+
+  // Negative components select the magnitude.
+  stats.range(range, -1);
+  EXPECT_EQ(range[0], 0.0);
+  EXPECT_EQ(range[1], 10.0);
+  EXPECT_DOUBLE_EQ(stats.mean(-1), 5.0);
+  EXPECT_DOUBLE_EQ(stats.percentile(50, -1), 5.0);
+
+  // Out of range components have no statistics.
+  stats.range(range, 2);
+  EXPECT_EQ(range[0], 0.0);
+  EXPECT_EQ(range[1], 0.0);
+}
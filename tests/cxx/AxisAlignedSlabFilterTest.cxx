@@ -0,0 +1,134 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <gtest/gtest.h>
+
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkRTAnalyticSource.h>
+
+#include "vtkAxisAlignedSlabFilter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const int WholeExtent[6] = { 0, 7, 0, 5, 0, 19 };
+
+// The slab of the output plane z computed from the whole volume.
+double bruteForce(vtkImageData* volume, int x, int y, int z, int thickness,
+                  int mode)
+{
+  const int half = (thickness - 1) / 2;
+  const int lo = std::max(z - half, WholeExtent[4]);
+  const int hi = std::min(z - half + thickness - 1, WholeExtent[5]);
+  double sum = 0.0;
+  for (int p = lo; p <= hi; ++p) {
+    sum += volume->GetScalarComponentAsDouble(x, y, p, 0);
+  }
+  return mode == vtkAxisAlignedSlabFilter::Mean ? sum / (hi - lo + 1) : sum;
+}
+} // namespace
+
+class AxisAlignedSlabFilterTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // The wavelet source produces the requested extent only, the slab filter
+    // sees restricted inputs, until the tests set the whole volume as input.
+    source->SetWholeExtent(WholeExtent[0], WholeExtent[1], WholeExtent[2],
+                           WholeExtent[3], WholeExtent[4], WholeExtent[5]);
+    volume->DeepCopy(wholeVolume());
+
+    filter->SetInputConnection(source->GetOutputPort());
+    filter->SetAxis(2);
+    filter->SetSlabThickness(5);
+  }
+
+  vtkImageData* wholeVolume()
+  {
+    source->UpdateWholeExtent();
+    return source->GetOutput();
+  }
+
+  // Request the planes first to last and compare them with the brute force
+  // slabs.
+  void check(int first, int last)
+  {
+    int extent[6];
+    std::copy(WholeExtent, WholeExtent + 6, extent);
+    extent[4] = first;
+    extent[5] = last;
+    filter->UpdateExtent(extent);
+    auto output = filter->GetOutput();
+    int outExtent[6];
+    output->GetExtent(outExtent);
+    ASSERT_LE(outExtent[4], first);
+    ASSERT_GE(outExtent[5], last);
+    const int thickness = filter->GetSlabThickness();
+    const int mode = filter->GetSlabMode();
+    for (int z = first; z <= last; ++z) {
+      for (int y = WholeExtent[2]; y <= WholeExtent[3]; ++y) {
+        for (int x = WholeExtent[0]; x <= WholeExtent[1]; ++x) {
+          const double expected =
+            bruteForce(volume, x, y, z, thickness, mode);
+          ASSERT_NEAR(output->GetScalarComponentAsDouble(x, y, z, 0),
+                      expected, std::abs(expected) * 1e-5)
+            << "plane " << z << " of " << first << " to " << last;
+        }
+      }
+    }
+  }
+
+  vtkNew<vtkRTAnalyticSource> source;
+  vtkNew<vtkImageData> volume;
+  vtkNew<vtkAxisAlignedSlabFilter> filter;
+};
+
+TEST_F(AxisAlignedSlabFilterTest, slidingSum)
+{
+  filter->SetSlabMode(vtkAxisAlignedSlabFilter::Sum);
+  for (int pass = 0; pass < 2; ++pass) {
+    for (int z = 0; z < 20; ++z) {
+      check(z, z);
+    }
+    for (int z = 19; z >= 0; --z) {
+      check(z, z);
+    }
+    check(3, 6);
+    check(5, 8);
+
+    // The whole volume in memory.
+    filter->SetInputData(volume);
+  }
+}
+
+TEST_F(AxisAlignedSlabFilterTest, jumpingMean)
+{
+  filter->SetSlabMode(vtkAxisAlignedSlabFilter::Mean);
+  const int planes[] = { 10, 0, 19, 2, 17, 9, 12, 11, 1, 18 };
+  for (int pass = 0; pass < 2; ++pass) {
+    for (int z : planes) {
+      check(z, z);
+    }
+    check(0, 19);
+    filter->SetInputData(volume);
+  }
+}
+
+TEST_F(AxisAlignedSlabFilterTest, changes)
+{
+  filter->SetSlabMode(vtkAxisAlignedSlabFilter::Sum);
+  check(8, 8);
+  filter->SetSlabThickness(4);
+  check(9, 9);
+
+  // New values of the input invalidate the running sum.
+  source->SetMaximum(100.0);
+  volume->DeepCopy(wholeVolume());
+  check(10, 10);
+}
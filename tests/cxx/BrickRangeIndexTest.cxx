@@ -0,0 +1,140 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <gtest/gtest.h>
+
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkUnsignedCharArray.h>
+
+#include "BrickRangeIndex.h"
+
+using namespace tomviz;
+
+class BrickRangeIndexTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // A sparse segmented volume, a single labelled cube in a 64^3 background.
+    image->SetDimensions(64, 64, 64);
+    image->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+    auto scalars = image->GetPointData()->GetScalars();
+    scalars->FillComponent(0, 0);
+    for (int k = 20; k < 28; ++k) {
+      for (int j = 20; j < 28; ++j) {
+        for (int i = 20; i < 28; ++i) {
+          auto ptr = static_cast<unsigned char*>(
+            image->GetScalarPointer(i, j, k));
+          *ptr = 1;
+        }
+      }
+    }
+  }
+
+  vtkNew<vtkImageData> image;
+};
+
+TEST_F(BrickRangeIndexTest, bricks)
+{
+  BrickRangeIndex index(image, image->GetPointData()->GetScalars());
+  ASSERT_TRUE(index.isValid());
+  // 63 cells along each axis, four bricks of 16 cells.
+  EXPECT_EQ(index.brickDimensions()[0], 4);
+  EXPECT_EQ(index.numberOfBricks(), 64);
+}
+
+TEST_F(BrickRangeIndexTest, sparse_query)
+{
+  BrickRangeIndex index(image, image->GetPointData()->GetScalars());
+
+  // The label is contained in the second brick along each axis.
+  EXPECT_EQ(index.countActiveBricks(0.5, 0.5), 1);
+  int extent[6];
+  ASSERT_TRUE(index.activeExtent(0.5, 0.5, extent));
+  int expected[6] = { 16, 32, 16, 32, 16, 32 };
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(extent[i], expected[i]);
+  }
+  EXPECT_FALSE(index.isWholeExtent(extent));
+
+  // The background touches every brick.
+  EXPECT_EQ(index.countActiveBricks(0, 0), 64);
+  ASSERT_TRUE(index.activeExtent(0, 0, extent));
+  EXPECT_TRUE(index.isWholeExtent(extent));
+
+  // Nothing is out of range.
+  EXPECT_FALSE(index.activeExtent(2, 10, extent));
+}
+
+TEST_F(BrickRangeIndexTest, active_extent)
+{
+  // A second label in two opposite corners, its bricks are far apart.
+  for (int k = 0; k < 4; ++k) {
+    for (int j = 0; j < 4; ++j) {
+      for (int i = 0; i < 4; ++i) {
+        *static_cast<unsigned char*>(image->GetScalarPointer(i, j, k)) = 2;
+        *static_cast<unsigned char*>(
+          image->GetScalarPointer(60 + i, 60 + j, 60 + k)) = 2;
+      }
+    }
+  }
+  BrickRangeIndex index(image, image->GetPointData()->GetScalars());
+
+  int extent[6];
+  ASSERT_TRUE(index.activeExtent(1, 1, extent));
+  EXPECT_FALSE(index.coversMostOfImage(extent));
+
+  // The extent bounding the corners is the whole image, though only two
+  // bricks are active.
+  EXPECT_EQ(index.countActiveBricks(2, 2), 2);
+  ASSERT_TRUE(index.activeExtent(2, 2, extent));
+  EXPECT_TRUE(index.isWholeExtent(extent));
+  EXPECT_TRUE(index.coversMostOfImage(extent));
+
+  // The first label and the corners.
+  ASSERT_TRUE(index.activeExtent(1, 2, extent));
+  int expected[6] = { 0, 63, 0, 63, 0, 63 };
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(extent[i], expected[i]);
+  }
+
+  // The last brick of an image not starting at 0, shorter than the others.
+  vtkNew<vtkImageData> slab;
+  slab->SetExtent(10, 45, 5, 5, -3, 13);
+  slab->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  slab->GetPointData()->GetScalars()->FillComponent(0, 0);
+  *static_cast<unsigned char*>(slab->GetScalarPointer(45, 5, 13)) = 1;
+  BrickRangeIndex slabIndex(slab, slab->GetPointData()->GetScalars());
+  EXPECT_EQ(slabIndex.brickDimensions()[0], 3);
+  ASSERT_TRUE(slabIndex.activeExtent(1, 1, extent));
+  int last[6] = { 42, 45, 5, 5, -3, 13 };
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(extent[i], last[i]);
+  }
+  EXPECT_FALSE(slabIndex.coversMostOfImage(extent));
+}
+
+TEST_F(BrickRangeIndexTest, current)
+{
+  auto scalars = image->GetPointData()->GetScalars();
+  BrickRangeIndex index(image, scalars);
+  EXPECT_TRUE(index.isCurrent(scalars));
+
+  vtkNew<vtkUnsignedCharArray> other;
+  other->DeepCopy(scalars);
+  EXPECT_FALSE(index.isCurrent(other));
+
+  scalars->Modified();
+  EXPECT_FALSE(index.isCurrent(scalars));
+}
+
+TEST_F(BrickRangeIndexTest, multi_component)
+{
+  vtkNew<vtkUnsignedCharArray> rgb;
+  rgb->SetNumberOfComponents(3);
+  rgb->SetNumberOfTuples(image->GetNumberOfPoints());
+  BrickRangeIndex index(image, rgb);
+  EXPECT_FALSE(index.isValid());
+}
@@ -0,0 +1,115 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <gtest/gtest.h>
+
+#include <vtkFloatArray.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+
+#include "DirectFourierReconstruction.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace tomviz;
+
+namespace {
+
+const double Radius = 8.0;
+const double CenterY = 3.0;
+const double CenterZ = -2.0;
+
+// The projections of a disk of value 1, identical for every x slice.
+void projectDisk(const std::vector<double>& angles, const int dims[3],
+                 vtkFloatArray* tiltSeries)
+{
+  const int n = dims[1];
+  tiltSeries->SetNumberOfTuples(dims[0] * dims[1] * dims[2]);
+  for (int t = 0; t < dims[2]; ++t) {
+    const double angle = vtkMath::RadiansFromDegrees(angles[t]);
+    const double center =
+      CenterY * std::cos(angle) + CenterZ * std::sin(angle);
+    for (int r = 0; r < n; ++r) {
+      // Average the chord over the width of the ray.
+      double sum = 0.0;
+      for (int i = 0; i < 16; ++i) {
+        const double d = r - n / 2 + (i + 0.5) / 16 - 0.5 - center;
+        if (std::abs(d) < Radius) {
+          sum += 2.0 * std::sqrt(Radius * Radius - d * d);
+        }
+      }
+      for (int x = 0; x < dims[0]; ++x) {
+        tiltSeries->SetValue((t * n + r) * dims[0] + x, sum / 16);
+      }
+    }
+  }
+}
+} // namespace
+
+TEST(DirectFourierReconstructionTest, disk)
+{
+  int dims[3] = { 3, 32, 90 };
+  std::vector<double> angles(dims[2]);
+  for (int t = 0; t < dims[2]; ++t) {
+    angles[t] = -90.0 + 2.0 * t;
+  }
+  vtkNew<vtkFloatArray> tiltSeries;
+  projectDisk(angles, dims, tiltSeries);
+
+  DirectFourierReconstruction reconstruction(dims[1], angles);
+  EXPECT_EQ(reconstruction.slabSize(dims[0]), dims[0]);
+
+  // Reconstruct in two slabs.
+  const int n = dims[1];
+  std::vector<float> volume(dims[0] * n * n);
+  std::vector<float> slice;
+  ASSERT_TRUE(
+    reconstruction.reconstruct(tiltSeries, dims, 0, 2, volume.data()));
+  ASSERT_TRUE(
+    reconstruction.reconstruct(tiltSeries, dims, 2, 1, volume.data(), &slice));
+  ASSERT_EQ(slice.size(), static_cast<size_t>(n * n));
+
+  // Pixels along the edge of the disk are partially covered.
+  double error = 0.0;
+  int count = 0;
+  for (int y = 0; y < n; ++y) {
+    for (int z = 0; z < n; ++z) {
+      const double distance =
+        std::hypot(y + 0.5 - n / 2 - CenterY, z + 0.5 - n / 2 - CenterZ);
+      const float value = slice[y * n + z];
+      if (std::abs(distance - Radius) > 1.5) {
+        const double expected = distance < Radius ? 1.0 : 0.0;
+        EXPECT_NEAR(value, expected, 0.15);
+        error += std::abs(value - expected);
+        ++count;
+      }
+      for (int x = 0; x < dims[0]; ++x) {
+        EXPECT_FLOAT_EQ(volume[(z * n + y) * dims[0] + x], value);
+      }
+    }
+  }
+  EXPECT_LT(error / count, 0.03);
+}
+
+TEST(DirectFourierReconstructionTest, invalidInput)
+{
+  int dims[3] = { 1, 8, 4 };
+  std::vector<double> angles = { -45.0, 0.0, 45.0, 90.0 };
+  vtkNew<vtkFloatArray> tiltSeries;
+  tiltSeries->SetNumberOfTuples(dims[0] * dims[1] * dims[2]);
+  tiltSeries->FillComponent(0, 1.0);
+
+  std::vector<float> volume(dims[1] * dims[1]);
+  DirectFourierReconstruction fewerRays(6, angles);
+  EXPECT_FALSE(fewerRays.reconstruct(tiltSeries, dims, 0, 1, volume.data()));
+
+  vtkNew<vtkFloatArray> components;
+  components->SetNumberOfComponents(2);
+  components->SetNumberOfTuples(dims[0] * dims[1] * dims[2]);
+  DirectFourierReconstruction reconstruction(dims[1], angles);
+  EXPECT_FALSE(
+    reconstruction.reconstruct(components, dims, 0, 1, volume.data()));
+  EXPECT_TRUE(
+    reconstruction.reconstruct(tiltSeries, dims, 0, 1, volume.data()));
+}
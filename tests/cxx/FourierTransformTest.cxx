@@ -0,0 +1,194 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <gtest/gtest.h>
+
+#include <vtkFloatArray.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkShortArray.h>
+
+#include "FourierTransform.h"
+
+#include "TestVolumes.h"
+
+#include <cmath>
+#include <complex>
+#include <vector>
+
+using namespace tomviz;
+using tomviz::test::makeVolume;
+
+namespace {
+
+// The frequency (u, v, w) of the transform, computed directly.
+std::complex<double> dft(const std::vector<float>& values, const int dims[3],
+                         int u, int v, int w)
+{
+  std::complex<double> sum = 0.0;
+  for (int k = 0; k < dims[2]; ++k) {
+    for (int j = 0; j < dims[1]; ++j) {
+      for (int i = 0; i < dims[0]; ++i) {
+        double phase = -2.0 * vtkMath::Pi() *
+                       (static_cast<double>(u) * i / dims[0] +
+                        static_cast<double>(v) * j / dims[1] +
+                        static_cast<double>(w) * k / dims[2]);
+        sum += static_cast<double>(
+                 values[(k * dims[1] + j) * dims[0] + i]) *
+               std::polar(1.0, phase);
+      }
+    }
+  }
+  return sum;
+}
+
+void checkForward(const int dims[3])
+{
+  auto values = makeVolume(dims);
+  std::vector<FourierTransform::Complex> spectrum(
+    FourierTransform::spectrumSize(dims));
+  FourierTransform::forward(values.data(), dims, spectrum.data());
+
+  int spectrumDims[3];
+  FourierTransform::spectrumDimensions(dims, spectrumDims);
+  for (int w = 0; w < spectrumDims[2]; ++w) {
+    for (int v = 0; v < spectrumDims[1]; ++v) {
+      for (int u = 0; u < spectrumDims[0]; ++u) {
+        auto expected = dft(values, dims, u, v, w);
+        auto value =
+          spectrum[(w * spectrumDims[1] + v) * spectrumDims[0] + u];
+        EXPECT_NEAR(value.real(), expected.real(), 1e-3);
+        EXPECT_NEAR(value.imag(), expected.imag(), 1e-3);
+      }
+    }
+  }
+}
+} // namespace
+
+TEST(FourierTransformTest, forward)
+{
+  // Even and odd lengths along the first axis take different paths.
+  int even[3] = { 8, 5, 3 };
+  checkForward(even);
+  int odd[3] = { 7, 4, 1 };
+  checkForward(odd);
+  int line[3] = { 3, 1, 1 };
+  checkForward(line);
+}
+
+TEST(FourierTransformTest, roundTrip)
+{
+  int dims[3] = { 10, 9, 4 };
+  auto values = makeVolume(dims);
+  std::vector<FourierTransform::Complex> spectrum(
+    FourierTransform::spectrumSize(dims));
+  FourierTransform::forward(values.data(), dims, spectrum.data());
+
+  std::vector<float> result(values.size());
+  FourierTransform::inverse(spectrum.data(), dims, result.data());
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_NEAR(result[i], values[i], 1e-4);
+  }
+
+  // Plans are cached, transforming again must give the same result.
+  FourierTransform::forward(values.data(), dims, spectrum.data());
+  FourierTransform::clearPlans();
+  FourierTransform::inverse(spectrum.data(), dims, result.data());
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_NEAR(result[i], values[i], 1e-4);
+  }
+}
+
+TEST(FourierTransformTest, absLog)
+{
+  // A constant volume only has a zero frequency, shifted to the center.
+  int dims[3] = { 6, 5, 4 };
+  vtkNew<vtkFloatArray> array;
+  array->SetNumberOfTuples(dims[0] * dims[1] * dims[2]);
+  array->FillComponent(0, 2.0);
+
+  std::vector<FourierTransform::Complex> spectrum(
+    FourierTransform::spectrumSize(dims));
+  ASSERT_TRUE(FourierTransform::forward(array, dims, spectrum.data()));
+  std::vector<float> result(array->GetNumberOfTuples());
+  FourierTransform::absLog(spectrum.data(), dims, result.data());
+
+  int center = (2 * dims[1] + 2) * dims[0] + 3;
+  EXPECT_FLOAT_EQ(result[center], 1.0f);
+  EXPECT_LT(result[0], 0.0f);
+}
+
+TEST(FourierTransformTest, bandPass)
+{
+  int dims[3] = { 8, 8, 8 };
+  auto values = makeVolume(dims);
+  std::vector<FourierTransform::Complex> spectrum(
+    FourierTransform::spectrumSize(dims));
+  FourierTransform::forward(values.data(), dims, spectrum.data());
+
+  // Removing the zero frequency only removes the mean.
+  FourierTransform::bandPass(spectrum.data(), dims, 0.01, 2.0);
+  std::vector<float> result(values.size());
+  FourierTransform::inverse(spectrum.data(), dims, result.data());
+
+  double mean = 0.0;
+  for (auto value : values) {
+    mean += value;
+  }
+  mean /= values.size();
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_NEAR(result[i], values[i] - mean, 1e-4);
+  }
+}
+
+TEST(FourierTransformTest, axisCallback)
+{
+  int dims[3] = { 6, 5, 4 };
+  vtkNew<vtkFloatArray> array;
+  array->SetNumberOfTuples(dims[0] * dims[1] * dims[2]);
+  array->FillComponent(0, 2.0);
+  std::vector<FourierTransform::Complex> spectrum(
+    FourierTransform::spectrumSize(dims));
+  std::vector<float> result(array->GetNumberOfTuples());
+
+  std::vector<int> axes;
+  auto record = [&axes](int axesDone) {
+    axes.push_back(axesDone);
+    return true;
+  };
+  ASSERT_TRUE(FourierTransform::forward(array, dims, spectrum.data(), record));
+  ASSERT_TRUE(FourierTransform::inverse(spectrum.data(), dims, result.data(),
+                                        record));
+  EXPECT_EQ(axes, std::vector<int>({ 1, 2, 3, 1, 2, 3 }));
+  EXPECT_NEAR(result[7], 2.0f, 1e-5);
+
+  // Returning false stops the transform.
+  axes.clear();
+  auto stop = [&axes](int axesDone) {
+    axes.push_back(axesDone);
+    return axesDone < 2;
+  };
+  EXPECT_FALSE(FourierTransform::forward(array, dims, spectrum.data(), stop));
+  EXPECT_FALSE(
+    FourierTransform::inverse(spectrum.data(), dims, result.data(), stop));
+  EXPECT_EQ(axes, std::vector<int>({ 1, 2, 1, 2 }));
+}
+
+TEST(FourierTransformTest, hannWindow)
+{
+  int dims[3] = { 5, 3, 1 };
+  vtkNew<vtkShortArray> array;
+  array->SetNumberOfTuples(dims[0] * dims[1]);
+  array->FillComponent(0, 100.0);
+  ASSERT_TRUE(FourierTransform::hannWindow(array, dims));
+
+  // numpy.hanning(5) is [0, 0.5, 1, 0.5, 0] and numpy.hanning(3) [0, 1, 0].
+  EXPECT_EQ(array->GetValue(5 + 2), 100);
+  EXPECT_EQ(array->GetValue(5 + 1), 50);
+  EXPECT_EQ(array->GetValue(2), 0);
+
+  vtkNew<vtkFloatArray> components;
+  components->SetNumberOfComponents(3);
+  components->SetNumberOfTuples(dims[0] * dims[1]);
+  EXPECT_FALSE(FourierTransform::hannWindow(components, dims));
+}
@@ -0,0 +1,144 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <gtest/gtest.h>
+
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+#include "ImagePyramid.h"
+
+using namespace tomviz;
+
+class ImagePyramidTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // Odd dimensions so the last block along each axis is partial.
+    image->SetDimensions(9, 8, 5);
+    image->SetSpacing(1.0, 1.0, 2.0);
+    image->AllocateScalars(VTK_FLOAT, 1);
+    auto scalars = image->GetPointData()->GetScalars();
+    scalars->SetName("density");
+    for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i) {
+      scalars->SetTuple1(i, static_cast<double>(i % 9));
+    }
+
+    vtkNew<vtkFloatArray> labels;
+    labels->SetName("labels");
+    labels->SetNumberOfTuples(image->GetNumberOfPoints());
+    labels->FillComponent(0, 3.0);
+    image->GetPointData()->AddArray(labels);
+  }
+
+  vtkNew<vtkImageData> image;
+};
+
+TEST_F(ImagePyramidTest, levels)
+{
+  ImagePyramid pyramid(image);
+  // 9 -> 5 -> 3 -> 2 -> 1 along the longest axis.
+  EXPECT_EQ(pyramid.numberOfLevels(), 5);
+
+  int dims[3];
+  pyramid.levelDimensions(1, dims);
+  EXPECT_EQ(dims[0], 5);
+  EXPECT_EQ(dims[1], 4);
+  EXPECT_EQ(dims[2], 3);
+
+  // Two float arrays, eight bytes per point.
+  EXPECT_EQ(pyramid.levelSize(0), 9 * 8 * 5 * 8);
+  EXPECT_EQ(pyramid.levelSize(1), 5 * 4 * 3 * 8);
+  EXPECT_EQ(pyramid.levelForBudget(pyramid.levelSize(0)), 0);
+  EXPECT_EQ(pyramid.levelForBudget(pyramid.levelSize(0) - 1), 1);
+  EXPECT_EQ(pyramid.levelForBudget(0), -1);
+}
+
+TEST_F(ImagePyramidTest, downsample)
+{
+  ImagePyramid pyramid(image);
+  auto level = pyramid.level(1);
+  ASSERT_NE(level.GetPointer(), nullptr);
+
+  // Every array is kept, in order, with the same active scalars.
+  auto pointData = level->GetPointData();
+  ASSERT_EQ(pointData->GetNumberOfArrays(), 2);
+  EXPECT_STREQ(pointData->GetArrayName(0), "density");
+  EXPECT_STREQ(pointData->GetArrayName(1), "labels");
+  EXPECT_STREQ(pointData->GetScalars()->GetName(), "density");
+
+  // Blocks average two points along x, the last one is a single point.
+  auto density = pointData->GetArray(0);
+  EXPECT_DOUBLE_EQ(density->GetTuple1(0), 0.5);
+  EXPECT_DOUBLE_EQ(density->GetTuple1(3), 6.5);
+  EXPECT_DOUBLE_EQ(density->GetTuple1(4), 8.0);
+  EXPECT_DOUBLE_EQ(pointData->GetArray(1)->GetTuple1(7), 3.0);
+
+  // Points sit at the center of their block.
+  double* spacing = level->GetSpacing();
+  double* origin = level->GetOrigin();
+  EXPECT_DOUBLE_EQ(spacing[2], 4.0);
+  EXPECT_DOUBLE_EQ(origin[0], 0.5);
+  EXPECT_DOUBLE_EQ(origin[2], 1.0);
+
+  // Cached levels are shared.
+  EXPECT_EQ(pyramid.level(1).GetPointer(), level.GetPointer());
+}
+
+TEST_F(ImagePyramidTest, memory_budget)
+{
+  ImagePyramid pyramid(image);
+  pyramid.setMemoryBudget(pyramid.levelSize(2));
+
+  // Too large for the budget, returned but not cached.
+  auto level = pyramid.level(1);
+  ASSERT_NE(level.GetPointer(), nullptr);
+  EXPECT_EQ(pyramid.cachedSize(), 0);
+
+  pyramid.level(2);
+  EXPECT_EQ(pyramid.cachedSize(), pyramid.levelSize(2));
+
+  // Caching a smaller level drops the larger one to stay in budget.
+  pyramid.level(3);
+  EXPECT_EQ(pyramid.cachedSize(), pyramid.levelSize(3));
+}
+
+TEST_F(ImagePyramidTest, coarser_levels)
+{
+  ImagePyramid pyramid(image);
+
+  // Each level halves the previous one, 9 -> 5 -> 3 points along x.
+  auto level = pyramid.level(2);
+  ASSERT_NE(level.GetPointer(), nullptr);
+  int dims[3];
+  level->GetDimensions(dims);
+  EXPECT_EQ(dims[0], 3);
+  auto density = level->GetPointData()->GetArray(0);
+  EXPECT_DOUBLE_EQ(density->GetTuple1(0), 1.5);
+  EXPECT_DOUBLE_EQ(density->GetTuple1(1), 5.5);
+  EXPECT_DOUBLE_EQ(density->GetTuple1(2), 8.0);
+  EXPECT_DOUBLE_EQ(level->GetOrigin()[0], 1.5);
+  EXPECT_DOUBLE_EQ(level->GetSpacing()[0], 4.0);
+}
+
+TEST_F(ImagePyramidTest, snapshot)
+{
+  ImagePyramid pyramid(image);
+
+  // Arrays added to the image are not part of the pyramid.
+  vtkNew<vtkFloatArray> extra;
+  extra->SetName("extra");
+  extra->SetNumberOfTuples(image->GetNumberOfPoints());
+  image->GetPointData()->AddArray(extra);
+  auto level = pyramid.level(1);
+  ASSERT_NE(level.GetPointer(), nullptr);
+  EXPECT_EQ(level->GetPointData()->GetNumberOfArrays(), 2);
+
+  // Modified values make the levels stale.
+  image->GetPointData()->GetArray("density")->Modified();
+  EXPECT_EQ(pyramid.level(1).GetPointer(), nullptr);
+  EXPECT_EQ(pyramid.level(2).GetPointer(), nullptr);
+}
@@ -0,0 +1,158 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <gtest/gtest.h>
+
+#include "LabelStatistics.h"
+
+#include <vtkFloatArray.h>
+#include <vtkNew.h>
+#include <vtkShortArray.h>
+
+#include <cmath>
+
+using namespace tomviz;
+
+namespace {
+
+const int dims[3] = { 12, 10, 8 };
+const double origin[3] = { 1.0, -2.0, 0.5 };
+const double spacing[3] = { 0.5, 1.0, 2.0 };
+
+short labelAt(int x, int y, int z)
+{
+  // A box, a diagonal line, and a background with scattered labels.
+  if (x >= 2 && x < 6 && y >= 1 && y < 4 && z >= 3 && z < 5) {
+    return 1;
+  }
+  if (x == y && z == 6) {
+    return 2;
+  }
+  return (x * 7 + y * 3 + z * 5) % 11 == 0 ? 3 + (x + y + z) % 4 : 0;
+}
+
+void fill(vtkShortArray* labels)
+{
+  labels->SetNumberOfTuples(dims[0] * dims[1] * dims[2]);
+  vtkIdType i = 0;
+  for (int z = 0; z < dims[2]; ++z) {
+    for (int y = 0; y < dims[1]; ++y) {
+      for (int x = 0; x < dims[0]; ++x) {
+        labels->SetValue(i++, labelAt(x, y, z));
+      }
+    }
+  }
+}
+} // namespace
+
+TEST(LabelStatisticsTest, objects)
+{
+  vtkNew<vtkShortArray> labels;
+  fill(labels);
+  LabelStatistics statistics(dims);
+  ASSERT_TRUE(statistics.accumulate(labels, 0, dims[2]));
+  auto objects = statistics.objects(origin, spacing);
+  ASSERT_EQ(objects.size(), 6u);
+
+  for (auto& object : objects) {
+    // Compare with the moments computed directly.
+    double n = 0.0;
+    double mean[3] = { 0.0, 0.0, 0.0 };
+    for (int z = 0; z < dims[2]; ++z) {
+      for (int y = 0; y < dims[1]; ++y) {
+        for (int x = 0; x < dims[0]; ++x) {
+          if (labelAt(x, y, z) == object.label) {
+            n += 1.0;
+            mean[0] += origin[0] + spacing[0] * x;
+            mean[1] += origin[1] + spacing[1] * y;
+            mean[2] += origin[2] + spacing[2] * z;
+          }
+        }
+      }
+    }
+    EXPECT_EQ(object.voxels, static_cast<vtkIdType>(n));
+    for (int i = 0; i < 3; ++i) {
+      mean[i] /= n;
+      EXPECT_NEAR(object.centroid[i], mean[i], 1e-9);
+    }
+
+    double covariance[3][3] = {};
+    for (int z = 0; z < dims[2]; ++z) {
+      for (int y = 0; y < dims[1]; ++y) {
+        for (int x = 0; x < dims[0]; ++x) {
+          if (labelAt(x, y, z) == object.label) {
+            double d[3] = { origin[0] + spacing[0] * x - mean[0],
+                            origin[1] + spacing[1] * y - mean[1],
+                            origin[2] + spacing[2] * z - mean[2] };
+            for (int i = 0; i < 3; ++i) {
+              for (int j = 0; j < 3; ++j) {
+                covariance[i][j] += d[i] * d[j] / (n - 1.0);
+              }
+            }
+          }
+        }
+      }
+    }
+
+    // The axes are orthonormal eigenvectors of the covariance.
+    for (int k = 0; k < 3; ++k) {
+      const double* axis = object.axes[k];
+      EXPECT_NEAR(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2],
+                  1.0, 1e-9);
+      for (int i = 0; i < 3; ++i) {
+        double product = 0.0;
+        for (int j = 0; j < 3; ++j) {
+          product += covariance[i][j] * axis[j];
+        }
+        EXPECT_NEAR(product, object.moments[k] * axis[i], 1e-6);
+      }
+    }
+    EXPECT_GE(object.moments[0], object.moments[1]);
+    EXPECT_GE(object.moments[1], object.moments[2]);
+  }
+
+  // The box.
+  EXPECT_EQ(objects[0].label, 1);
+  EXPECT_EQ(objects[0].voxels, 24);
+  const double bounds[6] = { 2.0, 3.5, -1.0, 1.0, 6.5, 8.5 };
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_DOUBLE_EQ(objects[0].bounds[i], bounds[i]);
+  }
+
+  // The line, along (1, 2, 0) once scaled by the spacing.
+  EXPECT_EQ(objects[1].label, 2);
+  EXPECT_NEAR(std::abs(objects[1].axes[0][0]), 1.0 / std::sqrt(5.0), 1e-9);
+  EXPECT_NEAR(std::abs(objects[1].axes[0][1]), 2.0 / std::sqrt(5.0), 1e-9);
+  EXPECT_NEAR(objects[1].moments[1], 0.0, 1e-9);
+}
+
+TEST(LabelStatisticsTest, slabs)
+{
+  vtkNew<vtkShortArray> labels;
+  fill(labels);
+  LabelStatistics whole(dims);
+  ASSERT_TRUE(whole.accumulate(labels, 0, dims[2]));
+  LabelStatistics slabs(dims);
+  ASSERT_TRUE(slabs.accumulate(labels, 0, 3));
+  ASSERT_TRUE(slabs.accumulate(labels, 3, dims[2] - 3));
+
+  auto expected = whole.objects(origin, spacing);
+  auto objects = slabs.objects(origin, spacing);
+  ASSERT_EQ(objects.size(), expected.size());
+  for (size_t i = 0; i < objects.size(); ++i) {
+    EXPECT_EQ(objects[i].label, expected[i].label);
+    EXPECT_EQ(objects[i].voxels, expected[i].voxels);
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_EQ(objects[i].centroid[j], expected[i].centroid[j]);
+      EXPECT_EQ(objects[i].moments[j], expected[i].moments[j]);
+    }
+  }
+}
+
+TEST(LabelStatisticsTest, floatingPoint)
+{
+  vtkNew<vtkFloatArray> labels;
+  labels->SetNumberOfTuples(dims[0] * dims[1] * dims[2]);
+  LabelStatistics statistics(dims);
+  EXPECT_FALSE(statistics.accumulate(labels, 0, dims[2]));
+}
@@ -0,0 +1,120 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <gtest/gtest.h>
+
+#include "LocalThickness.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace tomviz;
+
+namespace {
+
+const int dims[3] = { 15, 12, 10 };
+const int size = dims[0] * dims[1] * dims[2];
+
+bool isPore(int x, int y, int z)
+{
+  // Wavy channels, and a sparse scattering of single voxels.
+  const double value =
+    std::sin(x * 0.35) + std::cos(y * 0.3) + std::sin(z * 0.4 + x * 0.1);
+  return value > -0.3 || (x * 7 + y * 3 + z * 5) % 13 == 0;
+}
+
+int index(int x, int y, int z)
+{
+  return (z * dims[1] + y) * dims[0] + x;
+}
+
+std::vector<float> squaredDistances()
+{
+  std::vector<float> values(size);
+  for (int z = 0; z < dims[2]; ++z) {
+    for (int y = 0; y < dims[1]; ++y) {
+      for (int x = 0; x < dims[0]; ++x) {
+        values[index(x, y, z)] =
+          isPore(x, y, z) ? std::numeric_limits<float>::infinity() : 0.0f;
+      }
+    }
+  }
+  for (int axis = 0; axis < 3; ++axis) {
+    LocalThickness::distanceTransform(values.data(), dims, axis);
+  }
+  return values;
+}
+
+int squaredDistance(int x0, int y0, int z0, int x1, int y1, int z1)
+{
+  return (x0 - x1) * (x0 - x1) + (y0 - y1) * (y0 - y1) + (z0 - z1) * (z0 - z1);
+}
+} // namespace
+
+TEST(LocalThicknessTest, distanceTransform)
+{
+  auto values = squaredDistances();
+  for (int z = 0; z < dims[2]; ++z) {
+    for (int y = 0; y < dims[1]; ++y) {
+      for (int x = 0; x < dims[0]; ++x) {
+        // The nearest matter, including the matter around the volume.
+        int expected = isPore(x, y, z) ? std::numeric_limits<int>::max() : 0;
+        for (int k = -1; k <= dims[2] && expected > 0; ++k) {
+          for (int j = -1; j <= dims[1]; ++j) {
+            for (int i = -1; i <= dims[0]; ++i) {
+              const bool inside = i >= 0 && j >= 0 && k >= 0 &&
+                                  i < dims[0] && j < dims[1] && k < dims[2];
+              if (!inside || !isPore(i, j, k)) {
+                expected =
+                  std::min(expected, squaredDistance(x, y, z, i, j, k));
+              }
+            }
+          }
+        }
+        EXPECT_EQ(values[index(x, y, z)], static_cast<float>(expected));
+      }
+    }
+  }
+}
+
+TEST(LocalThicknessTest, thickness)
+{
+  auto values = squaredDistances();
+  LocalThickness localThickness(values.data(), dims);
+  std::vector<float> thickness(size);
+  // The slices are computed in two blocks.
+  localThickness.thickness(0, 4, thickness.data());
+  localThickness.thickness(4, dims[2] - 4,
+                           thickness.data() + 4 * dims[0] * dims[1]);
+
+  std::vector<int> radii(size);
+  int maximumRadius = 0;
+  for (int i = 0; i < size; ++i) {
+    radii[i] = static_cast<int>(std::floor(std::sqrt(values[i])));
+    maximumRadius = std::max(maximumRadius, radii[i]);
+  }
+  EXPECT_EQ(localThickness.maximumRadius(), maximumRadius);
+  EXPECT_GT(maximumRadius, 1);
+
+  // The largest ball, among the balls of every voxel, that contains each
+  // pore voxel.
+  for (int z = 0; z < dims[2]; ++z) {
+    for (int y = 0; y < dims[1]; ++y) {
+      for (int x = 0; x < dims[0]; ++x) {
+        int expected = 0;
+        for (int k = 0; k < dims[2] && isPore(x, y, z); ++k) {
+          for (int j = 0; j < dims[1]; ++j) {
+            for (int i = 0; i < dims[0]; ++i) {
+              const int r = radii[index(i, j, k)];
+              if (r > expected && squaredDistance(x, y, z, i, j, k) <= r * r) {
+                expected = r;
+              }
+            }
+          }
+        }
+        EXPECT_EQ(thickness[index(x, y, z)], static_cast<float>(expected));
+      }
+    }
+  }
+}
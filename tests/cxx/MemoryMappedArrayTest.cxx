@@ -0,0 +1,172 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <gtest/gtest.h>
+
+#include <vtkDataArray.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+#include "EmdFormat.h"
+#include "MemoryMappedArray.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTemporaryFile>
+
+using namespace tomviz;
+
+class MemoryMappedArrayTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // A 16 byte header followed by 1000 floats.
+    ASSERT_TRUE(file.open());
+    QByteArray header(HeaderSize, 'h');
+    file.write(header);
+    for (int i = 0; i < NumValues; ++i) {
+      float value = static_cast<float>(i);
+      file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    file.flush();
+  }
+
+  static const int HeaderSize = 16;
+  static const int NumValues = 1000;
+  QTemporaryFile file;
+};
+
+TEST_F(MemoryMappedArrayTest, values)
+{
+  auto array = MemoryMappedArray::map(file.fileName(), HeaderSize, VTK_FLOAT,
+                                      NumValues / 2, 2);
+  ASSERT_NE(array.GetPointer(), nullptr);
+  EXPECT_TRUE(MemoryMappedArray::isMapped(array));
+  ASSERT_NE(vtkFloatArray::SafeDownCast(array), nullptr);
+  EXPECT_EQ(array->GetNumberOfTuples(), NumValues / 2);
+  EXPECT_EQ(array->GetNumberOfComponents(), 2);
+  EXPECT_EQ(array->GetComponent(0, 0), 0.0);
+  EXPECT_EQ(array->GetComponent(10, 1), 21.0);
+  EXPECT_EQ(array->GetComponent(NumValues / 2 - 1, 1), NumValues - 1.0);
+
+  vtkNew<vtkFloatArray> copy;
+  EXPECT_FALSE(MemoryMappedArray::isMapped(copy));
+  copy->DeepCopy(array);
+  EXPECT_FALSE(MemoryMappedArray::isMapped(copy));
+}
+
+TEST_F(MemoryMappedArrayTest, copyOnWrite)
+{
+  auto array =
+    MemoryMappedArray::map(file.fileName(), HeaderSize, VTK_FLOAT, NumValues);
+  ASSERT_NE(array.GetPointer(), nullptr);
+  array->SetComponent(0, 0, 42.0);
+  EXPECT_EQ(array->GetComponent(0, 0), 42.0);
+  array = nullptr;
+
+  // The file is unchanged.
+  QFile reader(file.fileName());
+  ASSERT_TRUE(reader.open(QIODevice::ReadOnly));
+  reader.seek(HeaderSize);
+  float value = -1.0f;
+  reader.read(reinterpret_cast<char*>(&value), sizeof(value));
+  EXPECT_EQ(value, 0.0f);
+}
+
+TEST_F(MemoryMappedArrayTest, invalidRegion)
+{
+  // Past the end of the file.
+  auto array = MemoryMappedArray::map(file.fileName(), HeaderSize + 4,
+                                      VTK_FLOAT, NumValues);
+  EXPECT_EQ(array.GetPointer(), nullptr);
+
+  array = MemoryMappedArray::map("/no/such/file", 0, VTK_FLOAT, 1);
+  EXPECT_EQ(array.GetPointer(), nullptr);
+}
+
+TEST_F(MemoryMappedArrayTest, writeOverMapped)
+{
+  auto array =
+    MemoryMappedArray::map(file.fileName(), HeaderSize, VTK_FLOAT, NumValues);
+  ASSERT_NE(array.GetPointer(), nullptr);
+
+  // A shorter file, truncating the mapped one would make reading the array
+  // fault.
+  bool success = MemoryMappedArray::writeReplacing(
+    file.fileName(), [this](const QString& name) {
+      EXPECT_NE(name, file.fileName());
+      EXPECT_TRUE(name.endsWith(QFileInfo(file.fileName()).suffix()));
+      QFile part(name);
+      return part.open(QIODevice::WriteOnly) && part.write("new") == 3;
+    });
+  EXPECT_TRUE(success);
+  EXPECT_EQ(array->GetComponent(NumValues - 1, 0), NumValues - 1.0);
+
+  QFile reader(file.fileName());
+  ASSERT_TRUE(reader.open(QIODevice::ReadOnly));
+  EXPECT_EQ(reader.readAll(), QByteArray("new"));
+
+  // A failed write leaves the file as it was.
+  success = MemoryMappedArray::writeReplacing(
+    file.fileName(), [](const QString&) { return false; });
+  EXPECT_FALSE(success);
+  EXPECT_EQ(QFile(file.fileName()).size(), 3);
+  EXPECT_FALSE(
+    QFile::exists(MemoryMappedArray::partFileName(file.fileName())));
+}
+
+TEST_F(MemoryMappedArrayTest, failedReplace)
+{
+  // A directory can't be replaced by a file, the written data is kept.
+  QTemporaryDir dir;
+  ASSERT_TRUE(dir.isValid());
+  auto fileName = dir.filePath("volume.emd");
+  ASSERT_TRUE(QDir(dir.path()).mkdir("volume.emd"));
+  bool success =
+    MemoryMappedArray::writeReplacing(fileName, [](const QString& name) {
+      QFile part(name);
+      return part.open(QIODevice::WriteOnly) && part.write("new") == 3;
+    });
+  EXPECT_FALSE(success);
+  EXPECT_TRUE(QFileInfo(fileName).isDir());
+  QFile part(MemoryMappedArray::partFileName(fileName));
+  EXPECT_EQ(part.fileName(), dir.filePath("volume.part.emd"));
+  ASSERT_TRUE(part.open(QIODevice::ReadOnly));
+  EXPECT_EQ(part.readAll(), QByteArray("new"));
+}
+
+TEST_F(MemoryMappedArrayTest, saveEmdOverMapped)
+{
+  QTemporaryDir dir;
+  ASSERT_TRUE(dir.isValid());
+  auto fileName = dir.filePath("data.emd").toStdString();
+
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(10, 10, 10);
+  vtkNew<vtkFloatArray> values;
+  values->SetName("ImageScalars");
+  values->SetNumberOfTuples(NumValues);
+  for (int i = 0; i < NumValues; ++i) {
+    values->SetValue(i, static_cast<float>(i));
+  }
+  image->GetPointData()->SetScalars(values);
+  ASSERT_TRUE(EmdFormat::write(fileName, image));
+
+  // The data read back may be a mapping of the file, save it over the file.
+  vtkNew<vtkImageData> loaded;
+  ASSERT_TRUE(EmdFormat::read(fileName, loaded));
+  ASSERT_TRUE(EmdFormat::write(fileName, loaded));
+  auto scalars = loaded->GetPointData()->GetScalars();
+  ASSERT_NE(scalars, nullptr);
+  EXPECT_EQ(scalars->GetComponent(NumValues - 1, 0), NumValues - 1.0);
+
+  vtkNew<vtkImageData> saved;
+  ASSERT_TRUE(EmdFormat::read(fileName, saved));
+  EXPECT_EQ(saved->GetPointData()->GetScalars()->GetComponent(11, 0), 11.0);
+  EXPECT_FALSE(QFile::exists(dir.filePath("data.part.emd")));
+}
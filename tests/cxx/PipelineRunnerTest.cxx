@@ -0,0 +1,137 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+#include "EmdFormat.h"
+
+using namespace tomviz;
+
+// Runs the tomviz-pipeline executable on small EMD files, with a C++
+// operator.
+class PipelineRunnerTest : public QObject
+{
+  Q_OBJECT
+
+private:
+  QTemporaryDir m_dir;
+
+  int run(const QStringList& arguments)
+  {
+    QProcess process;
+    auto environment = QProcessEnvironment::systemEnvironment();
+    environment.insert("QT_QPA_PLATFORM", "offscreen");
+    process.setProcessEnvironment(environment);
+    process.setWorkingDirectory(m_dir.path());
+    process.setProcessChannelMode(QProcess::ForwardedChannels);
+    process.start(TOMVIZ_PIPELINE_EXECUTABLE, arguments);
+    if (!process.waitForFinished(60000) ||
+        process.exitStatus() != QProcess::NormalExit) {
+      return -1;
+    }
+    return process.exitCode();
+  }
+
+  QString path(const QString& name) { return m_dir.filePath(name); }
+
+  void writeVolume(const QString& fileName)
+  {
+    vtkNew<vtkImageData> image;
+    image->SetDimensions(6, 5, 4);
+    image->AllocateScalars(VTK_SHORT, 1);
+    auto scalars = image->GetPointData()->GetScalars();
+    for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); ++i) {
+      scalars->SetTuple1(i, i - 50);
+    }
+    QVERIFY(EmdFormat::write(fileName.toStdString(), image));
+  }
+
+  void checkOutput(const QString& fileName)
+  {
+    vtkNew<vtkImageData> image;
+    QVERIFY(EmdFormat::read(fileName.toStdString(), image));
+    int dims[3];
+    image->GetDimensions(dims);
+    QCOMPARE(dims[0], 6);
+    QCOMPARE(dims[1], 5);
+    QCOMPARE(dims[2], 4);
+    auto scalars = image->GetPointData()->GetScalars();
+    QCOMPARE(scalars->GetDataType(), VTK_FLOAT);
+    for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); ++i) {
+      QCOMPARE(scalars->GetTuple1(i), static_cast<double>(i - 50));
+    }
+  }
+
+private slots:
+  void initTestCase()
+  {
+    QVERIFY(m_dir.isValid());
+    QVERIFY(QDir(m_dir.path()).mkpath("volumes"));
+    QVERIFY(QDir(m_dir.path()).mkpath("empty"));
+    writeVolume(path("volume.emd"));
+    writeVolume(path("volumes/first.emd"));
+    writeVolume(path("volumes/second.emd"));
+
+    QJsonObject op;
+    op["type"] = "ConvertToFloat";
+    QJsonObject reader;
+    reader["fileNames"] = QJsonArray({ "volume.emd" });
+    QJsonObject dataSource;
+    dataSource["operators"] = QJsonArray({ op });
+    dataSource["reader"] = reader;
+    QJsonObject state;
+    state["dataSources"] = QJsonArray({ dataSource });
+
+    QFile file(path("state.tvsm"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QJsonDocument(state).toJson());
+  }
+
+  void stateDataFile()
+  {
+    QCOMPARE(run({ "-s", path("state.tvsm") }), 0);
+    checkOutput(path("volume_transformed.emd"));
+  }
+
+  void outputFile()
+  {
+    QCOMPARE(run({ "-s", path("state.tvsm"), "-d", path("volume.emd"), "-o",
+                   path("converted.emd") }),
+             0);
+    checkOutput(path("converted.emd"));
+  }
+
+  void directory()
+  {
+    QCOMPARE(run({ "-s", path("state.tvsm"), "-d", path("volumes"), "-o",
+                   path("output/converted") }),
+             0);
+    checkOutput(path("output/converted/first_transformed.emd"));
+    checkOutput(path("output/converted/second_transformed.emd"));
+  }
+
+  void directoryErrors()
+  {
+    QVERIFY(run({ "-s", path("state.tvsm"), "-d", path("empty") }) != 0);
+    QVERIFY(run({ "-s", path("state.tvsm"), "-d", path("volumes"), "-o",
+                  path("converted.tvh5") }) != 0);
+    QVERIFY(run({ "-s", path("state.tvsm"), "-d", path("volumes"), "-o",
+                  path("volume.emd") }) != 0);
+    QVERIFY(!QFile::exists(path("converted.tvh5")));
+  }
+};
+
+QTEST_GUILESS_MAIN(PipelineRunnerTest)
+#include "PipelineRunnerTest.moc"
@@ -0,0 +1,256 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <gtest/gtest.h>
+
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+#include "RegionCopy.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace tomviz;
+using Boundary = RegionCopy::Boundary;
+
+namespace {
+
+const int dims[3] = { 9, 7, 11 };
+const int numComponents = 2;
+
+// Tuples of two distinct, non zero, shorts.
+std::vector<short> volume(const int size[3])
+{
+  std::vector<short> values(static_cast<size_t>(size[0]) * size[1] * size[2] *
+                            numComponents);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<short>(i + 1);
+  }
+  return values;
+}
+
+int inputIndex(int index, int size, Boundary boundary)
+{
+  if (index >= 0 && index < size) {
+    return index;
+  }
+  switch (boundary) {
+    case Boundary::Edge:
+      return index < 0 ? 0 : size - 1;
+    case Boundary::Wrap:
+      return (index % size + size) % size;
+    default:
+      return -1;
+  }
+}
+
+// output[o] = input[o - offset], tuple by tuple.
+std::vector<short> expected(const std::vector<short>& input,
+                            const int inputDims[3], const int outputDims[3],
+                            const int offset[3], Boundary boundary)
+{
+  std::vector<short> output(static_cast<size_t>(outputDims[0]) *
+                              outputDims[1] * outputDims[2] * numComponents,
+                            0);
+  size_t o = 0;
+  for (int z = 0; z < outputDims[2]; ++z) {
+    for (int y = 0; y < outputDims[1]; ++y) {
+      for (int x = 0; x < outputDims[0]; ++x, o += numComponents) {
+        int sx = inputIndex(x - offset[0], inputDims[0], boundary);
+        int sy = inputIndex(y - offset[1], inputDims[1], boundary);
+        int sz = inputIndex(z - offset[2], inputDims[2], boundary);
+        if (sx < 0 || sy < 0 || sz < 0) {
+          continue;
+        }
+        size_t i =
+          ((static_cast<size_t>(sz) * inputDims[1] + sy) * inputDims[0] + sx) *
+          numComponents;
+        for (int c = 0; c < numComponents; ++c) {
+          output[o + c] = input[i + c];
+        }
+      }
+    }
+  }
+  return output;
+}
+} // namespace
+
+TEST(RegionCopyTest, pad)
+{
+  const int before[3] = { 2, 0, 5 };
+  const int after[3] = { 3, 9, 1 };
+  const int paddedDims[3] = { dims[0] + 5, dims[1] + 9, dims[2] + 6 };
+  auto input = volume(dims);
+  for (auto boundary : { Boundary::Zero, Boundary::Edge, Boundary::Wrap }) {
+    std::vector<short> output(
+      static_cast<size_t>(paddedDims[0]) * paddedDims[1] * paddedDims[2] *
+        numComponents,
+      -1);
+    RegionCopy::pad(input.data(), dims, before, after, boundary,
+                    output.data(), sizeof(short) * numComponents);
+    EXPECT_EQ(output, expected(input, dims, paddedDims, before, boundary));
+  }
+}
+
+TEST(RegionCopyTest, roll)
+{
+  const int shifts[3][3] = { { 3, -2, 0 }, { -12, 7, 25 }, { 0, 0, -1 } };
+  auto input = volume(dims);
+  for (auto& shift : shifts) {
+    std::vector<short> output(input.size(), -1);
+    RegionCopy::roll(input.data(), dims, shift, output.data(),
+                     sizeof(short) * numComponents);
+    EXPECT_EQ(output, expected(input, dims, dims, shift, Boundary::Wrap));
+  }
+}
+
+TEST(RegionCopyTest, shift)
+{
+  const int shifts[5][3] = {
+    { 3, -2, 0 }, { -1, 4, 2 }, { 0, 0, -3 }, { 2, 1, -5 }, { 10, -7, 11 }
+  };
+  auto input = volume(dims);
+  for (auto& shift : shifts) {
+    auto values = input;
+    RegionCopy::shift(values.data(), dims, shift,
+                      sizeof(short) * numComponents);
+    EXPECT_EQ(values, expected(input, dims, dims, shift, Boundary::Zero));
+  }
+}
+
+TEST(RegionCopyTest, shiftSlices)
+{
+  auto input = volume(dims);
+  std::vector<int> shifts(2 * dims[2]);
+  for (int z = 0; z < dims[2]; ++z) {
+    shifts[2 * z] = z % 5 - 2;
+    shifts[2 * z + 1] = 3 - z % 4;
+  }
+  shifts[2] = 20;
+
+  auto values = input;
+  RegionCopy::shiftSlices(values.data(), dims, shifts.data(),
+                          sizeof(short) * numComponents);
+
+  const size_t sliceSize =
+    static_cast<size_t>(dims[0]) * dims[1] * numComponents;
+  const int sliceDims[3] = { dims[0], dims[1], 1 };
+  for (int z = 0; z < dims[2]; ++z) {
+    std::vector<short> slice(input.begin() + z * sliceSize,
+                             input.begin() + (z + 1) * sliceSize);
+    const int shift[3] = { shifts[2 * z], shifts[2 * z + 1], 0 };
+    std::vector<short> result(values.begin() + z * sliceSize,
+                              values.begin() + (z + 1) * sliceSize);
+    EXPECT_EQ(result,
+              expected(slice, sliceDims, sliceDims, shift, Boundary::Zero));
+  }
+}
+
+TEST(RegionCopyTest, crop)
+{
+  // The slices move one at a time or in parallel rounds, depending on how
+  // far they move.
+  const int extents[4][6] = { { 1, 7, 0, 6, 0, 10 },
+                              { 2, 5, 1, 3, 3, 9 },
+                              { 0, 8, 0, 6, 4, 10 },
+                              { 8, 8, 6, 6, 0, 0 } };
+  auto input = volume(dims);
+  for (auto& extent : extents) {
+    const int croppedDims[3] = { extent[1] - extent[0] + 1,
+                                 extent[3] - extent[2] + 1,
+                                 extent[5] - extent[4] + 1 };
+    const int offset[3] = { -extent[0], -extent[2], -extent[4] };
+    auto values = input;
+    RegionCopy::crop(values.data(), dims, extent,
+                     sizeof(short) * numComponents);
+    values.resize(static_cast<size_t>(croppedDims[0]) * croppedDims[1] *
+                  croppedDims[2] * numComponents);
+    EXPECT_EQ(values,
+              expected(input, dims, croppedDims, offset, Boundary::Zero));
+  }
+}
+
+TEST(RegionCopyTest, shiftLinear)
+{
+  std::vector<float> input(static_cast<size_t>(dims[0]) * dims[1] * dims[2]);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>(std::sin(i * 0.37) * 100.0);
+  }
+  auto index = [](int x, int y, int z) {
+    return (static_cast<size_t>(z) * dims[1] + y) * dims[0] + x;
+  };
+  auto sample = [&](int x, int y, int z) {
+    if (x < 0 || y < 0 || z < 0 || x >= dims[0] || y >= dims[1] ||
+        z >= dims[2]) {
+      return 0.0;
+    }
+    return static_cast<double>(input[index(x, y, z)]);
+  };
+
+  // Half a voxel along x, the integer shifts are exact.
+  const double shift[3] = { 0.5, -1.0, 2.0 };
+  std::vector<float> output(input.size());
+  RegionCopy::shiftLinear(input.data(), dims, 1, shift, output.data());
+  for (int z = 0; z < dims[2]; ++z) {
+    for (int y = 0; y < dims[1]; ++y) {
+      for (int x = 0; x < dims[0]; ++x) {
+        double value = 0.5 * (sample(x - 1, y + 1, z - 2) +
+                              sample(x, y + 1, z - 2));
+        ASSERT_NEAR(output[index(x, y, z)], value, 1e-4);
+      }
+    }
+  }
+
+  // Integer values are rounded.
+  const short values[4] = { 0, 3, 10, -8 };
+  const int lineDims[3] = { 4, 1, 1 };
+  const double quarter[3] = { 0.25, 0.0, 0.0 };
+  short shifted[4];
+  RegionCopy::shiftLinear(values, lineDims, 1, quarter, shifted);
+  EXPECT_EQ(shifted[0], 0);
+  EXPECT_EQ(shifted[1], 2);
+  EXPECT_EQ(shifted[2], 8);
+  EXPECT_EQ(shifted[3], -3);
+}
+
+TEST(RegionCopyTest, cropImage)
+{
+  vtkNew<vtkImageData> image;
+  image->SetExtent(-2, 6, 0, 6, 10, 20);
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetNumberOfComponents(2);
+  scalars->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < scalars->GetNumberOfValues(); ++i) {
+    scalars->SetValue(i, static_cast<float>(i));
+  }
+  image->GetPointData()->SetScalars(scalars);
+
+  // The extent is clamped to that of the image.
+  const int bounds[6] = { 0, 3, -5, 2, 12, 30 };
+  ASSERT_TRUE(RegionCopy::crop(image, bounds));
+  int extent[6];
+  image->GetExtent(extent);
+  const int voi[6] = { 0, 3, 0, 2, 12, 20 };
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(extent[i], voi[i]);
+  }
+
+  auto cropped = image->GetPointData()->GetScalars();
+  ASSERT_EQ(cropped->GetNumberOfTuples(), 4 * 3 * 9);
+  vtkIdType t = 0;
+  for (int z = 12; z <= 20; ++z) {
+    for (int y = 0; y <= 2; ++y) {
+      for (int x = 0; x <= 3; ++x, ++t) {
+        double source = ((z - 10) * 7 + y) * 9 + (x + 2);
+        EXPECT_EQ(cropped->GetComponent(t, 0), 2 * source);
+        EXPECT_EQ(cropped->GetComponent(t, 1), 2 * source + 1);
+      }
+    }
+  }
+
+  const int empty[6] = { 5, 4, 0, 2, 12, 20 };
+  EXPECT_FALSE(RegionCopy::crop(image, empty));
+}
@@ -0,0 +1,26 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizTestVolumes_h
+#define tomvizTestVolumes_h
+
+#include <cmath>
+#include <vector>
+
+namespace tomviz {
+namespace test {
+
+/// A volume of dimensions \p dims, in Fortran order, with values that vary
+/// at every frequency.
+inline std::vector<float> makeVolume(const int dims[3])
+{
+  std::vector<float> values(static_cast<size_t>(dims[0]) * dims[1] * dims[2]);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<float>(std::sin(0.7 * i) + 0.01 * (i % 13));
+  }
+  return values;
+}
+} // namespace test
+} // namespace tomviz
+
+#endif
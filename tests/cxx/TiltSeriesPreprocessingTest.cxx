@@ -0,0 +1,194 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <gtest/gtest.h>
+
+#include "TiltSeriesPreprocessing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace tomviz;
+using Parameters = TiltSeriesPreprocessing::Parameters;
+
+namespace {
+
+const int dims[3] = { 12, 9, 7 };
+const int size = dims[0] * dims[1];
+
+// Smooth projections, each with its own intensity and background.
+std::vector<float> tiltSeries()
+{
+  std::vector<float> values(size * dims[2]);
+  for (int z = 0; z < dims[2]; ++z) {
+    for (int y = 0; y < dims[1]; ++y) {
+      for (int x = 0; x < dims[0]; ++x) {
+        values[(z * dims[1] + y) * dims[0] + x] = static_cast<float>(
+          (z + 1) * (std::sin(x * 0.3) + std::cos(y * 0.4) + 3.0) + z * 2.0);
+      }
+    }
+  }
+  return values;
+}
+
+double projectionSum(const std::vector<float>& values, int z)
+{
+  double sum = 0.0;
+  for (int i = 0; i < size; ++i) {
+    sum += values[z * size + i];
+  }
+  return sum;
+}
+} // namespace
+
+TEST(TiltSeriesPreprocessingTest, averageFrames)
+{
+  const int frameDims[3] = { 3, 2, 4 };
+  std::vector<unsigned short> frames(24);
+  for (int i = 0; i < 24; ++i) {
+    frames[i] = static_cast<unsigned short>(i);
+  }
+  float average[6];
+  TiltSeriesPreprocessing::averageFrames(frames.data(), frameDims, average);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_FLOAT_EQ(average[i], i + 9.0f);
+  }
+}
+
+TEST(TiltSeriesPreprocessingTest, removeBadPixels)
+{
+  auto values = tiltSeries();
+  std::vector<float> image(values.begin(), values.begin() + size);
+  const int imageDims[2] = { dims[0], dims[1] };
+  image[4 * dims[0] + 5] = 1000.0f;
+  image[0] = -1000.0f;
+
+  std::vector<float> output(size);
+  TiltSeriesPreprocessing::removeBadPixels(image.data(), imageDims, 2.0,
+                                           output.data());
+  for (int y = 0; y < dims[1]; ++y) {
+    for (int x = 0; x < dims[0]; ++x) {
+      const int i = y * dims[0] + x;
+      if (i == 4 * dims[0] + 5 || i == 0) {
+        // Replaced by the median of the neighbourhood.
+        EXPECT_LT(std::abs(output[i] - values[i]), 0.5f);
+      } else {
+        EXPECT_EQ(output[i], image[i]);
+      }
+    }
+  }
+}
+
+TEST(TiltSeriesPreprocessingTest, histogramPeak)
+{
+  // A background of 2 to 2.5 and a few brighter pixels.
+  std::vector<float> values(1000);
+  for (int i = 0; i < 1000; ++i) {
+    values[i] = i % 10 == 0 ? 10.0f + i * 0.01f : 2.0f + (i % 7) * 0.0001f;
+  }
+  values[3] = std::numeric_limits<float>::quiet_NaN();
+  const double peak = TiltSeriesPreprocessing::histogramPeak(values.data(),
+                                                             1000);
+  EXPECT_NEAR(peak, 2.0, 1e-6);
+
+  const float constant[3] = { 4.0f, 4.0f, 4.0f };
+  EXPECT_NEAR(TiltSeriesPreprocessing::histogramPeak(constant, 3),
+              3.5 + 128.0 / 256.0, 1e-9);
+}
+
+TEST(TiltSeriesPreprocessingTest, regionMean)
+{
+  const float values[6] = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f };
+  const int imageDims[2] = { 3, 2 };
+  const int region[4] = { 1, 5, -1, 0 };
+  EXPECT_DOUBLE_EQ(
+    TiltSeriesPreprocessing::regionMean(values, imageDims, region), 2.5);
+  const int empty[4] = { 2, 1, 0, 1 };
+  EXPECT_EQ(TiltSeriesPreprocessing::regionMean(values, imageDims, empty),
+            0.0);
+}
+
+TEST(TiltSeriesPreprocessingTest, flatFieldBackgroundNormalize)
+{
+  auto expected = tiltSeries();
+  std::vector<float> dark(size);
+  std::vector<float> white(size);
+  for (int i = 0; i < size; ++i) {
+    dark[i] = 0.5f + (i % 5) * 0.1f;
+    white[i] = dark[i] + 2.0f + (i % 3) * 0.5f;
+  }
+  // The raw projections that the flat field correction recovers.
+  auto values = expected;
+  for (int z = 0; z < dims[2]; ++z) {
+    for (int i = 0; i < size; ++i) {
+      values[z * size + i] =
+        expected[z * size + i] * (white[i] - dark[i]) + dark[i];
+    }
+  }
+
+  Parameters parameters;
+  parameters.steps = TiltSeriesPreprocessing::FlatField |
+                     TiltSeriesPreprocessing::Background |
+                     TiltSeriesPreprocessing::Normalize;
+  parameters.backgroundMethod =
+    TiltSeriesPreprocessing::BackgroundMethod::Region;
+  const int region[4] = { 0, 3, 2, 4 };
+  std::copy(region, region + 4, parameters.backgroundRegion);
+  TiltSeriesPreprocessing preprocessing(dims, parameters);
+  ASSERT_TRUE(preprocessing.apply(values.data(), dark.data(), white.data()));
+
+  const int imageDims[2] = { dims[0], dims[1] };
+  double intensity = 0.0;
+  for (int z = 0; z < dims[2]; ++z) {
+    const double level = TiltSeriesPreprocessing::regionMean(
+      expected.data() + z * size, imageDims, region);
+    for (int i = 0; i < size; ++i) {
+      expected[z * size + i] -= static_cast<float>(level);
+    }
+    intensity += projectionSum(expected, z);
+  }
+  intensity /= dims[2];
+  for (int z = 0; z < dims[2]; ++z) {
+    const double scale = intensity / projectionSum(expected, z);
+    for (int i = 0; i < size; ++i) {
+      ASSERT_NEAR(values[z * size + i], expected[z * size + i] * scale,
+                  1e-3);
+    }
+    EXPECT_NEAR(projectionSum(values, z), intensity,
+                std::abs(intensity) * 1e-5);
+  }
+}
+
+TEST(TiltSeriesPreprocessingTest, clipEdges)
+{
+  auto values = tiltSeries();
+  const float minimum = *std::min_element(values.begin(), values.end());
+  auto expected = values;
+
+  Parameters parameters;
+  parameters.steps = TiltSeriesPreprocessing::ClipEdges;
+  parameters.clipWidth = 2;
+  TiltSeriesPreprocessing preprocessing(dims, parameters);
+  ASSERT_TRUE(preprocessing.apply(values.data()));
+  for (int z = 0; z < dims[2]; ++z) {
+    for (int y = 0; y < dims[1]; ++y) {
+      for (int x = 0; x < dims[0]; ++x) {
+        const int i = (z * dims[1] + y) * dims[0] + x;
+        const bool edge =
+          x < 2 || y < 2 || x >= dims[0] - 2 || y >= dims[1] - 2;
+        EXPECT_EQ(values[i], edge ? minimum : expected[i]);
+      }
+    }
+  }
+}
+
+TEST(TiltSeriesPreprocessingTest, cancel)
+{
+  auto values = tiltSeries();
+  Parameters parameters;
+  TiltSeriesPreprocessing preprocessing(dims, parameters);
+  EXPECT_FALSE(preprocessing.apply(values.data(), nullptr, nullptr,
+                                   [](int) { return false; }));
+}
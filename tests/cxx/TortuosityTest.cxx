@@ -0,0 +1,187 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <gtest/gtest.h>
+
+#include "Tortuosity.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+using namespace tomviz;
+
+namespace {
+
+const int dims[3] = { 14, 11, 9 };
+const int size = dims[0] * dims[1] * dims[2];
+
+int index(int x, int y, int z)
+{
+  return (z * dims[1] + y) * dims[0] + x;
+}
+
+std::vector<unsigned char> makePhase()
+{
+  // Winding channels, with dead ends and closed pockets.
+  std::vector<unsigned char> phase(size);
+  for (int z = 0; z < dims[2]; ++z) {
+    for (int y = 0; y < dims[1]; ++y) {
+      for (int x = 0; x < dims[0]; ++x) {
+        const double value =
+          std::sin(x * 0.5 + z * 0.3) + std::cos(y * 0.6) * std::sin(z * 0.7);
+        phase[index(x, y, z)] = value > -0.2 && (x * 3 + y * 5 + z) % 7 != 0;
+      }
+    }
+  }
+  return phase;
+}
+
+// Dijkstra on the explicit voxel graph, with the first slice linked to the
+// face.
+std::vector<double> shortestPaths(const std::vector<unsigned char>& phase,
+                                  Tortuosity::Metric metric,
+                                  Tortuosity::Direction direction)
+{
+  const double infinity = std::numeric_limits<double>::infinity();
+  std::vector<double> distances(size, infinity);
+  typedef std::pair<double, int> Item;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+  const int axis = direction / 2;
+  for (int z = 0; z < dims[2]; ++z) {
+    for (int y = 0; y < dims[1]; ++y) {
+      for (int x = 0; x < dims[0]; ++x) {
+        const int p[3] = { x, y, z };
+        const int face = direction % 2 ? dims[axis] - 1 : 0;
+        if (p[axis] == face && phase[index(x, y, z)]) {
+          distances[index(x, y, z)] = 1.0;
+          queue.push({ 1.0, index(x, y, z) });
+        }
+      }
+    }
+  }
+
+  while (!queue.empty()) {
+    const Item item = queue.top();
+    queue.pop();
+    const int v = item.second;
+    if (item.first > distances[v]) {
+      continue;
+    }
+    const int x = v % dims[0];
+    const int y = (v / dims[0]) % dims[1];
+    const int z = v / (dims[0] * dims[1]);
+    for (int dz = -1; dz <= 1; ++dz) {
+      for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+          const int n = std::abs(dx) + std::abs(dy) + std::abs(dz);
+          if (n == 0 || (metric == Tortuosity::Metric::CityBlock && n > 1)) {
+            continue;
+          }
+          const int xx = x + dx;
+          const int yy = y + dy;
+          const int zz = z + dz;
+          if (xx < 0 || yy < 0 || zz < 0 || xx >= dims[0] || yy >= dims[1] ||
+              zz >= dims[2] || !phase[index(xx, yy, zz)]) {
+            continue;
+          }
+          const double length =
+            metric == Tortuosity::Metric::Euclidean ? std::sqrt(n) : 1.0;
+          const double candidate = item.first + length;
+          if (candidate < distances[index(xx, yy, zz)]) {
+            distances[index(xx, yy, zz)] = candidate;
+            queue.push({ candidate, index(xx, yy, zz) });
+          }
+        }
+      }
+    }
+  }
+  return distances;
+}
+} // namespace
+
+TEST(TortuosityTest, propagate)
+{
+  auto phase = makePhase();
+  std::vector<float> distances(size);
+  const Tortuosity::Metric metrics[3] = { Tortuosity::Metric::Euclidean,
+                                          Tortuosity::Metric::CityBlock,
+                                          Tortuosity::Metric::ChessBoard };
+  for (auto metric : metrics) {
+    Tortuosity tortuosity(dims, metric);
+    for (int d = Tortuosity::XPositive; d <= Tortuosity::ZNegative; ++d) {
+      auto direction = static_cast<Tortuosity::Direction>(d);
+      ASSERT_TRUE(
+        tortuosity.propagate(phase.data(), direction, distances.data()));
+      auto expected = shortestPaths(phase, metric, direction);
+      int reached = 0;
+      for (int i = 0; i < size; ++i) {
+        if (std::isinf(expected[i])) {
+          EXPECT_EQ(distances[i], Tortuosity::Unreachable);
+        } else {
+          EXPECT_NEAR(distances[i], expected[i], 1e-4);
+          ++reached;
+        }
+      }
+      EXPECT_GT(reached, size / 4);
+    }
+  }
+}
+
+TEST(TortuosityTest, straightChannels)
+{
+  // Every line along y is a channel, the paths are straight.
+  std::vector<unsigned char> phase(size, 0);
+  for (int z = 0; z < dims[2]; z += 2) {
+    for (int y = 0; y < dims[1]; ++y) {
+      for (int x = 0; x < dims[0]; x += 2) {
+        phase[index(x, y, z)] = 1;
+      }
+    }
+  }
+  std::vector<float> distances(size);
+  Tortuosity tortuosity(dims, Tortuosity::Metric::Euclidean);
+  ASSERT_TRUE(tortuosity.propagate(phase.data(), Tortuosity::YNegative,
+                                   distances.data()));
+
+  auto pathLength =
+    tortuosity.averagePathLength(distances.data(), Tortuosity::YNegative);
+  ASSERT_EQ(pathLength.size(), static_cast<size_t>(dims[1]));
+  for (int s = 0; s < dims[1]; ++s) {
+    EXPECT_EQ(pathLength[s], s + 1.0);
+  }
+  auto summary = Tortuosity::tortuosity(pathLength);
+  EXPECT_NEAR(summary.scale, 1.0, 1e-12);
+  EXPECT_NEAR(summary.end, 1.0, 1e-12);
+  EXPECT_NEAR(summary.average, 1.0, 1e-12);
+  EXPECT_EQ(summary.slope, -1.0);
+
+  // All the channels end in the first bin.
+  auto histogram = tortuosity.tortuosityDistribution(
+    distances.data(), Tortuosity::YNegative, 100);
+  ASSERT_EQ(histogram.size(), 100u);
+  EXPECT_EQ(histogram[0], 7 * 5);
+  for (int i = 1; i < 100; ++i) {
+    EXPECT_EQ(histogram[i], 0);
+  }
+}
+
+TEST(TortuosityTest, cancel)
+{
+  const int largeDims[3] = { 64, 64, 32 };
+  const int largeSize = largeDims[0] * largeDims[1] * largeDims[2];
+  std::vector<unsigned char> phase(largeSize, 1);
+  std::vector<float> distances(largeSize);
+  Tortuosity tortuosity(largeDims, Tortuosity::Metric::Euclidean);
+  int reports = 0;
+  EXPECT_FALSE(tortuosity.propagate(phase.data(), Tortuosity::ZPositive,
+                                    distances.data(), [&](vtkIdType) {
+                                      ++reports;
+                                      return false;
+                                    }));
+  EXPECT_EQ(reports, 1);
+}
@@ -0,0 +1,131 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <gtest/gtest.h>
+
+#include "TomographyReconstruction.h"
+#include "TotalVariation.h"
+
+#include "TestVolumes.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace tomviz;
+using tomviz::test::makeVolume;
+
+namespace {
+
+// The total variation with backward differences, computed directly.
+double backwardVariation(const std::vector<float>& values, const int dims[3])
+{
+  auto at = [&](int x, int y, int z) {
+    x = std::min(std::max(x, 0), dims[0] - 1);
+    y = std::min(std::max(y, 0), dims[1] - 1);
+    z = std::min(std::max(z, 0), dims[2] - 1);
+    return static_cast<double>(values[(z * dims[1] + y) * dims[0] + x]);
+  };
+
+  double sum = 0.0;
+  for (int z = 0; z < dims[2]; ++z) {
+    for (int y = 0; y < dims[1]; ++y) {
+      for (int x = 0; x < dims[0]; ++x) {
+        double dx = at(x, y, z) - at(x - 1, y, z);
+        double dy = at(x, y, z) - at(x, y - 1, z);
+        double dz = at(x, y, z) - at(x, y, z - 1);
+        sum += std::sqrt(1e-8 + dx * dx + dy * dy + dz * dz);
+      }
+    }
+  }
+  return sum;
+}
+} // namespace
+
+TEST(TotalVariationTest, constant)
+{
+  int dims[3] = { 4, 3, 5 };
+  std::vector<float> values(60, 3.0f);
+  EXPECT_NEAR(TotalVariation::value(values.data(), dims), 60 * 1e-4, 1e-6);
+
+  std::vector<float> gradient(values.size());
+  EXPECT_EQ(TotalVariation::gradient(values.data(), dims, gradient.data()),
+            0.0);
+}
+
+TEST(TotalVariationTest, gradient)
+{
+  int dims[3] = { 5, 4, 6 };
+  auto values = makeVolume(dims);
+  std::vector<float> gradient(values.size());
+  double norm = TotalVariation::gradient(values.data(), dims, gradient.data());
+
+  double sum = 0.0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    auto plus = values;
+    auto minus = values;
+    plus[i] += 1e-3f;
+    minus[i] -= 1e-3f;
+    double expected =
+      (backwardVariation(plus, dims) - backwardVariation(minus, dims)) / 2e-3;
+    EXPECT_NEAR(gradient[i], expected, 2e-2);
+    sum += static_cast<double>(gradient[i]) * gradient[i];
+  }
+  EXPECT_NEAR(norm, std::sqrt(sum), 1e-4);
+
+  // A small step along the gradient reduces the total variation.
+  std::vector<float> result(values.size());
+  TotalVariation::descend(values.data(), gradient.data(), 0.01 / norm,
+                          values.size(), result.data());
+  EXPECT_LT(backwardVariation(result, dims), backwardVariation(values, dims));
+  EXPECT_NEAR(TotalVariation::distance(values.data(), result.data(),
+                                       values.size()),
+              0.01, 1e-5);
+}
+
+TEST(TotalVariationTest, parallelRayMatrix)
+{
+  const int n = 16;
+  double angles[2] = { 0.001, 90.001 };
+  TomographyReconstruction::SystemMatrix matrix;
+  TomographyReconstruction::parallelRayMatrix(n, angles, 2, matrix);
+  ASSERT_EQ(matrix.rowNorms.size(), static_cast<size_t>(2 * n));
+
+  // Every ray crosses the whole image.
+  for (int r = 0; r < 2 * n; ++r) {
+    double length = 0.0;
+    for (vtkIdType k = matrix.rowStart[r]; k < matrix.rowStart[r + 1]; ++k) {
+      length += matrix.values[k];
+    }
+    EXPECT_NEAR(length, n, 1e-3);
+  }
+
+  // ART recovers an image from its projections.
+  std::vector<double> tiltAngles(60);
+  for (size_t i = 0; i < tiltAngles.size(); ++i) {
+    tiltAngles[i] = -90.0 + 3.0 * i + 0.001;
+  }
+  TomographyReconstruction::parallelRayMatrix(n, tiltAngles.data(), 60,
+                                              matrix);
+  std::vector<float> image(n * n, 0.0f);
+  std::vector<float> expected(n * n, 0.0f);
+  for (int y = 0; y < n; ++y) {
+    for (int z = 0; z < n; ++z) {
+      expected[y * n + z] = std::hypot(y - 6.5, z - 8.5) < 4.0 ? 1.0f : 0.0f;
+    }
+  }
+  std::vector<float> sinogram(matrix.rowNorms.size(), 0.0f);
+  for (size_t r = 0; r < sinogram.size(); ++r) {
+    for (vtkIdType k = matrix.rowStart[r]; k < matrix.rowStart[r + 1]; ++k) {
+      sinogram[r] += matrix.values[k] * expected[matrix.columns[k]];
+    }
+  }
+  for (int i = 0; i < 20; ++i) {
+    TomographyReconstruction::artSweep(matrix, sinogram.data(), image.data());
+  }
+  double error = 0.0;
+  for (int i = 0; i < n * n; ++i) {
+    error += std::abs(image[i] - expected[i]);
+  }
+  EXPECT_LT(error / (n * n), 0.05);
+}
@@ -0,0 +1,151 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <gtest/gtest.h>
+
+#include <vtkDataArray.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+#include "EmdFormat.h"
+#include "ImagePyramid.h"
+#include "Tvh5Multiscale.h"
+
+#include "TestVolumes.h"
+
+#include <h5cpp/h5readwrite.h>
+
+#include <QTemporaryDir>
+
+#include <string>
+#include <vector>
+
+using namespace tomviz;
+using tomviz::test::makeVolume;
+
+namespace {
+
+const char* NodePath = "/data/tomography";
+
+} // namespace
+
+class Tvh5MultiscaleTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_TRUE(dir.isValid());
+    fileName = dir.filePath("multiscale.tvh5").toStdString();
+
+    // Neither the volume nor its levels are multiples of the chunk size.
+    const int dims[3] = { 300, 70, 45 };
+    auto values = makeVolume(dims);
+    image->SetDimensions(dims);
+    image->SetSpacing(0.5, 1.0, 2.0);
+    image->SetOrigin(1.0, 2.0, 3.0);
+
+    vtkNew<vtkFloatArray> scalars;
+    scalars->SetName("density");
+    scalars->SetNumberOfTuples(image->GetNumberOfPoints());
+    vtkNew<vtkFloatArray> labels;
+    labels->SetName("labels");
+    labels->SetNumberOfTuples(image->GetNumberOfPoints());
+    for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i) {
+      scalars->SetValue(i, values[i]);
+      labels->SetValue(i, static_cast<float>(i % 7));
+    }
+    image->GetPointData()->SetScalars(scalars);
+    image->GetPointData()->AddArray(labels);
+  }
+
+  // Write the image with its levels, then read every level back.
+  void writeAndRead(bool compress)
+  {
+    auto levels = Tvh5Multiscale::prepare(image, nullptr, compress);
+    ASSERT_EQ(levels.size(), 2u);
+    for (const auto& level : levels) {
+      for (const auto& data : level.arrays) {
+        EXPECT_EQ(data.chunks.empty(),
+                  !compress || !h5::H5ReadWrite::canWriteChunks());
+      }
+    }
+
+    {
+      h5::H5ReadWrite writer(fileName, h5::H5ReadWrite::OpenMode::WriteOnly);
+      writer.createGroup("/data");
+      writer.createGroup(NodePath);
+      ASSERT_TRUE(EmdFormat::writeNode(writer, NodePath, image));
+      ASSERT_TRUE(Tvh5Multiscale::write(writer, NodePath, levels));
+    }
+
+    h5::H5ReadWrite reader(fileName, h5::H5ReadWrite::OpenMode::ReadOnly);
+    ASSERT_EQ(Tvh5Multiscale::coarsestLevel(reader, NodePath), 2);
+
+    ImagePyramid pyramid(image);
+    for (int level = 0; level <= 2; ++level) {
+      vtkNew<vtkImageData> read;
+      ASSERT_TRUE(Tvh5Multiscale::readLevel(reader, NodePath, level, read));
+      checkLevel(pyramid.level(level), read, level);
+    }
+  }
+
+  void checkLevel(vtkImageData* expected, vtkImageData* read, int level)
+  {
+    int expectedDims[3], dims[3];
+    expected->GetDimensions(expectedDims);
+    read->GetDimensions(dims);
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_EQ(dims[i], expectedDims[i]) << "level " << level;
+    }
+
+    // The full resolution origin is not stored.
+    if (level > 0) {
+      double expectedOrigin[3], origin[3];
+      expected->GetOrigin(expectedOrigin);
+      read->GetOrigin(origin);
+      for (int i = 0; i < 3; ++i) {
+        EXPECT_DOUBLE_EQ(origin[i], expectedOrigin[i]) << "level " << level;
+      }
+    }
+
+    double expectedSpacing[3], spacing[3];
+    expected->GetSpacing(expectedSpacing);
+    read->GetSpacing(spacing);
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_NEAR(spacing[i], expectedSpacing[i], 1e-6) << "level " << level;
+    }
+
+    auto expectedData = expected->GetPointData();
+    auto readData = read->GetPointData();
+    ASSERT_EQ(readData->GetNumberOfArrays(), 2);
+    ASSERT_NE(readData->GetScalars(), nullptr);
+    EXPECT_EQ(std::string(readData->GetScalars()->GetName()), "density");
+    for (auto name : { "density", "labels" }) {
+      auto expectedArray = expectedData->GetArray(name);
+      auto array = readData->GetArray(name);
+      ASSERT_NE(array, nullptr) << name << " at level " << level;
+      ASSERT_EQ(array->GetNumberOfTuples(),
+                expectedArray->GetNumberOfTuples());
+      for (vtkIdType i = 0; i < array->GetNumberOfTuples(); ++i) {
+        ASSERT_EQ(array->GetComponent(i, 0), expectedArray->GetComponent(i, 0))
+          << name << " at level " << level << ", value " << i;
+      }
+    }
+  }
+
+  QTemporaryDir dir;
+  std::string fileName;
+  vtkNew<vtkImageData> image;
+};
+
+TEST_F(Tvh5MultiscaleTest, compressedChunks)
+{
+  writeAndRead(true);
+}
+
+TEST_F(Tvh5MultiscaleTest, chunkedData)
+{
+  writeAndRead(false);
+}
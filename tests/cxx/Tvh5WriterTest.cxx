@@ -0,0 +1,162 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <gtest/gtest.h>
+
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+#include "EmdFormat.h"
+#include "MemoryMappedArray.h"
+#include "Tvh5Writer.h"
+
+#include "TestVolumes.h"
+
+#include <h5cpp/h5readwrite.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QTemporaryDir>
+
+#include <memory>
+#include <vector>
+
+using namespace tomviz;
+using tomviz::test::makeVolume;
+
+class Tvh5WriterTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_TRUE(dir.isValid());
+    fileName = dir.filePath("state.tvh5");
+
+    values = makeVolume(Dims);
+    image->SetDimensions(Dims[0], Dims[1], Dims[2]);
+    vtkNew<vtkFloatArray> scalars;
+    scalars->SetName("ImageScalars");
+    scalars->SetNumberOfTuples(static_cast<vtkIdType>(values.size()));
+    for (size_t i = 0; i < values.size(); ++i) {
+      scalars->SetValue(static_cast<vtkIdType>(i), values[i]);
+    }
+    image->GetPointData()->SetScalars(scalars);
+  }
+
+  // Save the image, returns the success reported by finished().
+  bool save(bool cancel = false)
+  {
+    QMap<QString, vtkImageData*> images;
+    images.insert("0", image);
+
+    bool success = false;
+    std::unique_ptr<Tvh5Writer> writer(new Tvh5Writer(fileName));
+    auto w = writer.get();
+    QObject::connect(w, &Tvh5Writer::finished, w,
+                     [this, &success, w](bool result) {
+                       success = result;
+                       errorMessage = w->errorMessage();
+                     },
+                     Qt::DirectConnection);
+    if (cancel) {
+      w->cancel();
+    }
+    if (!w->start("{}", "0", images)) {
+      errorMessage = w->errorMessage();
+      return false;
+    }
+    // Waits for the writer thread.
+    writer.reset();
+    return success;
+  }
+
+  void writeOriginal()
+  {
+    QFile file(fileName);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    ASSERT_EQ(file.write("old"), 3);
+  }
+
+  void checkOriginal()
+  {
+    QFile file(fileName);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    EXPECT_EQ(file.readAll(), QByteArray("old"));
+  }
+
+  const int Dims[3] = { 7, 5, 3 };
+  QTemporaryDir dir;
+  QString fileName;
+  QString errorMessage;
+  std::vector<float> values;
+  vtkNew<vtkImageData> image;
+};
+
+TEST_F(Tvh5WriterTest, save)
+{
+  writeOriginal();
+  ASSERT_TRUE(save()) << errorMessage.toStdString();
+  EXPECT_FALSE(QFile::exists(MemoryMappedArray::partFileName(fileName)));
+
+  {
+    h5::H5ReadWrite reader(fileName.toStdString(),
+                           h5::H5ReadWrite::OpenMode::ReadOnly);
+    auto state = reader.readData<char>("/tomviz_state");
+    EXPECT_EQ(std::string(state.begin(), state.end()), "{}");
+  }
+
+  vtkNew<vtkImageData> saved;
+  ASSERT_TRUE(
+    EmdFormat::readNode(fileName.toStdString(), "/data/tomography", saved));
+  int dims[3];
+  saved->GetDimensions(dims);
+  EXPECT_EQ(dims[0], Dims[0]);
+  EXPECT_EQ(dims[1], Dims[1]);
+  EXPECT_EQ(dims[2], Dims[2]);
+  auto scalars = saved->GetPointData()->GetScalars();
+  ASSERT_NE(scalars, nullptr);
+  ASSERT_EQ(scalars->GetNumberOfTuples(),
+            static_cast<vtkIdType>(values.size()));
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(scalars->GetComponent(static_cast<vtkIdType>(i), 0), values[i]);
+  }
+}
+
+TEST_F(Tvh5WriterTest, cancel)
+{
+  writeOriginal();
+  EXPECT_FALSE(save(true));
+  checkOriginal();
+  EXPECT_FALSE(QFile::exists(MemoryMappedArray::partFileName(fileName)));
+}
+
+TEST_F(Tvh5WriterTest, failedWrite)
+{
+  // The temporary file can't be created.
+  writeOriginal();
+  auto partName = MemoryMappedArray::partFileName(fileName);
+  ASSERT_TRUE(QDir(dir.path()).mkdir(QFileInfo(partName).fileName()));
+  EXPECT_FALSE(save());
+  EXPECT_FALSE(errorMessage.isEmpty());
+  checkOriginal();
+}
+
+TEST_F(Tvh5WriterTest, failedReplace)
+{
+  // A directory can't be replaced by a file, the saved file is kept.
+  ASSERT_TRUE(QDir(dir.path()).mkdir(QFileInfo(fileName).fileName()));
+  EXPECT_FALSE(save());
+  auto partName = MemoryMappedArray::partFileName(fileName);
+  EXPECT_TRUE(errorMessage.contains(partName));
+  EXPECT_TRUE(QFileInfo(fileName).isDir());
+
+  vtkNew<vtkImageData> saved;
+  ASSERT_TRUE(
+    EmdFormat::readNode(partName.toStdString(), "/data/tomography", saved));
+  EXPECT_EQ(saved->GetNumberOfPoints(),
+            static_cast<vtkIdType>(values.size()));
+}
@@ -0,0 +1,102 @@
+import json
+import os
+
+import h5py
+import numpy as np
+
+from click.testing import CliRunner
+
+from tomviz import batch, executor
+from tomviz.cli import main
+from tomviz.external_dataset import Dataset
+
+ADD_ONE = '''
+def transform(dataset):
+    dataset.active_scalars = dataset.active_scalars + 1
+'''
+
+OPERATORS = [{'type': 'Python', 'label': 'Add One', 'script': ADD_ONE}]
+
+
+def write_inputs(tmpdir, count):
+    paths = []
+    for i in range(count):
+        array = np.arange(24 * (i + 1), dtype=np.float32)
+        array = array.reshape((2, 3, 4 * (i + 1)), order='F')
+        path = tmpdir.join('input%d.emd' % i).strpath
+        executor._write_emd(path, Dataset({'scalars': array}))
+        paths.append((path, array))
+    return paths
+
+
+def read_output(path):
+    with h5py.File(path, 'r') as f:
+        return f['data/tomography/data'][:]
+
+
+def test_parse_size():
+    assert batch.parse_size('2048') == 2048
+    assert batch.parse_size('512M') == 512 << 20
+    assert batch.parse_size('1.5g') == 3 << 29
+    assert batch.parse_size('16GB') == 16 << 30
+
+
+def test_run(tmpdir):
+    inputs = write_inputs(tmpdir, 5)
+    file_paths = [(path, tmpdir.join('output%d.emd' % i).strpath)
+                  for (i, (path, _)) in enumerate(inputs)]
+    file_paths.append((tmpdir.join('corrupt.emd').strpath,
+                       tmpdir.join('corrupt_output.emd').strpath))
+    tmpdir.join('corrupt.emd').write('not an HDF5 file')
+    report_path = tmpdir.join('report.json').strpath
+
+    # The budget only fits two of the larger files at once.
+    budget = 2 * batch.MEMORY_FACTOR * batch.estimate_size(inputs[-1][0])
+    report = batch.run(OPERATORS, 0, file_paths, workers=3,
+                       memory_budget=budget, report_path=report_path)
+
+    with open(report_path) as f:
+        assert json.load(f) == report
+
+    assert report['summary']['files'] == 6
+    assert report['summary']['failed'] == 1
+    records = report['files']
+    for ((_, array), (_, output_path), record) in zip(inputs, file_paths,
+                                                      records):
+        assert record['status'] == 'ok'
+        assert record['bytes'] >= array.nbytes
+        assert record['read_seconds'] >= 0
+        assert record['compute_seconds'] >= 0
+        assert record['write_seconds'] >= 0
+        # EMD files are row major
+        expected = np.ascontiguousarray(array + 1)
+        assert np.array_equal(read_output(output_path), expected)
+
+    assert records[-1]['status'] == 'failed'
+    assert records[-1]['error']
+
+
+def test_cli(tmpdir):
+    inputs = write_inputs(tmpdir, 3)
+    state = {'dataSources': [{'operators': OPERATORS}]}
+    state_path = tmpdir.join('state.tvsm')
+    state_path.write(json.dumps(state))
+    output_dir = tmpdir.mkdir('output')
+    report_path = tmpdir.join('report.json')
+
+    runner = CliRunner()
+    result = runner.invoke(main, ['-s', state_path.strpath,
+                                  '-d', tmpdir.strpath,
+                                  '-o', output_dir.strpath,
+                                  '-j', '2',
+                                  '-r', report_path.strpath])
+    assert result.exit_code == 0
+
+    report = json.loads(report_path.read())
+    assert report['workers'] == 2
+    assert report['summary']['failed'] == 0
+    for (path, array) in inputs:
+        (name, _) = os.path.splitext(os.path.basename(path))
+        output_path = output_dir.join('%s_transformed.emd' % name)
+        expected = np.ascontiguousarray(array + 1)
+        assert np.array_equal(read_output(output_path.strpath), expected)
@@ -0,0 +1,114 @@
+import gc
+import tracemalloc
+
+import numpy as np
+import pytest
+
+from tomviz.external_dataset import Dataset
+
+itk = pytest.importorskip('itk')
+from tomviz import itkutils # noqa
+
+SHAPE = (128, 96, 64)
+
+
+class AllocationCounter:
+    """Records the peak of the memory allocated by Python and NumPy while it
+    is active."""
+
+    def __enter__(self):
+        tracemalloc.start()
+        return self
+
+    def __exit__(self, *args):
+        (_, self.peak) = tracemalloc.get_traced_memory()
+        tracemalloc.stop()
+
+
+def make_dataset(shape=SHAPE):
+    array = -np.arange(np.prod(shape), dtype=np.float32)
+    array = array.reshape(shape, order='F')
+    dataset = Dataset({'scalars': array})
+    dataset.spacing = [1.0, 2.0, 3.0]
+    return dataset
+
+
+def abs_filter(itk_image, in_place):
+    image_type = type(itk_image)
+    abs_filter = itk.AbsImageFilter[image_type, image_type].New()
+    abs_filter.SetInput(itk_image)
+    abs_filter.SetInPlace(in_place)
+    abs_filter.Update()
+    return abs_filter
+
+
+def setup_module():
+    # Load the ITK modules, which are imported lazily, before counting.
+    dataset = make_dataset((4, 3, 2))
+    itk_image = itkutils.dataset_to_itk_image(dataset)
+    for in_place in (False, True):
+        output = abs_filter(itk_image, in_place).GetOutput()
+        itkutils.set_itk_image_on_dataset(output, dataset)
+
+
+def test_dataset_to_itk_image():
+    dataset = make_dataset()
+    array = dataset.active_scalars
+
+    with AllocationCounter() as counter:
+        itk_image = itkutils.dataset_to_itk_image(dataset)
+
+    assert counter.peak < array.nbytes / 10
+    assert tuple(itk_image.GetLargestPossibleRegion().GetSize()) == SHAPE
+    assert tuple(itk_image.GetSpacing()) == (1.0, 2.0, 3.0)
+    assert itk_image.GetPixel([5, 7, 3]) == array[5, 7, 3]
+    assert np.shares_memory(itk.GetArrayViewFromImage(itk_image), array)
+
+
+def test_set_filter_output_on_dataset():
+    dataset = make_dataset()
+    expected = np.abs(dataset.active_scalars)
+    itk_image = itkutils.dataset_to_itk_image(dataset)
+    output = abs_filter(itk_image, False).GetOutput()
+
+    with AllocationCounter() as counter:
+        itkutils.set_itk_image_on_dataset(output, dataset)
+
+    assert counter.peak < expected.nbytes / 10
+    result = dataset.active_scalars
+    assert np.isfortran(result)
+    assert np.shares_memory(result, itk.GetArrayViewFromImage(output))
+
+    # The scalars keep the buffer of the output alive.
+    del itk_image, output
+    gc.collect()
+    assert np.array_equal(result, expected)
+
+
+def test_set_in_place_output_on_dataset():
+    dataset = make_dataset()
+    array = dataset.active_scalars
+    expected = np.abs(array)
+    itk_image = itkutils.dataset_to_itk_image(dataset)
+    output = abs_filter(itk_image, True).GetOutput()
+
+    with AllocationCounter() as counter:
+        itkutils.set_itk_image_on_dataset(output, dataset)
+
+    assert counter.peak < expected.nbytes / 10
+    assert np.shares_memory(dataset.active_scalars, array)
+    assert np.array_equal(dataset.active_scalars, expected)
+
+
+def test_set_foreign_view_on_dataset():
+    dataset = make_dataset()
+    other = np.ones(SHAPE[::-1], dtype=np.float32)
+    itk_image = itk.GetImageViewFromArray(other)
+
+    itkutils.set_itk_image_on_dataset(itk_image, dataset)
+
+    # Nothing would keep other alive, so its pixels are copied.
+    result = dataset.active_scalars
+    assert result.shape == SHAPE
+    assert not np.shares_memory(result, other)
+    assert np.array_equal(result, np.ones(SHAPE))
@@ -1,6 +1,8 @@
+import json
 import sys
 import os
 import pytest
+import types
 
 import unittest
 import mock
@@ -21,6 +23,7 @@ from tomviz._internal import find_operator_class # noqa
 from tomviz._internal import find_transform_from_module # noqa
 from tomviz._internal import find_transform_function, is_cancelable # noqa
 from tomviz._internal import find_operators # noqa
+from tomviz import _internal # noqa
 
 
 def test_find_operator_class():
@@ -127,3 +130,84 @@ def test_find_operators():
 
     assert (
         sorted(operators, key=sort_key) == sorted(expected, key=sort_key))
+
+
+def test_find_operators_cache(tmpdir, monkeypatch):
+    op_dir = os.path.join(os.path.dirname(__file__), 'fixtures')
+    for name in ('function.py', 'simple.py', 'invalidjson.py',
+                 'invalidjson.json'):
+        tmpdir.join(name).write(open(os.path.join(op_dir, name)).read())
+
+    cache = {}
+    first = find_operators(tmpdir.strpath, cache)
+    # The operator that failed to load isn't cached.
+    assert len(cache) == 2
+
+    loaded = []
+    load_module = _internal._load_module
+
+    def counting_load_module(operator_dir, python_file):
+        loaded.append(python_file)
+        return load_module(operator_dir, python_file)
+
+    monkeypatch.setattr(_internal, '_load_module', counting_load_module)
+
+    # Nothing changed, only the operator that failed is imported.
+    assert find_operators(tmpdir.strpath, cache) == first
+    assert loaded == ['invalidjson.py']
+    del loaded[:]
+
+    # The changed file is imported again, and so is the one whose JSON file
+    # changed.
+    tmpdir.join('simple.py').write('def transform(dataset):\n    pass\n')
+    tmpdir.join('invalidjson.json').write('{"label": "Valid JSON"}')
+    tmpdir.join('simple.pyc').write('')
+    tmpdir.join('function.py').remove()
+    operators = find_operators(tmpdir.strpath, cache)
+    assert sorted(loaded) == ['invalidjson.py', 'simple.py']
+    assert sorted(op['label'] for op in operators) == ['Valid JSON', 'simple']
+    assert len(cache) == 2
+
+    # The cache can be kept as JSON.
+    (operators, cache_json) = _internal.find_operators_cached(
+        tmpdir.strpath, json.dumps(cache))
+    assert json.loads(cache_json) == cache
+    assert len(loaded) == 2
+
+
+def test_find_transform_function_cached(monkeypatch):
+    # The lookups are done once per key.
+    assert find_transform_function(function, None, 'function') == \
+        function.transform_scalars
+    assert not is_cancelable(function, 'function')
+    assert is_cancelable(cancelable, 'cancelable')
+
+    monkeypatch.setattr(_internal, 'find_operator_class', None)
+    monkeypatch.setattr(_internal, 'find_transform_from_module', None)
+    assert find_transform_function(function, None, 'function') == \
+        function.transform_scalars
+    assert not is_cancelable(function, 'function')
+    assert is_cancelable(cancelable, 'cancelable')
+
+    # Each operator gets its own instance of the operator class.
+    monkeypatch.undo()
+    func = find_transform_function(simple, None, 'simple')
+    other = find_transform_function(simple, None, 'simple')
+    assert isinstance(func.__self__, simple.SimpleOperator)
+    assert func.__self__ is not other.__self__
+    assert other(None)
+
+
+def test_find_transform_function_renamed():
+    # The attribute names are looked up, not the names of the objects.
+    module = types.ModuleType('renamed')
+    module.transform = lambda dataset: 'lambda'
+    assert find_transform_function(module, None, 'renamed')(None) == 'lambda'
+    assert find_transform_function(module, None, 'renamed')(None) == 'lambda'
+
+    module = types.ModuleType('aliased')
+    module.Aliased = simple.SimpleOperator
+    func = find_transform_function(module, None, 'aliased')
+    assert isinstance(func.__self__, simple.SimpleOperator)
+    func = find_transform_function(module, None, 'aliased')
+    assert isinstance(func.__self__, simple.SimpleOperator)
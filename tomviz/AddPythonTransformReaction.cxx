@@ -13,6 +13,7 @@
 #include "PipelineManager.h"
 #include "SelectVolumeWidget.h"
 #include "SpinBox.h"
+#include "Tvh5Multiscale.h"
 #include "Utilities.h"
 
 #include <vtkImageData.h>
@@ -210,6 +211,9 @@ OperatorPython* AddPythonTransformReaction::addExpression(DataSource* source)
     return nullptr;
   }
 
+  // The dialogs show the extent of the data, it must be the full resolution.
+  Tvh5Multiscale::finishAll();
+
   bool hasJson = this->jsonSource.size() > 0;
   if (hasJson) {
     OperatorPython* opPython = new OperatorPython(source);
@@ -0,0 +1,160 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "ArrayConversion.h"
+
+#include <vtkDataArray.h>
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+namespace {
+
+// The arrays whose buffer was reused by the output of a conversion, they
+// free it once no output uses it anymore. Outputs may be converted in place
+// again, the buffer is then shared by more than one output.
+struct BufferOwner
+{
+  vtkSmartPointer<vtkDataArray> array;
+  int users = 0;
+};
+
+QMutex ownersMutex;
+QHash<void*, BufferOwner> owners;
+
+void releaseBuffer(void* buffer)
+{
+  vtkSmartPointer<vtkDataArray> owner;
+  {
+    QMutexLocker lock(&ownersMutex);
+    auto it = owners.find(buffer);
+    if (it == owners.end() || --it->users > 0) {
+      return;
+    }
+    // The owner is released outside of the lock.
+    owner = it->array;
+    owners.erase(it);
+  }
+}
+
+// Whether the buffer of array can be reused by an output of type.
+bool canReuse(vtkDataArray* array, int type, int numComponents)
+{
+  // The single reference is that of the data set of the caller, nothing else
+  // may see the values change.
+  if (array->GetReferenceCount() > 1 || !array->HasStandardMemoryLayout()) {
+    return false;
+  }
+  return vtkDataArray::GetDataTypeSize(type) * numComponents <=
+         array->GetDataTypeSize() * array->GetNumberOfComponents();
+}
+
+vtkSmartPointer<vtkDataArray> createOutput(vtkDataArray* input, int type,
+                                           int numComponents, bool inPlace)
+{
+  vtkSmartPointer<vtkDataArray> output;
+  output.TakeReference(vtkDataArray::CreateDataArray(type));
+  output->SetNumberOfComponents(numComponents);
+  output->SetName(input->GetName());
+  const vtkIdType numTuples = input->GetNumberOfTuples();
+  if (!inPlace) {
+    output->SetNumberOfTuples(numTuples);
+    return output;
+  }
+
+  void* buffer = input->GetVoidPointer(0);
+  {
+    QMutexLocker lock(&ownersMutex);
+    auto& owner = owners[buffer];
+    if (owner.users++ == 0) {
+      owner.array = input;
+    }
+  }
+  output->SetVoidArray(buffer, numTuples * numComponents, 0,
+                       vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+  output->SetArrayFreeFunction(releaseBuffer);
+  return output;
+}
+
+template <typename In>
+void convertToFloat(const In* input, vtkDataArray* output, vtkIdType count)
+{
+  tomviz::ArrayConversion::convert(
+    input, static_cast<float*>(output->GetVoidPointer(0)), count);
+}
+
+template <typename In, typename Out>
+void rescaleComponent(const In* input, vtkIdType numTuples, int numComponents,
+                      int component, vtkDataArray* output)
+{
+  double range[2];
+  auto values = static_cast<Out*>(output->GetVoidPointer(0));
+  tomviz::ArrayConversion::finiteRange(input, numTuples, numComponents,
+                                       component, range);
+  tomviz::ArrayConversion::rescale(input, numTuples, numComponents, component,
+                                   range, values);
+}
+} // namespace
+
+namespace tomviz {
+
+vtkSmartPointer<vtkDataArray> ArrayConversion::toFloat(vtkDataArray* array,
+                                                       bool inPlace)
+{
+  if (!array) {
+    return nullptr;
+  }
+  if (array->GetDataType() == VTK_FLOAT) {
+    return array;
+  }
+
+  const int numComponents = array->GetNumberOfComponents();
+  inPlace = inPlace && canReuse(array, VTK_FLOAT, numComponents);
+  auto input = array->GetVoidPointer(0);
+  auto output = createOutput(array, VTK_FLOAT, numComponents, inPlace);
+  const vtkIdType count = array->GetNumberOfTuples() * numComponents;
+  switch (array->GetDataType()) {
+    vtkTemplateMacro(
+      convertToFloat(static_cast<const VTK_TT*>(input), output, count));
+    default:
+      return nullptr;
+  }
+  return output;
+}
+
+vtkSmartPointer<vtkDataArray> ArrayConversion::rescaleComponent(
+  vtkDataArray* array, int component, int type, bool inPlace)
+{
+  if (!array || component < 0 ||
+      component >= array->GetNumberOfComponents() ||
+      (type != VTK_TYPE_UINT8 && type != VTK_TYPE_UINT16)) {
+    return nullptr;
+  }
+
+  inPlace = inPlace && canReuse(array, type, 1);
+  auto input = array->GetVoidPointer(0);
+  auto output = createOutput(array, type, 1, inPlace);
+  const vtkIdType numTuples = array->GetNumberOfTuples();
+  const int numComponents = array->GetNumberOfComponents();
+  if (type == VTK_TYPE_UINT8) {
+    switch (array->GetDataType()) {
+      vtkTemplateMacro(
+        (rescaleComponent<VTK_TT, vtkTypeUInt8>(static_cast<const VTK_TT*>(
+          input), numTuples, numComponents, component, output)));
+      default:
+        return nullptr;
+    }
+  } else {
+    switch (array->GetDataType()) {
+      vtkTemplateMacro(
+        (rescaleComponent<VTK_TT, vtkTypeUInt16>(static_cast<const VTK_TT*>(
+          input), numTuples, numComponents, component, output)));
+      default:
+        return nullptr;
+    }
+  }
+  return output;
+}
+
+} // namespace tomviz
@@ -0,0 +1,218 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizArrayConversion_h
+#define tomvizArrayConversion_h
+
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkType.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+class vtkDataArray;
+
+namespace tomviz {
+
+/// Conversion of the values of arrays to another type, shared by the
+/// operators that change the type of the scalars. The values are processed
+/// in parallel, by plain loops over contiguous values that the compiler
+/// vectorizes.
+///
+/// The output may be the input, its buffer reused, when the output values are
+/// not larger than the input tuples: the values are then converted in rounds
+/// whose output never overlaps the input tuples still to be read.
+class ArrayConversion
+{
+public:
+  /// Values are processed in chunks of this many tuples, the reductions are
+  /// merged in order so they do not depend on the number of threads.
+  static const vtkIdType ChunkSize = 1 << 16;
+
+  /// Convert the \p numValues values of \p input to the type of \p output.
+  template <typename In, typename Out>
+  static void convert(const In* input, Out* output, vtkIdType numValues);
+
+  /// The range of the finite values of \p component, in one pass over the
+  /// values. Returns false, with both ends 0, if there are no such values.
+  template <typename T>
+  static bool finiteRange(const T* values, vtkIdType numTuples,
+                          int numComponents, int component, double range[2]);
+
+  /// Rescale \p component from \p range to the full range of the unsigned
+  /// integer type of \p output, rounding to the nearest integer. Values out
+  /// of the range are clamped, NaN are 0.
+  template <typename In, typename Out>
+  static void rescale(const In* input, vtkIdType numTuples, int numComponents,
+                      int component, const double range[2], Out* output);
+
+  /// A float array holding the values of \p array, or the array itself if
+  /// it is one already. If \p inPlace is true, the buffer of \p array is
+  /// reused when it is at least as large and the array has a single
+  /// reference, that of its data set. Its values are then lost. Returns
+  /// nullptr on failure.
+  static vtkSmartPointer<vtkDataArray> toFloat(vtkDataArray* array,
+                                               bool inPlace = false);
+
+  /// A single component array of the unsigned integer \p type, VTK_TYPE_UINT8
+  /// or VTK_TYPE_UINT16, with \p component of \p array rescaled from its
+  /// finite range to the full range of the type. \p inPlace is as for
+  /// toFloat(). Returns nullptr on failure.
+  static vtkSmartPointer<vtkDataArray> rescaleComponent(vtkDataArray* array,
+                                                        int component,
+                                                        int type,
+                                                        bool inPlace = false);
+
+private:
+  // Apply \p function to \p component of the tuples of \p input.
+  template <typename In, typename Out, typename Function>
+  static void transform(const In* input, vtkIdType numTuples,
+                        int numComponents, int component, Out* output,
+                        Function function);
+
+  template <typename T>
+  static bool isFinite(T value, std::true_type)
+  {
+    return std::isfinite(value);
+  }
+
+  template <typename T>
+  static bool isFinite(T, std::false_type)
+  {
+    return true;
+  }
+};
+
+template <typename In, typename Out, typename Function>
+void ArrayConversion::transform(const In* input, vtkIdType numTuples,
+                                int numComponents, int component, Out* output,
+                                Function function)
+{
+  const In* values = input + component;
+  auto apply = [=](vtkIdType begin, vtkIdType end) {
+    // Separate loops, so the contiguous one is vectorized.
+    if (numComponents == 1) {
+      for (vtkIdType i = begin; i < end; ++i) {
+        output[i] = function(values[i]);
+      }
+    } else {
+      for (vtkIdType i = begin; i < end; ++i) {
+        output[i] = function(values[i * numComponents]);
+      }
+    }
+  };
+
+  const void* inputBytes = input;
+  const void* outputBytes = output;
+  const vtkIdType inTupleSize =
+    static_cast<vtkIdType>(sizeof(In)) * numComponents;
+  const vtkIdType outTupleSize = sizeof(Out);
+  if (inputBytes != outputBytes || inTupleSize == outTupleSize) {
+    // Each output value is written where its input value was, if anywhere.
+    vtkSMPTools::For(0, numTuples, apply);
+    return;
+  }
+
+  // The output is narrower than the input tuples. The output of the tuples
+  // [begin, end) ends at or before the input of the tuple begin, so it only
+  // overlaps the input of the tuples before begin, which were converted
+  // already. A round of a single tuple reads its input before writing.
+  for (vtkIdType begin = 0; begin < numTuples;) {
+    const vtkIdType end = std::min(
+      numTuples,
+      std::max(begin + 1, begin * inTupleSize / outTupleSize));
+    if (end - begin == 1) {
+      apply(begin, end);
+    } else {
+      vtkSMPTools::For(begin, end, apply);
+    }
+    begin = end;
+  }
+}
+
+template <typename In, typename Out>
+void ArrayConversion::convert(const In* input, Out* output,
+                              vtkIdType numValues)
+{
+  transform(input, numValues, 1, 0, output,
+            [](In value) { return static_cast<Out>(value); });
+}
+
+template <typename T>
+bool ArrayConversion::finiteRange(const T* values, vtkIdType numTuples,
+                                  int numComponents, int component,
+                                  double range[2])
+{
+  typedef typename std::is_floating_point<T>::type Floating;
+  const vtkIdType numChunks = (numTuples + ChunkSize - 1) / ChunkSize;
+  std::vector<T> minima(numChunks, std::numeric_limits<T>::max());
+  std::vector<T> maxima(numChunks, std::numeric_limits<T>::lowest());
+  std::vector<char> found(numChunks, 0);
+
+  vtkSMPTools::For(0, numChunks, [&](vtkIdType first, vtkIdType last) {
+    for (vtkIdType chunk = first; chunk < last; ++chunk) {
+      const vtkIdType end = std::min(numTuples, (chunk + 1) * ChunkSize);
+      const T* value = values + chunk * ChunkSize * numComponents + component;
+      T minimum = minima[chunk];
+      T maximum = maxima[chunk];
+      bool any = false;
+      for (vtkIdType i = chunk * ChunkSize; i < end; ++i) {
+        if (isFinite(*value, Floating())) {
+          minimum = std::min(minimum, *value);
+          maximum = std::max(maximum, *value);
+          any = true;
+        }
+        value += numComponents;
+      }
+      minima[chunk] = minimum;
+      maxima[chunk] = maximum;
+      found[chunk] = any;
+    }
+  });
+
+  range[0] = range[1] = 0.0;
+  bool any = false;
+  for (vtkIdType chunk = 0; chunk < numChunks; ++chunk) {
+    if (!found[chunk]) {
+      continue;
+    }
+    const double minimum = static_cast<double>(minima[chunk]);
+    const double maximum = static_cast<double>(maxima[chunk]);
+    range[0] = any ? std::min(range[0], minimum) : minimum;
+    range[1] = any ? std::max(range[1], maximum) : maximum;
+    any = true;
+  }
+  return any;
+}
+
+template <typename In, typename Out>
+void ArrayConversion::rescale(const In* input, vtkIdType numTuples,
+                              int numComponents, int component,
+                              const double range[2], Out* output)
+{
+  static_assert(std::is_integral<Out>::value && std::is_unsigned<Out>::value,
+                "The output type must be an unsigned integer type.");
+
+  // new = (old - oldmin) / oldrange * newrange + newmin, where newmin is 0
+  // and newrange the largest value of the output type.
+  const double maximum = std::numeric_limits<Out>::max();
+  const double minimum = range[0];
+  const double multiplier =
+    range[1] > range[0] ? maximum / (range[1] - range[0]) : 0.0;
+  transform(input, numTuples, numComponents, component, output,
+            [=](In value) {
+              // Add 0.5 so the truncation rounds to the nearest integer, the
+              // comparisons send NaN to 0.
+              double scaled = (value - minimum) * multiplier + 0.5;
+              scaled = scaled > 0.0 ? scaled : 0.0;
+              scaled = scaled < maximum ? scaled : maximum;
+              return static_cast<Out>(scaled);
+            });
+}
+} // namespace tomviz
+
+#endif
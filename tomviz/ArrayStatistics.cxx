@@ -0,0 +1,233 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "ArrayStatistics.h"
+
+#include <vtkDataArray.h>
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Tuples are processed in fixed size chunks, the chunk results are merged in
+// order so the statistics do not depend on the number of threads.
+const vtkIdType ChunkSize = 1 << 16;
+
+template <typename T>
+double columnValue(const T* tuple, int numComps, int column)
+{
+  if (column < numComps) {
+    return static_cast<double>(tuple[column]);
+  }
+
+  double sum = 0.0;
+  for (int c = 0; c < numComps; ++c) {
+    double value = static_cast<double>(tuple[c]);
+    sum += value * value;
+  }
+  return std::sqrt(sum);
+}
+} // namespace
+
+namespace tomviz {
+
+ArrayStatistics::Summary::Summary()
+  : min(std::numeric_limits<double>::infinity()),
+    max(-std::numeric_limits<double>::infinity()),
+    finiteMin(std::numeric_limits<double>::infinity()),
+    finiteMax(-std::numeric_limits<double>::infinity())
+{
+}
+
+void ArrayStatistics::Summary::merge(const Summary& other)
+{
+  min = std::min(min, other.min);
+  max = std::max(max, other.max);
+  finiteMin = std::min(finiteMin, other.finiteMin);
+  finiteMax = std::max(finiteMax, other.finiteMax);
+  nanCount += other.nanCount;
+  if (other.finiteCount == 0) {
+    return;
+  }
+
+  // Pairwise update of the moments (Chan et al.), stable for large counts.
+  const double count = static_cast<double>(finiteCount + other.finiteCount);
+  const double delta = other.mean - mean;
+  const double weight = static_cast<double>(other.finiteCount) / count;
+  m2 += other.m2 + delta * delta * finiteCount * weight;
+  mean += delta * weight;
+  finiteCount += other.finiteCount;
+}
+
+ArrayStatistics::ArrayStatistics(vtkDataArray* array)
+{
+  if (!array || array->GetNumberOfComponents() < 1) {
+    return;
+  }
+
+  m_arrayMTime = array->GetMTime();
+  m_numberOfComponents = array->GetNumberOfComponents();
+  m_summaries.resize(m_numberOfComponents > 1 ? m_numberOfComponents + 1 : 1);
+
+  switch (array->GetDataType()) {
+    vtkTemplateMacro(
+      compute(static_cast<const VTK_TT*>(array->GetVoidPointer(0)),
+              array->GetNumberOfTuples()));
+    default:
+      return;
+  }
+  m_valid = true;
+}
+
+template <typename T>
+void ArrayStatistics::compute(const T* values, vtkIdType numTuples)
+{
+  const int numComps = m_numberOfComponents;
+  const int numColumns = static_cast<int>(m_summaries.size());
+  const vtkIdType numChunks = (numTuples + ChunkSize - 1) / ChunkSize;
+  const vtkIdType stride =
+    std::max<vtkIdType>(1, (numTuples + MaxSamples - 1) / MaxSamples);
+  const vtkIdType numSamples = (numTuples + stride - 1) / stride;
+
+  std::vector<Summary> chunks(numChunks * numColumns);
+  // Sampled values, NaN marks the values that are not finite.
+  std::vector<double> samples(numSamples * numColumns,
+                              std::numeric_limits<double>::quiet_NaN());
+
+  vtkSMPTools::For(0, numChunks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk) {
+      const vtkIdType t0 = chunk * ChunkSize;
+      const vtkIdType t1 = std::min(t0 + ChunkSize, numTuples);
+      for (int column = 0; column < numColumns; ++column) {
+        Summary& summary = chunks[chunk * numColumns + column];
+        vtkIdType nextSample = (t0 + stride - 1) / stride * stride;
+        double sum = 0.0;
+        for (vtkIdType t = t0; t < t1; ++t) {
+          double value = columnValue(values + t * numComps, numComps, column);
+          if (std::isnan(value)) {
+            ++summary.nanCount;
+          } else {
+            summary.min = std::min(summary.min, value);
+            summary.max = std::max(summary.max, value);
+            if (std::isfinite(value)) {
+              summary.finiteMin = std::min(summary.finiteMin, value);
+              summary.finiteMax = std::max(summary.finiteMax, value);
+              ++summary.finiteCount;
+              sum += value;
+              if (t == nextSample) {
+                samples[(t / stride) * numColumns + column] = value;
+              }
+            }
+          }
+          if (t == nextSample) {
+            nextSample += stride;
+          }
+        }
+
+        if (summary.finiteCount == 0) {
+          continue;
+        }
+
+        // The chunk is still in cache, a second pass gives accurate moments.
+        summary.mean = sum / summary.finiteCount;
+        for (vtkIdType t = t0; t < t1; ++t) {
+          double value = columnValue(values + t * numComps, numComps, column);
+          if (std::isfinite(value)) {
+            summary.m2 += (value - summary.mean) * (value - summary.mean);
+          }
+        }
+      }
+    }
+  });
+
+  for (int column = 0; column < numColumns; ++column) {
+    Summary& summary = m_summaries[column];
+    for (vtkIdType chunk = 0; chunk < numChunks; ++chunk) {
+      summary.merge(chunks[chunk * numColumns + column]);
+    }
+
+    for (vtkIdType i = 0; i < numSamples; ++i) {
+      double value = samples[i * numColumns + column];
+      if (!std::isnan(value)) {
+        summary.sample.push_back(value);
+      }
+    }
+    std::sort(summary.sample.begin(), summary.sample.end());
+  }
+}
+
+const ArrayStatistics::Summary* ArrayStatistics::summary(int component) const
+{
+  if (!m_valid || component >= m_numberOfComponents) {
+    return nullptr;
+  }
+  if (component < 0) {
+    return &m_summaries.back();
+  }
+  return &m_summaries[component];
+}
+
+void ArrayStatistics::range(double range[2], int component) const
+{
+  range[0] = range[1] = 0.0;
+  auto s = summary(component);
+  if (s && s->min <= s->max) {
+    range[0] = s->min;
+    range[1] = s->max;
+  }
+}
+
+void ArrayStatistics::finiteRange(double range[2], int component) const
+{
+  range[0] = range[1] = 0.0;
+  auto s = summary(component);
+  if (s && s->finiteCount > 0) {
+    range[0] = s->finiteMin;
+    range[1] = s->finiteMax;
+  }
+}
+
+double ArrayStatistics::mean(int component) const
+{
+  auto s = summary(component);
+  return s ? s->mean : 0.0;
+}
+
+double ArrayStatistics::variance(int component) const
+{
+  auto s = summary(component);
+  return s && s->finiteCount > 0 ? s->m2 / s->finiteCount : 0.0;
+}
+
+vtkIdType ArrayStatistics::finiteCount(int component) const
+{
+  auto s = summary(component);
+  return s ? s->finiteCount : 0;
+}
+
+vtkIdType ArrayStatistics::nanCount(int component) const
+{
+  auto s = summary(component);
+  return s ? s->nanCount : 0;
+}
+
+double ArrayStatistics::percentile(double p, int component) const
+{
+  auto s = summary(component);
+  if (!s || s->sample.empty()) {
+    return 0.0;
+  }
+
+  // Linear interpolation between the closest ranks.
+  const double position = std::min(std::max(p, 0.0), 100.0) / 100.0 *
+                          (s->sample.size() - 1);
+  const size_t lower = static_cast<size_t>(position);
+  const size_t upper = std::min(lower + 1, s->sample.size() - 1);
+  const double fraction = position - lower;
+  return s->sample[lower] + (s->sample[upper] - s->sample[lower]) * fraction;
+}
+
+} // namespace tomviz
@@ -0,0 +1,93 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizArrayStatistics_h
+#define tomvizArrayStatistics_h
+
+#include <vtkType.h>
+
+#include <vector>
+
+class vtkDataArray;
+
+namespace tomviz {
+
+/// Summary statistics of a data array, computed in a single parallel pass:
+/// the range, the finite range, the mean and variance of the finite values,
+/// the number of NaN values and approximate percentiles. They are available
+/// for every component and, for arrays with more than one component, for the
+/// magnitude of the tuples.
+///
+/// The component arguments follow vtkDataArray::GetRange(), a negative
+/// component selects the magnitude (the only component of single component
+/// arrays).
+class ArrayStatistics
+{
+public:
+  /// Percentiles are estimated from an evenly strided sample of at most this
+  /// many tuples, they are exact for smaller arrays.
+  static const vtkIdType MaxSamples = 1 << 18;
+
+  explicit ArrayStatistics(vtkDataArray* array);
+
+  /// Returns true if the statistics were computed successfully.
+  bool isValid() const { return m_valid; }
+
+  /// The modified time of the array when the statistics were computed.
+  vtkMTimeType arrayMTime() const { return m_arrayMTime; }
+
+  int numberOfComponents() const { return m_numberOfComponents; }
+
+  /// Range of the values, ignoring NaN like vtkDataArray::GetRange(). Both
+  /// ends are 0 if there are no such values.
+  void range(double range[2], int component = -1) const;
+
+  /// Range of the finite values, like vtkDataArray::GetFiniteRange(). Both
+  /// ends are 0 if there are no finite values.
+  void finiteRange(double range[2], int component = -1) const;
+
+  /// Mean and variance (population) of the finite values.
+  double mean(int component = -1) const;
+  double variance(int component = -1) const;
+
+  /// Number of finite and NaN values.
+  vtkIdType finiteCount(int component = -1) const;
+  vtkIdType nanCount(int component = -1) const;
+
+  /// The \p p th percentile, with \p p in [0, 100], of the finite values.
+  double percentile(double p, int component = -1) const;
+
+private:
+  struct Summary
+  {
+    double min;
+    double max;
+    double finiteMin;
+    double finiteMax;
+    double mean = 0.0;
+    // Sum of the squared differences from the mean.
+    double m2 = 0.0;
+    vtkIdType finiteCount = 0;
+    vtkIdType nanCount = 0;
+    // Sorted finite values of the sample.
+    std::vector<double> sample;
+
+    Summary();
+    void merge(const Summary& other);
+  };
+
+  template <typename T>
+  void compute(const T* values, vtkIdType numTuples);
+
+  const Summary* summary(int component) const;
+
+  bool m_valid = false;
+  vtkMTimeType m_arrayMTime = 0;
+  int m_numberOfComponents = 0;
+  // One summary per component followed, for multi-component arrays, by the
+  // summary of the magnitude.
+  std::vector<Summary> m_summaries;
+};
+} // namespace tomviz
+
+#endif
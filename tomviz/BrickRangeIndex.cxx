@@ -0,0 +1,179 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "BrickRangeIndex.h"
+
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+template <typename T>
+void computeBrickRanges(const T* values, const int dims[3], int brickSize,
+                        const int brickDims[3], double* ranges)
+{
+  const vtkIdType sliceSize = static_cast<vtkIdType>(dims[0]) * dims[1];
+  const vtkIdType numBricks =
+    static_cast<vtkIdType>(brickDims[0]) * brickDims[1] * brickDims[2];
+
+  vtkSMPTools::For(0, numBricks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType b = begin; b < end; ++b) {
+      int bi = static_cast<int>(b % brickDims[0]);
+      int bj = static_cast<int>((b / brickDims[0]) % brickDims[1]);
+      int bk = static_cast<int>(b / (static_cast<vtkIdType>(brickDims[0]) *
+                                     brickDims[1]));
+
+      // Bricks overlap by one plane of points so cells spanning two bricks
+      // are always fully contained in one of them.
+      int i0 = bi * brickSize, i1 = std::min(i0 + brickSize, dims[0] - 1);
+      int j0 = bj * brickSize, j1 = std::min(j0 + brickSize, dims[1] - 1);
+      int k0 = bk * brickSize, k1 = std::min(k0 + brickSize, dims[2] - 1);
+
+      T min = std::numeric_limits<T>::max();
+      T max = std::numeric_limits<T>::lowest();
+      bool found = false;
+      for (int k = k0; k <= k1; ++k) {
+        for (int j = j0; j <= j1; ++j) {
+          const T* row = values + k * sliceSize +
+                         static_cast<vtkIdType>(j) * dims[0];
+          for (int i = i0; i <= i1; ++i) {
+            T value = row[i];
+            // Skips NaN for floating point types, always true otherwise.
+            if (value == value) {
+              min = std::min(min, value);
+              max = std::max(max, value);
+              found = true;
+            }
+          }
+        }
+      }
+
+      if (found) {
+        ranges[2 * b] = static_cast<double>(min);
+        ranges[2 * b + 1] = static_cast<double>(max);
+      } else {
+        // An empty range never intersects a query.
+        ranges[2 * b] = std::numeric_limits<double>::infinity();
+        ranges[2 * b + 1] = -std::numeric_limits<double>::infinity();
+      }
+    }
+  });
+}
+} // namespace
+
+namespace tomviz {
+
+BrickRangeIndex::BrickRangeIndex(vtkImageData* image, vtkDataArray* array,
+                                 int brickSize)
+  : m_brickSize(std::max(brickSize, 1))
+{
+  if (!image || !array || array->GetNumberOfComponents() != 1 ||
+      array->GetNumberOfTuples() != image->GetNumberOfPoints() ||
+      image->GetNumberOfPoints() == 0) {
+    return;
+  }
+
+  image->GetExtent(m_extent);
+  int dims[3];
+  image->GetDimensions(dims);
+  for (int i = 0; i < 3; ++i) {
+    // A dimension of one point still needs one brick.
+    m_brickDims[i] = std::max((dims[i] - 2) / m_brickSize + 1, 1);
+  }
+
+  m_ranges.resize(2 * numberOfBricks());
+  switch (array->GetDataType()) {
+    vtkTemplateMacro(computeBrickRanges(
+      static_cast<const VTK_TT*>(array->GetVoidPointer(0)), dims, m_brickSize,
+      m_brickDims, m_ranges.data()));
+    default:
+      return;
+  }
+
+  m_arrayMTime = array->GetMTime();
+  m_array = array;
+  m_valid = true;
+}
+
+vtkIdType BrickRangeIndex::numberOfBricks() const
+{
+  return static_cast<vtkIdType>(m_brickDims[0]) * m_brickDims[1] *
+         m_brickDims[2];
+}
+
+vtkIdType BrickRangeIndex::countActiveBricks(double min, double max) const
+{
+  vtkIdType count = 0;
+  const vtkIdType numBricks = numberOfBricks();
+  for (vtkIdType b = 0; b < numBricks; ++b) {
+    if (m_ranges[2 * b] <= max && m_ranges[2 * b + 1] >= min) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+bool BrickRangeIndex::activeExtent(double min, double max,
+                                   int extent[6]) const
+{
+  if (!m_valid) {
+    return false;
+  }
+
+  int lo[3] = { m_brickDims[0], m_brickDims[1], m_brickDims[2] };
+  int hi[3] = { -1, -1, -1 };
+  vtkIdType b = 0;
+  for (int k = 0; k < m_brickDims[2]; ++k) {
+    for (int j = 0; j < m_brickDims[1]; ++j) {
+      for (int i = 0; i < m_brickDims[0]; ++i, ++b) {
+        if (m_ranges[2 * b] <= max && m_ranges[2 * b + 1] >= min) {
+          lo[0] = std::min(lo[0], i);
+          lo[1] = std::min(lo[1], j);
+          lo[2] = std::min(lo[2], k);
+          hi[0] = std::max(hi[0], i);
+          hi[1] = std::max(hi[1], j);
+          hi[2] = std::max(hi[2], k);
+        }
+      }
+    }
+  }
+
+  if (hi[0] < 0) {
+    return false;
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    extent[2 * i] = m_extent[2 * i] + lo[i] * m_brickSize;
+    extent[2 * i + 1] = std::min(m_extent[2 * i] + (hi[i] + 1) * m_brickSize,
+                                 m_extent[2 * i + 1]);
+  }
+  return true;
+}
+
+bool BrickRangeIndex::isCurrent(vtkDataArray* array) const
+{
+  return array && m_array == array && m_arrayMTime == array->GetMTime();
+}
+
+bool BrickRangeIndex::isWholeExtent(const int extent[6]) const
+{
+  return std::equal(extent, extent + 6, m_extent);
+}
+
+bool BrickRangeIndex::coversMostOfImage(const int extent[6]) const
+{
+  double points = 1.0;
+  double wholePoints = 1.0;
+  for (int i = 0; i < 3; ++i) {
+    points *= std::max(extent[2 * i + 1] - extent[2 * i] + 1, 0);
+    wholePoints *= m_extent[2 * i + 1] - m_extent[2 * i] + 1;
+  }
+  return points > 0.5 * wholePoints;
+}
+
+} // namespace tomviz
@@ -0,0 +1,80 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizBrickRangeIndex_h
+#define tomvizBrickRangeIndex_h
+
+#include <vtkType.h>
+#include <vtkWeakPointer.h>
+
+#include <vector>
+
+class vtkDataArray;
+class vtkImageData;
+
+namespace tomviz {
+
+/// Coarse min/max acceleration structure over a single component image array.
+/// The volume is split into cubic bricks, and the value range of each brick is
+/// recorded. Bricks share their last plane of points with the next brick so
+/// that every cell is fully contained in at least one brick, this means any
+/// iso-surface or threshold query only needs to visit the bricks whose range
+/// intersects the query range.
+class BrickRangeIndex
+{
+public:
+  static const int DefaultBrickSize = 16;
+
+  /// Build the index for \p array, which must be a point data array of
+  /// \p image. Multi-component arrays are not indexed, isValid() will return
+  /// false for them.
+  BrickRangeIndex(vtkImageData* image, vtkDataArray* array,
+                  int brickSize = DefaultBrickSize);
+
+  /// Returns true if the index was built successfully.
+  bool isValid() const { return m_valid; }
+
+  /// The edge length (in points) of a brick.
+  int brickSize() const { return m_brickSize; }
+
+  /// Number of bricks along each axis.
+  const int* brickDimensions() const { return m_brickDims; }
+
+  /// Total number of bricks in the index.
+  vtkIdType numberOfBricks() const;
+
+  /// The modified time of the array when the index was built.
+  vtkMTimeType arrayMTime() const { return m_arrayMTime; }
+
+  /// Returns true if the index was built for \p array, as it is now. A
+  /// renamed or replaced array, or a modified one, needs a new index.
+  bool isCurrent(vtkDataArray* array) const;
+
+  /// Returns the number of bricks whose range intersects [min, max].
+  vtkIdType countActiveBricks(double min, double max) const;
+
+  /// Compute the union of the point extents of all the bricks whose range
+  /// intersects [min, max]. Returns false if no brick intersects the range.
+  bool activeExtent(double min, double max, int extent[6]) const;
+
+  /// Returns true if \p extent covers the whole extent of the indexed image.
+  bool isWholeExtent(const int extent[6]) const;
+
+  /// Returns true if \p extent holds more than half of the points of the
+  /// indexed image. Active bricks far apart have such a bounding extent,
+  /// extracting it then costs more than processing the whole image.
+  bool coversMostOfImage(const int extent[6]) const;
+
+private:
+  bool m_valid = false;
+  int m_brickSize = DefaultBrickSize;
+  int m_extent[6] = { 0, -1, 0, -1, 0, -1 };
+  int m_brickDims[3] = { 0, 0, 0 };
+  vtkMTimeType m_arrayMTime = 0;
+  vtkWeakPointer<vtkDataArray> m_array;
+  // Interleaved min/max for each brick, x fastest.
+  std::vector<double> m_ranges;
+};
+} // namespace tomviz
+
+#endif
@@ -27,6 +27,7 @@
 
 #include "AbstractDataModel.h"
 #include "ActiveObjects.h"
+#include "ArrayStatistics.h"
 #include "DataSource.h"
 #include "HistogramManager.h"
 #include "Module.h"
@@ -270,8 +271,11 @@ void CentralWidget::setColorMapDataSource(DataSource* source)
   m_ui->histogram2DWidget->updateTransfer2D();
 
   vtkSmartPointer<vtkImageData> const imageSP = image;
-  auto histogram = HistogramManager::instance().getHistogram(imageSP);
-  auto histogram2D = HistogramManager::instance().getHistogram2D(imageSP);
+  auto statistics = source->statistics();
+  auto histogram =
+    HistogramManager::instance().getHistogram(imageSP, statistics);
+  auto histogram2D =
+    HistogramManager::instance().getHistogram2D(imageSP, statistics);
 
   if (histogram) {
     setHistogramTable(histogram);
@@ -4,11 +4,17 @@
 #ifndef tomvizComputeHistogram_h
 #define tomvizComputeHistogram_h
 
+#include <vtkAOSDataArrayTemplate.h>
 #include <vtkDoubleArray.h>
 #include <vtkImageData.h>
 #include <vtkMath.h>
+#include <vtkPointData.h>
 
 #include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 namespace tomviz {
 
@@ -31,8 +37,8 @@ void calcHistogram(T*, const vtkIdType, uint64_t*)
 }
 
 /** Single component unsigned char covering 0 -> 255 range. */
-void calcHistogram(unsigned char* values, const vtkIdType numTuples,
-                   uint64_t* pops)
+inline void calcHistogram(unsigned char* values, const vtkIdType numTuples,
+                          uint64_t* pops)
 {
   for (vtkIdType j = 0; j < numTuples; ++j) {
     ++pops[*values++];
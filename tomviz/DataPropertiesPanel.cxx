@@ -9,6 +9,7 @@
 #include <iterator>
 
 #include "ActiveObjects.h"
+#include "ArrayStatistics.h"
 #include "DataSource.h"
 #include "SetTiltAnglesOperator.h"
 #include "SetTiltAnglesReaction.h"
@@ -273,6 +274,7 @@ QList<ArrayInfo> DataPropertiesPanel::getArraysInfo(DataSource* dataSource)
     // name, type, data range, data type, active
     auto arrayName = dataSource->scalarsName(i);
     auto array = dataSource->getScalarsArray(arrayName);
+    auto stats = dataSource->statistics(arrayName);
     QString dataType = vtkImageScalarTypeNameMacro(array->GetDataType());
     int numComponents = array->GetNumberOfComponents();
     QString dataRange;
@@ -283,7 +285,11 @@ QList<ArrayInfo> DataPropertiesPanel::getArraysInfo(DataSource* dataSource)
       if (j != 0) {
         dataRange.append(", ");
       }
-      array->GetRange(range, j);
+      if (stats) {
+        stats->range(range, j);
+      } else {
+        array->GetRange(range, j);
+      }
       QString componentRange = QString("[%1, %2]").arg(range[0]).arg(range[1]);
       dataRange.append(componentRange);
     }
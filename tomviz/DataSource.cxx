@@ -6,16 +6,20 @@
 #include "core/DataSourceBase.h"
 
 #include "ActiveObjects.h"
+#include "ArrayStatistics.h"
+#include "BrickRangeIndex.h"
 #include "ColorMap.h"
 #include "DataExchangeFormat.h"
 #include "EmdFormat.h"
 #include "GenericHDF5Format.h"
+#include "ImagePyramid.h"
 #include "ModuleFactory.h"
 #include "ModuleManager.h"
 #include "Operator.h"
 #include "OperatorFactory.h"
 #include "Pipeline.h"
 #include "Utilities.h"
+#include "vtkActiveScalarsProducer.h"
 
 #include <vtkDataObject.h>
 #include <vtkDoubleArray.h>
@@ -96,6 +100,14 @@ public:
   bool Forkable = true;
   // Track data array renames
   QMap<QString, QString> CurrentToOriginal;
+  // Array statistics shared by the consumers, keyed on array name
+  QMap<QString, QSharedPointer<ArrayStatistics>> Statistics;
+  // Brick min/max indices shared by the modules, keyed on array name
+  QMap<QString, QSharedPointer<BrickRangeIndex>> BrickIndices;
+  // Multiresolution pyramid shared by the modules
+  QSharedPointer<ImagePyramid> Pyramid;
+  // Active scalars filters shared by the modules, keyed on array name
+  QMap<QString, vtkSmartPointer<vtkActiveScalarsProducer>> ScalarsProducers;
 
   // Checks if the tilt angles data array exists on the given VTK data
   // and creates it if it does not exist.
@@ -676,6 +688,14 @@ void DataSource::getBounds(double bounds[6])
   }
 }
 
+void DataSource::getRange(double range[2])
+{
+  range[0] = range[1] = 0.0;
+  if (auto stats = statistics()) {
+    stats->finiteRange(range, -1);
+  }
+}
+
 void DataSource::getRange(vtkImageData* imageData, double range[2])
 {
   for (int i = 0; i < 2; ++i) {
@@ -853,6 +873,17 @@ void DataSource::renameScalarsArray(const QString& oldName,
 
   dataArray->SetName(newName.toLatin1().data());
 
+  // The caches are by name
+  Internals->Statistics.remove(oldName);
+  Internals->BrickIndices.remove(oldName);
+
+  // Keep the shared filter, the modules look it up again on the signals below
+  auto scalarsProducer = Internals->ScalarsProducers.take(oldName);
+  if (scalarsProducer) {
+    scalarsProducer->SetActiveScalars(newName.toLatin1().data());
+    Internals->ScalarsProducers[newName] = scalarsProducer;
+  }
+
   if (isCurrentScalars) {
     setActiveScalars(newName);
   } else {
@@ -886,6 +917,79 @@ vtkDataArray* DataSource::getScalarsArray(const QString& arrayName) const
   return pointData->GetScalars(arrayName.toLatin1().data());
 }
 
+QSharedPointer<ArrayStatistics> DataSource::statistics(
+  const QString& arrayName)
+{
+  auto array = getScalarsArray(arrayName);
+  if (!array) {
+    return QSharedPointer<ArrayStatistics>();
+  }
+
+  auto stats = this->Internals->Statistics.value(arrayName);
+  if (stats && stats->arrayMTime() == array->GetMTime()) {
+    return stats;
+  }
+
+  stats.reset(new ArrayStatistics(array));
+  if (!stats->isValid()) {
+    stats.reset();
+  }
+  this->Internals->Statistics[arrayName] = stats;
+  return stats;
+}
+
+QSharedPointer<ArrayStatistics> DataSource::statistics()
+{
+  return statistics(activeScalars());
+}
+
+QSharedPointer<BrickRangeIndex> DataSource::brickRangeIndex(
+  const QString& arrayName)
+{
+  auto array = getScalarsArray(arrayName);
+  if (!array) {
+    return QSharedPointer<BrickRangeIndex>();
+  }
+
+  auto index = this->Internals->BrickIndices.value(arrayName);
+  if (index && index->isCurrent(array)) {
+    return index;
+  }
+
+  index.reset(new BrickRangeIndex(imageData(), array));
+  if (!index->isValid()) {
+    index.reset();
+  }
+  this->Internals->BrickIndices[arrayName] = index;
+  return index;
+}
+
+QSharedPointer<ImagePyramid> DataSource::imagePyramid()
+{
+  auto image = imageData();
+  if (!image) {
+    return QSharedPointer<ImagePyramid>();
+  }
+
+  auto& pyramid = this->Internals->Pyramid;
+  if (!pyramid || pyramid->inputMTime() != image->GetMTime()) {
+    pyramid.reset(new ImagePyramid(image));
+  }
+  return pyramid;
+}
+
+vtkActiveScalarsProducer* DataSource::activeScalarsProducer(
+  const QString& arrayName)
+{
+  auto& scalarsProducer = this->Internals->ScalarsProducers[arrayName];
+  if (!scalarsProducer) {
+    scalarsProducer = vtkSmartPointer<vtkActiveScalarsProducer>::New();
+    scalarsProducer->SetInputConnection(producer()->GetOutputPort());
+    scalarsProducer->SetActiveScalars(arrayName.toLatin1().data());
+  }
+  return scalarsProducer;
+}
+
 unsigned int DataSource::getNumberOfComponents()
 {
   unsigned int numComponents = 0;
@@ -1006,6 +1110,9 @@ void DataSource::dataModified()
   vtkDataObject* dObject = tp->GetOutputDataObject(0);
   dObject->Modified();
   this->Internals->ProducerProxy->MarkModified(nullptr);
+  this->Internals->Statistics.clear();
+  this->Internals->BrickIndices.clear();
+  this->Internals->Pyramid.reset();
 
   vtkFieldData* fd = dObject->GetFieldData();
   if (fd->HasArray("tomviz_data_source_type")) {
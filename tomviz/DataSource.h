@@ -8,6 +8,7 @@
 
 #include <QJsonObject>
 #include <QScopedPointer>
+#include <QSharedPointer>
 #include <QVariantMap>
 #include <QVector>
 
@@ -22,9 +23,13 @@ class vtkDataObject;
 class vtkPiecewiseFunction;
 class vtkAlgorithm;
 class vtkTrivialProducer;
+class vtkActiveScalarsProducer;
 
 namespace tomviz {
+class ArrayStatistics;
+class BrickRangeIndex;
 class DataSourceBase;
+class ImagePyramid;
 class Operator;
 class Pipeline;
 
@@ -236,8 +241,11 @@ public:
   void getExtent(int extent[6]);
   /// Returns the physical extent (bounds) of the transformed dataset
   void getBounds(double bounds[6]);
-  /// Returns the range of the transformed dataset
-  void getRange(double range[2]) { getRange(imageData(), range); }
+  /// Returns the finite range of the active scalars, from the cached
+  /// statistics.
+  void getRange(double range[2]);
+  /// Returns the finite range of the active scalars of \p data, this scans the
+  /// array on every call.
   static void getRange(vtkImageData* data, double range[2]);
   /// Returns the spacing of the transformed dataset
   void getSpacing(double spacing[3]) const;
@@ -263,6 +271,32 @@ public:
   // Get pointer to scalar array
   vtkDataArray* getScalarsArray(const QString& arrayName) const;
 
+  /// Returns the statistics (range, moments, percentiles...) of the named
+  /// scalars array. They are computed once, in parallel, and shared by all the
+  /// consumers until the data changes. Returns a null pointer if there is no
+  /// such array.
+  QSharedPointer<ArrayStatistics> statistics(const QString& arrayName);
+  /// Returns the statistics of the active scalars.
+  QSharedPointer<ArrayStatistics> statistics();
+
+  /// Returns the brick min/max index for the named scalars array. The index is
+  /// shared by all modules on this data source, it is built on first use and
+  /// discarded whenever the data changes. Returns a null pointer if the array
+  /// cannot be indexed (e.g. it has more than one component).
+  QSharedPointer<BrickRangeIndex> brickRangeIndex(const QString& arrayName);
+
+  /// Returns the multiresolution pyramid of the image data, used for level of
+  /// detail rendering and previews. The pyramid is shared by all modules on
+  /// this data source and discarded whenever the data changes, its levels are
+  /// built on demand. Returns a null pointer if there is no image data.
+  QSharedPointer<ImagePyramid> imagePyramid();
+
+  /// Returns a filter, connected to producer(), selecting the named array as
+  /// the active scalars. There is a single filter per array shared by all the
+  /// modules on this data source, it follows array renames and only executes
+  /// when the data changes.
+  vtkActiveScalarsProducer* activeScalarsProducer(const QString& arrayName);
+
   /// Returns the number of components in the dataset.
   unsigned int getNumberOfComponents();
 
@@ -14,6 +14,11 @@
 #include "ConvertToFloatReaction.h"
 #include "CropReaction.h"
 #include "DeleteDataReaction.h"
+#include "FourierTransformReaction.h"
+#include "LabelStatisticsReaction.h"
+#include "PoreSizeDistributionReaction.h"
+#include "TortuosityReaction.h"
+#include "TotalVariationReaction.h"
 #include "TransposeDataReaction.h"
 #include "Utilities.h"
 
@@ -62,6 +67,7 @@ void DataTransformMenu::buildTransforms()
   auto cropEdgesAction = menu->addAction("Clip Edges");
   auto hannWindowAction = menu->addAction("Hann Window");
   auto fftAbsLogAction = menu->addAction("FFT (abs log)");
+  auto bandPassAction = menu->addAction("Band Pass Filter");
   auto gradientMagnitudeSobelAction = menu->addAction("Gradient Magnitude");
   auto unsharpMaskAction = menu->addAction("Unsharp Mask");
   auto laplaceFilterAction = menu->addAction("Laplace Sharpen");
@@ -126,10 +132,13 @@ void DataTransformMenu::buildTransforms()
   new AddPythonTransformReaction(cropEdgesAction, "Clip Edges",
                                  readInPythonScript("ClipEdges"), false, true,
                                  false, readInJSONDescription("ClipEdges"));
-  new AddPythonTransformReaction(hannWindowAction, "Hann Window",
-                                 readInPythonScript("HannWindow3D"));
-  new AddPythonTransformReaction(fftAbsLogAction, "FFT (ABS LOG)",
-                                 readInPythonScript("FFT_AbsLog"));
+  new FourierTransformReaction(hannWindowAction,
+                               FourierTransformOperator::Filter::HannWindow,
+                               mainWindow);
+  new FourierTransformReaction(
+    fftAbsLogAction, FourierTransformOperator::Filter::AbsLog, mainWindow);
+  new FourierTransformReaction(
+    bandPassAction, FourierTransformOperator::Filter::BandPass, mainWindow);
   new AddPythonTransformReaction(gradientMagnitudeSobelAction,
                                  "Gradient Magnitude",
                                  readInPythonScript("GradientMagnitude_Sobel"));
@@ -141,9 +150,8 @@ void DataTransformMenu::buildTransforms()
   new AddPythonTransformReaction(
     wienerAction, "Wiener Filter", readInPythonScript("WienerFilter"), false,
     false, false, readInJSONDescription("WienerFilter"));
-  new AddPythonTransformReaction(TVminAction, "TV_Filter",
-                                 readInPythonScript("TV_Filter"), false, false,
-                                 false, readInJSONDescription("TV_Filter"));
+  new TotalVariationReaction(
+    TVminAction, TotalVariationOperator::Mode::ArtifactRemoval, mainWindow);
   new AddPythonTransformReaction(
     gaussianFilterAction, "Gaussian Blur", readInPythonScript("GaussianFilter"),
     false, false, false, readInJSONDescription("GaussianFilter"));
@@ -159,13 +167,8 @@ void DataTransformMenu::buildTransforms()
     moleculeAction, "Add Molecule", readInPythonScript("DummyMolecule"), false,
     false, false, readInJSONDescription("DummyMolecule"));
 
-  new AddPythonTransformReaction(
-    tortuosityAction, "Tortuosity", readInPythonScript("Tortuosity"), false,
-    false, false, readInJSONDescription("Tortuosity"));
-  new AddPythonTransformReaction(
-    poreSizeAction, "Pore Size Distribution",
-    readInPythonScript("PoreSizeDistribution"), false, false, false,
-    readInJSONDescription("PoreSizeDistribution"));
+  new TortuosityReaction(tortuosityAction, mainWindow);
+  new PoreSizeDistributionReaction(poreSizeAction, mainWindow);
 
   new CloneDataReaction(cloneAction);
   new DeleteDataReaction(deleteDataAction);
@@ -194,6 +197,7 @@ void DataTransformMenu::buildSegmentation()
     menu->addAction("Binary MinMax Curvature Flow");
   menu->addSeparator();
   auto labelObjectAttributesAction = menu->addAction("Label Object Attributes");
+  auto labelObjectStatisticsAction = menu->addAction("Label Object Statistics");
   auto labelObjectPrincipalAxesAction =
     menu->addAction("Label Object Principal Axes");
   auto distanceFromAxisAction =
@@ -236,6 +240,7 @@ void DataTransformMenu::buildSegmentation()
     labelObjectAttributesAction, "Label Object Attributes",
     readInPythonScript("LabelObjectAttributes"), false, false, false,
     readInJSONDescription("LabelObjectAttributes"));
+  new LabelStatisticsReaction(labelObjectStatisticsAction);
   new AddPythonTransformReaction(
     labelObjectPrincipalAxesAction, "Label Object Principal Axes",
     readInPythonScript("LabelObjectPrincipalAxes"), false, false, false,
@@ -0,0 +1,298 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "DirectFourierReconstruction.h"
+
+#include "FourierTransform.h"
+
+#include <vtkDataArray.h>
+#include <vtkMath.h>
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+using Complex = tomviz::FourierTransform::Complex;
+
+// Values of the kernel tabulated per grid cell.
+const int KernelSamples = 1024;
+
+// The shape of the Kaiser-Bessel kernel, from Beatty et al., IEEE TMI 24(6),
+// 2005, for a grid twice as large as the image.
+double kernelShape(int width)
+{
+  const double ratio = 2.0;
+  const double w = static_cast<double>(width) / ratio * (ratio - 0.5);
+  return vtkMath::Pi() * std::sqrt(w * w - 0.8);
+}
+
+// The modified Bessel function of the first kind of order 0.
+double besselI0(double x)
+{
+  double sum = 1.0;
+  double term = 1.0;
+  const double y = x * x / 4.0;
+  for (int k = 1; term > 1e-16 * sum; ++k) {
+    term *= y / (static_cast<double>(k) * k);
+    sum += term;
+  }
+  return sum;
+}
+
+// The angle covered by each projection, half the gaps to its neighbours.
+// When the projections cover the half circle the gaps wrap around it,
+// otherwise the first and last projections cover their inner gap twice.
+std::vector<double> angularWeights(const std::vector<double>& angles)
+{
+  const size_t n = angles.size();
+  std::vector<double> weights(n, vtkMath::Pi());
+  if (n < 2) {
+    return weights;
+  }
+
+  std::vector<size_t> order(n);
+  for (size_t i = 0; i < n; ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(),
+            [&angles](size_t a, size_t b) { return angles[a] < angles[b]; });
+
+  const double first = angles[order.front()];
+  const double last = angles[order.back()];
+  const double step = (last - first) / (n - 1);
+  const bool wraps = last - first + 1.5 * step > vtkMath::Pi();
+  const double wrapGap = std::max(first + vtkMath::Pi() - last, 0.0);
+  for (size_t i = 0; i < n; ++i) {
+    const double current = angles[order[i]];
+    double before = i > 0 ? current - angles[order[i - 1]] : 0.0;
+    double after = i + 1 < n ? angles[order[i + 1]] - current : 0.0;
+    if (i == 0) {
+      before = wraps ? wrapGap : after;
+    }
+    if (i + 1 == n) {
+      after = wraps ? wrapGap : before;
+    }
+    weights[order[i]] = (before + after) / 2.0;
+  }
+  return weights;
+}
+
+int wrap(int index, int size)
+{
+  index %= size;
+  return index < 0 ? index + size : index;
+}
+} // namespace
+
+namespace tomviz {
+
+DirectFourierReconstruction::DirectFourierReconstruction(
+  int numberOfRays, const std::vector<double>& tiltAngles)
+  : m_numberOfRays(numberOfRays),
+    m_numberOfTilts(static_cast<int>(tiltAngles.size())),
+    m_gridSize(2 * numberOfRays)
+{
+  const int n = m_numberOfRays;
+  const int m = m_gridSize;
+  const double beta = kernelShape(KernelWidth);
+
+  // The kernel integrates to 1 along each axis.
+  const double scale = beta / (KernelWidth * std::sinh(beta));
+  const int tableSize = KernelSamples * KernelWidth / 2;
+  m_kernel.resize(tableSize + 2, 0.0);
+  for (int i = 0; i <= tableSize; ++i) {
+    const double x = static_cast<double>(i) / tableSize;
+    m_kernel[i] = besselI0(beta * std::sqrt(1.0 - x * x)) * scale;
+  }
+
+  // The transform of the kernel, which the gridding multiplied the image by.
+  m_deapodization.resize(n);
+  for (int i = 0; i < n; ++i) {
+    const double x = vtkMath::Pi() * KernelWidth * (i - n / 2) / m;
+    const double s = std::sqrt(beta * beta - x * x);
+    m_deapodization[i] = std::sinh(beta) / beta * s / std::sinh(s);
+  }
+
+  // Rays start at -n / 2 while pixel centers, like in
+  // TomographyReconstruction::unweightedBackProjection2(), are offset by
+  // half a pixel for even sizes.
+  const double offset = 0.5 - (n / 2.0 - n / 2);
+  std::vector<double> angles(m_numberOfTilts);
+  for (int t = 0; t < m_numberOfTilts; ++t) {
+    angles[t] = vtkMath::RadiansFromDegrees(tiltAngles[t]);
+  }
+  const auto weights = angularWeights(angles);
+  m_samples.resize(static_cast<size_t>(m_numberOfTilts) * (m / 2));
+  for (int t = 0; t < m_numberOfTilts; ++t) {
+    const double angle = angles[t];
+    for (int k = 0; k < m / 2; ++k) {
+      Sample& sample = m_samples[t * (m / 2) + k];
+      sample.u = k * std::sin(angle);
+      sample.v = k * std::cos(angle);
+      // The origin is shared by all projections, it covers the disk of
+      // radius 1/2 around it.
+      const double area = k > 0 ? weights[t] * k : weights[t] / 4.0;
+      const double phase =
+        2.0 * vtkMath::Pi() * offset * (sample.u + sample.v) / m;
+      sample.weight = std::polar(static_cast<float>(area),
+                                 static_cast<float>(phase));
+    }
+  }
+}
+
+int DirectFourierReconstruction::slabSize(int numberOfSlices) const
+{
+  const vtkIdType m = m_gridSize;
+  const vtkIdType rays = m_numberOfTilts * m;
+  const vtkIdType spectrum = (m / 2 + 1) * m;
+  const vtkIdType sliceMemory =
+    rays * sizeof(float) + rays * sizeof(Complex) + spectrum * sizeof(Complex);
+  const vtkIdType slices = SlabMemory / sliceMemory;
+  return static_cast<int>(
+    std::max<vtkIdType>(1, std::min<vtkIdType>(slices, numberOfSlices)));
+}
+
+bool DirectFourierReconstruction::reconstruct(
+  vtkDataArray* tiltSeries, const int dims[3], int first, int count,
+  float* reconstruction, std::vector<float>* lastSlice) const
+{
+  if (!tiltSeries || tiltSeries->GetNumberOfComponents() != 1 ||
+      dims[1] != m_numberOfRays || dims[2] != m_numberOfTilts) {
+    return false;
+  }
+
+  const int n = m_numberOfRays;
+  const int m = m_gridSize;
+  const vtkIdType numLines = static_cast<vtkIdType>(count) * m_numberOfTilts;
+  std::vector<float> rays(numLines * m, 0.0f);
+  switch (tiltSeries->GetDataType()) {
+    vtkTemplateMacro(
+      gatherRays(static_cast<const VTK_TT*>(tiltSeries->GetVoidPointer(0)),
+                 dims, first, count, rays.data()));
+    default:
+      return false;
+  }
+
+  const int half = m / 2 + 1;
+  std::vector<Complex> raySpectra(numLines * half);
+  FourierTransform::forwardLines(rays.data(), m, numLines, raySpectra.data());
+  rays = std::vector<float>();
+
+  const vtkIdType spectrumSize = static_cast<vtkIdType>(half) * m;
+  std::vector<Complex> spectra(count * spectrumSize);
+  vtkSMPTools::For(0, count, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType s = begin; s < end; ++s) {
+      grid(raySpectra.data() + s * m_numberOfTilts * half,
+           spectra.data() + s * spectrumSize);
+    }
+  });
+  raySpectra = std::vector<Complex>();
+
+  const int imageDims[3] = { m, m, 1 };
+  const vtkIdType sliceSize = static_cast<vtkIdType>(dims[0]) * n;
+  std::vector<float> image(static_cast<size_t>(m) * m);
+  for (int s = 0; s < count; ++s) {
+    FourierTransform::inverse(spectra.data() + s * spectrumSize, imageDims,
+                              image.data());
+
+    // Crop the slice, centered on the origin of the grid.
+    const int x = first + s;
+    vtkSMPTools::For(0, n, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType y = begin; y < end; ++y) {
+        const float* row =
+          image.data() + wrap(static_cast<int>(y) - n / 2, m) * m;
+        for (int z = 0; z < n; ++z) {
+          reconstruction[z * sliceSize + y * dims[0] + x] = static_cast<float>(
+            row[wrap(z - n / 2, m)] * m_deapodization[y] * m_deapodization[z]);
+        }
+      }
+    });
+  }
+
+  if (lastSlice) {
+    lastSlice->resize(static_cast<size_t>(n) * n);
+    const int x = first + count - 1;
+    for (int y = 0; y < n; ++y) {
+      for (int z = 0; z < n; ++z) {
+        (*lastSlice)[y * n + z] =
+          reconstruction[z * sliceSize + y * dims[0] + x];
+      }
+    }
+  }
+  return true;
+}
+
+template <typename T>
+void DirectFourierReconstruction::gatherRays(const T* tiltSeries,
+                                             const int dims[3], int first,
+                                             int count, float* rays) const
+{
+  // Rays are padded with zeros, their origin at the first value.
+  const int n = m_numberOfRays;
+  const int m = m_gridSize;
+  vtkSMPTools::For(0, m_numberOfTilts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType t = begin; t < end; ++t) {
+      for (int r = 0; r < n; ++r) {
+        const T* values = tiltSeries + (t * n + r) * dims[0] + first;
+        const int position = wrap(r - n / 2, m);
+        for (int s = 0; s < count; ++s) {
+          rays[(s * m_numberOfTilts + t) * m + position] =
+            static_cast<float>(values[s]);
+        }
+      }
+    }
+  });
+}
+
+void DirectFourierReconstruction::grid(const Complex* raySpectra,
+                                       Complex* spectrum) const
+{
+  const int m = m_gridSize;
+  const int half = m / 2 + 1;
+  const double radius = KernelWidth / 2.0;
+  std::fill(spectrum, spectrum + static_cast<size_t>(half) * m, Complex());
+
+  // Only the columns of the half spectrum are kept, the other half is filled
+  // by the mirrored samples, the conjugates of the samples at -k.
+  auto spread = [&](double u, double v, Complex value) {
+    const int u0 = static_cast<int>(std::ceil(u - radius));
+    const int v0 = static_cast<int>(std::ceil(v - radius));
+    for (int gv = v0; gv <= v + radius; ++gv) {
+      const double wv = kernel(std::abs(gv - v));
+      Complex* row = spectrum + wrap(gv, m) * half;
+      for (int gu = u0; gu <= u + radius; ++gu) {
+        const int column = wrap(gu, m);
+        if (column < half) {
+          row[column] += value * static_cast<float>(wv * kernel(gu - u));
+        }
+      }
+    }
+  };
+
+  for (int t = 0; t < m_numberOfTilts; ++t) {
+    const Complex* line = raySpectra + t * half;
+    const Sample* samples = m_samples.data() + t * (m / 2);
+    for (int k = 0; k < m / 2; ++k) {
+      const Complex value = line[k] * samples[k].weight;
+      spread(samples[k].u, samples[k].v, value);
+      if (k > 0) {
+        spread(-samples[k].u, -samples[k].v, std::conj(value));
+      }
+    }
+  }
+}
+
+double DirectFourierReconstruction::kernel(double distance) const
+{
+  const double x = std::abs(distance) * KernelSamples;
+  const int i = static_cast<int>(x);
+  if (i >= KernelSamples * KernelWidth / 2) {
+    return 0.0;
+  }
+  const double f = x - i;
+  return m_kernel[i] * (1.0 - f) + m_kernel[i + 1] * f;
+}
+
+} // namespace tomviz
@@ -0,0 +1,89 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizDirectFourierReconstruction_h
+#define tomvizDirectFourierReconstruction_h
+
+#include <vtkType.h>
+
+#include <complex>
+#include <vector>
+
+class vtkDataArray;
+
+namespace tomviz {
+
+/// Direct Fourier reconstruction of a tilt series, tilted about the x axis.
+/// Each x slice is reconstructed independently from its sinogram, following
+/// the central slice theorem: the rays of every projection are padded to
+/// twice their length and transformed, the polar samples are weighted by
+/// the area they cover and gridded onto a Cartesian spectrum with a
+/// Kaiser-Bessel kernel, which is transformed back and deapodized.
+///
+/// Slices are reconstructed a slab at a time: the rays of the whole slab are
+/// transformed at once, the slices are gridded in parallel and transformed
+/// back one after the other. Only the spectra of a slab are held in memory.
+///
+/// The reconstruction has the geometry of
+/// TomographyReconstruction::unweightedBackProjection2(): slices are N x N
+/// for N rays and stored as y * N + z.
+///
+/// This replaces the unconstrained reconstruction of Recon_DFT only. The
+/// constrained iterations of Recon_DFT_constraint, which alternate the
+/// support, positivity and Fourier magnitude constraints over the whole
+/// volume, are out of scope and stay a Python operator.
+class DirectFourierReconstruction
+{
+public:
+  /// Width, in grid cells, of the gridding kernel.
+  static const int KernelWidth = 4;
+  /// Memory used for the spectra of a slab.
+  static const vtkIdType SlabMemory = 256 * 1024 * 1024;
+
+  /// \p tiltAngles are in degrees.
+  DirectFourierReconstruction(int numberOfRays,
+                              const std::vector<double>& tiltAngles);
+
+  /// The number of slices reconstructed together, at most \p numberOfSlices.
+  int slabSize(int numberOfSlices) const;
+
+  /// Reconstruct the x slices [first, first + count) of \p tiltSeries, of
+  /// dimensions \p dims (slices, rays, tilts), into \p reconstruction, of
+  /// dimensions (slices, rays, rays). \p lastSlice, if set, receives the last
+  /// slice reconstructed. Returns false if the tilt series has several
+  /// components or an unsupported type.
+  bool reconstruct(vtkDataArray* tiltSeries, const int dims[3], int first,
+                   int count, float* reconstruction,
+                   std::vector<float>* lastSlice = nullptr) const;
+
+private:
+  struct Sample
+  {
+    // Position on the grid, along z and y.
+    double u;
+    double v;
+    // Area covered, times the phase that moves the origin to the pixel
+    // centers.
+    std::complex<float> weight;
+  };
+
+  template <typename T>
+  void gatherRays(const T* tiltSeries, const int dims[3], int first,
+                  int count, float* rays) const;
+  void grid(const std::complex<float>* raySpectra,
+            std::complex<float>* spectrum) const;
+  double kernel(double distance) const;
+
+  int m_numberOfRays;
+  int m_numberOfTilts;
+  // The padded size of the rays and of the grid.
+  int m_gridSize;
+  // Samples of each projection, for frequencies [0, m_gridSize / 2).
+  std::vector<Sample> m_samples;
+  std::vector<double> m_kernel;
+  // Deapodization, for every pixel along an axis.
+  std::vector<double> m_deapodization;
+};
+} // namespace tomviz
+
+#endif
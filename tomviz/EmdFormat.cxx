@@ -5,6 +5,7 @@
 
 #include "DataSource.h"
 #include "GenericHDF5Format.h"
+#include "MemoryMappedArray.h"
 
 #include <h5cpp/h5readwrite.h>
 
@@ -101,7 +102,36 @@ bool EmdFormat::readNode(h5::H5ReadWrite& reader, const std::string& emdNode,
   if (!reader.isDataSet(emdDataNode))
     return false;
 
-  if (!GenericHDF5Format::readVolume(reader, emdDataNode, image, options)) {
+  // Read in the dimensions first, they tell whether the data will be
+  // re-ordered.
+  auto dim1 = reader.readData<float>(emdNode + "/dim1");
+  auto dim2 = reader.readData<float>(emdNode + "/dim2");
+  auto dim3 = reader.readData<float>(emdNode + "/dim3");
+
+  // If there are angles, read them in
+  QVector<double> angles;
+  auto units = reader.attribute<std::string>(emdNode + "/dim1", "units", &ok);
+  if (ok) {
+    if (units == "[deg]") {
+      for (unsigned i = 0; i < dim1.size(); ++i) {
+        angles.push_back(dim1[i]);
+      }
+    } else if (units == "[rad]") {
+      for (unsigned i = 0; i < dim1.size(); ++i) {
+        // Convert radians to degrees since tomviz assumes degrees everywhere.
+        angles.push_back(dim1[i] * 180.0 / vtkMath::Pi());
+      }
+    }
+  }
+
+  // Tilt series are not re-ordered, so they can be memory mapped.
+  QVariantMap volumeOptions = options;
+  if (!angles.isEmpty() && !volumeOptions.contains("memoryMap")) {
+    volumeOptions["memoryMap"] = MemoryMappedArray::enabled();
+  }
+
+  if (!GenericHDF5Format::readVolume(reader, emdDataNode, image,
+                                     volumeOptions)) {
     cerr << "Failed to read the volume at " << emdDataNode << "\n";
     return false;
   }
@@ -115,11 +145,6 @@ bool EmdFormat::readNode(h5::H5ReadWrite& reader, const std::string& emdNode,
     }
   }
 
-  // Now to read in the dimensions...
-  auto dim1 = reader.readData<float>(emdNode + "/dim1");
-  auto dim2 = reader.readData<float>(emdNode + "/dim2");
-  auto dim3 = reader.readData<float>(emdNode + "/dim3");
-
   // Set the spacing
   if (dim1.size() > 1 && dim2.size() > 1 && dim3.size() > 1) {
     double spacing[3];
@@ -129,22 +154,6 @@ bool EmdFormat::readNode(h5::H5ReadWrite& reader, const std::string& emdNode,
     image->SetSpacing(spacing);
   }
 
-  // If there are angles, read them in
-  QVector<double> angles;
-  auto units = reader.attribute<std::string>(emdNode + "/dim1", "units", &ok);
-  if (ok) {
-    if (units == "[deg]") {
-      for (unsigned i = 0; i < dim1.size(); ++i) {
-        angles.push_back(dim1[i]);
-      }
-    } else if (units == "[rad]") {
-      for (unsigned i = 0; i < dim1.size(); ++i) {
-        // Convert radians to degrees since tomviz assumes degrees everywhere.
-        angles.push_back(dim1[i] * 180.0 / vtkMath::Pi());
-      }
-    }
-  }
-
   // Now read in any extra scalars
   readExtraScalars(reader, emdNode, image);
 
@@ -168,31 +177,37 @@ bool EmdFormat::write(const std::string& fileName, DataSource* source)
 
 bool EmdFormat::write(const std::string& fileName, vtkImageData* image)
 {
-  using h5::H5ReadWrite;
-  H5ReadWrite::OpenMode mode = H5ReadWrite::OpenMode::WriteOnly;
-  H5ReadWrite writer(fileName, mode);
-
-  // Now to create the attributes, groups, etc.
-  writer.setAttribute("/", "version_major", 0u);
-  writer.setAttribute("/", "version_minor", 2u);
-
-  // Now create a "data" group
-  writer.createGroup("/data");
-  writer.createGroup("/data/tomography");
-
-  return writeNode(writer, "/data/tomography", image);
+  // Opening the file for writing truncates it, the data being written may
+  // be a mapping of it.
+  auto write = [image](const QString& name) {
+    using h5::H5ReadWrite;
+    H5ReadWrite::OpenMode mode = H5ReadWrite::OpenMode::WriteOnly;
+    H5ReadWrite writer(name.toStdString(), mode);
+
+    // Now to create the attributes, groups, etc.
+    writer.setAttribute("/", "version_major", 0u);
+    writer.setAttribute("/", "version_minor", 2u);
+
+    // Now create a "data" group
+    writer.createGroup("/data");
+    writer.createGroup("/data/tomography");
+
+    return writeNode(writer, "/data/tomography", image);
+  };
+  return MemoryMappedArray::writeReplacing(QString::fromStdString(fileName),
+                                           write);
 }
 
 bool EmdFormat::writeNode(h5::H5ReadWrite& writer, const std::string& path,
                           vtkImageData* image)
 {
-  // Create the emd_group_type attribute.
-  writer.setAttribute(path, "emd_group_type", 1u);
-
-  // See if we have tilt angles
-  auto hasTiltAngles = DataSource::hasTiltAngles(image);
-
   vtkNew<vtkImageData> permutedImage;
+  prepareNode(image, permutedImage);
+  return writePreparedNode(writer, path, permutedImage);
+}
+
+void EmdFormat::prepareNode(vtkImageData* image, vtkImageData* permutedImage)
+{
   if (DataSource::hasTiltAngles(image)) {
     // No deep copies of data needed. Just re-label the axes.
     permutedImage->ShallowCopy(image);
@@ -202,8 +217,21 @@ bool EmdFormat::writeNode(h5::H5ReadWrite& writer, const std::string& path,
     GenericHDF5Format::reorderData(image, permutedImage,
                                    ReorderMode::FortranToC);
   }
+}
+
+bool EmdFormat::writePreparedNode(h5::H5ReadWrite& writer,
+                                  const std::string& path,
+                                  vtkImageData* permutedImage)
+{
+  // Create the emd_group_type attribute.
+  writer.setAttribute(path, "emd_group_type", 1u);
+
+  // See if we have tilt angles
+  auto hasTiltAngles = DataSource::hasTiltAngles(permutedImage);
 
-  GenericHDF5Format::writeVolume(writer, path, "data", permutedImage);
+  if (!GenericHDF5Format::writeVolume(writer, path, "data", permutedImage)) {
+    return false;
+  }
 
   // Set a "name" attribute on the data so we can remember the
   // scalar name that the user gave it.
@@ -267,9 +295,7 @@ bool EmdFormat::writeNode(h5::H5ReadWrite& writer, const std::string& path,
   }
 
   // Write any extra scalars we might have
-  writeExtraScalars(writer, path, permutedImage);
-
-  return true;
+  return writeExtraScalars(writer, path, permutedImage);
 }
 
 static void readExtraScalars(h5::H5ReadWrite& reader,
@@ -320,7 +346,10 @@ static bool writeExtraScalars(h5::H5ReadWrite& writer,
 
     // Make it active and write it
     pointData->SetActiveScalars(arrayName);
-    GenericHDF5Format::writeVolume(writer, path, arrayName, image);
+    if (!GenericHDF5Format::writeVolume(writer, path, arrayName, image)) {
+      pointData->SetActiveScalars(activeName.c_str());
+      return false;
+    }
   }
 
   // Make the original one active again
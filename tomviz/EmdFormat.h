@@ -36,6 +36,15 @@ public:
   // Write EMD data to a specified node in the HDF5 file
   static bool writeNode(h5::H5ReadWrite& writer, const std::string& path,
                         vtkImageData* image);
+
+  // Writing a node is split in two steps, so that the re-ordering of the data
+  // to C order, the expensive part, may run on another thread than the
+  // writing. prepareNode() writes the image, laid out as it is stored in the
+  // node, to @param permutedImage, sharing the data when it can.
+  static void prepareNode(vtkImageData* image, vtkImageData* permutedImage);
+  static bool writePreparedNode(h5::H5ReadWrite& writer,
+                                const std::string& path,
+                                vtkImageData* permutedImage);
 };
 } // namespace tomviz
 
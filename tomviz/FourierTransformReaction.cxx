@@ -0,0 +1,44 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "FourierTransformReaction.h"
+
+#include <QAction>
+#include <QMainWindow>
+
+#include "ActiveObjects.h"
+#include "DataSource.h"
+#include "EditOperatorDialog.h"
+
+namespace tomviz {
+
+FourierTransformReaction::FourierTransformReaction(
+  QAction* parentObject, FourierTransformOperator::Filter filter,
+  QMainWindow* mw)
+  : Reaction(parentObject), m_filter(filter), m_mainWindow(mw)
+{
+}
+
+void FourierTransformReaction::addFilter(DataSource* source)
+{
+  source = source ? source : ActiveObjects::instance().activeParentDataSource();
+  if (!source) {
+    return;
+  }
+
+  auto* op = new FourierTransformOperator();
+  op->setFilter(m_filter);
+
+  // Only the band pass filter has parameters to edit
+  if (!op->hasCustomUI()) {
+    source->addOperator(op);
+    return;
+  }
+
+  EditOperatorDialog* dialog =
+    new EditOperatorDialog(op, source, true, m_mainWindow);
+  dialog->setAttribute(Qt::WA_DeleteOnClose);
+  dialog->show();
+  connect(op, SIGNAL(destroyed()), dialog, SLOT(reject()));
+}
+} // namespace tomviz
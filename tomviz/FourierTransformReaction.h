@@ -0,0 +1,37 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizFourierTransformReaction_h
+#define tomvizFourierTransformReaction_h
+
+#include <Reaction.h>
+
+#include "FourierTransformOperator.h"
+
+class QMainWindow;
+
+namespace tomviz {
+class DataSource;
+
+class FourierTransformReaction : public Reaction
+{
+  Q_OBJECT
+
+public:
+  FourierTransformReaction(QAction* parent,
+                           FourierTransformOperator::Filter filter,
+                           QMainWindow* mw);
+
+  void addFilter(DataSource* source = nullptr);
+
+protected:
+  void onTriggered() override { addFilter(); }
+
+private:
+  Q_DISABLE_COPY(FourierTransformReaction)
+  FourierTransformOperator::Filter m_filter;
+  QMainWindow* m_mainWindow;
+};
+} // namespace tomviz
+
+#endif
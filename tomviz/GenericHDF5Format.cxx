@@ -6,6 +6,7 @@
 #include <DataExchangeFormat.h>
 #include <DataSource.h>
 #include <Hdf5SubsampleWidget.h>
+#include <MemoryMappedArray.h>
 #include <Utilities.h>
 
 #include <h5cpp/h5readwrite.h>
@@ -478,6 +479,31 @@ bool GenericHDF5Format::readVolume(h5::H5ReadWrite& reader,
     vtkCounts[i] = counts[i];
 
   image->SetDimensions(&vtkCounts[0]);
+
+  // Map the whole volume, rather than reading it, if the caller asked for it
+  // and the data is stored as is in the file.
+  bool whole = true;
+  for (int i = 0; i < 3; ++i) {
+    whole = whole && start[i] == 0 && strides[i] == 1 &&
+            vtkCounts[i] == dims[i];
+  }
+  size_t offset = 0;
+  if (whole && options.value("memoryMap", false).toBool() &&
+      reader.contiguousOffset(path, offset)) {
+    auto numTuples = static_cast<vtkIdType>(vtkCounts[0]) * vtkCounts[1] *
+                     vtkCounts[2];
+    auto scalars =
+      MemoryMappedArray::map(QString::fromStdString(reader.fileName()),
+                             static_cast<qint64>(offset), vtkDataType,
+                             numTuples);
+    if (scalars) {
+      scalars->SetName("ImageScalars");
+      image->GetPointData()->SetScalars(scalars);
+      image->Modified();
+      return true;
+    }
+  }
+
   image->AllocateScalars(vtkDataType, 1);
 
   if (!reader.readData(path, type, image->GetScalarPointer(), strides, start,
@@ -53,6 +53,11 @@ public:
    * Read a volume and write it to a vtkImageData object. This function
    * does not perform any memory re-ordering on the data.
    *
+   * If the "memoryMap" option is true and the whole volume is read from a
+   * contiguous, uncompressed dataset, the scalars are memory mapped from
+   * the file instead of being read (see MemoryMappedArray). Otherwise, or
+   * if mapping fails, the data is read.
+   *
    * @param reader A reader that has already opened the file of interest.
    * @param path The path to the volume in the HDF5 file.
    * @param data The vtkImageData where the volume will be written.
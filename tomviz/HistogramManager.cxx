@@ -9,6 +9,7 @@
 #include <vtkTable.h>
 #include <vtkUnsignedLongLongArray.h>
 
+#include "ArrayStatistics.h"
 #include "ComputeHistogram.h"
 
 #include <QCoreApplication>
@@ -20,7 +21,9 @@ Q_DECLARE_METATYPE(vtkSmartPointer<vtkTable>)
 namespace {
 
 // This is just here for now - quick and dirty historgram calculations...
-void PopulateHistogram(vtkImageData* input, vtkTable* output)
+// A valid range, from the data source statistics, saves a scan of the array.
+void PopulateHistogram(vtkImageData* input, vtkTable* output,
+                       const double range[2])
 {
   // The output table will have the twice the number of columns, they will be
   // the x and y for input column. This is the bin centers, and the population.
@@ -38,7 +41,12 @@ void PopulateHistogram(vtkImageData* input, vtkTable* output)
   }
 
   // The bin values are the centers, extending +/- half an inc either side
-  arrayPtr->GetFiniteRange(minmax, -1);
+  if (range[0] <= range[1]) {
+    minmax[0] = range[0];
+    minmax[1] = range[1];
+  } else {
+    arrayPtr->GetFiniteRange(minmax, -1);
+  }
   if (minmax[0] == minmax[1]) {
     minmax[1] = minmax[0] + 1.0;
   }
@@ -93,7 +101,8 @@ void PopulateHistogram(vtkImageData* input, vtkTable* output)
   output->AddColumn(populations);
 }
 
-void Populate2DHistogram(vtkImageData* input, vtkImageData* output)
+void Populate2DHistogram(vtkImageData* input, vtkImageData* output,
+                         const double range[2])
 {
   double minmax[2] = { DBL_MAX, -DBL_MAX };
   const int numberOfBins = 256;
@@ -106,10 +115,15 @@ void Populate2DHistogram(vtkImageData* input, vtkImageData* output)
   }
 
   // The bin values are the centers, extending +/- half an inc either side
-  for (int i = 0; i < arrayPtr->GetNumberOfComponents(); ++i) {
-    double* tmp = arrayPtr->GetFiniteRange(i);
-    minmax[0] = std::min(minmax[0], tmp[0]);
-    minmax[1] = std::max(minmax[1], tmp[1]);
+  if (range[0] <= range[1]) {
+    minmax[0] = range[0];
+    minmax[1] = range[1];
+  } else {
+    for (int i = 0; i < arrayPtr->GetNumberOfComponents(); ++i) {
+      double* tmp = arrayPtr->GetFiniteRange(i);
+      minmax[0] = std::min(minmax[0], tmp[0]);
+      minmax[1] = std::max(minmax[1], tmp[1]);
+    }
   }
 
   if (minmax[0] == minmax[1]) {
@@ -153,10 +167,11 @@ public:
 
 public slots:
   void makeHistogram(vtkSmartPointer<vtkImageData> input,
-                     vtkSmartPointer<vtkTable> output);
+                     vtkSmartPointer<vtkTable> output, double min, double max);
 
   void makeHistogram2D(vtkSmartPointer<vtkImageData> input,
-                       vtkSmartPointer<vtkImageData> output);
+                       vtkSmartPointer<vtkImageData> output, double min,
+                       double max);
 
 signals:
   void histogramDone(vtkSmartPointer<vtkImageData> image,
@@ -167,21 +182,25 @@ signals:
 };
 
 void HistogramMaker::makeHistogram(vtkSmartPointer<vtkImageData> input,
-                                   vtkSmartPointer<vtkTable> output)
+                                   vtkSmartPointer<vtkTable> output,
+                                   double min, double max)
 {
   // make the histogram and notify observers (the main thread) that it
   // is done.
   if (input && output) {
-    PopulateHistogram(input, output);
+    double range[2] = { min, max };
+    PopulateHistogram(input, output, range);
   }
   emit histogramDone(input, output);
 }
 
 void HistogramMaker::makeHistogram2D(vtkSmartPointer<vtkImageData> input,
-                                     vtkSmartPointer<vtkImageData> output)
+                                     vtkSmartPointer<vtkImageData> output,
+                                     double min, double max)
 {
   if (input && output) {
-    Populate2DHistogram(input, output);
+    double range[2] = { min, max };
+    Populate2DHistogram(input, output, range);
   }
   emit histogram2DDone(input, output);
 }
@@ -241,7 +260,8 @@ HistogramManager& HistogramManager::instance()
 }
 
 vtkSmartPointer<vtkTable> HistogramManager::getHistogram(
-  vtkSmartPointer<vtkImageData> image)
+  vtkSmartPointer<vtkImageData> image,
+  QSharedPointer<ArrayStatistics> statistics)
 {
   if (m_histogramCache.contains(image)) {
     auto cachedTable = m_histogramCache[image];
@@ -260,13 +280,20 @@ vtkSmartPointer<vtkTable> HistogramManager::getHistogram(
   m_histogramsInProgress.append(image);
   vtkSmartPointer<vtkImageData> const imageSP = image;
 
+  // An empty range tells the background thread to compute it.
+  double range[2] = { 1.0, 0.0 };
+  if (statistics) {
+    statistics->finiteRange(range, -1);
+  }
+
   // This fakes a Qt signal to the background thread (without exposing the
   // class internals as a signal).  The background thread will then call
   // makeHistogram on the HistogramMaker object with the parameters we
   // gave here.
   QMetaObject::invokeMethod(m_histogramGen, "makeHistogram",
                             Q_ARG(vtkSmartPointer<vtkImageData>, imageSP),
-                            Q_ARG(vtkSmartPointer<vtkTable>, table));
+                            Q_ARG(vtkSmartPointer<vtkTable>, table),
+                            Q_ARG(double, range[0]), Q_ARG(double, range[1]));
 
   // The histogram cannot be returned for use while the background thread is
   // populating it.
@@ -274,7 +301,8 @@ vtkSmartPointer<vtkTable> HistogramManager::getHistogram(
 }
 
 vtkSmartPointer<vtkImageData> HistogramManager::getHistogram2D(
-  vtkSmartPointer<vtkImageData> image)
+  vtkSmartPointer<vtkImageData> image,
+  QSharedPointer<ArrayStatistics> statistics)
 {
   if (m_histogram2DCache.contains(image)) {
     auto cachedHistogram = m_histogram2DCache[image];
@@ -293,13 +321,27 @@ vtkSmartPointer<vtkImageData> HistogramManager::getHistogram2D(
   m_histogram2DsInProgress.append(image);
   vtkSmartPointer<vtkImageData> const imageSP = image;
 
+  // The 2D histogram covers the union of the component ranges.
+  double range[2] = { 1.0, 0.0 };
+  if (statistics && statistics->finiteCount(0) > 0) {
+    range[0] = DBL_MAX;
+    range[1] = -DBL_MAX;
+    for (int i = 0; i < statistics->numberOfComponents(); ++i) {
+      double tmp[2];
+      statistics->finiteRange(tmp, i);
+      range[0] = std::min(range[0], tmp[0]);
+      range[1] = std::max(range[1], tmp[1]);
+    }
+  }
+
   // This fakes a Qt signal to the background thread (without exposing the
   // class internals as a signal).  The background thread will then call
   // makeHistogram on the HistogramMaker object with the parameters we
   // gave here.
   QMetaObject::invokeMethod(m_histogramGen, "makeHistogram2D",
                             Q_ARG(vtkSmartPointer<vtkImageData>, imageSP),
-                            Q_ARG(vtkSmartPointer<vtkImageData>, histogram));
+                            Q_ARG(vtkSmartPointer<vtkImageData>, histogram),
+                            Q_ARG(double, range[0]), Q_ARG(double, range[1]));
   // The histogram cannot be returned for use while the background thread is
   // populating it.
   return nullptr;
@@ -8,6 +8,7 @@
 #include <vtkSmartPointer.h>
 
 #include <QMap>
+#include <QSharedPointer>
 
 class QThread;
 
@@ -15,6 +16,7 @@ class vtkImageData;
 class vtkTable;
 
 namespace tomviz {
+class ArrayStatistics;
 class HistogramMaker;
 
 class HistogramManager : public QObject
@@ -28,9 +30,15 @@ public:
 
   void finalize();
 
-  vtkSmartPointer<vtkTable> getHistogram(vtkSmartPointer<vtkImageData> image);
+  /// The histograms are computed on a background thread. Passing the
+  /// statistics of the image scalars, when they are known, spares the thread
+  /// a scan of the array to find its range.
+  vtkSmartPointer<vtkTable> getHistogram(
+    vtkSmartPointer<vtkImageData> image,
+    QSharedPointer<ArrayStatistics> statistics = {});
   vtkSmartPointer<vtkImageData> getHistogram2D(
-    vtkSmartPointer<vtkImageData> image);
+    vtkSmartPointer<vtkImageData> image,
+    QSharedPointer<ArrayStatistics> statistics = {});
 
 signals:
   void histogramReady(vtkSmartPointer<vtkImageData>, vtkSmartPointer<vtkTable>);
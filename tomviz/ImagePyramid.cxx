@@ -0,0 +1,267 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "ImagePyramid.h"
+
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+// Average each block of 2^shift points per axis of the input into one output
+// point. Blocks on the upper boundaries may be partial.
+template <typename T>
+void downsample(const T* input, T* output, const int inDims[3],
+                const int outDims[3], int shift, int numComps)
+{
+  const int factor = 1 << shift;
+  const vtkIdType inSliceSize = static_cast<vtkIdType>(inDims[0]) * inDims[1];
+  const vtkIdType numRows = static_cast<vtkIdType>(outDims[1]) * outDims[2];
+
+  vtkSMPTools::For(0, numRows, [&](vtkIdType begin, vtkIdType end) {
+    std::vector<double> sums(static_cast<size_t>(outDims[0]) * numComps);
+    for (vtkIdType r = begin; r < end; ++r) {
+      int j = static_cast<int>(r % outDims[1]);
+      int k = static_cast<int>(r / outDims[1]);
+      int j0 = j * factor, j1 = std::min(j0 + factor, inDims[1]);
+      int k0 = k * factor, k1 = std::min(k0 + factor, inDims[2]);
+
+      std::fill(sums.begin(), sums.end(), 0.0);
+      for (int kk = k0; kk < k1; ++kk) {
+        for (int jj = j0; jj < j1; ++jj) {
+          const T* row =
+            input +
+            (kk * inSliceSize + static_cast<vtkIdType>(jj) * inDims[0]) *
+              numComps;
+          for (int i = 0; i < inDims[0]; ++i) {
+            double* sum = &sums[static_cast<size_t>(i >> shift) * numComps];
+            for (int c = 0; c < numComps; ++c) {
+              sum[c] += row[i * numComps + c];
+            }
+          }
+        }
+      }
+
+      T* outRow = output + r * outDims[0] * numComps;
+      const int blockRows = (j1 - j0) * (k1 - k0);
+      for (int i = 0; i < outDims[0]; ++i) {
+        const int count =
+          blockRows * (std::min((i + 1) * factor, inDims[0]) - i * factor);
+        for (int c = 0; c < numComps; ++c) {
+          double mean = sums[i * numComps + c] / count;
+          if (std::is_integral<T>::value) {
+            mean = std::round(mean);
+          }
+          outRow[i * numComps + c] = static_cast<T>(mean);
+        }
+      }
+    }
+  });
+}
+} // namespace
+
+namespace tomviz {
+
+ImagePyramid::ImagePyramid(vtkImageData* image)
+{
+  if (!image || image->GetNumberOfPoints() == 0) {
+    return;
+  }
+
+  m_inputMTime = image->GetMTime();
+  m_input = vtkSmartPointer<vtkImageData>::New();
+  m_input->ShallowCopy(image);
+  m_snapshotMTime = m_input->GetMTime();
+
+  auto pointData = image->GetPointData();
+  for (int i = 0; i < pointData->GetNumberOfArrays(); ++i) {
+    if (auto array = pointData->GetArray(i)) {
+      m_pointSize += array->GetDataTypeSize() * array->GetNumberOfComponents();
+    }
+  }
+
+  int dims[3];
+  image->GetDimensions(dims);
+  int maxDim = std::max(dims[0], std::max(dims[1], dims[2]));
+  m_numberOfLevels = 1;
+  while (maxDim > 1) {
+    maxDim = (maxDim + 1) / 2;
+    ++m_numberOfLevels;
+  }
+}
+
+void ImagePyramid::levelDimensions(int level, int dims[3]) const
+{
+  dims[0] = dims[1] = dims[2] = 0;
+  if (level < 0 || level >= m_numberOfLevels) {
+    return;
+  }
+
+  m_input->GetDimensions(dims);
+  const int factor = 1 << level;
+  for (int i = 0; i < 3; ++i) {
+    dims[i] = (dims[i] + factor - 1) / factor;
+  }
+}
+
+vtkIdType ImagePyramid::levelSize(int level) const
+{
+  int dims[3];
+  levelDimensions(level, dims);
+  return static_cast<vtkIdType>(dims[0]) * dims[1] * dims[2] * m_pointSize;
+}
+
+int ImagePyramid::levelForBudget(vtkIdType maxBytes) const
+{
+  for (int i = 0; i < m_numberOfLevels; ++i) {
+    if (levelSize(i) <= maxBytes) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+vtkSmartPointer<vtkImageData> ImagePyramid::level(int level)
+{
+  if (level < 0 || level >= m_numberOfLevels) {
+    return nullptr;
+  }
+  if (level == 0) {
+    return m_input;
+  }
+
+  // Building under the lock means concurrent requests for the same level wait
+  // for the first one instead of building it twice.
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto image = buildLevel(level);
+
+  // The values may have changed while they were read.
+  if (isModified()) {
+    m_levels.clear();
+    return nullptr;
+  }
+  return image;
+}
+
+vtkSmartPointer<vtkImageData> ImagePyramid::buildLevel(int level)
+{
+  if (level == 0) {
+    return m_input;
+  }
+  auto it = m_levels.find(level);
+  if (it != m_levels.end()) {
+    return it->second;
+  }
+  if (isModified()) {
+    return nullptr;
+  }
+
+  // Coarser levels read the previous level, an eighth of its points, rather
+  // than the whole image.
+  auto previous = buildLevel(level - 1);
+  if (!previous) {
+    return nullptr;
+  }
+
+  int inDims[3], outDims[3];
+  previous->GetDimensions(inDims);
+  levelDimensions(level, outDims);
+
+  double spacing[3], origin[3];
+  int extent[6];
+  previous->GetSpacing(spacing);
+  previous->GetOrigin(origin);
+  previous->GetExtent(extent);
+
+  // Each output point sits at the center of the block it averages.
+  auto image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(outDims);
+  for (int i = 0; i < 3; ++i) {
+    origin[i] += (extent[2 * i] + 0.5) * spacing[i];
+    spacing[i] *= 2;
+  }
+  image->SetOrigin(origin);
+  image->SetSpacing(spacing);
+
+  auto inPointData = previous->GetPointData();
+  auto outPointData = image->GetPointData();
+  const vtkIdType numPoints = image->GetNumberOfPoints();
+  for (int i = 0; i < inPointData->GetNumberOfArrays(); ++i) {
+    auto inArray = inPointData->GetArray(i);
+    if (!inArray) {
+      continue;
+    }
+
+    auto outArray = vtkSmartPointer<vtkDataArray>::Take(inArray->NewInstance());
+    outArray->SetName(inArray->GetName());
+    outArray->SetNumberOfComponents(inArray->GetNumberOfComponents());
+    outArray->SetNumberOfTuples(numPoints);
+    switch (inArray->GetDataType()) {
+      vtkTemplateMacro(downsample(
+        static_cast<const VTK_TT*>(inArray->GetVoidPointer(0)),
+        static_cast<VTK_TT*>(outArray->GetVoidPointer(0)), inDims, outDims, 1,
+        inArray->GetNumberOfComponents()));
+    }
+    outPointData->AddArray(outArray);
+  }
+
+  if (auto scalars = inPointData->GetScalars()) {
+    outPointData->SetActiveScalars(scalars->GetName());
+  }
+
+  if (levelSize(level) <= m_memoryBudget) {
+    m_levels[level] = image;
+    trimCache(level);
+  }
+  return image;
+}
+
+bool ImagePyramid::isModified() const
+{
+  return m_input->GetMTime() != m_snapshotMTime;
+}
+
+void ImagePyramid::setMemoryBudget(vtkIdType bytes)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_memoryBudget = bytes;
+  trimCache(-1);
+}
+
+vtkIdType ImagePyramid::cachedSize() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  vtkIdType size = 0;
+  for (const auto& level : m_levels) {
+    size += levelSize(level.first);
+  }
+  return size;
+}
+
+void ImagePyramid::trimCache(int keep)
+{
+  vtkIdType size = 0;
+  for (const auto& level : m_levels) {
+    size += levelSize(level.first);
+  }
+
+  // Finer levels are the largest, they are dropped first.
+  auto it = m_levels.begin();
+  while (size > m_memoryBudget && it != m_levels.end()) {
+    if (it->first == keep) {
+      ++it;
+      continue;
+    }
+    size -= levelSize(it->first);
+    it = m_levels.erase(it);
+  }
+}
+
+} // namespace tomviz
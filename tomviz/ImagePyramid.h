@@ -0,0 +1,83 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizImagePyramid_h
+#define tomvizImagePyramid_h
+
+#include <vtkSmartPointer.h>
+#include <vtkType.h>
+
+#include <map>
+#include <mutex>
+
+class vtkImageData;
+
+namespace tomviz {
+
+/// Multiresolution pyramid of an image. Level 0 is the image itself and each
+/// following level halves the resolution along every axis, a point of level n
+/// is the average of a block of 2 points per axis of level n - 1. Every point
+/// data array is downsampled, in the same order, so array indices remain valid
+/// on every level.
+///
+/// Levels are built on demand, in parallel, each one from the previous level,
+/// and then cached. The cache is kept within the memory budget by dropping the
+/// largest levels first.
+///
+/// The pyramid holds a shallow copy of the image, arrays added to or removed
+/// from the image later do not affect it. level() may be called from a worker
+/// thread, it returns a null pointer once the arrays were modified.
+class ImagePyramid
+{
+public:
+  explicit ImagePyramid(vtkImageData* image);
+
+  /// The modified time of the image when the pyramid was created.
+  vtkMTimeType inputMTime() const { return m_inputMTime; }
+
+  /// Number of levels, including level 0. The coarsest level is the first one
+  /// with a single point along its longest axis.
+  int numberOfLevels() const { return m_numberOfLevels; }
+
+  /// Dimensions of \p level.
+  void levelDimensions(int level, int dims[3]) const;
+
+  /// Memory needed to store the point data of \p level, in bytes.
+  vtkIdType levelSize(int level) const;
+
+  /// Returns the finest level whose size fits within \p maxBytes, 0 if the
+  /// image itself fits or -1 if even the coarsest level is too large.
+  int levelForBudget(vtkIdType maxBytes) const;
+
+  /// Returns the image for \p level, building and caching it if needed.
+  /// Returns a null pointer for invalid levels, or if the arrays of the image
+  /// were modified since the pyramid was created.
+  vtkSmartPointer<vtkImageData> level(int level);
+
+  /// Memory the cached levels may use, in bytes. Levels larger than the budget
+  /// are still returned by level(), they are just not cached.
+  void setMemoryBudget(vtkIdType bytes);
+  vtkIdType memoryBudget() const { return m_memoryBudget; }
+
+  /// Memory currently used by the cached levels, in bytes.
+  vtkIdType cachedSize() const;
+
+private:
+  // Called with the mutex locked.
+  vtkSmartPointer<vtkImageData> buildLevel(int level);
+  bool isModified() const;
+  void trimCache(int keep);
+
+  vtkSmartPointer<vtkImageData> m_input;
+  vtkMTimeType m_inputMTime = 0;
+  vtkMTimeType m_snapshotMTime = 0;
+  int m_numberOfLevels = 0;
+  // Bytes per point, summed over all the point data arrays.
+  vtkIdType m_pointSize = 0;
+  vtkIdType m_memoryBudget = VTK_ID_MAX;
+  std::map<int, vtkSmartPointer<vtkImageData>> m_levels;
+  mutable std::mutex m_mutex;
+};
+} // namespace tomviz
+
+#endif
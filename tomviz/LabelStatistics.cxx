@@ -0,0 +1,168 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "LabelStatistics.h"
+
+#include <vtkDataArray.h>
+#include <vtkMath.h>
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace {
+
+// The sum of the squares of [0, k).
+long long sumOfSquares(long long k)
+{
+  return (k - 1) * k * (2 * k - 1) / 6;
+}
+} // namespace
+
+namespace tomviz {
+
+LabelStatistics::LabelStatistics(const int dims[3])
+{
+  std::copy(dims, dims + 3, m_dims);
+}
+
+void LabelStatistics::Accumulator::addRun(int x0, int x1, int y, int z)
+{
+  // The voxels [x0, x1) of the row (y, z).
+  const long long n = x1 - x0;
+  const long long sx = n * (x0 + x1 - 1) / 2;
+  voxels += n;
+  sums[0] += sx;
+  sums[1] += n * y;
+  sums[2] += n * z;
+  products[0] += sumOfSquares(x1) - sumOfSquares(x0);
+  products[1] += n * y * y;
+  products[2] += n * z * z;
+  products[3] += sx * y;
+  products[4] += sx * z;
+  products[5] += n * y * z;
+  bounds[0] = std::min(bounds[0], x0);
+  bounds[1] = std::max(bounds[1], x1 - 1);
+  bounds[2] = std::min(bounds[2], y);
+  bounds[3] = std::max(bounds[3], y);
+  bounds[4] = std::min(bounds[4], z);
+  bounds[5] = std::max(bounds[5], z);
+}
+
+void LabelStatistics::Accumulator::merge(const Accumulator& other)
+{
+  voxels += other.voxels;
+  for (int i = 0; i < 3; ++i) {
+    sums[i] += other.sums[i];
+    bounds[2 * i] = std::min(bounds[2 * i], other.bounds[2 * i]);
+    bounds[2 * i + 1] = std::max(bounds[2 * i + 1], other.bounds[2 * i + 1]);
+  }
+  for (int i = 0; i < 6; ++i) {
+    products[i] += other.products[i];
+  }
+}
+
+bool LabelStatistics::accumulate(vtkDataArray* labels, int first, int count)
+{
+  const int type = labels->GetDataType();
+  if (labels->GetNumberOfComponents() != 1 || type == VTK_FLOAT ||
+      type == VTK_DOUBLE) {
+    return false;
+  }
+
+  switch (type) {
+    vtkTemplateMacro(accumulate(
+      static_cast<const VTK_TT*>(labels->GetVoidPointer(0)), first, count));
+    default:
+      return false;
+  }
+  return true;
+}
+
+template <typename T>
+void LabelStatistics::accumulate(const T* labels, int first, int count)
+{
+  const int nx = m_dims[0];
+  const int ny = m_dims[1];
+  const vtkIdType begin = static_cast<vtkIdType>(first) * ny;
+  const vtkIdType end = begin + static_cast<vtkIdType>(count) * ny;
+  vtkSMPTools::For(begin, end, [&](vtkIdType rowBegin, vtkIdType rowEnd) {
+    Accumulators& accumulators = m_accumulators.Local();
+    for (vtkIdType r = rowBegin; r < rowEnd; ++r) {
+      const int y = static_cast<int>(r % ny);
+      const int z = static_cast<int>(r / ny);
+      const T* row = labels + r * nx;
+      for (int x0 = 0; x0 < nx;) {
+        const T label = row[x0];
+        int x1 = x0 + 1;
+        while (x1 < nx && row[x1] == label) {
+          ++x1;
+        }
+        if (label > 0) {
+          accumulators[static_cast<long long>(label)].addRun(x0, x1, y, z);
+        }
+        x0 = x1;
+      }
+    }
+  });
+}
+
+std::vector<LabelStatistics::Object> LabelStatistics::objects(
+  const double origin[3], const double spacing[3])
+{
+  // The integer sums are exact, so the order of the merge does not matter.
+  std::map<long long, Accumulator> merged;
+  for (auto& accumulators : m_accumulators) {
+    for (auto& item : accumulators) {
+      merged[item.first].merge(item.second);
+    }
+  }
+
+  std::vector<Object> objects;
+  objects.reserve(merged.size());
+  for (auto& item : merged) {
+    const Accumulator& a = item.second;
+    const double n = static_cast<double>(a.voxels);
+    Object object;
+    object.label = static_cast<vtkIdType>(item.first);
+    object.voxels = static_cast<vtkIdType>(a.voxels);
+
+    double mean[3];
+    for (int i = 0; i < 3; ++i) {
+      mean[i] = a.sums[i] / n;
+      object.centroid[i] = origin[i] + spacing[i] * mean[i];
+      object.bounds[2 * i] = origin[i] + spacing[i] * a.bounds[2 * i];
+      object.bounds[2 * i + 1] = origin[i] + spacing[i] * a.bounds[2 * i + 1];
+    }
+
+    // The covariance of the voxel positions, as numpy.cov computes it.
+    const int pairs[6][2] = { { 0, 0 }, { 1, 1 }, { 2, 2 },
+                              { 0, 1 }, { 0, 2 }, { 1, 2 } };
+    const double normalization = a.voxels > 1 ? n / (n - 1.0) : 0.0;
+    double covariance[3][3];
+    for (int k = 0; k < 6; ++k) {
+      const int i = pairs[k][0];
+      const int j = pairs[k][1];
+      const double value = (a.products[k] / n - mean[i] * mean[j]) *
+                           normalization * spacing[i] * spacing[j];
+      covariance[i][j] = covariance[j][i] = value;
+    }
+
+    double* rows[3] = { covariance[0], covariance[1], covariance[2] };
+    double vectors[3][3];
+    double* vectorRows[3] = { vectors[0], vectors[1], vectors[2] };
+    vtkMath::Jacobi(rows, object.moments, vectorRows);
+    // Jacobi returns the eigenvectors as columns.
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        object.axes[i][j] = vectors[j][i];
+      }
+      object.moments[i] = std::max(object.moments[i], 0.0);
+    }
+    objects.push_back(object);
+  }
+  return objects;
+}
+
+} // namespace tomviz
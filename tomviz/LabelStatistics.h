@@ -0,0 +1,75 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizLabelStatistics_h
+#define tomvizLabelStatistics_h
+
+#include <vtkSMPThreadLocal.h>
+#include <vtkType.h>
+
+#include <unordered_map>
+#include <vector>
+
+class vtkDataArray;
+
+namespace tomviz {
+
+/// Statistics of the objects of a label map, gathered in a single pass over
+/// the voxels: the number of voxels, the centroid, the bounding box and the
+/// principal axes of every label. Voxels labeled 0 or less are background.
+///
+/// The rows of the label map are visited in parallel. Each thread gathers
+/// the runs of equal labels along x into its own accumulators, which are
+/// merged at the end. Moments are accumulated as exact integers of the voxel
+/// indices, so the results do not depend on the number of threads.
+class LabelStatistics
+{
+public:
+  struct Object
+  {
+    vtkIdType label;
+    vtkIdType voxels;
+    double centroid[3];
+    /// Bounds of the voxel centers, as xmin, xmax, ymin, ymax, zmin, zmax.
+    double bounds[6];
+    /// Variances along the principal axes, largest first.
+    double moments[3];
+    /// Unit principal axes, in the order of the moments.
+    double axes[3][3];
+  };
+
+  /// The label map has dimensions \p dims.
+  LabelStatistics(const int dims[3]);
+
+  /// Accumulate the z slices [first, first + count) of \p labels. Returns
+  /// false if the labels are not integers or have several components.
+  bool accumulate(vtkDataArray* labels, int first, int count);
+
+  /// The objects accumulated so far, by increasing label, placed by
+  /// \p origin and \p spacing. Covariances are normalized by n - 1.
+  std::vector<Object> objects(const double origin[3], const double spacing[3]);
+
+private:
+  struct Accumulator
+  {
+    long long voxels = 0;
+    // Sums of x, y, z and of xx, yy, zz, xy, xz, yz over the voxel indices.
+    long long sums[3] = { 0, 0, 0 };
+    long long products[6] = { 0, 0, 0, 0, 0, 0 };
+    int bounds[6] = { VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX,
+                      VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN };
+
+    void addRun(int x0, int x1, int y, int z);
+    void merge(const Accumulator& other);
+  };
+  typedef std::unordered_map<long long, Accumulator> Accumulators;
+
+  template <typename T>
+  void accumulate(const T* labels, int first, int count);
+
+  int m_dims[3];
+  vtkSMPThreadLocal<Accumulators> m_accumulators;
+};
+} // namespace tomviz
+
+#endif
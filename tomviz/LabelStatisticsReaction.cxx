@@ -0,0 +1,28 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "LabelStatisticsReaction.h"
+
+#include <QDebug>
+
+#include "ActiveObjects.h"
+#include "DataSource.h"
+#include "LabelStatisticsOperator.h"
+
+namespace tomviz {
+
+LabelStatisticsReaction::LabelStatisticsReaction(QAction* parentObject)
+  : Reaction(parentObject)
+{
+}
+
+void LabelStatisticsReaction::addOperator()
+{
+  DataSource* source = ActiveObjects::instance().activeParentDataSource();
+  if (!source) {
+    qDebug() << "Exiting early - no data found.";
+    return;
+  }
+  source->addOperator(new LabelStatisticsOperator());
+}
+} // namespace tomviz
@@ -0,0 +1,27 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizLabelStatisticsReaction_h
+#define tomvizLabelStatisticsReaction_h
+
+#include <Reaction.h>
+
+namespace tomviz {
+
+class LabelStatisticsReaction : public Reaction
+{
+  Q_OBJECT
+
+public:
+  LabelStatisticsReaction(QAction* parent);
+
+  void addOperator();
+
+protected:
+  void onTriggered() override { addOperator(); }
+
+private:
+  Q_DISABLE_COPY(LabelStatisticsReaction)
+};
+} // namespace tomviz
+#endif
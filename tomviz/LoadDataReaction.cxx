@@ -13,6 +13,7 @@
 #include "ImageStackDialog.h"
 #include "ImageStackModel.h"
 #include "LoadStackReaction.h"
+#include "MemoryMappedArray.h"
 #include "ModuleManager.h"
 #include "MoleculeSource.h"
 #include "Pipeline.h"
@@ -40,6 +41,7 @@
 #include <vtkSMViewProxy.h>
 
 #include <vtkImageData.h>
+#include <vtkImageReader.h>
 #include <vtkMolecule.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
@@ -94,6 +96,51 @@ bool hasData(vtkSMProxy* reader)
   }
   return true;
 }
+
+// Memory map the data of a raw reader rather than reading it, which is
+// possible for a single file in the native byte order that is read as is.
+vtkSmartPointer<vtkImageData> mapRawImage(vtkSMProxy* proxy)
+{
+  auto source = vtkSMSourceProxy::SafeDownCast(proxy);
+  auto reader = vtkImageReader::SafeDownCast(
+    source ? source->GetClientSideObject() : nullptr);
+  if (!reader || reader->GetFileDimensionality() != 3 ||
+      reader->GetSwapBytes() || !reader->GetFileLowerLeft() ||
+      reader->GetTransform()) {
+    return nullptr;
+  }
+
+  int* voi = reader->GetDataVOI();
+  if (voi[0] || voi[1] || voi[2] || voi[3] || voi[4] || voi[5]) {
+    return nullptr;
+  }
+
+  int extent[6];
+  reader->GetDataExtent(extent);
+  vtkIdType numTuples = 1;
+  for (int i = 0; i < 3; ++i) {
+    numTuples *= extent[2 * i + 1] - extent[2 * i] + 1;
+  }
+
+  // The header size is the part of the file that precedes the data.
+  reader->ComputeInternalFileName(extent[4]);
+  QString fileName(reader->GetInternalFileName());
+  auto scalars = tomviz::MemoryMappedArray::map(
+    fileName, static_cast<qint64>(reader->GetHeaderSize()),
+    reader->GetDataScalarType(), numTuples,
+    reader->GetNumberOfScalarComponents());
+  if (!scalars) {
+    return nullptr;
+  }
+  scalars->SetName(reader->GetScalarArrayName());
+
+  auto image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(extent);
+  image->SetSpacing(reader->GetDataSpacing());
+  image->SetOrigin(reader->GetDataOrigin());
+  image->GetPointData()->SetScalars(scalars);
+  return image;
+}
 } // namespace
 
 namespace tomviz {
@@ -385,16 +432,26 @@ DataSource* LoadDataReaction::createDataSource(vtkSMProxy* reader,
   if (QString(reader->GetXMLName()) == "TIFFSeriesReader" ||
       hasVisibleWidgets == false || dialog->exec() == QDialog::Accepted) {
 
-    if (!hasData(reader)) {
-      qCritical() << "Error: failed to load file!";
-      return nullptr;
+    // Raw data is memory mapped, pages are read as they are accessed.
+    vtkSmartPointer<vtkImageData> image;
+    if (QString(reader->GetXMLName()) == "TVRawImageReader" &&
+        MemoryMappedArray::enabled()) {
+      image = mapRawImage(reader);
+    }
+
+    if (!image) {
+      if (!hasData(reader)) {
+        qCritical() << "Error: failed to load file!";
+        return nullptr;
+      }
+
+      auto source = vtkSMSourceProxy::SafeDownCast(reader);
+      source->UpdatePipeline();
+      auto algo = vtkAlgorithm::SafeDownCast(source->GetClientSideObject());
+      auto data = algo->GetOutputDataObject(0);
+      image = vtkImageData::SafeDownCast(data);
     }
 
-    auto source = vtkSMSourceProxy::SafeDownCast(reader);
-    source->UpdatePipeline();
-    auto algo = vtkAlgorithm::SafeDownCast(source->GetClientSideObject());
-    auto data = algo->GetOutputDataObject(0);
-    auto image = vtkImageData::SafeDownCast(data);
     DataSource::DataSourceType type = DataSource::hasTiltAngles(image)
                                         ? DataSource::TiltSeries
                                         : DataSource::Volume;
@@ -0,0 +1,248 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "LocalThickness.h"
+
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// The largest integer whose square is at most value.
+int floorSqrt(double value)
+{
+  int root = static_cast<int>(std::sqrt(value));
+  while (static_cast<double>(root + 1) * (root + 1) <= value) {
+    ++root;
+  }
+  while (root > 0 && static_cast<double>(root) * root > value) {
+    --root;
+  }
+  return root;
+}
+
+// The squared distance transform of a line of n values, following
+// Felzenszwalb and Huttenlocher: the lower envelope of the parabolas rooted
+// at the finite values. The matter around the volume adds roots of 0 at -1
+// and n.
+void transformLine(const float* values, int n, float* result,
+                   std::vector<int>& roots, std::vector<double>& heights,
+                   std::vector<double>& bounds)
+{
+  const double infinity = std::numeric_limits<double>::infinity();
+  int k = 0;
+  roots[0] = -1;
+  heights[0] = 0.0;
+  bounds[0] = -infinity;
+  bounds[1] = infinity;
+  for (int q = 0; q <= n; ++q) {
+    const double height = q < n ? values[q] : 0.0;
+    if (std::isinf(height)) {
+      continue;
+    }
+    double s;
+    while (true) {
+      const int r = roots[k];
+      s = ((height + static_cast<double>(q) * q) -
+           (heights[k] + static_cast<double>(r) * r)) /
+          (2.0 * (q - r));
+      if (s > bounds[k]) {
+        break;
+      }
+      --k;
+    }
+    ++k;
+    roots[k] = q;
+    heights[k] = height;
+    bounds[k] = s;
+    bounds[k + 1] = infinity;
+  }
+
+  k = 0;
+  for (int q = 0; q < n; ++q) {
+    while (bounds[k + 1] < q) {
+      ++k;
+    }
+    const double d = q - roots[k];
+    result[q] = static_cast<float>(d * d + heights[k]);
+  }
+}
+} // namespace
+
+namespace tomviz {
+
+void LocalThickness::distanceTransform(float* values, const int dims[3],
+                                       int axis)
+{
+  const vtkIdType nx = dims[0];
+  const vtkIdType ny = dims[1];
+  const int n = dims[axis];
+  const vtkIdType numLines =
+    static_cast<vtkIdType>(dims[0]) * dims[1] * dims[2] / n;
+  const vtkIdType stride = axis == 0 ? 1 : (axis == 1 ? nx : nx * ny);
+
+  vtkSMPTools::For(0, numLines, [&](vtkIdType begin, vtkIdType end) {
+    std::vector<float> line(n);
+    std::vector<float> result(n);
+    std::vector<int> roots(n + 2);
+    std::vector<double> heights(n + 2);
+    std::vector<double> bounds(n + 3);
+    for (vtkIdType l = begin; l < end; ++l) {
+      vtkIdType start;
+      if (axis == 0) {
+        start = l * nx;
+      } else if (axis == 1) {
+        start = (l / nx) * nx * ny + l % nx;
+      } else {
+        start = l;
+      }
+
+      float* lineValues = values + start;
+      for (int i = 0; i < n; ++i) {
+        line[i] = lineValues[i * stride];
+      }
+      transformLine(line.data(), n, result.data(), roots, heights, bounds);
+      for (int i = 0; i < n; ++i) {
+        lineValues[i * stride] = result[i];
+      }
+    }
+  });
+}
+
+LocalThickness::LocalThickness(const float* squaredDistances,
+                               const int dims[3])
+  : m_squaredDistances(squaredDistances), m_balls(dims[2])
+{
+  std::copy(dims, dims + 3, m_dims);
+  const int nx = dims[0];
+  const int ny = dims[1];
+  const int nz = dims[2];
+  auto radius = [&](int x, int y, int z) {
+    if (x < 0 || y < 0 || z < 0 || x >= nx || y >= ny || z >= nz) {
+      return 0;
+    }
+    return floorSqrt(
+      squaredDistances[(static_cast<vtkIdType>(z) * ny + y) * nx + x]);
+  };
+
+  std::vector<int> maximumRadii(nz, 0);
+  vtkSMPTools::For(0, nz, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType zz = begin; zz < end; ++zz) {
+      const int z = static_cast<int>(zz);
+      auto& balls = m_balls[z];
+      for (int y = 0; y < ny; ++y) {
+        for (int x = 0; x < nx; ++x) {
+          const int r = radius(x, y, z);
+          if (r == 0) {
+            continue;
+          }
+          maximumRadii[z] = std::max(maximumRadii[z], r);
+          // The ball is inside the ball of a face neighbour with a larger
+          // radius.
+          if (radius(x - 1, y, z) > r || radius(x + 1, y, z) > r ||
+              radius(x, y - 1, z) > r || radius(x, y + 1, z) > r ||
+              radius(x, y, z - 1) > r || radius(x, y, z + 1) > r) {
+            continue;
+          }
+          balls.push_back({ x, y, r });
+        }
+      }
+      std::stable_sort(
+        balls.begin(), balls.end(),
+        [](const Ball& a, const Ball& b) { return a.radius > b.radius; });
+    }
+  });
+
+  for (int r : maximumRadii) {
+    m_maximumRadius = std::max(m_maximumRadius, r);
+  }
+}
+
+void LocalThickness::thickness(int first, int count, float* thickness) const
+{
+  const int nx = m_dims[0];
+  const int ny = m_dims[1];
+  const int nz = m_dims[2];
+  const vtkIdType sliceSize = static_cast<vtkIdType>(nx) * ny;
+
+  vtkSMPTools::For(first, first + count, [&](vtkIdType begin, vtkIdType end) {
+    // The sections of the balls which cross a slice, by radius, as the
+    // center and squared radius of a disk.
+    std::vector<std::vector<Ball>> sections(m_maximumRadius + 1);
+    // For each voxel of a row, the next voxel which is not painted yet.
+    std::vector<int> unpainted(static_cast<vtkIdType>(nx + 1) * ny);
+
+    for (vtkIdType zz = begin; zz < end; ++zz) {
+      const int z = static_cast<int>(zz);
+      for (auto& disks : sections) {
+        disks.clear();
+      }
+      const int zBegin = std::max(0, z - m_maximumRadius);
+      const int zEnd = std::min(nz - 1, z + m_maximumRadius);
+      for (int cz = zBegin; cz <= zEnd; ++cz) {
+        const int dz = std::abs(cz - z);
+        for (const auto& ball : m_balls[cz]) {
+          if (ball.radius < dz) {
+            break;
+          }
+          sections[ball.radius].push_back(
+            { ball.x, ball.y, ball.radius * ball.radius - dz * dz });
+        }
+      }
+
+      // The disks are painted from the largest radius down, so each voxel
+      // takes the radius of the first disk which covers it, and is skipped
+      // by the following ones.
+      for (int y = 0; y < ny; ++y) {
+        int* next = unpainted.data() + static_cast<vtkIdType>(y) * (nx + 1);
+        for (int x = 0; x <= nx; ++x) {
+          next[x] = x;
+        }
+      }
+      auto find = [](int* next, int x) {
+        while (next[x] != x) {
+          next[x] = next[next[x]];
+          x = next[x];
+        }
+        return x;
+      };
+
+      float* slice = thickness + (z - first) * sliceSize;
+      std::fill(slice, slice + sliceSize, 0.0f);
+      for (int r = m_maximumRadius; r > 0; --r) {
+        const float value = static_cast<float>(r);
+        for (const auto& disk : sections[r]) {
+          const int r2 = disk.radius;
+          const int halfHeight = floorSqrt(r2);
+          const int yBegin = std::max(0, disk.y - halfHeight);
+          const int yEnd = std::min(ny - 1, disk.y + halfHeight);
+          for (int y = yBegin; y <= yEnd; ++y) {
+            const int dy = y - disk.y;
+            const int halfWidth = floorSqrt(r2 - dy * dy);
+            const int xEnd = std::min(nx - 1, disk.x + halfWidth);
+            float* row = slice + static_cast<vtkIdType>(y) * nx;
+            int* next = unpainted.data() + static_cast<vtkIdType>(y) * (nx + 1);
+            for (int x = find(next, std::max(0, disk.x - halfWidth));
+                 x <= xEnd; x = find(next, x + 1)) {
+              row[x] = value;
+              next[x] = x + 1;
+            }
+          }
+        }
+      }
+
+      // A ball may touch the matter, at exactly its radius.
+      const float* distances = m_squaredDistances + z * sliceSize;
+      for (vtkIdType i = 0; i < sliceSize; ++i) {
+        if (distances[i] == 0.0f) {
+          slice[i] = 0.0f;
+        }
+      }
+    }
+  });
+}
+
+} // namespace tomviz
@@ -0,0 +1,60 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizLocalThickness_h
+#define tomvizLocalThickness_h
+
+#include <vtkType.h>
+
+#include <vector>
+
+namespace tomviz {
+
+/// The local thickness of the pores of a volume: the radius of the largest
+/// ball, inside the pores, that contains each voxel. The fraction of the
+/// volume with a thickness of at least r is the continuous pore size
+/// distribution, the volume of the opening of the pores by a ball of radius
+/// r, which the PoreSizeDistribution Python operator computed with a
+/// dilation for each radius.
+///
+/// The balls are centered on voxels, with integer radii at most the
+/// Euclidean distance of their center to the matter. The volume is
+/// surrounded by matter.
+class LocalThickness
+{
+public:
+  /// Exact squared Euclidean distance transform, one axis at a time, along
+  /// \p axis. The lines along the axis are transformed in parallel. Call it
+  /// for the axes 0, 1 and 2 on \p values, of dimensions \p dims, which are
+  /// 0 for matter and infinite for pores.
+  static void distanceTransform(float* values, const int dims[3], int axis);
+
+  /// Find the balls of the pores from the squared distances. Balls which are
+  /// contained in the ball of a neighbour are left out.
+  LocalThickness(const float* squaredDistances, const int dims[3]);
+
+  /// The largest radius of a ball.
+  int maximumRadius() const { return m_maximumRadius; }
+
+  /// The local thickness of the z slices [first, first + count), 0 for the
+  /// matter, into \p thickness which holds these slices only. The slices are
+  /// computed in parallel.
+  void thickness(int first, int count, float* thickness) const;
+
+private:
+  struct Ball
+  {
+    int x;
+    int y;
+    int radius;
+  };
+
+  const float* m_squaredDistances;
+  int m_dims[3];
+  int m_maximumRadius = 0;
+  // The balls centered in each z slice, by decreasing radius.
+  std::vector<std::vector<Ball>> m_balls;
+};
+} // namespace tomviz
+
+#endif
@@ -59,6 +59,8 @@
 #include "SetDataTypeReaction.h"
 #include "SetTiltAnglesOperator.h"
 #include "SetTiltAnglesReaction.h"
+#include "TiltSeriesPreprocessingReaction.h"
+#include "TotalVariationReaction.h"
 #include "Utilities.h"
 #include "ViewMenuManager.h"
 #include "VolumeManager.h"
@@ -284,6 +286,8 @@ MainWindow::MainWindow(QWidget* parent, Qt::WindowFlags flags)
   QAction* dataProcessingLabel =
     m_ui->menuTomography->addAction("Pre-processing:");
   dataProcessingLabel->setEnabled(false);
+  QAction* preprocessTiltSeriesAction =
+    m_ui->menuTomography->addAction("Preprocess Tilt Series");
   QAction* downsampleByTwoAction =
     m_ui->menuTomography->addAction("Bin Tilt Images x2");
   QAction* removeBadPixelsAction =
@@ -363,23 +367,30 @@ MainWindow::MainWindow(QWidget* parent, Qt::WindowFlags flags)
   new AddPythonTransformReaction(downsampleByTwoAction, "Bin Tilt Image x2",
                                  readInPythonScript("BinTiltSeriesByTwo"),
                                  false, false, false);
-  new AddPythonTransformReaction(
-    removeBadPixelsAction, "Remove Bad Pixels",
-    readInPythonScript("RemoveBadPixelsTiltSeries"), false, false, false);
+  // The corrections of the projections are steps of a single operator, the
+  // entries of the steps start it with that step only.
+  TiltSeriesPreprocessing::Parameters preprocessing;
+  preprocessing.steps |= TiltSeriesPreprocessing::FlatField;
+  new TiltSeriesPreprocessingReaction(preprocessTiltSeriesAction,
+                                      preprocessing, this);
+  TiltSeriesPreprocessing::Parameters badPixels;
+  badPixels.steps = TiltSeriesPreprocessing::BadPixels;
+  new TiltSeriesPreprocessingReaction(removeBadPixelsAction, badPixels, this);
   new AddPythonTransformReaction(
     gaussianFilterAction, "Gaussian Filter Tilt Series",
     readInPythonScript("GaussianFilterTiltSeries"), false, false, false,
     readInJSONDescription("GaussianFilterTiltSeries"));
-  new AddPythonTransformReaction(
-    autoSubtractBackgroundAction, "Background Subtraction (Auto)",
-    readInPythonScript("Subtract_TiltSer_Background_Auto"), false, false,
-    false);
-  new AddPythonTransformReaction(
-    subtractBackgroundAction, "Background Subtraction (Manual)",
-    readInPythonScript("Subtract_TiltSer_Background"), false, false, false);
-  new AddPythonTransformReaction(normalizationAction, "Normalize Tilt Series",
-                                 readInPythonScript("NormalizeTiltSeries"),
-                                 false, false, false);
+  TiltSeriesPreprocessing::Parameters background;
+  background.steps = TiltSeriesPreprocessing::Background;
+  new TiltSeriesPreprocessingReaction(autoSubtractBackgroundAction, background,
+                                      this);
+  background.backgroundMethod =
+    TiltSeriesPreprocessing::BackgroundMethod::Region;
+  new TiltSeriesPreprocessingReaction(subtractBackgroundAction, background,
+                                      this);
+  TiltSeriesPreprocessing::Parameters normalize;
+  normalize.steps = TiltSeriesPreprocessing::Normalize;
+  new TiltSeriesPreprocessingReaction(normalizationAction, normalize, this);
   new AddPythonTransformReaction(
     gradientMagnitude2DSobelAction, "Gradient Magnitude 2D",
     readInPythonScript("GradientMagnitude2D_Sobel"), false, false, false);
@@ -403,9 +414,6 @@ MainWindow::MainWindow(QWidget* parent, Qt::WindowFlags flags)
     autoAlignCOMAction, "Auto Tilt Image Align (CoM)",
     readInPythonScript("AutoCenterOfMassTiltImageAlignment"), false, false,
     false, readInJSONDescription("AutoCenterOfMassTiltImageAlignment"));
-  new AddPythonTransformReaction(reconDFMAction, "Reconstruct (Direct Fourier)",
-                                 readInPythonScript("Recon_DFT"), true, false,
-                                 false, readInJSONDescription("Recon_DFT"));
   new AddPythonTransformReaction(reconWBPAction,
                                  "Reconstruct (Back Projection)",
                                  readInPythonScript("Recon_WBP"), true, false,
@@ -420,10 +428,6 @@ MainWindow::MainWindow(QWidget* parent, Qt::WindowFlags flags)
     reconDFMConstraintAction, "Reconstruct (Constraint-based Direct Fourier)",
     readInPythonScript("Recon_DFT_constraint"), true, false, false,
     readInJSONDescription("Recon_DFT_constraint"));
-  new AddPythonTransformReaction(
-    reconTVMinimizationAction, "Reconstruct (TV Minimization)",
-    readInPythonScript("Recon_TV_minimization"), true, false, false,
-    readInJSONDescription("Recon_TV_minimization"));
   new AddPythonTransformReaction(
     reconTomoPyGridRecAction, "Reconstruct (TomoPy Gridrec)",
     readInPythonScript("Recon_tomopy_gridrec"), true, false, false,
@@ -434,6 +438,11 @@ MainWindow::MainWindow(QWidget* parent, Qt::WindowFlags flags)
     readInJSONDescription("Recon_tomopy_fxi"));
 
   new ReconstructionReaction(reconWBP_CAction);
+  new ReconstructionReaction(reconDFMAction,
+                             ReconstructionOperator::Method::DirectFourier);
+  new TotalVariationReaction(reconTVMinimizationAction,
+                             TotalVariationOperator::Mode::Reconstruction,
+                             this);
 
   new AddPythonTransformReaction(
     randomShiftsAction, "Shift Tilt Series Randomly",
@@ -810,8 +819,14 @@ void MainWindow::importCustomTransform()
         QFile::copy(jsonSourcePath, jsonDestPath);
       }
 
-      // Register custom operators again.
-      registerCustomOperators(findCustomOperators());
+      // Register custom operators again. Only the new operator is imported,
+      // in the background.
+      auto watcher = new QFutureWatcher<std::vector<OperatorDescription>>;
+      connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher]() {
+        registerCustomOperators(watcher->result());
+        watcher->deleteLater();
+      });
+      watcher->setFuture(QtConcurrent::run(findCustomOperators));
     }
   }
 }
@@ -1090,11 +1105,17 @@ std::vector<OperatorDescription> MainWindow::findCustomOperators()
     }
   }
 
+  // Importing the operators can be slow, they are only imported again if
+  // their files changed since they were cached in the settings.
+  auto settings = pqApplicationCore::instance()->settings();
+  auto cache = settings->value("customOperators/cache").toString();
   std::vector<OperatorDescription> operators;
   foreach (QString path, paths) {
-    std::vector<OperatorDescription> ops = tomviz::findCustomOperators(path);
+    std::vector<OperatorDescription> ops =
+      tomviz::findCustomOperators(path, &cache);
     operators.insert(operators.end(), ops.begin(), ops.end());
   }
+  settings->setValue("customOperators/cache", cache);
 
   // Sort so we get a consistent order each time we load
   std::sort(operators.begin(), operators.end(),
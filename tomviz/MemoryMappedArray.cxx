@@ -0,0 +1,198 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "MemoryMappedArray.h"
+
+#include <pqApplicationCore.h>
+#include <pqSettings.h>
+
+#include <vtkDataArray.h>
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <cstdio>
+#endif
+
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// The file and the array of a mapped region. Destroying the file unmaps the
+// region.
+struct Mapping
+{
+  QFile* file;
+  vtkDataArray* array;
+};
+
+// The mapped regions, keyed by their address.
+QMutex mappingsMutex;
+QHash<void*, Mapping> mappings;
+
+void releaseMapping(void* data)
+{
+  QFile* file = nullptr;
+  {
+    QMutexLocker lock(&mappingsMutex);
+    file = mappings.take(data).file;
+  }
+  delete file;
+}
+
+#ifdef Q_OS_WIN
+// Give the arrays mapping \p fileName their own copy of the data, which
+// unmaps the file.
+bool detachMappings(const QString& fileName)
+{
+  auto path = QFileInfo(fileName).canonicalFilePath();
+  QList<vtkDataArray*> arrays;
+  {
+    QMutexLocker lock(&mappingsMutex);
+    for (const auto& mapping : mappings) {
+      if (QFileInfo(mapping.file->fileName()).canonicalFilePath() == path) {
+        arrays << mapping.array;
+      }
+    }
+  }
+
+  for (auto array : arrays) {
+    const vtkIdType numValues = array->GetNumberOfValues();
+    const size_t size =
+      static_cast<size_t>(numValues) * array->GetDataTypeSize();
+    auto copy = malloc(size);
+    if (!copy) {
+      return false;
+    }
+    memcpy(copy, array->GetVoidPointer(0), size);
+    // Releases the mapping.
+    array->SetVoidArray(copy, numValues, 0,
+                        vtkAbstractArray::VTK_DATA_ARRAY_FREE);
+  }
+  return true;
+}
+#endif
+} // namespace
+
+namespace tomviz {
+
+bool MemoryMappedArray::enabled()
+{
+  auto core = pqApplicationCore::instance();
+  if (!core) {
+    return true;
+  }
+  return core->settings()->value("Tomviz.MemoryMapData", true).toBool();
+}
+
+vtkSmartPointer<vtkDataArray> MemoryMappedArray::map(const QString& fileName,
+                                                     qint64 offset, int vtkType,
+                                                     vtkIdType numTuples,
+                                                     int numComponents)
+{
+  vtkSmartPointer<vtkDataArray> array;
+  array.TakeReference(vtkDataArray::CreateDataArray(vtkType));
+  if (!array || numTuples <= 0 || numComponents < 1 || offset < 0) {
+    return nullptr;
+  }
+
+  const vtkIdType numValues = numTuples * numComponents;
+  const qint64 size =
+    static_cast<qint64>(numValues) * array->GetDataTypeSize();
+
+  auto file = new QFile(fileName);
+  if (!file->open(QIODevice::ReadOnly) || file->size() < offset + size) {
+    delete file;
+    return nullptr;
+  }
+
+  auto data = file->map(offset, size, QFileDevice::MapPrivateOption);
+  if (!data) {
+    delete file;
+    return nullptr;
+  }
+  // The mapping outlives the file descriptor.
+  file->close();
+
+  {
+    QMutexLocker lock(&mappingsMutex);
+    mappings.insert(data, { file, array });
+  }
+
+  array->SetNumberOfComponents(numComponents);
+  array->SetVoidArray(data, numValues, 0,
+                      vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+  array->SetArrayFreeFunction(releaseMapping);
+
+  return array;
+}
+
+bool MemoryMappedArray::isMapped(vtkDataArray* array)
+{
+  if (!array) {
+    return false;
+  }
+
+  QMutexLocker lock(&mappingsMutex);
+  return mappings.contains(array->GetVoidPointer(0));
+}
+
+bool MemoryMappedArray::writeReplacing(
+  const QString& fileName, const std::function<bool(const QString&)>& write)
+{
+  if (!QFile::exists(fileName)) {
+    return write(fileName);
+  }
+
+  auto partName = partFileName(fileName);
+  QFile::remove(partName);
+  if (!write(partName)) {
+    QFile::remove(partName);
+    return false;
+  }
+  return replace(partName, fileName);
+}
+
+QString MemoryMappedArray::partFileName(const QString& fileName)
+{
+  QFileInfo info(fileName);
+  auto partName = info.completeBaseName() + ".part";
+  if (!info.suffix().isEmpty()) {
+    partName += "." + info.suffix();
+  }
+  return info.dir().filePath(partName);
+}
+
+bool MemoryMappedArray::replace(const QString& partName,
+                                const QString& fileName)
+{
+#ifdef Q_OS_WIN
+  bool success =
+    detachMappings(fileName) &&
+    MoveFileExW(reinterpret_cast<const wchar_t*>(
+                  QDir::toNativeSeparators(partName).utf16()),
+                reinterpret_cast<const wchar_t*>(
+                  QDir::toNativeSeparators(fileName).utf16()),
+                MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+  bool success = std::rename(QFile::encodeName(partName).constData(),
+                             QFile::encodeName(fileName).constData()) == 0;
+#endif
+  if (!success) {
+    qCritical() << "Unable to replace" << fileName << "the data was written to"
+                << partName;
+  }
+  return success;
+}
+
+} // namespace tomviz
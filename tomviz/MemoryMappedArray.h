@@ -0,0 +1,63 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizMemoryMappedArray_h
+#define tomvizMemoryMappedArray_h
+
+#include <QString>
+
+#include <vtkSmartPointer.h>
+#include <vtkType.h>
+
+#include <functional>
+
+class vtkDataArray;
+
+namespace tomviz {
+
+/// Data arrays backed by a private memory mapping of a region of a file.
+/// Pages are read from the file when they are first accessed, so loading
+/// costs nothing up front and the resident memory follows what is actually
+/// used. The mapping is copy on write, modifying the array never modifies the
+/// file.
+class MemoryMappedArray
+{
+public:
+  /// Returns true if readers should memory map the data they can, the
+  /// "Tomviz.MemoryMapData" setting, on by default.
+  static bool enabled();
+
+  /// Map \p numTuples tuples of \p numComponents values of \p vtkType stored
+  /// at \p offset in \p fileName. The values must be in the native byte
+  /// order. Returns a null pointer if the region can't be mapped, the caller
+  /// should then read the data instead.
+  static vtkSmartPointer<vtkDataArray> map(const QString& fileName,
+                                           qint64 offset, int vtkType,
+                                           vtkIdType numTuples,
+                                           int numComponents = 1);
+
+  /// Returns true if \p array is memory mapped by map().
+  static bool isMapped(vtkDataArray* array);
+
+  /// Write \p fileName by calling \p write with the name to write to. An
+  /// existing file is not truncated, it may be mapped by an array still in
+  /// use: the data is written to partFileName() next to it, which then
+  /// replaces it. If the write fails the file is left as it was. If only the
+  /// replacement fails the written data is kept in the part file.
+  static bool writeReplacing(const QString& fileName,
+                             const std::function<bool(const QString&)>& write);
+
+  /// "<name>.part.<suffix>" next to \p fileName. The suffix is kept since
+  /// writers may pick the format from it.
+  static QString partFileName(const QString& fileName);
+
+  /// Replace \p fileName by \p partName in a single step, \p fileName is
+  /// never missing. The mappings of \p fileName keep the data they mapped:
+  /// on POSIX systems the replaced file lives on until it is unmapped, on
+  /// Windows, where a mapped file can't be replaced, the arrays mapping it
+  /// get a copy of their data first.
+  static bool replace(const QString& partName, const QString& fileName);
+};
+} // namespace tomviz
+
+#endif
@@ -0,0 +1,253 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "PipelineRunner.h"
+
+#include "ActiveObjects.h"
+#include "DataExchangeFormat.h"
+#include "DataSource.h"
+#include "EmdFormat.h"
+#include "GenericHDF5Format.h"
+#include "ModuleManager.h"
+#include "Operator.h"
+#include "OperatorFactory.h"
+#include "Pipeline.h"
+#include "Tvh5Format.h"
+
+#include <vtkImageData.h>
+#include <vtkNew.h>
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSharedPointer>
+#include <QVariantMap>
+
+#include <iostream>
+
+namespace tomviz {
+
+PipelineRunner::PipelineRunner(QObject* p) : QObject(p) {}
+
+bool PipelineRunner::loadState(const QString& fileName)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly)) {
+    m_errorMessage = QString("Unable to read the state file %1.").arg(fileName);
+    return false;
+  }
+  QJsonParseError error;
+  auto document = QJsonDocument::fromJson(file.readAll(), &error);
+  if (error.error != QJsonParseError::NoError || !document.isObject()) {
+    m_errorMessage = QString("Invalid state file %1: %2.")
+                       .arg(fileName)
+                       .arg(error.errorString());
+    return false;
+  }
+
+  auto dataSources = document.object()["dataSources"].toArray();
+  if (dataSources.size() != 1) {
+    m_errorMessage =
+      "Only state files with a single data source are supported.";
+    return false;
+  }
+  m_dataSourceState = dataSources[0].toObject();
+  m_operators = m_dataSourceState["operators"].toArray();
+  if (m_operators.isEmpty()) {
+    m_errorMessage = "No operators found.";
+    return false;
+  }
+
+  // The file names are relative to the state file.
+  m_stateDataFile.clear();
+  auto fileNames =
+    m_dataSourceState["reader"].toObject()["fileNames"].toArray();
+  if (fileNames.size() == 1) {
+    auto dir = QFileInfo(fileName).absoluteDir();
+    m_stateDataFile =
+      QDir::cleanPath(dir.absoluteFilePath(fileNames[0].toString()));
+  }
+
+  return true;
+}
+
+bool PipelineRunner::execute(const QString& dataFile,
+                             const QString& outputFile)
+{
+  m_errorMessage.clear();
+  auto dataSource = readData(dataFile);
+  if (!dataSource) {
+    return false;
+  }
+
+  // The pipeline runs in the background, whatever the settings of the
+  // application are.
+  auto pipeline = new Pipeline(dataSource, this);
+  pipeline->setExecutionMode(Pipeline::Threaded);
+  ModuleManager::instance().addDataSource(dataSource);
+
+  // The label, the scalars, the spacing and the units of the data source,
+  // the operators are added by runPipeline().
+  auto state = m_dataSourceState;
+  state.remove("modules");
+  state.remove("operators");
+  dataSource->deserialize(state);
+
+  bool success = runPipeline(dataSource) &&
+                 writeOutput(pipeline->transformedDataSource(), outputFile);
+
+  // Release the data before the next file, the event loop may not run in
+  // between.
+  ActiveObjects::instance().setActiveDataSource(nullptr);
+  for (auto child : ModuleManager::instance().childDataSources()) {
+    ModuleManager::instance().removeChildDataSource(child);
+  }
+  ModuleManager::instance().removeDataSource(dataSource);
+  pipeline->deleteLater();
+  QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+  return success;
+}
+
+DataSource* PipelineRunner::readData(const QString& fileName)
+{
+  QFileInfo info(fileName);
+  auto suffix = info.suffix().toLower();
+  auto name = fileName.toStdString();
+
+  // Never prompt for the subsample settings, use those of the state.
+  QVariantMap options = { { "askForSubsample", false } };
+  if (m_dataSourceState.contains("subsampleSettings")) {
+    auto settings = m_dataSourceState["subsampleSettings"].toObject();
+    options["subsampleStrides"] = settings["strides"].toVariant();
+    options["subsampleVolumeBounds"] = settings["volumeBounds"].toVariant();
+  }
+
+  DataSource* dataSource = nullptr;
+  bool hdf5 = suffix == "h5" || suffix == "hdf5";
+  if (hdf5 && GenericHDF5Format::isDataExchange(name)) {
+    dataSource = new DataSource(info.completeBaseName());
+    DataExchangeFormat format;
+    if (!format.read(name, dataSource, options)) {
+      delete dataSource;
+      dataSource = nullptr;
+    }
+  } else if (hdf5 || suffix == "emd") {
+    vtkNew<vtkImageData> image;
+    bool read = hdf5 ? GenericHDF5Format::read(name, image, options)
+                     : EmdFormat::read(name, image, options);
+    if (read) {
+      DataSource::DataSourceType type = DataSource::hasTiltAngles(image)
+                                          ? DataSource::TiltSeries
+                                          : DataSource::Volume;
+      dataSource = new DataSource(image, type);
+    }
+  } else {
+    m_errorMessage =
+      QString("Unsupported data source format %1, only HDF5 formats are "
+              "supported.")
+        .arg(fileName);
+    return nullptr;
+  }
+
+  if (!dataSource) {
+    m_errorMessage = QString("Unable to read %1.").arg(fileName);
+    return nullptr;
+  }
+  dataSource->setFileNames(QStringList() << info.absoluteFilePath());
+
+  return dataSource;
+}
+
+bool PipelineRunner::runPipeline(DataSource* dataSource)
+{
+  // Adding the operators must not start the pipeline, it is run once all of
+  // them are added.
+  auto pipeline = dataSource->pipeline();
+  pipeline->pause();
+
+  QList<Operator*> operators;
+  auto count = m_operators.size() - m_operatorIndex;
+  for (int i = m_operatorIndex; i < m_operators.size(); ++i) {
+    auto json = m_operators[i].toObject();
+    auto type = json["type"].toString();
+    auto op = OperatorFactory::instance().createOperator(type, dataSource);
+    if (!op || !op->deserialize(json)) {
+      delete op;
+      m_errorMessage =
+        QString("Unable to create the operator %1 of type \"%2\".")
+          .arg(i)
+          .arg(type);
+      return false;
+    }
+
+    // The operators report from the worker thread, the messages are written
+    // from this one.
+    auto timer = QSharedPointer<QElapsedTimer>::create();
+    auto number = operators.size() + 1;
+    connect(op, &Operator::transformingStarted, this, [op, timer, number,
+                                                       count]() {
+      timer->start();
+      std::cout << "[" << number << "/" << count << "] Running "
+                << op->label().toStdString() << std::endl;
+    });
+    connect(op, &Operator::transformingDone, this,
+            [op, timer](TransformResult result) {
+              if (result == TransformResult::Complete) {
+                std::cout << op->label().toStdString() << " completed in "
+                          << timer->elapsed() / 1000.0 << " s" << std::endl;
+              }
+            });
+
+    dataSource->addOperator(op);
+    operators << op;
+  }
+
+  if (operators.isEmpty()) {
+    return true;
+  }
+
+  pipeline->resume();
+  QEventLoop loop;
+  auto future = pipeline->execute(dataSource);
+  connect(future, &Pipeline::Future::finished, &loop, &QEventLoop::quit);
+  connect(future, &Pipeline::Future::canceled, &loop, &QEventLoop::quit);
+  loop.exec();
+  future->deleteLater();
+
+  foreach (auto op, operators) {
+    if (op->state() != OperatorState::Complete) {
+      m_errorMessage = QString("The operator \"%1\" failed.").arg(op->label());
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool PipelineRunner::writeOutput(DataSource* dataSource,
+                                 const QString& fileName)
+{
+  auto name = fileName.toStdString();
+  bool success = false;
+  if (QFileInfo(fileName).suffix().toLower() == "tvh5") {
+    // The output is the active data source, the standard EMD node of the
+    // file, and the state holds the pipeline that produced it.
+    ActiveObjects::instance().setActiveDataSource(dataSource);
+    success = Tvh5Format::write(name);
+  } else {
+    success = EmdFormat::write(name, dataSource);
+  }
+
+  if (!success) {
+    m_errorMessage = QString("Unable to write %1.").arg(fileName);
+  }
+  return success;
+}
+
+} // namespace tomviz
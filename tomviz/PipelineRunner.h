@@ -0,0 +1,70 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizPipelineRunner_h
+#define tomvizPipelineRunner_h
+
+#include <QObject>
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+
+namespace tomviz {
+
+class DataSource;
+
+/// Runs the pipeline of a state file on data files without the user
+/// interface, as the tomviz command line does with the Python executor, but
+/// with the operators of the application, C++ operators included. The
+/// operators are created through the OperatorFactory and run by the
+/// ThreadPipelineExecutor, the pipeline is the one the application builds.
+///
+/// Only the operators of the root data source of the state are run, the
+/// modules are ignored.
+class PipelineRunner : public QObject
+{
+  Q_OBJECT
+
+public:
+  PipelineRunner(QObject* parent = nullptr);
+
+  /// Load the pipeline from a state file, which must have a single data
+  /// source. Returns false, and sets the error message, on failure.
+  bool loadState(const QString& fileName);
+
+  /// The data file of the data source of the state, an absolute path, empty
+  /// if it has none.
+  QString stateDataFile() const { return m_stateDataFile; }
+
+  /// The operator to start at, the data read being the output of the ones
+  /// before.
+  void setOperatorIndex(int index) { m_operatorIndex = qMax(index, 0); }
+  int operatorIndex() const { return m_operatorIndex; }
+
+  /// Run the pipeline on the data of an EMD, Data Exchange or HDF5 file, and
+  /// write the output. The output is written as a tvh5 file, with the state
+  /// of the pipeline, if the file name ends with .tvh5, and as EMD otherwise.
+  /// The event loop runs meanwhile. Returns false, and sets the error
+  /// message, on failure.
+  bool execute(const QString& dataFile, const QString& outputFile);
+
+  /// Describes the error once loadState() or execute() failed.
+  QString errorMessage() const { return m_errorMessage; }
+
+private:
+  DataSource* readData(const QString& fileName);
+  bool runPipeline(DataSource* dataSource);
+  bool writeOutput(DataSource* dataSource, const QString& fileName);
+
+  QJsonObject m_dataSourceState;
+  QJsonArray m_operators;
+  QString m_stateDataFile;
+  int m_operatorIndex = 0;
+  QString m_errorMessage;
+
+  Q_DISABLE_COPY(PipelineRunner)
+};
+} // namespace tomviz
+
+#endif
@@ -0,0 +1,181 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include <QApplication>
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFileInfo>
+
+#include <pqActiveObjects.h>
+#include <pqApplicationCore.h>
+#include <pqObjectBuilder.h>
+#include <pqPVApplicationCore.h>
+#include <pqServer.h>
+#include <pqServerResource.h>
+
+#include "PipelineRunner.h"
+#include "tomvizConfig.h"
+#include "tomvizPythonConfig.h"
+
+#include <clocale>
+#include <iostream>
+
+// Runs the pipeline of a state file on data files, with the operators of the
+// application, and without its user interface. The options are those of the
+// tomviz Python command line.
+int main(int argc, char** argv)
+{
+  // Nothing is shown, no display is needed.
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+
+  QCoreApplication::setApplicationName("tomviz");
+  QCoreApplication::setApplicationVersion(TOMVIZ_VERSION);
+  QCoreApplication::setOrganizationName("tomviz");
+
+  tomviz::InitializePythonEnvironment(argc, argv);
+
+  QApplication app(argc, argv);
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+    "Run the pipeline of a Tomviz state file on data files.");
+  parser.addHelpOption();
+  parser.addVersionOption();
+  QCommandLineOption dataOption(
+    QStringList() << "d"
+                  << "data-path",
+    "Path to an EMD/Data Exchange file or directory containing EMD/Data "
+    "Exchange files, can be used to override data source in state file. If "
+    "multiple files are provided the pipeline will be run for each file.",
+    "path");
+  QCommandLineOption stateOption(QStringList() << "s"
+                                               << "state-file-path",
+                                 "Path to the Tomviz state file.", "path");
+  QCommandLineOption outputOption(
+    QStringList() << "o"
+                  << "output-file-path",
+    "Path to write the transformed dataset, as tvh5 if it ends with .tvh5 "
+    "and as EMD otherwise, or the directory to write them to.",
+    "path");
+  QCommandLineOption indexOption(QStringList() << "i"
+                                               << "operator-index",
+                                 "The operator to start at.", "index", "0");
+  parser.addOptions({ dataOption, stateOption, outputOption, indexOption });
+  parser.process(app);
+
+  if (!parser.isSet(stateOption)) {
+    std::cerr << "The state file is required." << std::endl;
+    return 1;
+  }
+
+  std::string exeDir = QApplication::applicationDirPath().toLatin1().data();
+  if (tomviz::isApplicationBundle(exeDir)) {
+    QByteArray pythonPath = tomviz::bundlePythonPath(exeDir).c_str();
+    qputenv("PYTHONPATH", pythonPath);
+    qputenv("PYTHONHOME", pythonPath);
+  }
+
+  // The Python operators run as they do inside the application.
+  qputenv("TOMVIZ_APPLICATION", "1");
+
+  setlocale(LC_NUMERIC, "C");
+  // Our options are not ParaView's.
+  int pvArgc = 1;
+  pqPVApplicationCore appCore(pvArgc, argv);
+  auto server = pqApplicationCore::instance()->getObjectBuilder()->createServer(
+    pqServerResource("builtin:"));
+  pqActiveObjects::instance().setActiveServer(server);
+
+  tomviz::PipelineRunner runner;
+  if (!runner.loadState(parser.value(stateOption))) {
+    std::cerr << runner.errorMessage().toStdString() << std::endl;
+    return 1;
+  }
+  runner.setOperatorIndex(parser.value(indexOption).toInt());
+
+  auto dataPath = parser.value(dataOption);
+  if (dataPath.isEmpty()) {
+    dataPath = runner.stateDataFile();
+    if (dataPath.isEmpty()) {
+      std::cerr << "Data source does not contain a single data file."
+                << std::endl;
+      return 1;
+    }
+  }
+  if (!QFileInfo::exists(dataPath)) {
+    std::cerr << "Data source path does not exist: " << dataPath.toStdString()
+              << std::endl;
+    return 1;
+  }
+
+  // Files in a directory are written to the output directory, created if
+  // needed, or to the current one.
+  auto outputPath = parser.value(outputOption);
+  QStringList dataFiles;
+  QStringList outputFiles;
+  if (QFileInfo(dataPath).isDir()) {
+    QDir outputDir;
+    if (!outputPath.isEmpty()) {
+      QFileInfo outputInfo(outputPath);
+      auto suffix = outputInfo.suffix().toLower();
+      if ((outputInfo.exists() && !outputInfo.isDir()) || suffix == "tvh5" ||
+          suffix == "emd") {
+        std::cerr << "The output path must be a directory when the data path "
+                     "is one: "
+                  << outputPath.toStdString() << std::endl;
+        return 1;
+      }
+      if (!QDir().mkpath(outputPath)) {
+        std::cerr << "Unable to create the output directory "
+                  << outputPath.toStdString() << std::endl;
+        return 1;
+      }
+      outputDir = QDir(outputPath);
+    }
+    auto entries = QDir(dataPath).entryInfoList(
+      QStringList() << "*.emd"
+                    << "*.h5"
+                    << "*.hdf5",
+      QDir::Files, QDir::Name);
+    foreach (const QFileInfo& entry, entries) {
+      dataFiles << entry.absoluteFilePath();
+      outputFiles << outputDir.filePath(entry.completeBaseName() +
+                                        "_transformed.emd");
+    }
+  } else {
+    dataFiles << dataPath;
+    if (outputPath.isEmpty()) {
+      outputPath = QFileInfo(dataPath).completeBaseName() + "_transformed.emd";
+    }
+    outputFiles << outputPath;
+  }
+
+  if (dataFiles.isEmpty()) {
+    std::cerr << "No data files found." << std::endl;
+    return 1;
+  }
+  if (dataFiles.size() > 1) {
+    std::cout << "Executing pipeline on " << dataFiles.size() << " files."
+              << std::endl;
+  }
+
+  int failed = 0;
+  for (int i = 0; i < dataFiles.size(); ++i) {
+    std::cout << "Executing pipeline on " << dataFiles[i].toStdString()
+              << std::endl;
+    if (!runner.execute(dataFiles[i], outputFiles[i])) {
+      std::cerr << runner.errorMessage().toStdString() << std::endl;
+      ++failed;
+    }
+  }
+
+  if (failed > 0) {
+    std::cerr << "The pipeline failed on " << failed << " of "
+              << dataFiles.size() << " files." << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,37 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "PoreSizeDistributionReaction.h"
+
+#include <QAction>
+#include <QMainWindow>
+
+#include "ActiveObjects.h"
+#include "DataSource.h"
+#include "EditOperatorDialog.h"
+#include "PoreSizeDistributionOperator.h"
+
+namespace tomviz {
+
+PoreSizeDistributionReaction::PoreSizeDistributionReaction(
+  QAction* parentObject, QMainWindow* mw)
+  : Reaction(parentObject), m_mainWindow(mw)
+{
+}
+
+void PoreSizeDistributionReaction::addOperator(DataSource* source)
+{
+  source = source ? source : ActiveObjects::instance().activeParentDataSource();
+  if (!source) {
+    return;
+  }
+
+  auto* op = new PoreSizeDistributionOperator();
+
+  EditOperatorDialog* dialog =
+    new EditOperatorDialog(op, source, true, m_mainWindow);
+  dialog->setAttribute(Qt::WA_DeleteOnClose);
+  dialog->show();
+  connect(op, SIGNAL(destroyed()), dialog, SLOT(reject()));
+}
+} // namespace tomviz
@@ -17,8 +17,16 @@
 
 #include <pybind11/pybind11.h>
 
+#include <QCryptographicHash>
+#include <QHash>
+
 namespace py = pybind11;
 
+namespace {
+// The compiled scripts that are kept, the cache starts over beyond that.
+const int MaxCachedScripts = 256;
+} // namespace
+
 namespace tomviz {
 
 Python::Capsule::Capsule(const void* ptr)
@@ -510,14 +518,26 @@ Python::Module Python::import(const QString& str, const QString& filename,
 
   Python::Module module;
 
-  vtkSmartPyObject code =
-    Py_CompileString(str.toLatin1().data(), filename.toLatin1().data(),
-                     Py_file_input /*Py_eval_input*/);
+  // Scripts are compiled once, each import executes the code in a new
+  // module. The cache is only used with the GIL held, and is never destroyed
+  // as its code objects may not outlive the interpreter.
+  static auto* codeCache = new QHash<QByteArray, vtkSmartPyObject>();
+  auto key = QCryptographicHash::hash(
+    filename.toUtf8() + '\0' + str.toUtf8(), QCryptographicHash::Sha1);
+  vtkSmartPyObject code = codeCache->value(key);
   if (!code) {
-    checkForPythonError();
-    Logger::critical(
-      "Invalid script. Please check the traceback message for details");
-    return module;
+    code = Py_CompileString(str.toLatin1().data(), filename.toLatin1().data(),
+                            Py_file_input /*Py_eval_input*/);
+    if (!code) {
+      checkForPythonError();
+      Logger::critical(
+        "Invalid script. Please check the traceback message for details");
+      return module;
+    }
+    if (codeCache->size() >= MaxCachedScripts) {
+      codeCache->clear();
+    }
+    codeCache->insert(key, code);
   }
 
   module = PyImport_ExecCodeModule(moduleName.toLatin1().data(), code);
@@ -627,7 +647,8 @@ Python::Object Python::createDataset(vtkObjectBase* data,
   return createDatasetFunc.call(args);
 }
 
-std::vector<OperatorDescription> findCustomOperators(const QString& path)
+std::vector<OperatorDescription> findCustomOperators(const QString& path,
+                                                     QString* cache)
 {
   Python python;
   auto internalModule = python.import("tomviz._internal");
@@ -635,22 +656,31 @@ std::vector<OperatorDescription> findCustomOperators(const QString& path)
     Logger::critical("Failed to import tomviz._internal module.");
   }
 
-  auto findCustomOperators = internalModule.findFunction("find_operators");
+  auto findCustomOperators =
+    internalModule.findFunction("find_operators_cached");
   if (!findCustomOperators.isValid()) {
-    Logger::critical("Unable to locate find_operators.");
+    Logger::critical("Unable to locate find_operators_cached.");
   }
 
   std::vector<OperatorDescription> operators;
   Python::Object pyPath(path);
-  Python::Tuple args(1);
+  Python::Object pyCache(cache ? *cache : QString());
+  Python::Tuple args(2);
   args.set(0, pyPath);
+  args.set(1, pyCache);
 
-  auto pyOperators = findCustomOperators.call(args);
-  if (!pyOperators.isValid()) {
+  auto result = findCustomOperators.call(args);
+  if (!result.isValid()) {
     Logger::critical("Failed to execute findCustomOperators.");
+    return operators;
+  }
+
+  Python::Tuple reply(result);
+  if (cache) {
+    *cache = reply[1].toString();
   }
 
-  Python::List ops(pyOperators);
+  Python::List ops(reply[0]);
   for (int i = 0; i < ops.length(); i++) {
     Python::Dict opDict = ops[i].toDict();
     OperatorDescription op;
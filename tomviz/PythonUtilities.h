@@ -228,7 +228,11 @@ struct OperatorDescription
   bool valid = true;
 };
 
-std::vector<OperatorDescription> findCustomOperators(const QString& path);
+/// Find the operators of the Python files in a directory. If @param cache is
+/// given, a JSON document of the operators found before, only the files that
+/// changed since are imported again, and the document is updated.
+std::vector<OperatorDescription> findCustomOperators(const QString& path,
+                                                     QString* cache = nullptr);
 } // namespace tomviz
 
 #endif
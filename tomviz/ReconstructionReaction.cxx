@@ -10,15 +10,14 @@
 #include <vtkSMSourceProxy.h>
 #include <vtkTrivialProducer.h>
 
-#include "ReconstructionOperator.h"
-
 #include <QDebug>
 #include <QSharedPointer>
 
 namespace tomviz {
 
-ReconstructionReaction::ReconstructionReaction(QAction* parentObject)
-  : Reaction(parentObject)
+ReconstructionReaction::ReconstructionReaction(
+  QAction* parentObject, ReconstructionOperator::Method method)
+  : Reaction(parentObject), m_method(method)
 {
 }
 
@@ -30,7 +29,8 @@ void ReconstructionReaction::recon(DataSource* input)
     return;
   }
 
-  Operator* op = new ReconstructionOperator(input);
+  auto* op = new ReconstructionOperator(input);
+  op->setMethod(m_method);
   input->addOperator(op);
 }
 } // namespace tomviz
@@ -6,6 +6,8 @@
 
 #include <Reaction.h>
 
+#include "ReconstructionOperator.h"
+
 namespace tomviz {
 class DataSource;
 
@@ -14,7 +16,9 @@ class ReconstructionReaction : public Reaction
   Q_OBJECT
 
 public:
-  ReconstructionReaction(QAction* parent);
+  ReconstructionReaction(QAction* parent,
+                         ReconstructionOperator::Method method =
+                           ReconstructionOperator::Method::BackProjection);
 
   void recon(DataSource* input = NULL);
 
@@ -22,6 +26,8 @@ protected:
   void onTriggered() { recon(); }
 
 private:
+  ReconstructionOperator::Method m_method;
+
   Q_DISABLE_COPY(ReconstructionReaction)
 };
 } // namespace tomviz
@@ -11,8 +11,10 @@
 #include "ActiveObjects.h"
 #include "DataSource.h"
 #include "FileFormatManager.h"
+#include "MemoryMappedArray.h"
 #include "ModuleManager.h"
 #include "PythonWriter.h"
+#include "Tvh5Multiscale.h"
 
 #include <pqActiveObjects.h>
 #include <pqPipelineSource.h>
@@ -27,7 +29,9 @@
 #include <vtkSMWriterFactory.h>
 
 #include <vtkDataArray.h>
+#include <vtkAlgorithm.h>
 #include <vtkDataObject.h>
+#include <vtkErrorCode.h>
 #include <vtkImageData.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
@@ -107,6 +111,12 @@ void SaveDataReaction::onTriggered()
 
 bool SaveDataReaction::saveData(const QString& filename)
 {
+  // Data sources still being streamed from a file must be complete
+  if (!Tvh5Multiscale::finishAll()) {
+    qCritical("The data could not all be read, it can't be saved.");
+    return false;
+  }
+
   auto server = pqActiveObjects::instance().activeServer();
   auto source = ActiveObjects::instance().activeDataSource();
   auto result = ActiveObjects::instance().activeOperatorResult();
@@ -137,7 +147,10 @@ bool SaveDataReaction::saveData(const QString& filename)
     }
   } else if (info.suffix() == "h5") {
     DataExchangeFormat writer;
-    if (!writer.write(filename.toLatin1().data(), source)) {
+    auto write = [&writer, source](const QString& name) {
+      return writer.write(name.toLatin1().data(), source);
+    };
+    if (!MemoryMappedArray::writeReplacing(filename, write)) {
       qCritical() << "Failed to write out data.";
       return false;
     } else {
@@ -152,7 +165,10 @@ bool SaveDataReaction::saveData(const QString& filename)
     auto writer = factory->createWriter();
     auto t = source->producer();
     auto data = vtkImageData::SafeDownCast(t->GetOutputDataObject(0));
-    if (!writer.write(filename, data)) {
+    auto write = [&writer, data](const QString& name) {
+      return writer.write(name, data);
+    };
+    if (!MemoryMappedArray::writeReplacing(filename, write)) {
       qCritical() << "Failed to write out data.";
       return false;
     } else {
@@ -193,8 +209,15 @@ bool SaveDataReaction::saveData(const QString& filename)
 
       vtkNew<vtkTIFFWriter> tiff;
       tiff->SetInputData(fImage);
-      tiff->SetFileName(filename.toLatin1().data());
-      tiff->Write();
+      auto write = [&tiff](const QString& name) {
+        tiff->SetFileName(name.toLatin1().data());
+        tiff->Write();
+        return tiff->GetErrorCode() == vtkErrorCode::NoError;
+      };
+      if (!MemoryMappedArray::writeReplacing(filename, write)) {
+        qCritical() << "Failed to write out data.";
+        return false;
+      }
 
       updateSource(filename, source);
       return true;
@@ -216,8 +239,19 @@ bool SaveDataReaction::saveData(const QString& filename)
       return false;
     }
   }
-  writer->UpdateVTKObjects();
-  writer->UpdatePipeline();
+  // The data may be mapped from the file written over.
+  auto write = [writer](const QString& name) {
+    vtkSMPropertyHelper(writer, "FileName").Set(name.toLatin1().data());
+    writer->UpdateVTKObjects();
+    writer->UpdatePipeline();
+    auto algorithm = vtkAlgorithm::SafeDownCast(writer->GetClientSideObject());
+    return algorithm && algorithm->GetErrorCode() == vtkErrorCode::NoError &&
+           QFileInfo::exists(name);
+  };
+  if (!MemoryMappedArray::writeReplacing(filename, write)) {
+    qCritical() << "Failed to write out data.";
+    return false;
+  }
 
   updateSource(filename, source);
 
@@ -0,0 +1,248 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "TiltSeriesPreprocessing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+// The smallest white - dark of the flat field correction, as in TomoPy.
+const float MinimumFlat = 1e-6f;
+
+// The bins of the histogram of the Histogram background method.
+const int HistogramBins = 256;
+} // namespace
+
+namespace tomviz {
+
+TiltSeriesPreprocessing::TiltSeriesPreprocessing(const int dims[3],
+                                                 const Parameters& parameters)
+  : m_parameters(parameters)
+{
+  std::copy(dims, dims + 3, m_dims);
+}
+
+bool TiltSeriesPreprocessing::apply(float* values, const float* dark,
+                                    const float* white,
+                                    const Progress& progress) const
+{
+  const int steps = m_parameters.steps;
+  const int numProjections = m_dims[2];
+  const vtkIdType size = static_cast<vtkIdType>(m_dims[0]) * m_dims[1];
+  const bool flatField = (steps & FlatField) && dark && white;
+
+  // The sum and the finite range of each projection, for the second pass.
+  std::vector<double> sums(numProjections, 0.0);
+  std::vector<float> minima(numProjections,
+                            std::numeric_limits<float>::infinity());
+  std::vector<float> maxima(numProjections,
+                            -std::numeric_limits<float>::infinity());
+
+  std::atomic<int> done(0);
+  std::atomic<bool> stopped(false);
+  vtkSMPTools::For(0, numProjections, 1, [&](vtkIdType begin, vtkIdType end) {
+    // The projection before bad pixel removal, one per thread.
+    std::vector<float> buffer;
+    for (vtkIdType z = begin; z < end && !stopped; ++z) {
+      float* projection = values + z * size;
+      if (flatField) {
+        for (vtkIdType i = 0; i < size; ++i) {
+          projection[i] = (projection[i] - dark[i]) /
+                          std::max(white[i] - dark[i], MinimumFlat);
+        }
+      }
+      if (steps & BadPixels) {
+        buffer.assign(projection, projection + size);
+        removeBadPixels(buffer.data(), m_dims, m_parameters.badPixelThreshold,
+                        projection);
+      }
+      if (steps & Background) {
+        const double level =
+          m_parameters.backgroundMethod == BackgroundMethod::Histogram
+            ? histogramPeak(projection, size)
+            : regionMean(projection, m_dims, m_parameters.backgroundRegion);
+        const float background = static_cast<float>(level);
+        for (vtkIdType i = 0; i < size; ++i) {
+          projection[i] -= background;
+        }
+      }
+
+      double sum = 0.0;
+      float minimum = minima[z];
+      float maximum = maxima[z];
+      for (vtkIdType i = 0; i < size; ++i) {
+        const float value = projection[i];
+        sum += value;
+        if (std::isfinite(value)) {
+          minimum = std::min(minimum, value);
+          maximum = std::max(maximum, value);
+        }
+      }
+      sums[z] = sum;
+      minima[z] = minimum;
+      maxima[z] = maximum;
+
+      const int count = ++done;
+      if (progress && !progress(count)) {
+        stopped = true;
+      }
+    }
+  });
+  if (stopped) {
+    return false;
+  }
+  if (!(steps & (Normalize | ClipEdges)) || numProjections == 0) {
+    return true;
+  }
+
+  // Each projection is scaled to the mean total intensity of the series,
+  // unless its own is 0.
+  std::vector<float> scales(numProjections, 1.0f);
+  if (steps & Normalize) {
+    double intensity = 0.0;
+    for (double sum : sums) {
+      intensity += sum;
+    }
+    intensity /= numProjections;
+    for (int z = 0; z < numProjections; ++z) {
+      if (sums[z] != 0.0) {
+        scales[z] = static_cast<float>(intensity / sums[z]);
+      }
+    }
+  }
+
+  // The minimum of the scaled series fills the clipped edges.
+  float fill = std::numeric_limits<float>::infinity();
+  for (int z = 0; z < numProjections; ++z) {
+    if (minima[z] <= maxima[z]) {
+      fill = std::min(
+        fill, std::min(minima[z] * scales[z], maxima[z] * scales[z]));
+    }
+  }
+  if (!std::isfinite(fill)) {
+    fill = 0.0f;
+  }
+
+  const int width = (steps & ClipEdges) ? std::max(m_parameters.clipWidth, 0)
+                                        : 0;
+  vtkSMPTools::For(0, numProjections, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType z = begin; z < end; ++z) {
+      float* projection = values + z * size;
+      if (scales[z] != 1.0f) {
+        const float scale = scales[z];
+        for (vtkIdType i = 0; i < size; ++i) {
+          projection[i] *= scale;
+        }
+      }
+      if (width == 0) {
+        continue;
+      }
+      for (int y = 0; y < m_dims[1]; ++y) {
+        float* row = projection + static_cast<vtkIdType>(y) * m_dims[0];
+        if (y < width || y >= m_dims[1] - width) {
+          std::fill(row, row + m_dims[0], fill);
+        } else {
+          const int left = std::min(width, m_dims[0]);
+          std::fill(row, row + left, fill);
+          std::fill(row + std::max(m_dims[0] - width, left), row + m_dims[0],
+                    fill);
+        }
+      }
+    }
+  });
+  return true;
+}
+
+void TiltSeriesPreprocessing::removeBadPixels(const float* input,
+                                              const int dims[2],
+                                              double threshold, float* output)
+{
+  float window[9];
+  for (int y = 0; y < dims[1]; ++y) {
+    for (int x = 0; x < dims[0]; ++x) {
+      double sum = 0.0;
+      double sumOfSquares = 0.0;
+      int n = 0;
+      for (int j = -1; j <= 1; ++j) {
+        const int sy = std::min(std::max(y + j, 0), dims[1] - 1);
+        const float* row = input + static_cast<vtkIdType>(sy) * dims[0];
+        for (int i = -1; i <= 1; ++i) {
+          const float value = row[std::min(std::max(x + i, 0), dims[0] - 1)];
+          sum += value;
+          sumOfSquares += static_cast<double>(value) * value;
+          window[n++] = value;
+        }
+      }
+      const double mean = sum / 9.0;
+      const double deviation = std::sqrt(std::abs(sumOfSquares / 9.0 -
+                                                  mean * mean));
+      std::nth_element(window, window + 4, window + 9);
+      const float median = window[4];
+
+      const vtkIdType index = static_cast<vtkIdType>(y) * dims[0] + x;
+      const float value = input[index];
+      output[index] =
+        std::abs(value - median) > deviation * threshold ? median : value;
+    }
+  }
+}
+
+double TiltSeriesPreprocessing::histogramPeak(const float* values,
+                                              vtkIdType size)
+{
+  double first = std::numeric_limits<double>::infinity();
+  double last = -std::numeric_limits<double>::infinity();
+  for (vtkIdType i = 0; i < size; ++i) {
+    if (std::isfinite(values[i])) {
+      first = std::min(first, static_cast<double>(values[i]));
+      last = std::max(last, static_cast<double>(values[i]));
+    }
+  }
+  if (first > last) {
+    return 0.0;
+  }
+  // Like numpy.histogram, a single value is in the middle of a range of 1.
+  if (first == last) {
+    first -= 0.5;
+    last += 0.5;
+  }
+
+  std::vector<vtkIdType> counts(HistogramBins, 0);
+  const double norm = HistogramBins / (last - first);
+  for (vtkIdType i = 0; i < size; ++i) {
+    if (std::isfinite(values[i])) {
+      const int bin = static_cast<int>((values[i] - first) * norm);
+      ++counts[std::min(std::max(bin, 0), HistogramBins - 1)];
+    }
+  }
+  const auto peak = std::max_element(counts.begin(), counts.end());
+  return first + (peak - counts.begin()) / norm;
+}
+
+double TiltSeriesPreprocessing::regionMean(const float* values,
+                                           const int dims[2],
+                                           const int region[4])
+{
+  const int x0 = std::max(region[0], 0);
+  const int x1 = std::min(region[1], dims[0] - 1);
+  const int y0 = std::max(region[2], 0);
+  const int y1 = std::min(region[3], dims[1] - 1);
+  if (x0 > x1 || y0 > y1) {
+    return 0.0;
+  }
+  double sum = 0.0;
+  for (int y = y0; y <= y1; ++y) {
+    const float* row = values + static_cast<vtkIdType>(y) * dims[0];
+    for (int x = x0; x <= x1; ++x) {
+      sum += row[x];
+    }
+  }
+  return sum / (static_cast<double>(x1 - x0 + 1) * (y1 - y0 + 1));
+}
+
+} // namespace tomviz
@@ -0,0 +1,121 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizTiltSeriesPreprocessing_h
+#define tomvizTiltSeriesPreprocessing_h
+
+#include <vtkSMPTools.h>
+#include <vtkType.h>
+
+#include <functional>
+
+namespace tomviz {
+
+/// The corrections applied to the projections of a tilt series before it is
+/// aligned and reconstructed, in a single pass: the projections, the z slices
+/// of the volume, are processed in parallel, each one by a single thread
+/// that applies every enabled step to it in turn. Only normalization and edge
+/// clipping, which depend on the whole series, take a second pass, a scaling
+/// of the values.
+///
+/// The steps are those of the Python operators, applied in this order:
+/// - dark and white (flat field) correction, (p - dark) / (white - dark);
+/// - bad pixel removal, as RemoveBadPixelsTiltSeries;
+/// - background subtraction, as Subtract_TiltSer_Background and
+///   Subtract_TiltSer_Background_Auto;
+/// - normalization to the same total intensity, as NormalizeTiltSeries;
+/// - edge clipping, setting a border of each projection to the minimum of
+///   the series.
+class TiltSeriesPreprocessing
+{
+public:
+  enum Step
+  {
+    FlatField = 0x1,
+    BadPixels = 0x2,
+    Background = 0x4,
+    Normalize = 0x8,
+    ClipEdges = 0x10
+  };
+
+  /// How the background level of each projection is found.
+  enum class BackgroundMethod
+  {
+    /// The left edge of the highest bin of a histogram of 256 bins.
+    Histogram,
+    /// The mean of a region.
+    Region
+  };
+
+  struct Parameters
+  {
+    /// The enabled steps, a combination of Step values.
+    int steps = BadPixels | Background | Normalize;
+    /// Pixels further than this many standard deviations of their 3 x 3
+    /// neighbourhood from its median are replaced by the median.
+    double badPixelThreshold = 5.0;
+    BackgroundMethod backgroundMethod = BackgroundMethod::Histogram;
+    /// The first and last x and y of the region of the Region method,
+    /// clamped to the projections.
+    int backgroundRegion[4] = { 0, 15, 0, 15 };
+    /// The width of the clipped border, in pixels.
+    int clipWidth = 5;
+  };
+
+  /// Called with the number of projections done from time to time, from any
+  /// thread, returns false to stop.
+  using Progress = std::function<bool(int)>;
+
+  TiltSeriesPreprocessing(const int dims[3], const Parameters& parameters);
+
+  /// Apply the steps to the projections of \p values in place. \p dark and
+  /// \p white are single images, the size of a projection, needed for the
+  /// FlatField step. Returns false if \p progress stopped it.
+  bool apply(float* values, const float* dark = nullptr,
+             const float* white = nullptr,
+             const Progress& progress = nullptr) const;
+
+  /// The mean of the frames of \p frames, a stack of \p dims[2] images,
+  /// into \p average.
+  template <typename T>
+  static void averageFrames(const T* frames, const int dims[3],
+                            float* average);
+
+  /// Replace the bad pixels of the image \p input into \p output, which
+  /// must not overlap. The neighbourhoods are clamped at the edges. This runs
+  /// on the calling thread only.
+  static void removeBadPixels(const float* input, const int dims[2],
+                              double threshold, float* output);
+
+  /// The background level of the Histogram method, 0 if no value is finite.
+  static double histogramPeak(const float* values, vtkIdType size);
+
+  /// The mean of the region, the first and last x and y in \p region, of
+  /// the image \p values, 0 if the region is empty.
+  static double regionMean(const float* values, const int dims[2],
+                           const int region[4]);
+
+private:
+  int m_dims[3];
+  Parameters m_parameters;
+};
+
+template <typename T>
+void TiltSeriesPreprocessing::averageFrames(const T* frames,
+                                            const int dims[3],
+                                            float* average)
+{
+  const vtkIdType size = static_cast<vtkIdType>(dims[0]) * dims[1];
+  vtkSMPTools::For(0, size, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i) {
+      double sum = 0.0;
+      for (int z = 0; z < dims[2]; ++z) {
+        sum += static_cast<double>(frames[z * size + i]);
+      }
+      average[i] = dims[2] > 0 ? static_cast<float>(sum / dims[2]) : 0.0f;
+    }
+  });
+}
+} // namespace tomviz
+
+#endif
@@ -0,0 +1,43 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "TiltSeriesPreprocessingReaction.h"
+
+#include <QAction>
+#include <QMainWindow>
+
+#include "ActiveObjects.h"
+#include "DataSource.h"
+#include "EditOperatorDialog.h"
+#include "TiltSeriesPreprocessingOperator.h"
+
+namespace tomviz {
+
+TiltSeriesPreprocessingReaction::TiltSeriesPreprocessingReaction(
+  QAction* parentObject, const TiltSeriesPreprocessing::Parameters& parameters,
+  QMainWindow* mw)
+  : Reaction(parentObject), m_parameters(parameters), m_mainWindow(mw)
+{
+}
+
+void TiltSeriesPreprocessingReaction::addOperator(DataSource* source)
+{
+  source = source ? source : ActiveObjects::instance().activeParentDataSource();
+  if (!source) {
+    return;
+  }
+
+  auto parameters = m_parameters;
+  if (!source->darkData() || !source->whiteData()) {
+    parameters.steps &= ~TiltSeriesPreprocessing::FlatField;
+  }
+  auto* op = new TiltSeriesPreprocessingOperator();
+  op->setParameters(parameters);
+
+  EditOperatorDialog* dialog =
+    new EditOperatorDialog(op, source, true, m_mainWindow);
+  dialog->setAttribute(Qt::WA_DeleteOnClose);
+  dialog->show();
+  connect(op, SIGNAL(destroyed()), dialog, SLOT(reject()));
+}
+} // namespace tomviz
@@ -0,0 +1,39 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizTiltSeriesPreprocessingReaction_h
+#define tomvizTiltSeriesPreprocessingReaction_h
+
+#include <Reaction.h>
+
+#include "TiltSeriesPreprocessing.h"
+
+class QMainWindow;
+
+namespace tomviz {
+class DataSource;
+
+/// Adds a TiltSeriesPreprocessingOperator, with \p parameters. The dark and
+/// white correction is turned off for data without dark and white images.
+class TiltSeriesPreprocessingReaction : public Reaction
+{
+  Q_OBJECT
+
+public:
+  TiltSeriesPreprocessingReaction(
+    QAction* parent, const TiltSeriesPreprocessing::Parameters& parameters,
+    QMainWindow* mw);
+
+  void addOperator(DataSource* source = nullptr);
+
+protected:
+  void onTriggered() override { addOperator(); }
+
+private:
+  Q_DISABLE_COPY(TiltSeriesPreprocessingReaction)
+  TiltSeriesPreprocessing::Parameters m_parameters;
+  QMainWindow* m_mainWindow;
+};
+} // namespace tomviz
+
+#endif
@@ -15,8 +15,20 @@
 
 #include <QDebug>
 
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
 namespace {
 
+// An intersection of a ray with the grid, at t along the ray.
+struct RayPoint
+{
+  double t;
+  double x;
+  double y;
+};
+
 // Conversion code
 template <typename T>
 vtkSmartPointer<vtkFloatArray> convertToFloatT(T* data, int len)
@@ -123,5 +135,125 @@ void unweightedBackProjection2(float* sinogram, double* tiltAngles,
     image[i] *= normalizationFactor;
   }
 }
+
+// Siddon's ray tracing, following parallelRay() of the Python ART and TV
+// minimization operators.
+void parallelRayMatrix(int numOfRays, const double* tiltAngles,
+                       int numOfTilts, SystemMatrix& matrix)
+{
+  const int n = numOfRays;
+  const double half = n / 2.0;
+  auto removeEpsilon = [](double x) { return std::abs(x) < 1e-10 ? 0.0 : x; };
+
+  matrix.rowStart.assign(1, 0);
+  matrix.columns.clear();
+  matrix.values.clear();
+  matrix.rowNorms.clear();
+
+  std::vector<RayPoint> points;
+  std::vector<std::pair<int, float>> row;
+  for (int i = 0; i < numOfTilts; ++i) {
+    const double angle = tiltAngles[i] * PI / 180;
+    const double a = removeEpsilon(-sin(angle));
+    const double b = removeEpsilon(cos(angle));
+    for (int j = 0; j < n; ++j) {
+      const double offset = j - (n - 1) / 2.0;
+      double xRay = cos(angle) * offset;
+      double yRay = sin(angle) * offset;
+      xRay = std::abs(xRay) < 1e-8 ? 0.0 : xRay;
+      yRay = std::abs(yRay) < 1e-8 ? 0.0 : yRay;
+
+      // Intersections of the ray with the grid lines inside of the grid,
+      // sorted along the ray.
+      points.clear();
+      for (int k = 0; k <= n; ++k) {
+        const double grid = k - half;
+        if (a != 0.0) {
+          const double t = (grid - xRay) / a;
+          points.push_back({ t, grid, b * t + yRay });
+        }
+        if (b != 0.0) {
+          const double t = (grid - yRay) / b;
+          points.push_back({ t, a * t + xRay, grid });
+        }
+      }
+      auto outside = [half](const RayPoint& p) {
+        return p.x < -half || p.x > half || p.y < -half || p.y > half;
+      };
+      points.erase(std::remove_if(points.begin(), points.end(), outside),
+                   points.end());
+      std::sort(points.begin(), points.end(),
+                [](const RayPoint& p, const RayPoint& q) { return p.t < q.t; });
+
+      // Points counted twice, at the corners of the pixels.
+      size_t count = 0;
+      for (size_t k = 0; k < points.size(); ++k) {
+        if (k + 1 < points.size() &&
+            std::abs(points[k + 1].x - points[k].x) <= 1e-8 &&
+            std::abs(points[k + 1].y - points[k].y) <= 1e-8) {
+          continue;
+        }
+        points[count++] = points[k];
+      }
+      points.resize(count);
+
+      // Rays along the top or right edges of the grid are left out.
+      const bool onEdge = (b == 0.0 && std::abs(yRay - half) < 1e-15) ||
+                          (a == 0.0 && std::abs(xRay - half) < 1e-15);
+      row.clear();
+      for (size_t k = 0; !onEdge && k + 1 < points.size(); ++k) {
+        const RayPoint& p = points[k];
+        const RayPoint& q = points[k + 1];
+        const double length =
+          std::sqrt((q.x - p.x) * (q.x - p.x) + (q.y - p.y) * (q.y - p.y));
+        const double xMid = removeEpsilon(0.5 * (p.x + q.x));
+        const double yMid = removeEpsilon(0.5 * (p.y + q.y));
+        const int pixelY = static_cast<int>(std::floor(half - yMid));
+        const int pixelZ = static_cast<int>(std::floor(xMid + half));
+        if (pixelY >= 0 && pixelY < n && pixelZ >= 0 && pixelZ < n) {
+          row.push_back(
+            std::make_pair(pixelY * n + pixelZ, static_cast<float>(length)));
+        }
+      }
+
+      // Merge the segments through the same pixel.
+      std::sort(row.begin(), row.end());
+      float norm = 0.0f;
+      for (size_t k = 0; k < row.size(); ++k) {
+        float value = row[k].second;
+        while (k + 1 < row.size() && row[k + 1].first == row[k].first) {
+          value += row[++k].second;
+        }
+        matrix.columns.push_back(row[k].first);
+        matrix.values.push_back(value);
+        norm += value * value;
+      }
+      matrix.rowStart.push_back(static_cast<vtkIdType>(matrix.columns.size()));
+      matrix.rowNorms.push_back(norm);
+    }
+  }
+}
+
+void artSweep(const SystemMatrix& matrix, const float* sinogram, float* image,
+              float relaxation)
+{
+  const int numRows = static_cast<int>(matrix.rowNorms.size());
+  for (int r = 0; r < numRows; ++r) {
+    if (matrix.rowNorms[r] <= 0.0f) {
+      continue;
+    }
+    const vtkIdType begin = matrix.rowStart[r];
+    const vtkIdType end = matrix.rowStart[r + 1];
+    float projection = 0.0f;
+    for (vtkIdType k = begin; k < end; ++k) {
+      projection += matrix.values[k] * image[matrix.columns[k]];
+    }
+    const float a =
+      (sinogram[r] - projection) / matrix.rowNorms[r] * relaxation;
+    for (vtkIdType k = begin; k < end; ++k) {
+      image[matrix.columns[k]] += matrix.values[k] * a;
+    }
+  }
+}
 } // namespace TomographyReconstruction
 } // namespace tomviz
@@ -7,6 +7,8 @@
 #include <pqReaction.h>
 #include <vtkImageData.h>
 
+#include <vector>
+
 namespace tomviz {
 class DataSource;
 
@@ -29,6 +31,31 @@ void weightedBackProjection3(vtkImageData* tiltSeries,
 void unweightedBackProjection2(float* sinogram, double* tiltAngles,
                                float* recon, int numOfTilts,
                                int numOfRays); // 2D WBP recon
+
+// Sparse measurement matrix of a parallel beam, in compressed rows. Row
+// tilt * numOfRays + ray holds the lengths of the ray through the pixels of a
+// numOfRays by numOfRays image, which are stored as y * numOfRays + z.
+struct SystemMatrix
+{
+  // The matrix holds about numOfTilts * numOfRays^2 values, more than an int
+  // can index for large tilt series.
+  std::vector<vtkIdType> rowStart;
+  std::vector<int> columns;
+  std::vector<float> values;
+  // The squared norm of each row.
+  std::vector<float> rowNorms;
+};
+
+// Trace the rays of every tilt through the pixels of the reconstruction, the
+// rays of each projection are centered on the image and one pixel apart.
+void parallelRayMatrix(int numOfRays, const double* tiltAngles,
+                       int numOfTilts, SystemMatrix& matrix);
+
+// One algebraic reconstruction technique (ART) sweep over the rows of the
+// matrix, updating the image in place. The sinogram is stored as
+// tilt * numOfRays + ray.
+void artSweep(const SystemMatrix& matrix, const float* sinogram, float* image,
+              float relaxation = 1.0f);
 } // namespace TomographyReconstruction
 } // namespace tomviz
 
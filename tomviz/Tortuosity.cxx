@@ -0,0 +1,262 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "Tortuosity.h"
+
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace {
+
+// Voxels settled between progress reports.
+const vtkIdType ReportInterval = 1 << 16;
+
+// The longest step is shorter than 2, so the distances queued while a bucket
+// is settled fall in the two next buckets.
+const int NumberOfBuckets = 3;
+
+// The state of the voxels during the propagation.
+const unsigned char Outside = 0;
+const unsigned char Queued = 1;
+const unsigned char Settled = 2;
+
+struct Step
+{
+  int dx;
+  int dy;
+  int dz;
+  float length;
+};
+} // namespace
+
+namespace tomviz {
+
+const float Tortuosity::Unreachable = -1.0f;
+
+Tortuosity::Tortuosity(const int dims[3], Metric metric) : m_metric(metric)
+{
+  std::copy(dims, dims + 3, m_dims);
+}
+
+vtkIdType Tortuosity::sliceSize(Direction direction) const
+{
+  const int axis = direction / 2;
+  return static_cast<vtkIdType>(m_dims[(axis + 1) % 3]) *
+         m_dims[(axis + 2) % 3];
+}
+
+vtkIdType Tortuosity::sliceVoxel(Direction direction, int slice,
+                                 vtkIdType i) const
+{
+  const vtkIdType nx = m_dims[0];
+  const vtkIdType ny = m_dims[1];
+  const int axis = direction / 2;
+  const vtkIdType s = direction % 2 ? m_dims[axis] - 1 - slice : slice;
+  if (axis == 0) {
+    // i runs over y, then z.
+    return i * nx + s;
+  } else if (axis == 1) {
+    // i runs over x, then z.
+    return ((i / nx) * ny + s) * nx + i % nx;
+  }
+  return s * nx * ny + i;
+}
+
+bool Tortuosity::propagate(const unsigned char* phase, Direction direction,
+                           float* distances, const Progress& progress) const
+{
+  const int nx = m_dims[0];
+  const int ny = m_dims[1];
+  const int nz = m_dims[2];
+  const vtkIdType size = static_cast<vtkIdType>(nx) * ny * nz;
+  const float infinity = std::numeric_limits<float>::infinity();
+
+  std::vector<unsigned char> state(size);
+  vtkSMPTools::For(0, size, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i) {
+      state[i] = phase[i] ? Queued : Outside;
+      distances[i] = infinity;
+    }
+  });
+
+  std::vector<Step> steps;
+  for (int dz = -1; dz <= 1; ++dz) {
+    for (int dy = -1; dy <= 1; ++dy) {
+      for (int dx = -1; dx <= 1; ++dx) {
+        const int n = std::abs(dx) + std::abs(dy) + std::abs(dz);
+        if (n == 0 || (m_metric == Metric::CityBlock && n > 1)) {
+          continue;
+        }
+        const float length = m_metric == Metric::Euclidean
+                               ? static_cast<float>(std::sqrt(n))
+                               : 1.0f;
+        steps.push_back({ dx, dy, dz, length });
+      }
+    }
+  }
+
+  // The bucket of a voxel is the integer part of its distance.
+  std::vector<std::vector<vtkIdType>> buckets(NumberOfBuckets);
+  vtkIdType queued = 0;
+  const vtkIdType faceSize = sliceSize(direction);
+  for (vtkIdType i = 0; i < faceSize; ++i) {
+    const vtkIdType v = sliceVoxel(direction, 0, i);
+    if (state[v] == Queued) {
+      distances[v] = 1.0f;
+      buckets[1].push_back(v);
+      ++queued;
+    }
+  }
+
+  std::vector<vtkIdType> frontier;
+  vtkIdType settled = 0;
+  vtkIdType nextReport = ReportInterval;
+  const vtkIdType sliceStride = static_cast<vtkIdType>(nx) * ny;
+  for (long long bucket = 1; queued > 0; ++bucket) {
+    frontier.clear();
+    std::swap(frontier, buckets[bucket % NumberOfBuckets]);
+    queued -= static_cast<vtkIdType>(frontier.size());
+    for (vtkIdType v : frontier) {
+      // A voxel is queued again when its distance decreases.
+      if (state[v] == Settled) {
+        continue;
+      }
+      state[v] = Settled;
+      const float distance = distances[v];
+      const int x = static_cast<int>(v % nx);
+      const int y = static_cast<int>((v / nx) % ny);
+      const int z = static_cast<int>(v / sliceStride);
+      for (const auto& step : steps) {
+        const int xx = x + step.dx;
+        const int yy = y + step.dy;
+        const int zz = z + step.dz;
+        if (xx < 0 || yy < 0 || zz < 0 || xx >= nx || yy >= ny || zz >= nz) {
+          continue;
+        }
+        const vtkIdType n = v + step.dz * sliceStride + step.dy * nx + step.dx;
+        if (state[n] != Queued) {
+          continue;
+        }
+        const float candidate = distance + step.length;
+        if (candidate < distances[n]) {
+          distances[n] = candidate;
+          buckets[static_cast<long long>(candidate) % NumberOfBuckets]
+            .push_back(n);
+          ++queued;
+        }
+      }
+
+      if (++settled == nextReport) {
+        nextReport += ReportInterval;
+        if (progress && !progress(settled)) {
+          return false;
+        }
+      }
+    }
+  }
+
+  vtkSMPTools::For(0, size, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i) {
+      if (distances[i] == infinity) {
+        distances[i] = Unreachable;
+      }
+    }
+  });
+  return true;
+}
+
+std::vector<double> Tortuosity::averagePathLength(const float* distances,
+                                                  Direction direction) const
+{
+  const int numSlices = numberOfSlices(direction);
+  const vtkIdType size = sliceSize(direction);
+  std::vector<double> pathLength(numSlices);
+  vtkSMPTools::For(0, numSlices, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType s = begin; s < end; ++s) {
+      double sum = 0.0;
+      vtkIdType count = 0;
+      for (vtkIdType i = 0; i < size; ++i) {
+        const float distance =
+          distances[sliceVoxel(direction, static_cast<int>(s), i)];
+        if (distance != Unreachable) {
+          sum += distance;
+          ++count;
+        }
+      }
+      // Like numpy, the mean of an empty slice is not a number.
+      pathLength[s] = count > 0 ? sum / count
+                                : std::numeric_limits<double>::quiet_NaN();
+    }
+  });
+  return pathLength;
+}
+
+Tortuosity::Summary Tortuosity::tortuosity(
+  const std::vector<double>& pathLength)
+{
+  const double n = static_cast<double>(pathLength.size());
+  double meanDistance = 0.0;
+  double meanLength = 0.0;
+  double average = 0.0;
+  for (size_t i = 0; i < pathLength.size(); ++i) {
+    const double distance = static_cast<double>(i + 1);
+    meanDistance += distance / n;
+    meanLength += pathLength[i] / n;
+    average += pathLength[i] / distance / n;
+  }
+
+  // The least squares line, as numpy.polyfit fits it.
+  double covariance = 0.0;
+  double variance = 0.0;
+  for (size_t i = 0; i < pathLength.size(); ++i) {
+    const double d = static_cast<double>(i + 1) - meanDistance;
+    covariance += d * (pathLength[i] - meanLength);
+    variance += d * d;
+  }
+
+  Summary summary;
+  summary.scale = covariance / variance;
+  summary.end = pathLength.empty() ? 0.0 : pathLength.back() / n;
+  summary.average = average;
+  summary.slope = -1.0;
+  return summary;
+}
+
+std::vector<vtkIdType> Tortuosity::tortuosityDistribution(
+  const float* distances, Direction direction, int bins) const
+{
+  const int numSlices = numberOfSlices(direction);
+  const vtkIdType size = sliceSize(direction);
+  const double first = 1.0;
+  const double last = 6.0;
+  const double width = (last - first) / bins;
+  auto edge = [&](int i) { return i == bins ? last : first + i * width; };
+
+  std::vector<vtkIdType> histogram(bins, 0);
+  for (vtkIdType i = 0; i < size; ++i) {
+    const float distance = distances[sliceVoxel(direction, numSlices - 1, i)];
+    if (distance == Unreachable) {
+      continue;
+    }
+    // The bins of numpy.histogram, closed on the left, and the last one on
+    // both sides.
+    const double value = distance / static_cast<float>(numSlices);
+    if (!(value >= first && value <= last)) {
+      continue;
+    }
+    int bin = std::min(static_cast<int>((value - first) / width), bins - 1);
+    if (value < edge(bin)) {
+      --bin;
+    } else if (bin != bins - 1 && value >= edge(bin + 1)) {
+      ++bin;
+    }
+    ++histogram[bin];
+  }
+  return histogram;
+}
+
+} // namespace tomviz
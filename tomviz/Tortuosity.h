@@ -0,0 +1,111 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizTortuosity_h
+#define tomvizTortuosity_h
+
+#include <vtkType.h>
+
+#include <functional>
+#include <vector>
+
+namespace tomviz {
+
+/// Tortuosity of a phase of a volume by distance propagation, as the
+/// Tortuosity Python operator computed it with a voxel graph: the length of
+/// the shortest paths, within the phase, from a face of the volume to every
+/// voxel of the phase. The paths start at a distance of 1 on the face.
+///
+/// The graph is not built: the neighbours of the voxels are visited on the
+/// grid, by a Dijkstra search with a circular bucket queue. The steps between
+/// neighbours are at least 1 long, so the voxels of a bucket of width 1 are
+/// settled in any order.
+class Tortuosity
+{
+public:
+  /// The length of a step between neighbours, in the order of the Python
+  /// operator.
+  enum class Metric
+  {
+    /// Steps to the 26 neighbours, of length 1, sqrt(2) or sqrt(3).
+    Euclidean,
+    /// Steps to the 6 face neighbours, of length 1.
+    CityBlock,
+    /// Steps to the 26 neighbours, of length 1.
+    ChessBoard
+  };
+
+  /// The face the paths start from: X+ is the face at x = 0, and X- the
+  /// face at the largest x, and so on for y and z.
+  enum Direction
+  {
+    XPositive,
+    XNegative,
+    YPositive,
+    YNegative,
+    ZPositive,
+    ZNegative
+  };
+
+  /// The distance of the voxels that are outside of the phase or that no
+  /// path reaches.
+  static const float Unreachable;
+
+  /// Called with the number of settled voxels from time to time, returns
+  /// false to stop the propagation.
+  using Progress = std::function<bool(vtkIdType)>;
+
+  Tortuosity(const int dims[3], Metric metric);
+
+  /// The distances of the voxels of the phase, which are the non zero
+  /// values of \p phase, from the face of \p direction into \p distances.
+  /// Returns false if \p progress stopped it.
+  bool propagate(const unsigned char* phase, Direction direction,
+                 float* distances, const Progress& progress = nullptr) const;
+
+  /// The average distance of the reachable voxels of each slice, ordered
+  /// from the face of \p direction.
+  std::vector<double> averagePathLength(const float* distances,
+                                        Direction direction) const;
+
+  /// The number of slices along \p direction.
+  int numberOfSlices(Direction direction) const
+  {
+    return m_dims[direction / 2];
+  }
+
+  struct Summary
+  {
+    /// The slope of the line fit to the path lengths.
+    double scale;
+    /// The ratio of the path length to the linear distance of the last
+    /// slice.
+    double end;
+    /// The average ratio of the path lengths to the linear distances.
+    double average;
+    /// Not implemented, -1.
+    double slope;
+  };
+
+  /// The tortuosity of the path lengths of the slices, at linear distances
+  /// of 1, 2, ...
+  static Summary tortuosity(const std::vector<double>& pathLength);
+
+  /// The histogram of the tortuosity of the reachable voxels of the last
+  /// slice, over \p bins bins between 1 and 6.
+  std::vector<vtkIdType> tortuosityDistribution(const float* distances,
+                                                Direction direction,
+                                                int bins) const;
+
+private:
+  // The voxel of the slice at the distance \p slice from the face of
+  // \p direction, at position \p i within the slice.
+  vtkIdType sliceVoxel(Direction direction, int slice, vtkIdType i) const;
+  vtkIdType sliceSize(Direction direction) const;
+
+  int m_dims[3];
+  Metric m_metric;
+};
+} // namespace tomviz
+
+#endif
@@ -0,0 +1,37 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "TortuosityReaction.h"
+
+#include <QAction>
+#include <QMainWindow>
+
+#include "ActiveObjects.h"
+#include "DataSource.h"
+#include "EditOperatorDialog.h"
+#include "TortuosityOperator.h"
+
+namespace tomviz {
+
+TortuosityReaction::TortuosityReaction(
+  QAction* parentObject, QMainWindow* mw)
+  : Reaction(parentObject), m_mainWindow(mw)
+{
+}
+
+void TortuosityReaction::addOperator(DataSource* source)
+{
+  source = source ? source : ActiveObjects::instance().activeParentDataSource();
+  if (!source) {
+    return;
+  }
+
+  auto* op = new TortuosityOperator();
+
+  EditOperatorDialog* dialog =
+    new EditOperatorDialog(op, source, true, m_mainWindow);
+  dialog->setAttribute(Qt::WA_DeleteOnClose);
+  dialog->show();
+  connect(op, SIGNAL(destroyed()), dialog, SLOT(reject()));
+}
+} // namespace tomviz
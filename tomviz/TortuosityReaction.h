@@ -0,0 +1,32 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizTortuosityReaction_h
+#define tomvizTortuosityReaction_h
+
+#include <Reaction.h>
+
+class QMainWindow;
+
+namespace tomviz {
+class DataSource;
+
+class TortuosityReaction : public Reaction
+{
+  Q_OBJECT
+
+public:
+  TortuosityReaction(QAction* parent, QMainWindow* mw);
+
+  void addOperator(DataSource* source = nullptr);
+
+protected:
+  void onTriggered() override { addOperator(); }
+
+private:
+  Q_DISABLE_COPY(TortuosityReaction)
+  QMainWindow* m_mainWindow;
+};
+} // namespace tomviz
+
+#endif
@@ -0,0 +1,209 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "TotalVariation.h"
+
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Keeps the derivatives finite where the volume is flat, as the Python
+// operators did.
+const float Epsilon = 1e-8f;
+
+// Values are reduced in fixed size chunks, the chunk sums are added in order
+// so the results do not depend on the number of threads.
+const vtkIdType ChunkSize = 1 << 16;
+
+// The rows, along the first axis, of a volume with the edges replicated.
+class Rows
+{
+public:
+  Rows(const float* volume, const int dims[3]) : m_volume(volume), m_dims(dims)
+  {
+  }
+
+  const float* operator()(int y, int z) const
+  {
+    y = std::min(std::max(y, 0), m_dims[1] - 1);
+    z = std::min(std::max(z, 0), m_dims[2] - 1);
+    return m_volume + (static_cast<vtkIdType>(z) * m_dims[1] + y) * m_dims[0];
+  }
+
+private:
+  const float* m_volume;
+  const int* m_dims;
+};
+
+template <typename Functor>
+double sumRows(vtkIdType numRows, Functor rowSum)
+{
+  std::vector<double> sums(numRows);
+  vtkSMPTools::For(0, numRows, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType r = begin; r < end; ++r) {
+      sums[r] = rowSum(r);
+    }
+  });
+
+  double sum = 0.0;
+  for (auto value : sums) {
+    sum += value;
+  }
+  return sum;
+}
+
+template <typename Functor>
+double sumChunks(vtkIdType size, Functor valueAt)
+{
+  const vtkIdType numChunks = (size + ChunkSize - 1) / ChunkSize;
+  return sumRows(numChunks, [&](vtkIdType chunk) {
+    const vtkIdType end = std::min(size, (chunk + 1) * ChunkSize);
+    double sum = 0.0;
+    for (vtkIdType i = chunk * ChunkSize; i < end; ++i) {
+      sum += valueAt(i);
+    }
+    return sum;
+  });
+}
+
+float square(float x)
+{
+  return x * x;
+}
+} // namespace
+
+namespace tomviz {
+
+double TotalVariation::value(const float* volume, const int dims[3])
+{
+  const Rows rows(volume, dims);
+  const int nx = dims[0];
+  return sumRows(static_cast<vtkIdType>(dims[1]) * dims[2], [&](vtkIdType r) {
+    const int y = static_cast<int>(r % dims[1]);
+    const int z = static_cast<int>(r / dims[1]);
+    const float* row = rows(y, z);
+    const float* nextY = rows(y + 1, z);
+    const float* nextZ = rows(y, z + 1);
+    double sum = 0.0;
+    for (int x = 0; x < nx; ++x) {
+      const float v = row[x];
+      sum += std::sqrt(Epsilon + square(v - row[std::min(x + 1, nx - 1)]) +
+                       square(v - nextY[x]) + square(v - nextZ[x]));
+    }
+    return sum;
+  });
+}
+
+double TotalVariation::gradient(const float* volume, const int dims[3],
+                                float* gradient)
+{
+  const Rows rows(volume, dims);
+  const int nx = dims[0];
+  const double squaredNorm =
+    sumRows(static_cast<vtkIdType>(dims[1]) * dims[2], [&](vtkIdType r) {
+      const int y = static_cast<int>(r % dims[1]);
+      const int z = static_cast<int>(r / dims[1]);
+      const float* row = rows(y, z);
+      const float* prevY = rows(y - 1, z);
+      const float* prevZ = rows(y, z - 1);
+      const float* nextY = rows(y + 1, z);
+      const float* nextYPrevZ = rows(y + 1, z - 1);
+      const float* nextZ = rows(y, z + 1);
+      const float* nextZPrevY = rows(y - 1, z + 1);
+      float* out = gradient + r * nx;
+
+      double sum = 0.0;
+      for (int x = 0; x < nx; ++x) {
+        const int xm = std::max(x - 1, 0);
+        const int xp = std::min(x + 1, nx - 1);
+        const float v = row[x];
+
+        // The total variation at this voxel and at its three following
+        // neighbours depend on its value.
+        const float dx = v - row[xm];
+        const float dy = v - prevY[x];
+        const float dz = v - prevZ[x];
+        float value = (dx + dy + dz) /
+                      std::sqrt(Epsilon + dx * dx + dy * dy + dz * dz);
+
+        float q = row[xp];
+        value += (v - q) / std::sqrt(Epsilon + square(q - v) +
+                                     square(q - prevY[xp]) +
+                                     square(q - prevZ[xp]));
+        q = nextY[x];
+        value += (v - q) / std::sqrt(Epsilon + square(q - nextY[xm]) +
+                                     square(q - v) +
+                                     square(q - nextYPrevZ[x]));
+        q = nextZ[x];
+        value += (v - q) / std::sqrt(Epsilon + square(q - nextZ[xm]) +
+                                     square(q - nextZPrevY[x]) +
+                                     square(q - v));
+        out[x] = value;
+        sum += static_cast<double>(value) * value;
+      }
+      return sum;
+    });
+  return std::sqrt(squaredNorm);
+}
+
+double TotalVariation::imageGradient(const float* image, const int dims[2],
+                                     float* gradient)
+{
+  const int nx = dims[0];
+  const int ny = dims[1];
+  // Zero outside of the image.
+  auto at = [&](int x, int y) {
+    return x < 0 || y < 0 || x >= nx || y >= ny ? 0.0f : image[y * nx + x];
+  };
+
+  const double squaredNorm = sumRows(ny, [&](vtkIdType r) {
+    const int y = static_cast<int>(r);
+    float* out = gradient + r * nx;
+    double sum = 0.0;
+    for (int x = 0; x < nx; ++x) {
+      const float v = at(x, y);
+      const float dx = v - at(x + 1, y);
+      const float dy = v - at(x, y + 1);
+      float value = 2.0f * (dx + dy) / std::sqrt(Epsilon + dx * dx + dy * dy);
+
+      float q = at(x, y - 1);
+      float d = q - at(x + 1, y - 1);
+      value -= 2.0f * (q - v) / std::sqrt(Epsilon + square(q - v) + d * d);
+      q = at(x - 1, y);
+      d = q - at(x - 1, y + 1);
+      value -= 2.0f * (q - v) / std::sqrt(Epsilon + square(q - v) + d * d);
+      out[x] = value;
+      sum += static_cast<double>(value) * value;
+    }
+    return sum;
+  });
+  return std::sqrt(squaredNorm);
+}
+
+void TotalVariation::descend(const float* values, const float* direction,
+                             double step, vtkIdType size, float* result,
+                             bool positive)
+{
+  const float s = static_cast<float>(step);
+  vtkSMPTools::For(0, size, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i) {
+      const float value = values[i] - s * direction[i];
+      result[i] = positive && value < 0.0f ? 0.0f : value;
+    }
+  });
+}
+
+double TotalVariation::distance(const float* a, const float* b,
+                                vtkIdType size)
+{
+  return std::sqrt(sumChunks(size, [&](vtkIdType i) {
+    const double d = static_cast<double>(a[i]) - b[i];
+    return d * d;
+  }));
+}
+
+} // namespace tomviz
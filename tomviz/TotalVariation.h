@@ -0,0 +1,45 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizTotalVariation_h
+#define tomvizTotalVariation_h
+
+#include <vtkType.h>
+
+namespace tomviz {
+
+/// Multi-threaded kernels for total variation (TV) minimization by gradient
+/// descent, in single precision. Volumes are in Fortran order, the first
+/// dimension being the contiguous one. The differences along the three axes
+/// are computed in a single pass over the volume, rather than from shifted
+/// copies of it.
+class TotalVariation
+{
+public:
+  /// Isotropic total variation of a volume, with forward differences and the
+  /// edge values replicated outside of the volume.
+  static double value(const float* volume, const int dims[3]);
+
+  /// Gradient of the total variation of a volume, with backward differences
+  /// and the edge values replicated outside of the volume. Returns the norm
+  /// of the gradient.
+  static double gradient(const float* volume, const int dims[3],
+                         float* gradient);
+
+  /// Gradient of the total variation of an image, of dimensions \p dims,
+  /// which is zero outside of its bounds. Returns the norm of the gradient.
+  static double imageGradient(const float* image, const int dims[2],
+                              float* gradient);
+
+  /// \p result = \p values - \p step * \p direction, clamped to zero if
+  /// \p positive is set. \p result may be \p values.
+  static void descend(const float* values, const float* direction,
+                      double step, vtkIdType size, float* result,
+                      bool positive = false);
+
+  /// The Euclidean distance between \p a and \p b.
+  static double distance(const float* a, const float* b, vtkIdType size);
+};
+} // namespace tomviz
+
+#endif
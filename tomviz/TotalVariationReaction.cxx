@@ -0,0 +1,37 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "TotalVariationReaction.h"
+
+#include <QAction>
+#include <QMainWindow>
+
+#include "ActiveObjects.h"
+#include "DataSource.h"
+#include "EditOperatorDialog.h"
+
+namespace tomviz {
+
+TotalVariationReaction::TotalVariationReaction(
+  QAction* parentObject, TotalVariationOperator::Mode mode, QMainWindow* mw)
+  : Reaction(parentObject), m_mode(mode), m_mainWindow(mw)
+{
+}
+
+void TotalVariationReaction::addOperator(DataSource* source)
+{
+  source = source ? source : ActiveObjects::instance().activeParentDataSource();
+  if (!source) {
+    return;
+  }
+
+  auto* op = new TotalVariationOperator();
+  op->setMode(m_mode);
+
+  EditOperatorDialog* dialog =
+    new EditOperatorDialog(op, source, true, m_mainWindow);
+  dialog->setAttribute(Qt::WA_DeleteOnClose);
+  dialog->show();
+  connect(op, SIGNAL(destroyed()), dialog, SLOT(reject()));
+}
+} // namespace tomviz
@@ -0,0 +1,36 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizTotalVariationReaction_h
+#define tomvizTotalVariationReaction_h
+
+#include <Reaction.h>
+
+#include "TotalVariationOperator.h"
+
+class QMainWindow;
+
+namespace tomviz {
+class DataSource;
+
+class TotalVariationReaction : public Reaction
+{
+  Q_OBJECT
+
+public:
+  TotalVariationReaction(QAction* parent, TotalVariationOperator::Mode mode,
+                         QMainWindow* mw);
+
+  void addOperator(DataSource* source = nullptr);
+
+protected:
+  void onTriggered() override { addOperator(); }
+
+private:
+  Q_DISABLE_COPY(TotalVariationReaction)
+  TotalVariationOperator::Mode m_mode;
+  QMainWindow* m_mainWindow;
+};
+} // namespace tomviz
+
+#endif
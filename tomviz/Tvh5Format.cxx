@@ -9,6 +9,9 @@
 #include "LoadDataReaction.h"
 #include "ModuleManager.h"
 #include "Pipeline.h"
+#include "Tvh5Multiscale.h"
+#include "Tvh5Writer.h"
+#include "Utilities.h"
 
 #include <h5cpp/h5readwrite.h>
 
@@ -16,10 +19,13 @@
 #include <vtkNew.h>
 
 #include <QDir>
+#include <QEventLoop>
 #include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QProgressDialog>
+#include <QScopedPointer>
 
 #include <iostream>
 
@@ -30,63 +36,58 @@ namespace tomviz {
 
 bool Tvh5Format::write(const std::string& fileName)
 {
-  // First, write the standard EMD file
-  DataSource* source = ActiveObjects::instance().activeDataSource();
-
-  if (!EmdFormat::write(fileName, source)) {
-    cerr << "Failed to write the standard EMD node" << endl;
+  // The data is prepared and written in the background while a modal progress
+  // dialog keeps the save visible and cancelable. The event loop keeps running
+  // meanwhile, but no user input reaches the rest of the application, so the
+  // state being saved can't be changed and no other save can start.
+  static bool saving = false;
+  if (saving) {
+    cerr << "A state file is already being saved." << endl;
     return false;
   }
 
-  // We will create a soft link to the active id later
-  auto activeId = source->id().toStdString();
-
-  // Now, write the state file string to a dataset
-  QFileInfo info(fileName.c_str());
-  QJsonObject stateObject;
-  auto success =
-    ModuleManager::instance().serialize(stateObject, info.dir(), false);
-  if (!success) {
-    cerr << "Failed to serialize the state of Tomviz" << endl;
+  Tvh5Writer writer(fileName.c_str());
+  if (!writer.start()) {
+    cerr << writer.errorMessage().toStdString() << endl;
     return false;
   }
-
-  QByteArray state = QJsonDocument(stateObject).toJson();
-
-  // Write the state file to "tomviz_state"
-  using h5::H5ReadWrite;
-  H5ReadWrite::OpenMode mode = H5ReadWrite::OpenMode::ReadWrite;
-  H5ReadWrite writer(fileName, mode);
-
-  if (!writer.writeData("/", "tomviz_state", { state.size() }, state.data())) {
-    cerr << "Failed to write tomviz_state" << endl;
-    return false;
+  saving = true;
+
+  QScopedPointer<QProgressDialog> dialog;
+  if (auto* parent = mainWidget()) {
+    auto label = "Saving " + QFileInfo(fileName.c_str()).fileName();
+    dialog.reset(new QProgressDialog(label, "Cancel", 0, 100, parent));
+    dialog->setWindowModality(Qt::ApplicationModal);
+    dialog->setMinimumDuration(0);
+    QObject::connect(&writer, &Tvh5Writer::progress, dialog.data(),
+                     [&dialog](qint64 done, qint64 total) {
+                       if (total > 0) {
+                         dialog->setValue(
+                           static_cast<int>(100 * done / total));
+                       }
+                     });
+    QObject::connect(dialog.data(), &QProgressDialog::canceled, &writer,
+                     &Tvh5Writer::cancel);
+    dialog->show();
   }
 
-  // Now, write all the data sources
-  writer.createGroup("/tomviz_datasources");
-  auto sources = ModuleManager::instance().allDataSources();
-  for (auto* ds : sources) {
-    // Name the group after its id
-    auto id = ds->id().toStdString();
-
-    if (id == activeId) {
-      // Make a soft link rather than writing the data again
-      writer.createSoftLink("/data/tomography", "/tomviz_datasources/" + id);
-      continue;
-    }
-
-    std::string group = "/tomviz_datasources/" + id;
-    writer.createGroup(group);
-
-    // Write the data here
-    if (!EmdFormat::writeNode(writer, group, ds->imageData())) {
-      cerr << "Failed to write data source: " << id << endl;
-      return false;
-    }
+  bool success = false;
+  QEventLoop loop;
+  QObject::connect(&writer, &Tvh5Writer::finished, &loop,
+                   [&loop, &success](bool ok) {
+                     success = ok;
+                     loop.quit();
+                   });
+  // Without a dialog, nothing takes user input until the save is done.
+  loop.exec(dialog ? QEventLoop::AllEvents
+                   : QEventLoop::ExcludeUserInputEvents);
+  saving = false;
+
+  if (!success && !writer.isCanceled()) {
+    cerr << writer.errorMessage().toStdString() << endl;
   }
 
-  return true;
+  return success;
 }
 
 bool Tvh5Format::read(const std::string& fileName)
@@ -131,6 +132,10 @@ bool Tvh5Format::read(const std::string& fileName)
   }
   ModuleManager::instance().executePipelinesOnLoad(prev);
 
+  // Now that the state of the data sources is restored, stream in the finer
+  // levels of those that were loaded from a multiscale level.
+  Tvh5Multiscale::startAll();
+
   if (active) {
     // Set the active data source if one was flagged as active
     // We have to use "setSelectedDataSource" instead of
@@ -156,13 +161,22 @@ bool Tvh5Format::loadDataSource(h5::H5ReadWrite& reader,
     return false;
   }
 
-  // First, create the image data
+  // First, create the image data. If the data source has multiscale levels,
+  // start from the coarsest one and stream in the others later.
   std::string path = "/tomviz_datasources/" + id;
   vtkNew<vtkImageData> image;
-  QVariantMap options = { { "askForSubsample", false } };
-  if (!EmdFormat::readNode(reader, path, image, options)) {
-    cerr << "Failed to read data at: " << path << endl;
-    return false;
+  int level = Tvh5Multiscale::coarsestLevel(reader, path);
+  if (level > 0) {
+    if (!Tvh5Multiscale::readLevel(reader, path, level, image)) {
+      cerr << "Failed to read level " << level << " at: " << path << endl;
+      return false;
+    }
+  } else {
+    QVariantMap options = { { "askForSubsample", false } };
+    if (!EmdFormat::readNode(reader, path, image, options)) {
+      cerr << "Failed to read data at: " << path << endl;
+      return false;
+    }
   }
 
   // Next, create the data source
@@ -189,6 +203,9 @@ bool Tvh5Format::loadDataSource(h5::H5ReadWrite& reader,
     dataSource->deserialize(dsObject);
   }
 
+  Tvh5Multiscale::load(dataSource, reader.fileName(), path, level,
+                       dsObject.contains("spacing"));
+
   // Set the active data source
   if (dsObject.value("active").toBool()) {
     *active = dataSource;
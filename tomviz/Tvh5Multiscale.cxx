@@ -0,0 +1,750 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "Tvh5Multiscale.h"
+
+#include "DataSource.h"
+#include "GenericHDF5Format.h"
+#include "ImagePyramid.h"
+#include "Pipeline.h"
+
+#include <h5cpp/h5readwrite.h>
+#include <h5cpp/h5vtktypemaps.h>
+
+#include <pqApplicationCore.h>
+#include <pqSettings.h>
+
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+#include <QDebug>
+#include <QList>
+#include <QTimer>
+#include <QtConcurrent>
+
+#include <vtk_zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char* GroupName = "tomviz_multiscale";
+
+// The coarsest level written is the first one whose longest axis is at most
+// this size, small enough to be read and shown straight away.
+const int PreviewSize = 128;
+
+// Levels are stored in cubic chunks of this size, compressed with deflate at
+// a low level, which costs little when saving.
+const int ChunkSize = 64;
+const int CompressionLevel = 1;
+
+// Bytes read from the file per step of the event loop.
+const size_t SlabSize = 16 * 1024 * 1024;
+
+QList<tomviz::Tvh5Multiscale*>& loaders()
+{
+  static QList<tomviz::Tvh5Multiscale*> list;
+  return list;
+}
+
+// The data sources whose finer levels could not all be read.
+QList<QPointer<tomviz::DataSource>>& incompleteSources()
+{
+  static QList<QPointer<tomviz::DataSource>> list;
+  return list;
+}
+
+std::string levelPath(const std::string& path, int level)
+{
+  if (level == 0) {
+    return path;
+  }
+  return path + "/" + GroupName + "/level_" + std::to_string(level);
+}
+
+// The spacing of the full resolution data, from the dimension vectors of the
+// EMD node. As for EmdFormat, "dim1" is along x: the data is stored in C
+// order but its dimensions are not reversed.
+void fullSpacing(h5::H5ReadWrite& reader, const std::string& path,
+                 double spacing[3])
+{
+  auto dim1 = reader.readData<float>(path + "/dim1");
+  auto dim2 = reader.readData<float>(path + "/dim2");
+  auto dim3 = reader.readData<float>(path + "/dim3");
+  if (dim1.size() > 1 && dim2.size() > 1 && dim3.size() > 1) {
+    spacing[0] = static_cast<double>(dim1[1] - dim1[0]);
+    spacing[1] = static_cast<double>(dim2[1] - dim2[0]);
+    spacing[2] = static_cast<double>(dim3[1] - dim3[0]);
+  }
+}
+
+// The origin stored with \p level, if any.
+bool levelOrigin(h5::H5ReadWrite& reader, const std::string& path, int level,
+                 double origin[3])
+{
+  auto originPath = levelPath(path, level) + "/origin";
+  if (level == 0 || !reader.isDataSet(originPath)) {
+    return false;
+  }
+  auto values = reader.readData<double>(originPath);
+  if (values.size() != 3) {
+    return false;
+  }
+  std::copy(values.begin(), values.end(), origin);
+  return true;
+}
+} // namespace
+
+namespace tomviz {
+
+Tvh5Multiscale::Tvh5Multiscale(DataSource* dataSource,
+                               const std::string& fileName,
+                               const std::string& path, int level,
+                               bool fullSpacing)
+  : QObject(dataSource), m_dataSource(dataSource), m_fileName(fileName),
+    m_path(path), m_fullSpacing(fullSpacing), m_level(level)
+{
+  connect(&m_reorder, &QFutureWatcher<vtkSmartPointer<vtkImageData>>::finished,
+          this, &Tvh5Multiscale::levelReordered);
+  loaders().append(this);
+}
+
+Tvh5Multiscale::~Tvh5Multiscale()
+{
+  loaders().removeAll(this);
+}
+
+bool Tvh5Multiscale::enabled()
+{
+  auto core = pqApplicationCore::instance();
+  if (!core) {
+    return true;
+  }
+  return core->settings()->value("Tomviz.Tvh5Multiscale", true).toBool();
+}
+
+Tvh5Multiscale::Levels Tvh5Multiscale::prepare(
+  vtkImageData* image, const std::atomic<bool>* canceled, bool compress)
+{
+  Levels levels;
+  if (DataSource::hasTiltAngles(image)) {
+    // Averaging would mix projections taken at different angles.
+    return levels;
+  }
+
+  auto pointData = image->GetPointData();
+  if (!pointData->GetScalars()) {
+    return levels;
+  }
+  for (int i = 0; i < pointData->GetNumberOfArrays(); ++i) {
+    auto array = pointData->GetArray(i);
+    if (!array || array->GetNumberOfComponents() != 1) {
+      return levels;
+    }
+  }
+
+  // The levels are built straight from the image, there is no need to cache
+  // them.
+  ImagePyramid pyramid(image);
+  pyramid.setMemoryBudget(0);
+
+  int coarsest = 0;
+  for (int i = 0; i < pyramid.numberOfLevels(); ++i) {
+    coarsest = i;
+    int dims[3];
+    pyramid.levelDimensions(i, dims);
+    if (std::max({ dims[0], dims[1], dims[2] }) <= PreviewSize) {
+      break;
+    }
+  }
+
+  for (int level = 1; level <= coarsest; ++level) {
+    if (canceled && *canceled) {
+      return Levels();
+    }
+
+    // Stored in C order, as the EMD node
+    auto levelImage = pyramid.level(level);
+    vtkNew<vtkImageData> permutedImage;
+    GenericHDF5Format::reorderData(levelImage, permutedImage,
+                                   ReorderMode::FortranToC);
+
+    Level prepared;
+    prepared.level = level;
+    levelImage->GetOrigin(prepared.origin);
+    int dim[3];
+    permutedImage->GetDimensions(dim);
+    prepared.dims = { dim[0], dim[1], dim[2] };
+
+    auto levelData = permutedImage->GetPointData();
+    prepared.activeName = levelData->GetScalars()->GetName();
+    for (int i = 0; i < levelData->GetNumberOfArrays(); ++i) {
+      Level::Data data;
+      data.name = levelData->GetArrayName(i);
+      data.array = levelData->GetArray(i);
+      data.vtkType = data.array->GetDataType();
+      if (compress && h5::H5ReadWrite::canWriteChunks() &&
+          !compressChunks(data, prepared.dims, canceled)) {
+        return Levels();
+      }
+      prepared.arrays.push_back(std::move(data));
+    }
+    levels.push_back(std::move(prepared));
+  }
+
+  return levels;
+}
+
+bool Tvh5Multiscale::compressChunks(Level::Data& data,
+                                    const std::vector<int>& dims,
+                                    const std::atomic<bool>* canceled)
+{
+  // Chunks at the edges are padded to the full chunk size.
+  int chunk[3];
+  for (int i = 0; i < 3; ++i) {
+    chunk[i] = std::min(ChunkSize, dims[i]);
+  }
+
+  const size_t valueSize = data.array->GetDataTypeSize();
+  const size_t chunkRowSize = chunk[2] * valueSize;
+  std::vector<char> buffer(chunk[0] * chunk[1] * chunkRowSize);
+  auto values = static_cast<const char*>(data.array->GetVoidPointer(0));
+
+  for (int i0 = 0; i0 < dims[0]; i0 += chunk[0]) {
+    for (int i1 = 0; i1 < dims[1]; i1 += chunk[1]) {
+      for (int i2 = 0; i2 < dims[2]; i2 += chunk[2]) {
+        if (canceled && *canceled) {
+          return false;
+        }
+
+        std::fill(buffer.begin(), buffer.end(), 0);
+        const int n0 = std::min(chunk[0], dims[0] - i0);
+        const int n1 = std::min(chunk[1], dims[1] - i1);
+        const size_t rowSize = std::min(chunk[2], dims[2] - i2) * valueSize;
+        for (int j0 = 0; j0 < n0; ++j0) {
+          for (int j1 = 0; j1 < n1; ++j1) {
+            size_t index =
+              (static_cast<size_t>(i0 + j0) * dims[1] + i1 + j1) * dims[2] +
+              i2;
+            memcpy(&buffer[(j0 * chunk[1] + j1) * chunkRowSize],
+                   values + index * valueSize, rowSize);
+          }
+        }
+
+        uLongf size = compressBound(static_cast<uLong>(buffer.size()));
+        std::vector<char> compressed(size);
+        if (compress2(reinterpret_cast<Bytef*>(compressed.data()), &size,
+                      reinterpret_cast<const Bytef*>(buffer.data()),
+                      static_cast<uLong>(buffer.size()),
+                      CompressionLevel) != Z_OK) {
+          return false;
+        }
+        compressed.resize(size);
+        data.chunks.push_back(std::move(compressed));
+      }
+    }
+  }
+
+  // The array is not needed anymore.
+  data.array = nullptr;
+  return true;
+}
+
+bool Tvh5Multiscale::write(h5::H5ReadWrite& writer, const std::string& path,
+                           const Levels& levels)
+{
+  if (levels.empty()) {
+    return true;
+  }
+
+  std::string group = path + "/" + GroupName;
+  writer.createGroup(group);
+  writer.setAttribute(group, "coarsest_level",
+                      static_cast<unsigned int>(levels.back().level));
+
+  const std::vector<int> chunk = { ChunkSize, ChunkSize, ChunkSize };
+  for (const auto& level : levels) {
+    auto node = levelPath(path, level.level);
+    writer.createGroup(node);
+    writer.setAttribute(node, "factor", 1u << level.level);
+    std::vector<double> origin(level.origin, level.origin + 3);
+    writer.writeData(node, "origin", { 3 }, origin);
+    if (level.arrays.size() > 1) {
+      writer.createGroup(node + "/tomviz_scalars");
+    }
+
+    for (const auto& data : level.arrays) {
+      bool active = data.name == level.activeName;
+      auto parent = active ? node : node + "/tomviz_scalars";
+      auto name = active ? std::string("data") : data.name;
+      auto type = h5::H5VtkTypeMaps::VtkToDataType(data.vtkType);
+
+      if (data.chunks.empty()) {
+        if (!writer.writeData(parent, name, level.dims, type,
+                              data.array->GetVoidPointer(0), chunk,
+                              CompressionLevel)) {
+          return false;
+        }
+      } else {
+        if (!writer.createDataSet(parent, name, level.dims, type, chunk,
+                                  CompressionLevel)) {
+          return false;
+        }
+
+        // In the order they were compressed in
+        auto chunkIt = data.chunks.begin();
+        for (int i0 = 0; i0 < level.dims[0]; i0 += ChunkSize) {
+          for (int i1 = 0; i1 < level.dims[1]; i1 += ChunkSize) {
+            for (int i2 = 0; i2 < level.dims[2]; i2 += ChunkSize) {
+              if (!writer.writeChunk(parent + "/" + name, { i0, i1, i2 },
+                                     chunkIt->data(), chunkIt->size())) {
+                return false;
+              }
+              ++chunkIt;
+            }
+          }
+        }
+      }
+
+      if (active) {
+        writer.setAttribute(node + "/data", "name", data.name.c_str());
+      }
+    }
+  }
+
+  return true;
+}
+
+int Tvh5Multiscale::coarsestLevel(h5::H5ReadWrite& reader,
+                                  const std::string& path)
+{
+  std::string group = path + "/" + GroupName;
+  if (!reader.isGroup(group)) {
+    return 0;
+  }
+
+  bool ok;
+  auto level = reader.attribute<unsigned int>(group, "coarsest_level", &ok);
+  if (!ok || !reader.isDataSet(levelPath(path, level) + "/data")) {
+    return 0;
+  }
+
+  return static_cast<int>(level);
+}
+
+bool Tvh5Multiscale::readLevel(h5::H5ReadWrite& reader,
+                               const std::string& path, int level,
+                               vtkImageData* image)
+{
+  int dims[3];
+  std::vector<Array> arrays;
+  if (!openLevel(reader, path, level, dims, arrays)) {
+    return false;
+  }
+
+  for (auto& array : arrays) {
+    int row = 0;
+    while (row < dims[0]) {
+      if (!readSlab(reader, dims, array, row)) {
+        return false;
+      }
+    }
+  }
+
+  image->ShallowCopy(reorder(dims, arrays));
+
+  // As for ImagePyramid, each point sits at the center of the block it
+  // averages.
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  double origin[3];
+  fullSpacing(reader, path, spacing);
+  const int factor = 1 << level;
+  const bool stored = levelOrigin(reader, path, level, origin);
+  for (int i = 0; i < 3; ++i) {
+    if (!stored) {
+      origin[i] = (factor - 1) / 2.0 * spacing[i];
+    }
+    spacing[i] *= factor;
+  }
+  image->SetOrigin(origin);
+  image->SetSpacing(spacing);
+
+  return true;
+}
+
+void Tvh5Multiscale::load(DataSource* dataSource, const std::string& fileName,
+                          const std::string& path, int level,
+                          bool fullSpacing)
+{
+  if (level > 0) {
+    new Tvh5Multiscale(dataSource, fileName, path, level, fullSpacing);
+  }
+}
+
+void Tvh5Multiscale::startAll()
+{
+  auto list = loaders();
+  for (auto* loader : list) {
+    if (!loader->m_started) {
+      loader->start();
+    }
+  }
+}
+
+bool Tvh5Multiscale::finishAll()
+{
+  auto list = loaders();
+  for (auto* loader : list) {
+    loader->finish();
+  }
+
+  auto& sources = incompleteSources();
+  sources.removeAll(QPointer<DataSource>());
+  return sources.isEmpty();
+}
+
+bool Tvh5Multiscale::isIncomplete(DataSource* dataSource)
+{
+  return dataSource && incompleteSources().contains(dataSource);
+}
+
+void Tvh5Multiscale::start()
+{
+  m_started = true;
+  if (!m_dataSource) {
+    stop();
+    return;
+  }
+
+  m_reader.reset(
+    new h5::H5ReadWrite(m_fileName, h5::H5ReadWrite::OpenMode::ReadOnly));
+
+  if (m_fullSpacing) {
+    // Scale the spacing restored from the state to the level. The offset of
+    // the level from the full resolution origin scales with it.
+    double spacing[3], origin[3];
+    double fileSpacing[3] = { 1.0, 1.0, 1.0 };
+    m_dataSource->getSpacing(spacing);
+    m_dataSource->imageData()->GetOrigin(origin);
+    fullSpacing(*m_reader, m_path, fileSpacing);
+    const int factor = 1 << m_level;
+    for (int i = 0; i < 3; ++i) {
+      origin[i] += (factor - 1) / 2.0 * (spacing[i] - fileSpacing[i]);
+      spacing[i] *= factor;
+    }
+    m_dataSource->imageData()->SetOrigin(origin);
+    m_dataSource->setSpacing(spacing, false);
+  }
+
+  // Operators must run on the full resolution data.
+  if (auto pipeline = m_dataSource->pipeline()) {
+    connect(pipeline, &Pipeline::started, this, &Tvh5Multiscale::finish);
+  }
+
+  if (!beginLevel(m_level - 1)) {
+    fail();
+    return;
+  }
+
+  QTimer::singleShot(0, this, &Tvh5Multiscale::step);
+}
+
+void Tvh5Multiscale::finish()
+{
+  if (m_stopped) {
+    return;
+  }
+
+  if (!m_started) {
+    start();
+  }
+
+  while (!m_stopped && m_dataSource) {
+    vtkSmartPointer<vtkImageData> image;
+    if (m_reorder.isRunning() || m_arrays.empty()) {
+      m_reorder.waitForFinished();
+      image = m_reorder.result();
+    } else {
+      while (m_arrayIndex < m_arrays.size()) {
+        if (!readSlab()) {
+          fail();
+          return;
+        }
+      }
+      image = reorder(m_dims, std::move(m_arrays));
+      m_arrays.clear();
+    }
+
+    if (!swapLevel(image)) {
+      fail();
+      return;
+    }
+    if (m_level == 0) {
+      break;
+    }
+    if (!beginLevel(m_level - 1)) {
+      fail();
+      return;
+    }
+  }
+
+  stop();
+}
+
+void Tvh5Multiscale::stop()
+{
+  if (m_stopped) {
+    return;
+  }
+
+  m_stopped = true;
+  m_reader.reset();
+  m_arrays.clear();
+  loaders().removeAll(this);
+  deleteLater();
+}
+
+void Tvh5Multiscale::fail()
+{
+  if (m_dataSource) {
+    qCritical() << m_dataSource->label()
+                << "only holds a reduced resolution of its data, level"
+                << m_level << "of" << QString::fromStdString(m_fileName)
+                << "- it can't be saved";
+    incompleteSources().append(m_dataSource);
+  }
+  stop();
+}
+
+void Tvh5Multiscale::step()
+{
+  if (m_stopped) {
+    return;
+  }
+
+  if (!m_dataSource) {
+    stop();
+    return;
+  }
+  if (!readSlab()) {
+    fail();
+    return;
+  }
+
+  if (m_arrayIndex < m_arrays.size()) {
+    QTimer::singleShot(0, this, &Tvh5Multiscale::step);
+    return;
+  }
+
+  // The level has been read, re-order it on a worker thread.
+  std::vector<Array> arrays;
+  arrays.swap(m_arrays);
+  int dims[3] = { m_dims[0], m_dims[1], m_dims[2] };
+  m_reorder.setFuture(QtConcurrent::run(
+    [dims, arrays]() { return reorder(dims, arrays); }));
+}
+
+void Tvh5Multiscale::levelReordered()
+{
+  if (m_stopped) {
+    return;
+  }
+
+  if (!m_dataSource) {
+    stop();
+    return;
+  }
+  if (!swapLevel(m_reorder.result())) {
+    fail();
+    return;
+  }
+  if (m_level == 0) {
+    stop();
+    return;
+  }
+  if (!beginLevel(m_level - 1)) {
+    fail();
+    return;
+  }
+
+  QTimer::singleShot(0, this, &Tvh5Multiscale::step);
+}
+
+bool Tvh5Multiscale::beginLevel(int level)
+{
+  m_readLevel = level;
+  m_arrayIndex = 0;
+  m_row = 0;
+  m_arrays.clear();
+  if (!openLevel(*m_reader, m_path, level, m_dims, m_arrays)) {
+    qCritical() << "Failed to read level" << level << "of"
+                << QString::fromStdString(m_path);
+    return false;
+  }
+  return true;
+}
+
+bool Tvh5Multiscale::readSlab()
+{
+  if (!readSlab(*m_reader, m_dims, m_arrays[m_arrayIndex], m_row)) {
+    qCritical() << "Failed to read level" << m_readLevel << "of"
+                << QString::fromStdString(m_path);
+    return false;
+  }
+
+  if (m_row >= m_dims[0]) {
+    ++m_arrayIndex;
+    m_row = 0;
+  }
+  return true;
+}
+
+bool Tvh5Multiscale::swapLevel(vtkImageData* image)
+{
+  auto current = m_dataSource->imageData();
+  auto pointData = current->GetPointData();
+  auto levelData = image ? image->GetPointData() : nullptr;
+  if (!levelData ||
+      pointData->GetNumberOfArrays() != levelData->GetNumberOfArrays()) {
+    // The arrays of the data source changed since it was loaded.
+    return false;
+  }
+
+  // Keep any change made to the spacing meanwhile.
+  double spacing[3], origin[3];
+  current->GetSpacing(spacing);
+  current->GetOrigin(origin);
+  const int from = 1 << m_level;
+  const int to = 1 << m_readLevel;
+  for (int i = 0; i < 3; ++i) {
+    double base = spacing[i] / from;
+    origin[i] += (to - from) / 2.0 * base;
+    spacing[i] = base * to;
+  }
+
+  std::string activeName;
+  if (pointData->GetScalars() && pointData->GetScalars()->GetName()) {
+    activeName = pointData->GetScalars()->GetName();
+  }
+
+  // Arrays are replaced in place, keeping the names they have been given.
+  current->SetDimensions(image->GetDimensions());
+  current->SetOrigin(origin);
+  for (int i = 0; i < levelData->GetNumberOfArrays(); ++i) {
+    auto array = levelData->GetArray(i);
+    array->SetName(pointData->GetArrayName(i));
+    pointData->AddArray(array);
+  }
+  if (!activeName.empty()) {
+    pointData->SetActiveScalars(activeName.c_str());
+  }
+
+  m_level = m_readLevel;
+  m_dataSource->dataModified();
+  m_dataSource->setSpacing(spacing, false);
+  return true;
+}
+
+bool Tvh5Multiscale::openLevel(h5::H5ReadWrite& reader,
+                               const std::string& path, int level,
+                               int dims[3], std::vector<Array>& arrays)
+{
+  auto node = levelPath(path, level);
+  auto dataPath = node + "/data";
+  if (!reader.isDataSet(dataPath)) {
+    return false;
+  }
+
+  auto dataDims = reader.getDimensions(dataPath);
+  if (dataDims.size() != 3) {
+    return false;
+  }
+  std::copy(dataDims.begin(), dataDims.end(), dims);
+
+  std::vector<std::pair<std::string, std::string>> datasets;
+  std::string activeName = "ImageScalars";
+  if (reader.hasAttribute(dataPath, "name")) {
+    bool ok;
+    auto name = reader.attribute<std::string>(dataPath, "name", &ok);
+    if (ok) {
+      activeName = name;
+    }
+  }
+  datasets.emplace_back(dataPath, activeName);
+
+  std::string scalarsPath = node + "/tomviz_scalars";
+  if (reader.isGroup(scalarsPath)) {
+    for (const auto& name : reader.allDataSets(scalarsPath)) {
+      auto scalarPath = scalarsPath + "/" + name;
+      // The full resolution node links to its active scalars.
+      if (!reader.isSoftLink(scalarPath) &&
+          reader.getDimensions(scalarPath) == dataDims) {
+        datasets.emplace_back(scalarPath, name);
+      }
+    }
+  }
+
+  const vtkIdType numTuples =
+    static_cast<vtkIdType>(dims[0]) * dims[1] * dims[2];
+  for (const auto& dataset : datasets) {
+    auto type = reader.dataType(dataset.first);
+    auto vtkType = h5::H5VtkTypeMaps::dataTypeToVtk(type);
+    vtkSmartPointer<vtkDataArray> array;
+    array.TakeReference(vtkDataArray::CreateDataArray(vtkType));
+    array->SetName(dataset.second.c_str());
+    array->SetNumberOfTuples(numTuples);
+    arrays.push_back({ dataset.first, array });
+  }
+
+  return true;
+}
+
+bool Tvh5Multiscale::readSlab(h5::H5ReadWrite& reader, const int dims[3],
+                              Array& array, int& row)
+{
+  // Whole rows along the slowest axis, in multiples of the chunk size.
+  const size_t rowSize = static_cast<size_t>(dims[1]) * dims[2] *
+                         array.array->GetDataTypeSize();
+  int rows = static_cast<int>(std::max<size_t>(1, SlabSize / rowSize));
+  if (rows > ChunkSize) {
+    rows -= rows % ChunkSize;
+  }
+  rows = std::min(rows, dims[0] - row);
+
+  size_t start[3] = { static_cast<size_t>(row), 0, 0 };
+  size_t counts[3] = { static_cast<size_t>(rows),
+                       static_cast<size_t>(dims[1]),
+                       static_cast<size_t>(dims[2]) };
+  auto data =
+    static_cast<char*>(array.array->GetVoidPointer(0)) + row * rowSize;
+  if (!reader.readData(array.path, reader.dataType(array.path), data, nullptr,
+                       start, counts)) {
+    return false;
+  }
+
+  row += rows;
+  return true;
+}
+
+vtkSmartPointer<vtkImageData> Tvh5Multiscale::reorder(const int dims[3],
+                                                      std::vector<Array> arrays)
+{
+  vtkNew<vtkImageData> permutedImage;
+  permutedImage->SetDimensions(dims[0], dims[1], dims[2]);
+  auto pointData = permutedImage->GetPointData();
+  for (const auto& array : arrays) {
+    pointData->AddArray(array.array);
+  }
+  pointData->SetActiveScalars(arrays.front().array->GetName());
+
+  auto image = vtkSmartPointer<vtkImageData>::New();
+  GenericHDF5Format::reorderData(permutedImage, image,
+                                 ReorderMode::CToFortran);
+  return image;
+}
+
+} // namespace tomviz
@@ -0,0 +1,174 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizTvh5Multiscale_h
+#define tomvizTvh5Multiscale_h
+
+#include <QObject>
+
+#include <QFutureWatcher>
+#include <QPointer>
+
+#include <vtkSmartPointer.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+class vtkDataArray;
+class vtkImageData;
+
+namespace h5 {
+class H5ReadWrite;
+}
+
+namespace tomviz {
+
+class DataSource;
+
+/// The optional multiscale layout of the data sources in tvh5 files. Next to
+/// the full resolution "data" of an EMD node, the levels of its ImagePyramid
+/// are stored, chunked and compressed, as EMD style "data" and
+/// "tomviz_scalars" nodes under "tomviz_multiscale/level_<n>". Readers that
+/// do not know about the layout simply read the full resolution data.
+///
+/// A data source is first created from the coarsest level, so that it can be
+/// shown straight away. A Tvh5Multiscale object then reads the finer levels
+/// and swaps each one into the data source once it is complete. HDF5 is not
+/// thread safe, so the levels are read a slab at a time from the event loop
+/// and only their re-ordering to Fortran order runs on a worker thread.
+class Tvh5Multiscale : public QObject
+{
+  Q_OBJECT
+
+public:
+  ~Tvh5Multiscale() override;
+
+  /// Whether tvh5 files are written with the multiscale layout, the
+  /// "Tomviz.Tvh5Multiscale" setting, true by default.
+  static bool enabled();
+
+  /// The multiscale levels of an image, ready to be written.
+  struct Level
+  {
+    struct Data
+    {
+      std::string name;
+      int vtkType;
+      // In C order, released once it is compressed.
+      vtkSmartPointer<vtkDataArray> array;
+      // The compressed chunks, if the HDF5 library can write them directly.
+      std::vector<std::vector<char>> chunks;
+    };
+
+    int level;
+    std::vector<int> dims;
+    // The origin of the level, in x, y, z order. The EMD node does not store
+    // the origin of the full resolution data.
+    double origin[3];
+    std::string activeName;
+    std::vector<Data> arrays;
+  };
+  using Levels = std::vector<Level>;
+
+  /// Build, re-order and compress the multiscale levels of \p image. This
+  /// is the expensive part of writing them and may run on any thread. There
+  /// are no levels for tilt series, images with multi-component arrays or
+  /// images that are small enough to be read at once. Returns no levels
+  /// either if \p canceled is set meanwhile. The chunks are compressed here
+  /// if the HDF5 library can write them directly, unless \p compress is
+  /// false, they are then compressed by the library as they are written.
+  static Levels prepare(vtkImageData* image,
+                        const std::atomic<bool>* canceled = nullptr,
+                        bool compress = true);
+
+  /// Write \p levels for the EMD node at \p path.
+  static bool write(h5::H5ReadWrite& writer, const std::string& path,
+                    const Levels& levels);
+
+  /// The coarsest level stored for the EMD node at \p path, 0 if the node
+  /// has no multiscale layout.
+  static int coarsestLevel(h5::H5ReadWrite& reader, const std::string& path);
+
+  /// Read \p level of the EMD node at \p path into \p image, level 0 being
+  /// the full resolution data. The spacing and origin are those of the
+  /// level, as for ImagePyramid::level(), the origin the one stored with the
+  /// level.
+  static bool readLevel(h5::H5ReadWrite& reader, const std::string& path,
+                        int level, vtkImageData* image);
+
+  /// Stream the levels finer than \p level, which \p dataSource holds, from
+  /// the EMD node at \p path of \p fileName. Loading begins on startAll().
+  /// If \p fullSpacing is true the spacing of the data source was restored
+  /// from a state file, so it is that of the full resolution data.
+  static void load(DataSource* dataSource, const std::string& fileName,
+                   const std::string& path, int level, bool fullSpacing);
+
+  /// Start streaming the levels of every data source passed to load().
+  static void startAll();
+
+  /// Read the remaining levels of every data source being streamed right
+  /// away, e.g. before it is saved or processed. Returns false if the levels
+  /// of a data source could not all be read: it then only holds a reduced
+  /// resolution of its data, which must not be saved as the full one.
+  static bool finishAll();
+
+  /// Whether the levels of \p dataSource could not all be read.
+  static bool isIncomplete(DataSource* dataSource);
+
+private slots:
+  void step();
+  void levelReordered();
+
+private:
+  struct Array
+  {
+    std::string path;
+    vtkSmartPointer<vtkDataArray> array;
+  };
+
+  Tvh5Multiscale(DataSource* dataSource, const std::string& fileName,
+                 const std::string& path, int level, bool fullSpacing);
+
+  void start();
+  void finish();
+  void stop();
+  // Stop after a failure, the data source is left incomplete.
+  void fail();
+
+  bool beginLevel(int level);
+  bool readSlab();
+  bool swapLevel(vtkImageData* image);
+
+  static bool compressChunks(Level::Data& data, const std::vector<int>& dims,
+                             const std::atomic<bool>* canceled);
+  static bool openLevel(h5::H5ReadWrite& reader, const std::string& path,
+                        int level, int dims[3], std::vector<Array>& arrays);
+  static bool readSlab(h5::H5ReadWrite& reader, const int dims[3],
+                       Array& array, int& row);
+  static vtkSmartPointer<vtkImageData> reorder(const int dims[3],
+                                               std::vector<Array> arrays);
+
+  QPointer<DataSource> m_dataSource;
+  std::string m_fileName;
+  std::string m_path;
+  bool m_fullSpacing;
+  std::unique_ptr<h5::H5ReadWrite> m_reader;
+
+  // The level held by the data source.
+  int m_level;
+  // The level being read, its arrays in C order and where the next slab is.
+  int m_readLevel = -1;
+  int m_dims[3] = { 0, 0, 0 };
+  std::vector<Array> m_arrays;
+  size_t m_arrayIndex = 0;
+  int m_row = 0;
+
+  QFutureWatcher<vtkSmartPointer<vtkImageData>> m_reorder;
+  bool m_started = false;
+  bool m_stopped = false;
+};
+} // namespace tomviz
+
+#endif
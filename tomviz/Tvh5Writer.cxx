@@ -0,0 +1,255 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "Tvh5Writer.h"
+
+#include "ActiveObjects.h"
+#include "DataSource.h"
+#include "EmdFormat.h"
+#include "MemoryMappedArray.h"
+#include "ModuleManager.h"
+
+#include <h5cpp/h5readwrite.h>
+
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QMutexLocker>
+#include <QtConcurrent>
+
+namespace {
+
+// Data sources prepared ahead of the writer.
+const int MaxPreparedNodes = 2;
+
+const char* ActiveNodePath = "/data/tomography";
+
+} // namespace
+
+namespace tomviz {
+
+Tvh5Writer::Tvh5Writer(const QString& fileName, QObject* parent)
+  : QObject(parent), m_fileName(fileName), m_slots(MaxPreparedNodes)
+{
+  m_pool.setMaxThreadCount(MaxPreparedNodes);
+}
+
+Tvh5Writer::~Tvh5Writer()
+{
+  if (m_writer.joinable()) {
+    m_writer.join();
+  }
+  m_pool.waitForDone();
+}
+
+bool Tvh5Writer::start()
+{
+  // Data sources still being streamed from a file must be complete
+  if (!Tvh5Multiscale::finishAll()) {
+    m_errorMessage = "The data could not all be read, it can't be saved";
+    return false;
+  }
+
+  DataSource* source = ActiveObjects::instance().activeDataSource();
+  if (!source) {
+    m_errorMessage = "There is no active data source to save";
+    return false;
+  }
+
+  // The state is written to "tomviz_state"
+  QFileInfo info(m_fileName);
+  QJsonObject stateObject;
+  auto success =
+    ModuleManager::instance().serialize(stateObject, info.dir(), false);
+  if (!success) {
+    m_errorMessage = "Failed to serialize the state of Tomviz";
+    return false;
+  }
+
+  QMap<QString, vtkImageData*> images;
+  for (auto* ds : ModuleManager::instance().allDataSources()) {
+    images.insert(ds->id(), ds->imageData());
+  }
+  images.insert(source->id(), source->imageData());
+  return start(QJsonDocument(stateObject).toJson(), source->id(), images);
+}
+
+bool Tvh5Writer::start(const QByteArray& state, const QString& activeId,
+                       const QMap<QString, vtkImageData*>& images)
+{
+  if (!images.contains(activeId)) {
+    m_errorMessage = "There is no active data source to save";
+    return false;
+  }
+  m_state = state;
+
+  // The active data source is the standard EMD node, the others are written
+  // under "/tomviz_datasources", named after their ids.
+  m_activeId = activeId.toStdString();
+  m_multiscale = Tvh5Multiscale::enabled();
+  addNode(ActiveNodePath, images.value(activeId));
+  for (auto it = images.begin(); it != images.end(); ++it) {
+    if (it.key() != activeId) {
+      addNode("/tomviz_datasources/" + it.key().toStdString(), it.value());
+    }
+  }
+
+  m_writer = std::thread(&Tvh5Writer::write, this);
+  for (auto& node : m_nodes) {
+    auto* n = node.get();
+    QtConcurrent::run(&m_pool, [this, n]() { prepare(n); });
+  }
+
+  return true;
+}
+
+void Tvh5Writer::cancel()
+{
+  m_canceled = true;
+  m_stopped = true;
+}
+
+bool Tvh5Writer::isCanceled() const
+{
+  return m_canceled;
+}
+
+QString Tvh5Writer::errorMessage() const
+{
+  return m_errorMessage;
+}
+
+void Tvh5Writer::addNode(const std::string& path, vtkImageData* image)
+{
+  // A shallow copy keeps the arrays as they are now, data sources replace
+  // their arrays rather than modifying them when they change.
+  std::unique_ptr<Node> node(new Node);
+  node->path = path;
+  node->image = vtkSmartPointer<vtkImageData>::New();
+  node->image->ShallowCopy(image);
+
+  auto pointData = image->GetPointData();
+  for (int i = 0; i < pointData->GetNumberOfArrays(); ++i) {
+    if (auto array = pointData->GetArray(i)) {
+      node->size += static_cast<qint64>(array->GetNumberOfValues()) *
+                    array->GetDataTypeSize();
+    }
+  }
+
+  m_total += 2 * node->size;
+  m_nodes.push_back(std::move(node));
+}
+
+void Tvh5Writer::prepare(Node* node)
+{
+  m_slots.acquire();
+
+  if (!m_stopped) {
+    node->permutedImage = vtkSmartPointer<vtkImageData>::New();
+    EmdFormat::prepareNode(node->image, node->permutedImage);
+    if (m_multiscale) {
+      node->levels = Tvh5Multiscale::prepare(node->image, &m_stopped);
+    }
+    addProgress(node->size);
+  }
+  node->image = nullptr;
+
+  // Even skipped nodes are queued, the writer counts them.
+  QMutexLocker lock(&m_mutex);
+  m_prepared.enqueue(node);
+  m_ready.wakeOne();
+}
+
+void Tvh5Writer::write()
+{
+  // Next to the file, so that it can replace it.
+  auto fileName = MemoryMappedArray::partFileName(m_fileName);
+  QFile::remove(fileName);
+  bool success = writeFile(fileName.toStdString());
+
+  if (!success) {
+    QFile::remove(fileName);
+  } else if (!MemoryMappedArray::replace(fileName, m_fileName)) {
+    m_errorMessage = QString("Failed to replace %1, the data was written to %2")
+                       .arg(m_fileName, fileName);
+    success = false;
+  }
+
+  emit finished(success);
+}
+
+bool Tvh5Writer::writeFile(const std::string& fileName)
+{
+  using h5::H5ReadWrite;
+  H5ReadWrite writer(fileName, H5ReadWrite::OpenMode::WriteOnly);
+
+  // The standard EMD file, with the state next to it
+  writer.setAttribute("/", "version_major", 0u);
+  writer.setAttribute("/", "version_minor", 2u);
+  writer.createGroup("/data");
+  writer.createGroup(ActiveNodePath);
+
+  if (!writer.writeData("/", "tomviz_state", { m_state.size() },
+                        m_state.data())) {
+    m_errorMessage = "Failed to write tomviz_state";
+    m_stopped = true;
+  }
+
+  // Make a soft link rather than writing the active data again
+  writer.createGroup("/tomviz_datasources");
+  writer.createSoftLink(ActiveNodePath, "/tomviz_datasources/" + m_activeId);
+
+  // Write the data sources as they are prepared. Every node is taken off the
+  // queue, even when stopped, so that no worker is left waiting for a slot.
+  for (size_t i = 0; i < m_nodes.size(); ++i) {
+    Node* node;
+    {
+      QMutexLocker lock(&m_mutex);
+      while (m_prepared.isEmpty()) {
+        m_ready.wait(&m_mutex);
+      }
+      node = m_prepared.dequeue();
+    }
+
+    if (!m_stopped && !writeNode(writer, node)) {
+      m_errorMessage =
+        QString("Failed to write data source: %1").arg(node->path.c_str());
+      m_stopped = true;
+    }
+
+    node->permutedImage = nullptr;
+    node->levels.clear();
+    m_slots.release();
+  }
+
+  return !m_stopped;
+}
+
+bool Tvh5Writer::writeNode(h5::H5ReadWrite& writer, Node* node)
+{
+  if (node->path != ActiveNodePath) {
+    writer.createGroup(node->path);
+  }
+
+  if (!EmdFormat::writePreparedNode(writer, node->path, node->permutedImage) ||
+      !Tvh5Multiscale::write(writer, node->path, node->levels)) {
+    return false;
+  }
+
+  addProgress(node->size);
+  return true;
+}
+
+void Tvh5Writer::addProgress(qint64 bytes)
+{
+  emit progress(m_progress += bytes, m_total);
+}
+
+} // namespace tomviz
@@ -0,0 +1,124 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizTvh5Writer_h
+#define tomvizTvh5Writer_h
+
+#include <QObject>
+
+#include <QByteArray>
+#include <QMap>
+#include <QMutex>
+#include <QQueue>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#include <vtkSmartPointer.h>
+
+#include "Tvh5Multiscale.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class vtkImageData;
+
+namespace h5 {
+class H5ReadWrite;
+}
+
+namespace tomviz {
+
+/// Writes a tvh5 file in the background. The state and a shallow copy of each
+/// data source are taken on the main thread when the save starts. The data
+/// sources are then prepared, re-ordered to C order and their multiscale
+/// levels built and compressed, on worker threads while a single writer
+/// thread, libhdf5 not being thread safe, writes them as they become ready.
+///
+/// The file is written under a temporary name, which replaces it once
+/// complete, so that a failed or canceled save leaves an existing file
+/// untouched. If only the replacement fails the temporary file is kept.
+class Tvh5Writer : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit Tvh5Writer(const QString& fileName, QObject* parent = nullptr);
+  /// Waits for the threads, cancel() first to return quickly.
+  ~Tvh5Writer() override;
+
+  /// Serialize the state and start writing, must be called on the main
+  /// thread. Returns false, and sets the error message, if the save could
+  /// not be started, finished() is not emitted then.
+  bool start();
+
+  /// Start writing the serialized \p state and \p images, keyed by the id of
+  /// their data source, \p activeId being the active one. start() calls it
+  /// with the state of the application.
+  bool start(const QByteArray& state, const QString& activeId,
+             const QMap<QString, vtkImageData*>& images);
+
+  /// Stop the save as soon as possible, finished(false) follows.
+  void cancel();
+  bool isCanceled() const;
+
+  /// Describes the error once finished(false) was emitted, empty if the
+  /// save was canceled.
+  QString errorMessage() const;
+
+signals:
+  /// Emitted, from the worker threads, as data sources are prepared and
+  /// written. \p total is twice the size of the data, as every byte is
+  /// counted once prepared and once written.
+  void progress(qint64 done, qint64 total);
+
+  /// Emitted, from the writer thread, once the save is over.
+  void finished(bool success);
+
+private:
+  struct Node
+  {
+    std::string path;
+    vtkSmartPointer<vtkImageData> image;
+    qint64 size = 0;
+    // Filled in by the workers
+    vtkSmartPointer<vtkImageData> permutedImage;
+    Tvh5Multiscale::Levels levels;
+  };
+
+  void addNode(const std::string& path, vtkImageData* image);
+  void prepare(Node* node);
+  void write();
+  bool writeFile(const std::string& fileName);
+  bool writeNode(h5::H5ReadWrite& writer, Node* node);
+  void addProgress(qint64 bytes);
+
+  QString m_fileName;
+  QByteArray m_state;
+  std::string m_activeId;
+  bool m_multiscale = false;
+  std::vector<std::unique_ptr<Node>> m_nodes;
+
+  // Bounds the number of data sources prepared but not written yet, each
+  // holds a copy of its data.
+  QThreadPool m_pool;
+  QSemaphore m_slots;
+  QMutex m_mutex;
+  QWaitCondition m_ready;
+  QQueue<Node*> m_prepared;
+  std::thread m_writer;
+
+  // Set when canceled or on failure, the workers and the writer skip the
+  // remaining data sources.
+  std::atomic<bool> m_stopped{ false };
+  std::atomic<bool> m_canceled{ false };
+  std::atomic<qint64> m_progress{ 0 };
+  qint64 m_total = 0;
+  QString m_errorMessage;
+};
+} // namespace tomviz
+
+#endif
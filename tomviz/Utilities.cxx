@@ -3,6 +3,7 @@
 
 #include "Utilities.h"
 
+#include "ArrayStatistics.h"
 #include "DataSource.h"
 #include "tomvizConfig.h"
 
@@ -557,15 +558,14 @@ bool rescaleColorMap(vtkSMProxy* colorMap, DataSource* dataSource)
   vtkSMProxy* cmap = colorMap;
   vtkSMProxy* omap =
     vtkSMPropertyHelper(cmap, "ScalarOpacityFunction").GetAsProxy();
-  vtkPVArrayInformation* ainfo =
-    tomviz::scalarArrayInformation(dataSource->proxy());
-  if (ainfo != nullptr &&
+  auto stats = dataSource->statistics();
+  if (stats &&
       vtkSMPropertyHelper(cmap, "AutomaticRescaleRangeMode").GetAsInt() !=
         vtkSMTransferFunctionManager::NEVER) {
-    vtkSMTransferFunctionProxy::RescaleTransferFunction(
-      cmap, ainfo->GetComponentRange(-1));
-    vtkSMTransferFunctionProxy::RescaleTransferFunction(
-      omap, ainfo->GetComponentRange(-1));
+    double range[2];
+    stats->finiteRange(range, -1);
+    vtkSMTransferFunctionProxy::RescaleTransferFunction(cmap, range);
+    vtkSMTransferFunctionProxy::RescaleTransferFunction(omap, range);
     return true;
   }
   return false;
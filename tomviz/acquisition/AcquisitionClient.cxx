@@ -6,11 +6,13 @@
 #include "JsonRpcClient.h"
 
 #include <QNetworkAccessManager>
+#include <QNetworkReply>
 
 namespace tomviz {
 
 AcquisitionClient::AcquisitionClient(const QString& url, QObject* parent)
-  : QObject(parent), m_jsonRpcClient(new JsonRpcClient(url, this))
+  : QObject(parent), m_jsonRpcClient(new JsonRpcClient(url, this)),
+    m_networkAccessManager(new QNetworkAccessManager(this))
 {}
 
 AcquisitionClient::~AcquisitionClient() = default;
@@ -150,10 +152,11 @@ void AcquisitionClient::connectResultSignal(
         return;
       }
 
-      QNetworkAccessManager* manager = new QNetworkAccessManager(this);
+      auto networkReply =
+        m_networkAccessManager->get(QNetworkRequest(QUrl(url)));
       QObject::connect(
-        manager, &QNetworkAccessManager::finished,
-        [request, meta](QNetworkReply* networkReply) {
+        networkReply, &QNetworkReply::finished,
+        [request, meta, networkReply]() {
           if (networkReply->error() != QNetworkReply::NoError) {
             QJsonValue data(networkReply->error());
             emit request->error(networkReply->errorString(), data);
@@ -164,9 +167,8 @@ void AcquisitionClient::connectResultSignal(
             QByteArray imageData = networkReply->readAll();
             emit request->finished(mimeType, imageData, meta);
           }
+          networkReply->deleteLater();
         });
-
-      manager->get(QNetworkRequest(QUrl(url)));
     });
 }
 
@@ -9,6 +9,8 @@
 #include <QJsonObject>
 #include <QJsonValue>
 
+class QNetworkAccessManager;
+
 namespace tomviz {
 
 class JsonRpcClient;
@@ -96,6 +98,9 @@ private slots:
 
 private:
   JsonRpcClient* m_jsonRpcClient;
+  // Shared by the image downloads so that connections to the server are
+  // reused.
+  QNetworkAccessManager* m_networkAccessManager;
 };
 } // namespace tomviz
 
@@ -0,0 +1,449 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "AcquisitionStream.h"
+
+#include <vtkImageData.h>
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QMutexLocker>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QtConcurrent>
+#include <QtEndian>
+
+extern "C" {
+#include "vtk_tiff.h"
+}
+
+#include <algorithm>
+#include <cstring>
+
+Q_DECLARE_METATYPE(vtkSmartPointer<vtkImageData>)
+
+namespace {
+
+// Bytes of the stream buffered while the decoder is busy, grown if a single
+// frame is larger.
+const qint64 StreamBufferSize = 64 * 1024 * 1024;
+
+// Each frame is the size of the header, a 32-bit big endian integer, a JSON
+// header and the image data.
+const qint64 FramePrefixSize = 4;
+
+// libtiff client procedures reading from memory.
+struct MemoryFile
+{
+  const char* data;
+  toff_t size;
+  toff_t offset;
+};
+
+tmsize_t readProc(thandle_t handle, void* buffer, tmsize_t size)
+{
+  auto file = static_cast<MemoryFile*>(handle);
+  toff_t offset = std::min(file->offset, file->size);
+  toff_t count = std::min(static_cast<toff_t>(size), file->size - offset);
+  memcpy(buffer, file->data + offset, count);
+  file->offset = offset + count;
+  return static_cast<tmsize_t>(count);
+}
+
+tmsize_t writeProc(thandle_t, void*, tmsize_t)
+{
+  return 0;
+}
+
+toff_t seekProc(thandle_t handle, toff_t offset, int whence)
+{
+  auto file = static_cast<MemoryFile*>(handle);
+  auto delta = static_cast<int64_t>(offset);
+  switch (whence) {
+    case SEEK_SET:
+      file->offset = offset;
+      break;
+    case SEEK_CUR:
+      file->offset = static_cast<toff_t>(file->offset + delta);
+      break;
+    case SEEK_END:
+      file->offset = static_cast<toff_t>(file->size + delta);
+      break;
+  }
+  return file->offset;
+}
+
+int closeProc(thandle_t)
+{
+  return 0;
+}
+
+toff_t sizeProc(thandle_t handle)
+{
+  return static_cast<MemoryFile*>(handle)->size;
+}
+
+int mapProc(thandle_t handle, void** base, toff_t* size)
+{
+  auto file = static_cast<MemoryFile*>(handle);
+  *base = const_cast<char*>(file->data);
+  *size = file->size;
+  return 1;
+}
+
+void unmapProc(thandle_t, void*, toff_t) {}
+
+int vtkScalarType(uint16_t bitsPerSample, uint16_t sampleFormat)
+{
+  switch (sampleFormat) {
+    case SAMPLEFORMAT_UINT:
+      switch (bitsPerSample) {
+        case 8:
+          return VTK_UNSIGNED_CHAR;
+        case 16:
+          return VTK_UNSIGNED_SHORT;
+        case 32:
+          return VTK_UNSIGNED_INT;
+      }
+      break;
+    case SAMPLEFORMAT_INT:
+      switch (bitsPerSample) {
+        case 8:
+          return VTK_SIGNED_CHAR;
+        case 16:
+          return VTK_SHORT;
+        case 32:
+          return VTK_INT;
+      }
+      break;
+    case SAMPLEFORMAT_IEEEFP:
+      switch (bitsPerSample) {
+        case 32:
+          return VTK_FLOAT;
+        case 64:
+          return VTK_DOUBLE;
+      }
+      break;
+  }
+  return VTK_VOID;
+}
+} // namespace
+
+namespace tomviz {
+
+AcquisitionStream::AcquisitionStream(QObject* parent)
+  : QObject(parent), m_networkAccessManager(new QNetworkAccessManager(this))
+{
+  qRegisterMetaType<vtkSmartPointer<vtkImageData>>();
+}
+
+AcquisitionStream::~AcquisitionStream()
+{
+  close();
+  {
+    QMutexLocker lock(&m_mutex);
+    m_pending.clear();
+  }
+  m_decoder.waitForFinished();
+  m_ready.clear();
+}
+
+void AcquisitionStream::open(const QUrl& url)
+{
+  close();
+
+  m_reply = m_networkAccessManager->get(QNetworkRequest(url));
+  m_reply->setReadBufferSize(StreamBufferSize);
+  connect(m_reply.data(), &QNetworkReply::readyRead, this,
+          &AcquisitionStream::readFrames);
+  connect(m_reply.data(), &QNetworkReply::finished, this,
+          &AcquisitionStream::streamFinished);
+}
+
+void AcquisitionStream::close()
+{
+  if (!m_reply) {
+    return;
+  }
+
+  // Aborting emits finished(), which is not an error here.
+  auto reply = m_reply.data();
+  m_reply = nullptr;
+  reply->disconnect(this);
+  reply->abort();
+  reply->deleteLater();
+}
+
+bool AcquisitionStream::isOpen() const
+{
+  return m_reply != nullptr;
+}
+
+void AcquisitionStream::enqueue(const QString& mimeType,
+                                const QByteArray& data,
+                                const QJsonObject& meta)
+{
+  QMutexLocker lock(&m_mutex);
+  if (m_pending.size() >= m_maxPendingImages) {
+    qWarning() << "Dropping an acquired image, the decoder is behind.";
+    m_pending.dequeue();
+  }
+  m_pending.enqueue({ mimeType, data, meta });
+  if (!m_decoding) {
+    m_decoding = true;
+    m_decoder = QtConcurrent::run([this]() { decodeFrames(); });
+  }
+}
+
+void AcquisitionStream::setSaveDirectory(const QString& path)
+{
+  QMutexLocker lock(&m_mutex);
+  m_saveDirectory = path;
+}
+
+QString AcquisitionStream::saveDirectory() const
+{
+  QMutexLocker lock(&m_mutex);
+  return m_saveDirectory;
+}
+
+void AcquisitionStream::setMaxPendingImages(int count)
+{
+  {
+    QMutexLocker lock(&m_mutex);
+    m_maxPendingImages = std::max(count, 1);
+  }
+  readFrames();
+}
+
+int AcquisitionStream::maxPendingImages() const
+{
+  QMutexLocker lock(&m_mutex);
+  return m_maxPendingImages;
+}
+
+void AcquisitionStream::readFrames()
+{
+  if (!m_reply) {
+    return;
+  }
+
+  // Leave error responses to streamFinished().
+  auto status = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
+  if (status.isValid() && status.toInt() != 200) {
+    return;
+  }
+
+  forever
+  {
+    {
+      QMutexLocker lock(&m_mutex);
+      if (m_pending.size() >= m_maxPendingImages) {
+        // The decoder resumes reading when it takes a frame.
+        return;
+      }
+    }
+
+    qint64 available = m_reply->bytesAvailable();
+    if (available < FramePrefixSize) {
+      return;
+    }
+
+    auto prefix = m_reply->peek(FramePrefixSize);
+    qint64 headerSize = qFromBigEndian<quint32>(
+      reinterpret_cast<const uchar*>(prefix.constData()));
+    if (available < FramePrefixSize + headerSize) {
+      return;
+    }
+
+    auto headerData = m_reply->peek(FramePrefixSize + headerSize)
+                        .mid(FramePrefixSize);
+    QJsonParseError parseError;
+    auto doc = QJsonDocument::fromJson(headerData, &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+      close();
+      emit error("Invalid frame in the image stream.",
+                 parseError.errorString());
+      return;
+    }
+
+    auto header = doc.object();
+    auto size = static_cast<qint64>(header["size"].toDouble());
+    qint64 frameSize = FramePrefixSize + headerSize + size;
+    if (available < frameSize) {
+      // Make sure the whole frame fits in the buffer.
+      if (m_reply->readBufferSize() < frameSize) {
+        m_reply->setReadBufferSize(frameSize);
+      }
+      return;
+    }
+
+    m_reply->read(FramePrefixSize + headerSize);
+    auto data = m_reply->read(size);
+
+    // Empty frames are heartbeats.
+    if (size > 0) {
+      enqueue(header["mimeType"].toString(), data,
+              header["meta"].toObject());
+    }
+  }
+}
+
+void AcquisitionStream::streamFinished()
+{
+  if (!m_reply) {
+    return;
+  }
+
+  auto reply = m_reply.data();
+  m_reply = nullptr;
+  reply->deleteLater();
+
+  if (reply->error() != QNetworkReply::NoError) {
+    auto status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
+    QJsonValue data =
+      status.isValid() ? status.toInt() : static_cast<int>(reply->error());
+    emit error(reply->errorString(), data);
+  } else {
+    emit error("The image stream was closed by the server.", QJsonValue());
+  }
+}
+
+void AcquisitionStream::decodeFrames()
+{
+  forever
+  {
+    Frame frame;
+    QString saveDirectory;
+    {
+      QMutexLocker lock(&m_mutex);
+      if (m_pending.isEmpty()) {
+        m_decoding = false;
+        return;
+      }
+      frame = m_pending.dequeue();
+      saveDirectory = m_saveDirectory;
+    }
+
+    // There is room in the queue again.
+    QMetaObject::invokeMethod(this, "readFrames", Qt::QueuedConnection);
+
+    if (!saveDirectory.isEmpty()) {
+      saveFrame(frame, saveDirectory);
+    }
+
+    if (frame.mimeType != "image/tiff") {
+      qWarning() << "image/tiff is the only supported mime type right now:"
+                 << frame.mimeType;
+      continue;
+    }
+
+    auto image = decodeTiff(frame.data);
+    if (!image) {
+      qWarning() << "Unable to decode the acquired image.";
+      continue;
+    }
+
+    QMutexLocker lock(&m_mutex);
+    if (m_ready.size() >= m_maxPendingImages) {
+      qWarning() << "Dropping a decoded image, the display is behind.";
+      m_ready.dequeue();
+    }
+    m_ready.enqueue(qMakePair(image, frame.meta));
+    if (m_ready.size() == 1) {
+      QMetaObject::invokeMethod(this, "deliverImages", Qt::QueuedConnection);
+    }
+  }
+}
+
+void AcquisitionStream::deliverImages()
+{
+  forever
+  {
+    QPair<vtkSmartPointer<vtkImageData>, QJsonObject> ready;
+    {
+      QMutexLocker lock(&m_mutex);
+      if (m_ready.isEmpty()) {
+        return;
+      }
+      ready = m_ready.dequeue();
+    }
+    emit imageReady(ready.first, ready.second);
+  }
+}
+
+void AcquisitionStream::saveFrame(const Frame& frame, const QString& path)
+{
+  QDir dir(path);
+  if (!dir.exists()) {
+    dir.mkpath(dir.path());
+  }
+
+  QString fileName = frame.meta["fileName"].toString();
+  if (fileName.isEmpty()) {
+    auto angle = frame.meta["angle"].toString().toFloat();
+    fileName = "tomviz_";
+    if (angle > 0.0) {
+      fileName.append('+');
+    }
+    fileName.append(QString::number(angle, 'g', 2));
+    fileName.append(".tiff");
+  }
+
+  QFile file(dir.filePath(fileName));
+  if (!file.open(QIODevice::WriteOnly)) {
+    qWarning() << "Unable to write:" << file.fileName();
+    return;
+  }
+  file.write(frame.data);
+}
+
+vtkSmartPointer<vtkImageData> AcquisitionStream::decodeTiff(
+  const QByteArray& data)
+{
+  MemoryFile file = { data.constData(), static_cast<toff_t>(data.size()), 0 };
+  TIFF* tiff =
+    TIFFClientOpen("acquisition", "r", &file, readProc, writeProc, seekProc,
+                   closeProc, sizeProc, mapProc, unmapProc);
+  if (!tiff) {
+    return nullptr;
+  }
+
+  uint32_t width = 0, height = 0;
+  uint16_t bitsPerSample = 8, samplesPerPixel = 1;
+  uint16_t sampleFormat = SAMPLEFORMAT_UINT, planarConfig = PLANARCONFIG_CONTIG;
+  TIFFGetField(tiff, TIFFTAG_IMAGEWIDTH, &width);
+  TIFFGetField(tiff, TIFFTAG_IMAGELENGTH, &height);
+  TIFFGetFieldDefaulted(tiff, TIFFTAG_BITSPERSAMPLE, &bitsPerSample);
+  TIFFGetFieldDefaulted(tiff, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel);
+  TIFFGetFieldDefaulted(tiff, TIFFTAG_SAMPLEFORMAT, &sampleFormat);
+  TIFFGetFieldDefaulted(tiff, TIFFTAG_PLANARCONFIG, &planarConfig);
+
+  int type = vtkScalarType(bitsPerSample, sampleFormat);
+  if (width == 0 || height == 0 || type == VTK_VOID || TIFFIsTiled(tiff) ||
+      (samplesPerPixel > 1 && planarConfig != PLANARCONFIG_CONTIG)) {
+    TIFFClose(tiff);
+    return nullptr;
+  }
+
+  auto image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(width, height, 1);
+  image->AllocateScalars(type, samplesPerPixel);
+
+  // TIFF rows run top to bottom, VTK rows bottom to top.
+  auto scalars = static_cast<char*>(image->GetScalarPointer());
+  const size_t rowSize =
+    static_cast<size_t>(width) * samplesPerPixel * (bitsPerSample / 8);
+  bool success = TIFFScanlineSize(tiff) == static_cast<tmsize_t>(rowSize);
+  for (uint32_t row = 0; success && row < height; ++row) {
+    auto dest = scalars + (height - 1 - row) * rowSize;
+    success = TIFFReadScanline(tiff, dest, row, 0) >= 0;
+  }
+  TIFFClose(tiff);
+
+  return success ? image : nullptr;
+}
+
+} // namespace tomviz
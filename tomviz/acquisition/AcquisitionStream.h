@@ -0,0 +1,106 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizAcquisitionStream_h
+#define tomvizAcquisitionStream_h
+
+#include <QObject>
+
+#include <QFuture>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QMutex>
+#include <QPair>
+#include <QPointer>
+#include <QQueue>
+#include <QUrl>
+
+#include <vtkSmartPointer.h>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+class vtkImageData;
+
+namespace tomviz {
+
+/// Receives the images pushed by an acquisition server on its image stream,
+/// a single HTTP response that stays open while images are acquired, and
+/// decodes them in memory on a worker thread.
+///
+/// Images wait for the decoder in a bounded queue. While the queue is full
+/// the stream is not read, so a slow client throttles the server through TCP
+/// flow control instead of buffering without limit. Images queued with
+/// enqueue() while it is full replace the oldest one.
+///
+/// Decoded images wait for the thread of the stream in a bounded queue too,
+/// the oldest one is dropped when the consumer of imageReady() falls behind.
+class AcquisitionStream : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit AcquisitionStream(QObject* parent = nullptr);
+  ~AcquisitionStream() override;
+
+  /// Open the image stream at \p url, closing any open stream.
+  void open(const QUrl& url);
+  void close();
+  bool isOpen() const;
+
+  /// Queue an image received by other means, e.g. from stem_acquire, for
+  /// decoding.
+  void enqueue(const QString& mimeType, const QByteArray& data,
+               const QJsonObject& meta);
+
+  /// Directory where a copy of each image is written, from the worker thread.
+  /// Nothing is written if it is empty, the default.
+  void setSaveDirectory(const QString& path);
+  QString saveDirectory() const;
+
+  /// Maximum number of images waiting to be decoded, and of decoded images
+  /// waiting to be delivered.
+  void setMaxPendingImages(int count);
+  int maxPendingImages() const;
+
+  /// Decode a single image TIFF held in memory, rows are flipped so that the
+  /// image matches the output of vtkTIFFReader. Returns a null pointer if the
+  /// TIFF is not supported.
+  static vtkSmartPointer<vtkImageData> decodeTiff(const QByteArray& data);
+
+signals:
+  /// Emitted, from the thread of the stream, for each decoded image.
+  void imageReady(vtkSmartPointer<vtkImageData> image,
+                  const QJsonObject& meta);
+
+  void error(const QString& errorMessage, const QJsonValue& errorData);
+
+private slots:
+  void readFrames();
+  void streamFinished();
+  void deliverImages();
+
+private:
+  struct Frame
+  {
+    QString mimeType;
+    QByteArray data;
+    QJsonObject meta;
+  };
+
+  void decodeFrames();
+  static void saveFrame(const Frame& frame, const QString& path);
+
+  QNetworkAccessManager* m_networkAccessManager;
+  QPointer<QNetworkReply> m_reply;
+
+  mutable QMutex m_mutex;
+  QQueue<Frame> m_pending;
+  QQueue<QPair<vtkSmartPointer<vtkImageData>, QJsonObject>> m_ready;
+  int m_maxPendingImages = 16;
+  bool m_decoding = false;
+  QString m_saveDirectory;
+  QFuture<void> m_decoder;
+};
+} // namespace tomviz
+
+#endif
@@ -6,6 +6,7 @@
 #include "ui_PassiveAcquisitionWidget.h"
 
 #include "AcquisitionClient.h"
+#include "AcquisitionStream.h"
 #include "ActiveObjects.h"
 #include "ConnectionDialog.h"
 #include "InterfaceBuilder.h"
@@ -29,14 +30,12 @@
 #include <vtkRenderWindow.h>
 #include <vtkRenderer.h>
 #include <vtkScalarsToColors.h>
-#include <vtkTIFFReader.h>
 
 #include <QBuffer>
 #include <QCloseEvent>
 #include <QCoreApplication>
 #include <QDebug>
 #include <QDir>
-#include <QFile>
 #include <QJsonValueRef>
 #include <QMessageBox>
 #include <QNetworkReply>
@@ -57,6 +56,7 @@ const char* PASSIVE_ADAPTER =
 PassiveAcquisitionWidget::PassiveAcquisitionWidget(QWidget* parent)
   : QDialog(parent), m_ui(new Ui::PassiveAcquisitionWidget),
     m_client(new AcquisitionClient("http://localhost:8080/acquisition", this)),
+    m_stream(new AcquisitionStream(this)),
     m_connectParamsWidget(new QWidget), m_watchTimer(new QTimer)
 {
   m_ui->setupUi(this);
@@ -98,6 +98,31 @@ PassiveAcquisitionWidget::PassiveAcquisitionWidget(QWidget* parent)
   connect(m_ui->stopWatchingButton, &QPushButton::clicked, this,
           &PassiveAcquisitionWidget::stopWatching);
 
+  connect(m_stream, &AcquisitionStream::imageReady, this,
+          &PassiveAcquisitionWidget::imageReady);
+  // Servers without an image stream are polled.
+  connect(m_watchTimer, &QTimer::timeout, this, [this]() {
+    auto request = m_client->stem_acquire();
+    connect(request, &AcquisitionClientImageRequest::finished,
+            [this](const QString mimeType, const QByteArray& result,
+                   const QJsonObject& meta) {
+              if (!result.isNull()) {
+                m_stream->enqueue(mimeType, result, meta);
+              }
+            });
+    connect(request, &AcquisitionClientRequest::error, this,
+            &PassiveAcquisitionWidget::onError);
+  });
+  connect(m_stream, &AcquisitionStream::error,
+          [this](const QString& errorMessage, const QJsonValue& errorData) {
+            // Servers without an image stream are polled instead.
+            if (errorData.toInt() == 404) {
+              pollSource();
+            } else {
+              onError(errorMessage, errorData);
+            }
+          });
+
   checkEnableWatchButton();
 
   // Connect signal to clean up any servers we start.
@@ -137,6 +162,8 @@ void PassiveAcquisitionWidget::readSettings()
   if (!watchPath.isEmpty()) {
     m_ui->watchPathLineEdit->setText(watchPath);
   }
+  m_ui->saveImagesCheckBox->setChecked(
+    settings->value("saveImages", false).toBool());
 
   settings->endGroup();
 }
@@ -147,6 +174,7 @@ void PassiveAcquisitionWidget::writeSettings()
   settings->beginGroup("acquisition");
   settings->setValue("passive.geometry", geometry());
   settings->setValue("watchPath", m_ui->watchPathLineEdit->text());
+  settings->setValue("saveImages", m_ui->saveImagesCheckBox->isChecked());
   settings->endGroup();
 }
 
@@ -203,38 +231,12 @@ void PassiveAcquisitionWidget::connectToServer(bool startServer)
           });
 }
 
-void PassiveAcquisitionWidget::imageReady(QString mimeType, QByteArray result,
-                                          float angle, bool hasAngle)
+void PassiveAcquisitionWidget::imageReady(vtkSmartPointer<vtkImageData> image,
+                                          const QJsonObject& meta)
 {
-  if (mimeType != "image/tiff") {
-    qDebug() << "image/tiff is the only supported mime type right now.\n"
-             << mimeType << "\n";
-    return;
-  }
-
-  QDir dir(QDir::homePath() + "/tomviz-data");
-  if (!dir.exists()) {
-    dir.mkpath(dir.path());
-  }
-
-  QString path = "/tomviz_";
-
-  if (angle > 0.0) {
-    path.append('+');
-  }
-  path.append(QString::number(angle, 'g', 2));
-  path.append(".tiff");
-
-  QFile file(dir.path() + path);
-  file.open(QIODevice::WriteOnly);
-  file.write(result);
-  qDebug() << "Data file:" << file.fileName();
-  file.close();
-
-  vtkNew<vtkTIFFReader> reader;
-  reader->SetFileName(file.fileName().toLatin1());
-  reader->Update();
-  m_imageData = reader->GetOutput();
+  m_imageData = image;
+  bool hasAngle = meta.contains("angle");
+  float angle = meta["angle"].toString().toFloat();
 
   // If we haven't added it, add our live data source to the pipeline.
   if (!m_dataSource) {
@@ -288,26 +290,18 @@ void PassiveAcquisitionWidget::watchSource()
 {
   m_ui->watchButton->setEnabled(false);
   m_ui->stopWatchingButton->setEnabled(true);
-  connect(m_watchTimer, &QTimer::timeout, this,
-          [this]() {
-            auto request = m_client->stem_acquire();
-            connect(request, &AcquisitionClientImageRequest::finished,
-                    [this](const QString mimeType, const QByteArray& result,
-                           const QJsonObject& meta) {
-                      if (!result.isNull()) {
-                        float angle = 0;
-                        bool hasAngle = false;
-                        if (meta.contains("angle")) {
-                          angle = meta["angle"].toString().toFloat();
-                          hasAngle = true;
-                        }
-                        imageReady(mimeType, result, angle, hasAngle);
-                      }
-                    });
-            connect(request, &AcquisitionClientRequest::error, this,
-                    &PassiveAcquisitionWidget::onError);
-          },
-          Qt::UniqueConnection);
+
+  // Copies of the images are written by the decoding thread.
+  m_stream->setSaveDirectory(m_ui->saveImagesCheckBox->isChecked()
+                               ? QDir::homePath() + "/tomviz-data"
+                               : QString());
+
+  // The server pushes the images on its image stream as they are acquired.
+  m_stream->open(QUrl(url()).resolved(QUrl("/stream")));
+}
+
+void PassiveAcquisitionWidget::pollSource()
+{
   m_watchTimer->start(1000);
 }
 
@@ -434,6 +428,7 @@ void PassiveAcquisitionWidget::checkEnableWatchButton()
 
 void PassiveAcquisitionWidget::stopWatching()
 {
+  m_stream->close();
   m_watchTimer->stop();
   m_ui->stopWatchingButton->setEnabled(false);
   m_ui->watchButton->setEnabled(true);
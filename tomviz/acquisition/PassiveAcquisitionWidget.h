@@ -8,6 +8,7 @@
 
 #include "MatchInfo.h"
 
+#include <QJsonObject>
 #include <QLabel>
 #include <QPointer>
 #include <QScopedPointer>
@@ -32,6 +33,7 @@ class PassiveAcquisitionWidget;
 namespace tomviz {
 
 class AcquisitionClient;
+class AcquisitionStream;
 class DataSource;
 
 class PassiveAcquisitionWidget : public QDialog
@@ -51,8 +53,8 @@ protected:
 private slots:
   void connectToServer(bool startServer = true);
 
-  void imageReady(QString mimeType, QByteArray result, float angle = 0,
-                  bool hasAngle = false);
+  void imageReady(vtkSmartPointer<vtkImageData> image,
+                  const QJsonObject& meta);
 
   void onError(const QString& errorMessage, const QJsonValue& errorData);
   void watchSource();
@@ -69,6 +71,7 @@ signals:
 private:
   QScopedPointer<Ui::PassiveAcquisitionWidget> m_ui;
   QScopedPointer<AcquisitionClient> m_client;
+  AcquisitionStream* m_stream;
 
   QString m_testFileName;
 
@@ -96,6 +99,7 @@ private:
   void checkEnableWatchButton();
   void startLocalServer();
   void displayError(const QString& errorMessage);
+  void pollSource();
   void stopWatching();
   void validateTestFileName();
 
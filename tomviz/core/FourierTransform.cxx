@@ -0,0 +1,501 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "FourierTransform.h"
+
+#include <vtkDataArray.h>
+#include <vtkMath.h>
+#include <vtkSMPTools.h>
+
+#include <vtk_kissfft.h>
+// clang-format off
+#include VTK_KISSFFT_HEADER(kiss_fft.h)
+#include VTK_KISSFFT_HEADER(tools/kiss_fftr.h)
+// clang-format on
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Complex = tomviz::FourierTransform::Complex;
+
+// Lines transformed together along the second and third axes, so that the
+// gathers and scatters read and write consecutive values.
+const int LineGroupSize = 8;
+
+// Real plans are only used for even lengths, kissfft splits them in two.
+bool useRealPlan(int n)
+{
+  return n % 2 == 0 && n >= 4;
+}
+
+class PlanCache
+{
+public:
+  static PlanCache& instance()
+  {
+    static PlanCache cache;
+    return cache;
+  }
+
+  ~PlanCache() { clear(); }
+
+  // Complex plans are only read by out of place transforms, threads share
+  // them.
+  kiss_fft_cfg complexPlan(int n, bool inverse)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& plan = m_complexPlans[std::make_pair(n, inverse)];
+    if (!plan) {
+      plan = kiss_fft_alloc(n, inverse, nullptr, nullptr);
+    }
+    return plan;
+  }
+
+  // Real plans hold their own scratch space, each thread takes one and gives
+  // it back once done.
+  kiss_fftr_cfg takeRealPlan(int n, bool inverse)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto& plans = m_realPlans[std::make_pair(n, inverse)];
+      if (!plans.empty()) {
+        auto plan = plans.back();
+        plans.pop_back();
+        return plan;
+      }
+    }
+    return kiss_fftr_alloc(n, inverse, nullptr, nullptr);
+  }
+
+  void giveRealPlan(int n, bool inverse, kiss_fftr_cfg plan)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_realPlans[std::make_pair(n, inverse)].push_back(plan);
+  }
+
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& plan : m_complexPlans) {
+      kiss_fft_free(plan.second);
+    }
+    for (auto& plans : m_realPlans) {
+      for (auto plan : plans.second) {
+        kiss_fftr_free(plan);
+      }
+    }
+    m_complexPlans.clear();
+    m_realPlans.clear();
+  }
+
+private:
+  std::mutex m_mutex;
+  std::map<std::pair<int, bool>, kiss_fft_cfg> m_complexPlans;
+  std::map<std::pair<int, bool>, std::vector<kiss_fftr_cfg>> m_realPlans;
+};
+
+// Transforms the rows, along the first axis, of a real volume or of a
+// spectrum. Rows of odd length go through a complex plan.
+class RowTransform
+{
+public:
+  RowTransform(int n, bool inverse)
+    : m_n(n), m_half(n / 2 + 1), m_inverse(inverse), m_real(n), m_in(n),
+      m_out(n)
+  {
+    if (useRealPlan(n)) {
+      m_realPlan = PlanCache::instance().takeRealPlan(n, inverse);
+    } else if (n > 1) {
+      m_complexPlan = PlanCache::instance().complexPlan(n, inverse);
+    }
+  }
+
+  ~RowTransform()
+  {
+    if (m_realPlan) {
+      PlanCache::instance().giveRealPlan(m_n, m_inverse, m_realPlan);
+    }
+  }
+
+  template <typename T>
+  void forward(const T* row, Complex* spectrum)
+  {
+    if (m_realPlan) {
+      for (int i = 0; i < m_n; ++i) {
+        m_real[i] = static_cast<kiss_fft_scalar>(row[i]);
+      }
+      kiss_fftr(m_realPlan, m_real.data(), m_out.data());
+    } else {
+      for (int i = 0; i < m_n; ++i) {
+        m_in[i].r = static_cast<kiss_fft_scalar>(row[i]);
+        m_in[i].i = 0;
+      }
+      transform();
+    }
+    for (int i = 0; i < m_half; ++i) {
+      spectrum[i] = Complex(static_cast<float>(m_out[i].r),
+                            static_cast<float>(m_out[i].i));
+    }
+  }
+
+  void inverse(const Complex* spectrum, float* row, double scale)
+  {
+    for (int i = 0; i < m_half; ++i) {
+      m_in[i].r = spectrum[i].real();
+      m_in[i].i = spectrum[i].imag();
+    }
+    if (m_realPlan) {
+      kiss_fftri(m_realPlan, m_in.data(), m_real.data());
+      for (int i = 0; i < m_n; ++i) {
+        row[i] = static_cast<float>(m_real[i] * scale);
+      }
+      return;
+    }
+
+    // Restore the redundant half, the spectrum of a real line is Hermitian.
+    for (int i = m_half; i < m_n; ++i) {
+      m_in[i].r = m_in[m_n - i].r;
+      m_in[i].i = -m_in[m_n - i].i;
+    }
+    transform();
+    for (int i = 0; i < m_n; ++i) {
+      row[i] = static_cast<float>(m_out[i].r * scale);
+    }
+  }
+
+private:
+  void transform()
+  {
+    if (m_complexPlan) {
+      kiss_fft(m_complexPlan, m_in.data(), m_out.data());
+    } else {
+      m_out[0] = m_in[0];
+    }
+  }
+
+  int m_n;
+  int m_half;
+  bool m_inverse;
+  kiss_fftr_cfg m_realPlan = nullptr;
+  kiss_fft_cfg m_complexPlan = nullptr;
+  std::vector<kiss_fft_scalar> m_real;
+  std::vector<kiss_fft_cpx> m_in;
+  std::vector<kiss_fft_cpx> m_out;
+};
+
+template <typename T>
+void forwardRows(const T* values, const int dims[3], Complex* spectrum)
+{
+  const int half = dims[0] / 2 + 1;
+  const vtkIdType numRows = static_cast<vtkIdType>(dims[1]) * dims[2];
+  vtkSMPTools::For(0, numRows, [&](vtkIdType begin, vtkIdType end) {
+    RowTransform transform(dims[0], false);
+    for (vtkIdType r = begin; r < end; ++r) {
+      transform.forward(values + r * dims[0], spectrum + r * half);
+    }
+  });
+}
+
+void inverseRows(const Complex* spectrum, const int dims[3], float* values)
+{
+  const int half = dims[0] / 2 + 1;
+  const vtkIdType numRows = static_cast<vtkIdType>(dims[1]) * dims[2];
+  const double scale =
+    1.0 / (static_cast<double>(dims[0]) * dims[1] * dims[2]);
+  vtkSMPTools::For(0, numRows, [&](vtkIdType begin, vtkIdType end) {
+    RowTransform transform(dims[0], true);
+    for (vtkIdType r = begin; r < end; ++r) {
+      transform.inverse(spectrum + r * half, values + r * dims[0], scale);
+    }
+  });
+}
+
+// Transform, in place, the lines of the spectrum along its second (axis 1)
+// or third (axis 2) axis.
+void transformAxis(Complex* spectrum, const int spectrumDims[3], int axis,
+                   bool inverse)
+{
+  const int n = spectrumDims[axis];
+  if (n == 1) {
+    return;
+  }
+
+  // Lines are grouped by LineGroupSize consecutive values along the first
+  // axis, for every index along the remaining axis.
+  const int other = axis == 1 ? 2 : 1;
+  const vtkIdType sliceSize =
+    static_cast<vtkIdType>(spectrumDims[0]) * spectrumDims[1];
+  const vtkIdType stride = axis == 1 ? spectrumDims[0] : sliceSize;
+  const vtkIdType otherStride = axis == 1 ? sliceSize : spectrumDims[0];
+  const int groupsPerRow =
+    (spectrumDims[0] + LineGroupSize - 1) / LineGroupSize;
+  const vtkIdType numGroups =
+    static_cast<vtkIdType>(groupsPerRow) * spectrumDims[other];
+
+  auto plan = PlanCache::instance().complexPlan(n, inverse);
+  vtkSMPTools::For(0, numGroups, [&](vtkIdType begin, vtkIdType end) {
+    std::vector<kiss_fft_cpx> in(static_cast<size_t>(n) * LineGroupSize);
+    std::vector<kiss_fft_cpx> out(n);
+    for (vtkIdType g = begin; g < end; ++g) {
+      const int i0 = static_cast<int>(g % groupsPerRow) * LineGroupSize;
+      const int count = std::min(LineGroupSize, spectrumDims[0] - i0);
+      Complex* first = spectrum + (g / groupsPerRow) * otherStride + i0;
+
+      for (int p = 0; p < n; ++p) {
+        const Complex* value = first + p * stride;
+        for (int l = 0; l < count; ++l) {
+          in[l * n + p].r = value[l].real();
+          in[l * n + p].i = value[l].imag();
+        }
+      }
+      for (int l = 0; l < count; ++l) {
+        kiss_fft(plan, &in[l * n], out.data());
+        std::copy(out.begin(), out.end(), in.begin() + l * n);
+      }
+      for (int p = 0; p < n; ++p) {
+        Complex* value = first + p * stride;
+        for (int l = 0; l < count; ++l) {
+          value[l] = Complex(static_cast<float>(in[l * n + p].r),
+                             static_cast<float>(in[l * n + p].i));
+        }
+      }
+    }
+  });
+}
+
+// Transform the spectrum along its second and third axes, \p axesDone
+// being the number of axes transformed before.
+bool transformColumns(Complex* spectrum, const int dims[3], bool inverse,
+                      int axesDone,
+                      const tomviz::FourierTransform::AxisCallback& axisDone)
+{
+  int spectrumDims[3];
+  tomviz::FourierTransform::spectrumDimensions(dims, spectrumDims);
+  for (int axis = 1; axis < 3; ++axis) {
+    transformAxis(spectrum, spectrumDims, axis, inverse);
+    if (axisDone && !axisDone(++axesDone)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The Hann window of numpy.hanning.
+std::vector<double> hann(int n)
+{
+  std::vector<double> window(n, 1.0);
+  if (n > 1) {
+    for (int i = 0; i < n; ++i) {
+      window[i] = 0.5 - 0.5 * std::cos(2.0 * vtkMath::Pi() * i / (n - 1));
+    }
+  }
+  return window;
+}
+
+template <typename T>
+void applyHannWindow(T* values, const int dims[3])
+{
+  const auto wx = hann(dims[0]);
+  const auto wy = hann(dims[1]);
+  const auto wz = hann(dims[2]);
+  const vtkIdType numRows = static_cast<vtkIdType>(dims[1]) * dims[2];
+  vtkSMPTools::For(0, numRows, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType r = begin; r < end; ++r) {
+      const double y = wy[r % dims[1]];
+      const double z = wz[r / dims[1]];
+      T* row = values + r * dims[0];
+      for (int i = 0; i < dims[0]; ++i) {
+        // Rounded to float after every axis, as the Python operator did.
+        float value = static_cast<float>(row[i]);
+        value = static_cast<float>(value * wx[i]);
+        value = static_cast<float>(value * y);
+        value = static_cast<float>(value * z);
+        row[i] = static_cast<T>(value);
+      }
+    }
+  });
+}
+
+// The frequency, in cycles per sample, of index k of a transform of length n.
+double frequency(int k, int n)
+{
+  return (k <= n / 2 ? k : k - n) / static_cast<double>(n);
+}
+
+} // namespace
+
+namespace tomviz {
+
+void FourierTransform::spectrumDimensions(const int dims[3],
+                                          int spectrumDims[3])
+{
+  spectrumDims[0] = dims[0] / 2 + 1;
+  spectrumDims[1] = dims[1];
+  spectrumDims[2] = dims[2];
+}
+
+vtkIdType FourierTransform::spectrumSize(const int dims[3])
+{
+  return static_cast<vtkIdType>(dims[0] / 2 + 1) * dims[1] * dims[2];
+}
+
+bool FourierTransform::forward(vtkDataArray* array, const int dims[3],
+                               Complex* spectrum,
+                               const AxisCallback& axisDone)
+{
+  if (!array || array->GetNumberOfComponents() != 1) {
+    return false;
+  }
+
+  switch (array->GetDataType()) {
+    vtkTemplateMacro(forwardRows(
+      static_cast<const VTK_TT*>(array->GetVoidPointer(0)), dims, spectrum));
+    default:
+      return false;
+  }
+  if (axisDone && !axisDone(1)) {
+    return false;
+  }
+  return transformColumns(spectrum, dims, false, 1, axisDone);
+}
+
+void FourierTransform::forward(const float* values, const int dims[3],
+                               Complex* spectrum)
+{
+  forwardRows(values, dims, spectrum);
+  transformColumns(spectrum, dims, false, 1, AxisCallback());
+}
+
+void FourierTransform::forwardLines(const float* values, int length,
+                                    vtkIdType numLines, Complex* spectrum)
+{
+  const int half = length / 2 + 1;
+  vtkSMPTools::For(0, numLines, [&](vtkIdType begin, vtkIdType end) {
+    RowTransform transform(length, false);
+    for (vtkIdType r = begin; r < end; ++r) {
+      transform.forward(values + r * length, spectrum + r * half);
+    }
+  });
+}
+
+bool FourierTransform::inverse(Complex* spectrum, const int dims[3],
+                               float* values, const AxisCallback& axisDone)
+{
+  if (!transformColumns(spectrum, dims, true, 0, axisDone)) {
+    return false;
+  }
+  inverseRows(spectrum, dims, values);
+  if (axisDone) {
+    axisDone(3);
+  }
+  return true;
+}
+
+void FourierTransform::absLog(const Complex* spectrum, const int dims[3],
+                              float* values)
+{
+  // Keeps the log finite, as the Python operator did.
+  const double offset = std::numeric_limits<double>::epsilon();
+  const int half = dims[0] / 2 + 1;
+  const vtkIdType numRows = static_cast<vtkIdType>(dims[1]) * dims[2];
+
+  // The shifted value at (i, j, k) is that of the frequency
+  // ((i - n / 2) mod n, ...). The upper half along the first axis is the
+  // conjugate of the stored half, at the opposite frequency.
+  auto unshift = [](int i, int n) { return (i + n - n / 2) % n; };
+  std::vector<double> rowMax(numRows);
+  vtkSMPTools::For(0, numRows, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType r = begin; r < end; ++r) {
+      const int j = unshift(static_cast<int>(r % dims[1]), dims[1]);
+      const int k = unshift(static_cast<int>(r / dims[1]), dims[2]);
+      const int mj = (dims[1] - j) % dims[1];
+      const int mk = (dims[2] - k) % dims[2];
+      const Complex* row = spectrum + (static_cast<vtkIdType>(k) * dims[1] +
+                                       j) * half;
+      const Complex* mirror =
+        spectrum + (static_cast<vtkIdType>(mk) * dims[1] + mj) * half;
+
+      double max = -std::numeric_limits<double>::infinity();
+      float* out = values + r * dims[0];
+      for (int i = 0; i < dims[0]; ++i) {
+        const int f = unshift(i, dims[0]);
+        const Complex& value = f < half ? row[f] : mirror[dims[0] - f];
+        const double magnitude =
+          std::abs(std::complex<double>(value.real(), value.imag()));
+        const double result = std::log(magnitude + offset);
+        out[i] = static_cast<float>(result);
+        max = std::max(max, result);
+      }
+      rowMax[r] = max;
+    }
+  });
+
+  const double max = *std::max_element(rowMax.begin(), rowMax.end());
+  if (max == 0.0) {
+    return;
+  }
+  const vtkIdType numValues = numRows * dims[0];
+  vtkSMPTools::For(0, numValues, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i) {
+      values[i] = static_cast<float>(values[i] / max);
+    }
+  });
+}
+
+void FourierTransform::bandPass(Complex* spectrum, const int dims[3],
+                                double low, double high)
+{
+  // Radii are fractions of the Nyquist frequency, half a cycle per sample.
+  const int half = dims[0] / 2 + 1;
+  const vtkIdType numRows = static_cast<vtkIdType>(dims[1]) * dims[2];
+  vtkSMPTools::For(0, numRows, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType r = begin; r < end; ++r) {
+      const double fy = frequency(static_cast<int>(r % dims[1]), dims[1]);
+      const double fz = frequency(static_cast<int>(r / dims[1]), dims[2]);
+      Complex* row = spectrum + r * half;
+      for (int i = 0; i < half; ++i) {
+        const double fx = static_cast<double>(i) / dims[0];
+        const double radius = 2.0 * std::sqrt(fx * fx + fy * fy + fz * fz);
+        if (radius < low || radius > high) {
+          row[i] = Complex(0.0f, 0.0f);
+        }
+      }
+    }
+  });
+}
+
+bool FourierTransform::hannWindow(vtkDataArray* array, const int dims[3])
+{
+  if (!array || array->GetNumberOfComponents() != 1) {
+    return false;
+  }
+
+  switch (array->GetDataType()) {
+    vtkTemplateMacro(
+      applyHannWindow(static_cast<VTK_TT*>(array->GetVoidPointer(0)), dims));
+    default:
+      return false;
+  }
+  array->Modified();
+  return true;
+}
+
+void FourierTransform::hannWindow(float* values, const int dims[3])
+{
+  applyHannWindow(values, dims);
+}
+
+void FourierTransform::clearPlans()
+{
+  PlanCache::instance().clear();
+}
+
+} // namespace tomviz
@@ -0,0 +1,84 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizFourierTransform_h
+#define tomvizFourierTransform_h
+
+#include "tomvizcore_export.h"
+
+#include <vtkType.h>
+
+#include <complex>
+#include <functional>
+
+class vtkDataArray;
+
+namespace tomviz {
+
+/// Multi-threaded 3D Fourier transforms of real volumes, and the filters
+/// built on them. Volumes are in Fortran order, the first dimension being
+/// the contiguous one. Images and lines use dimensions of 1 for the missing
+/// axes.
+///
+/// Like FFTW's real to complex transforms only the non-redundant half of the
+/// spectrum is kept, of dimensions (dims[0] / 2 + 1, dims[1], dims[2]) and in
+/// single precision, so a spectrum takes about twice the memory of a float
+/// volume. Transforms along the second and third axes are done in place in
+/// the spectrum, one-dimensional plans are computed in double precision and
+/// cached for the lifetime of the application, so repeated shapes reuse them.
+class TOMVIZCORE_EXPORT FourierTransform
+{
+public:
+  using Complex = std::complex<float>;
+
+  /// Called after each of the three axes of a transform, with the number of
+  /// axes transformed so far. Returning false stops the transform.
+  using AxisCallback = std::function<bool(int axesDone)>;
+
+  /// The dimensions of the spectrum of a volume of dimensions \p dims.
+  static void spectrumDimensions(const int dims[3], int spectrumDims[3]);
+  static vtkIdType spectrumSize(const int dims[3]);
+
+  /// Forward transform of a volume into \p spectrum, which must hold
+  /// spectrumSize() values. The array must have a single component, false
+  /// is returned otherwise, or if \p axisDone stopped the transform.
+  static bool forward(vtkDataArray* array, const int dims[3],
+                      Complex* spectrum,
+                      const AxisCallback& axisDone = AxisCallback());
+  static void forward(const float* values, const int dims[3],
+                      Complex* spectrum);
+
+  /// Forward transforms of \p numLines consecutive lines of \p length
+  /// values, each into length / 2 + 1 consecutive values of \p spectrum.
+  static void forwardLines(const float* values, int length,
+                           vtkIdType numLines, Complex* spectrum);
+
+  /// Inverse transform of \p spectrum, normalized like numpy.fft.irfftn, into
+  /// the volume \p values of dimensions \p dims. The spectrum is overwritten.
+  /// Returns false if \p axisDone stopped the transform.
+  static bool inverse(Complex* spectrum, const int dims[3], float* values,
+                      const AxisCallback& axisDone = AxisCallback());
+
+  /// Log of the magnitude of the full spectrum, shifted like
+  /// numpy.fft.fftshift so that the zero frequency is at the center, and
+  /// divided by its maximum.
+  static void absLog(const Complex* spectrum, const int dims[3],
+                     float* values);
+
+  /// Zero the frequencies outside of [\p low, \p high], both fractions of
+  /// the Nyquist frequency, along the radius of the spectrum.
+  static void bandPass(Complex* spectrum, const int dims[3], double low,
+                       double high);
+
+  /// Multiply a volume, in place, by a separable Hann window, like
+  /// numpy.hanning along each axis. Integer values are truncated. The array
+  /// must have a single component, false is returned otherwise.
+  static bool hannWindow(vtkDataArray* array, const int dims[3]);
+  static void hannWindow(float* values, const int dims[3]);
+
+  /// Release the cached plans, no transform may be running.
+  static void clearPlans();
+};
+} // namespace tomviz
+
+#endif
@@ -0,0 +1,309 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "RegionCopy.h"
+
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using Boundary = tomviz::RegionCopy::Boundary;
+
+// The index of the input along an axis of size tuples for the index of the
+// output, -1 if the output is zero there.
+int inputIndex(int index, int size, Boundary boundary)
+{
+  if (index >= 0 && index < size) {
+    return index;
+  }
+  switch (boundary) {
+    case Boundary::Edge:
+      return index < 0 ? 0 : size - 1;
+    case Boundary::Wrap:
+      return (index % size + size) % size;
+    default:
+      return -1;
+  }
+}
+
+// dst[i] = src[i - offset], src and dst may be the same row with the zero
+// boundary.
+void copyRow(const char* src, int srcSize, char* dst, int dstSize, int offset,
+             Boundary boundary, int tupleSize)
+{
+  const int begin = std::min(std::max(offset, 0), dstSize);
+  const int end = std::max(std::min(offset + srcSize, dstSize), begin);
+  if (srcSize == 0) {
+    std::memset(dst, 0, static_cast<size_t>(dstSize) * tupleSize);
+    return;
+  }
+  if (boundary == Boundary::Wrap) {
+    for (int i = 0; i < dstSize;) {
+      const int j = inputIndex(i - offset, srcSize, boundary);
+      const int count = std::min(srcSize - j, dstSize - i);
+      std::memcpy(dst + static_cast<size_t>(i) * tupleSize,
+                  src + static_cast<size_t>(j) * tupleSize,
+                  static_cast<size_t>(count) * tupleSize);
+      i += count;
+    }
+    return;
+  }
+
+  // The copy goes first, the source may be overwritten by the fill.
+  if (end > begin) {
+    std::memmove(dst + static_cast<size_t>(begin) * tupleSize,
+                 src + static_cast<size_t>(begin - offset) * tupleSize,
+                 static_cast<size_t>(end - begin) * tupleSize);
+  }
+  if (boundary == Boundary::Zero) {
+    std::memset(dst, 0, static_cast<size_t>(begin) * tupleSize);
+    std::memset(dst + static_cast<size_t>(end) * tupleSize, 0,
+                static_cast<size_t>(dstSize - end) * tupleSize);
+    return;
+  }
+
+  for (int i = 0; i < begin; ++i) {
+    std::memcpy(dst + static_cast<size_t>(i) * tupleSize, src, tupleSize);
+  }
+  const char* last = src + static_cast<size_t>(srcSize - 1) * tupleSize;
+  for (int i = end; i < dstSize; ++i) {
+    std::memcpy(dst + static_cast<size_t>(i) * tupleSize, last, tupleSize);
+  }
+}
+
+// Copy each z slice, of size bytes, of [first, last) from the slice offset
+// slices before it.
+void copySlices(char* values, size_t size, vtkIdType first, vtkIdType last,
+                vtkIdType offset)
+{
+  vtkSMPTools::For(first, last, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType z = begin; z < end; ++z) {
+      std::memcpy(values + z * size, values + (z - offset) * size, size);
+    }
+  });
+}
+} // namespace
+
+namespace tomviz {
+
+void RegionCopy::copy(const void* input, const int inputDims[3], void* output,
+                      const int outputDims[3], const int offset[3],
+                      Boundary boundary, int tupleSize)
+{
+  auto in = static_cast<const char*>(input);
+  auto out = static_cast<char*>(output);
+  const size_t inRow = static_cast<size_t>(inputDims[0]) * tupleSize;
+  const size_t outRow = static_cast<size_t>(outputDims[0]) * tupleSize;
+  const vtkIdType numRows =
+    static_cast<vtkIdType>(outputDims[1]) * outputDims[2];
+  if (inputDims[0] == 0 || inputDims[1] == 0 || inputDims[2] == 0) {
+    std::memset(out, 0, numRows * outRow);
+    return;
+  }
+  vtkSMPTools::For(0, numRows, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType row = begin; row < end; ++row) {
+      const int y = static_cast<int>(row % outputDims[1]);
+      const int z = static_cast<int>(row / outputDims[1]);
+      const int sy = inputIndex(y - offset[1], inputDims[1], boundary);
+      const int sz = inputIndex(z - offset[2], inputDims[2], boundary);
+      if (sy < 0 || sz < 0) {
+        std::memset(out + row * outRow, 0, outRow);
+        continue;
+      }
+      const size_t source = static_cast<size_t>(sz) * inputDims[1] + sy;
+      copyRow(in + source * inRow, inputDims[0], out + row * outRow,
+              outputDims[0], offset[0], boundary, tupleSize);
+    }
+  });
+}
+
+void RegionCopy::crop(void* values, const int dims[3], const int extent[6],
+                      int tupleSize)
+{
+  auto data = static_cast<char*>(values);
+  const int cropped[3] = { extent[1] - extent[0] + 1,
+                           extent[3] - extent[2] + 1,
+                           extent[5] - extent[4] + 1 };
+  const size_t inRow = static_cast<size_t>(dims[0]) * tupleSize;
+  const size_t outRow = static_cast<size_t>(cropped[0]) * tupleSize;
+  const size_t inSlice = inRow * dims[1];
+  const size_t outSlice = outRow * cropped[1];
+
+  // Gather the rows of each slice at its start. The rows move towards the
+  // start of the slice, in order they never overwrite one still to move.
+  vtkSMPTools::For(0, cropped[2], [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType k = begin; k < end; ++k) {
+      char* slice = data + (extent[4] + k) * inSlice;
+      const char* first = slice + extent[2] * inRow + extent[0] * tupleSize;
+      for (int y = 0; y < cropped[1]; ++y) {
+        std::memmove(slice + y * outRow, first + y * inRow, outRow);
+      }
+    }
+  });
+
+  // Then move the slices to the start of the volume. The slices of each
+  // round move below the start of any slice still to move, they are copied
+  // in parallel.
+  vtkIdType first = 0;
+  while (first < cropped[2]) {
+    const size_t source = (extent[4] + first) * inSlice;
+    vtkIdType last = std::min<vtkIdType>(cropped[2], source / outSlice);
+    if (last <= first + 1) {
+      last = first + 1;
+      if (source != first * outSlice) {
+        std::memmove(data + first * outSlice, data + source, outSlice);
+      }
+    } else {
+      vtkSMPTools::For(first, last, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType k = begin; k < end; ++k) {
+          std::memcpy(data + k * outSlice, data + (extent[4] + k) * inSlice,
+                      outSlice);
+        }
+      });
+    }
+    first = last;
+  }
+}
+
+void RegionCopy::pad(const void* input, const int dims[3],
+                     const int before[3], const int after[3],
+                     Boundary boundary, void* output, int tupleSize)
+{
+  int outputDims[3];
+  for (int i = 0; i < 3; ++i) {
+    outputDims[i] = dims[i] + before[i] + after[i];
+  }
+  copy(input, dims, output, outputDims, before, boundary, tupleSize);
+}
+
+void RegionCopy::shift(void* values, const int dims[3], const int shift[3],
+                       int tupleSize)
+{
+  if (shift[0] != 0 || shift[1] != 0) {
+    std::vector<int> shifts(2 * static_cast<size_t>(dims[2]));
+    for (int z = 0; z < dims[2]; ++z) {
+      shifts[2 * z] = shift[0];
+      shifts[2 * z + 1] = shift[1];
+    }
+    shiftSlices(values, dims, shifts.data(), tupleSize);
+  }
+
+  // Whole slices move along z. The slices of a round are copied from slices
+  // outside of the round that no round wrote yet.
+  auto data = static_cast<char*>(values);
+  const size_t slice = static_cast<size_t>(dims[0]) * dims[1] * tupleSize;
+  const vtkIdType count = dims[2];
+  const vtkIdType offset = shift[2];
+  if (offset > 0) {
+    for (vtkIdType end = count; end > offset;) {
+      const vtkIdType begin = std::max(offset, end - offset);
+      copySlices(data, slice, begin, end, offset);
+      end = begin;
+    }
+    std::memset(data, 0, slice * std::min(offset, count));
+  } else if (offset < 0) {
+    for (vtkIdType begin = 0; begin < count + offset;) {
+      const vtkIdType end = std::min(count + offset, begin - offset);
+      copySlices(data, slice, begin, end, offset);
+      begin = end;
+    }
+    const vtkIdType zeroed = std::min(-offset, count);
+    std::memset(data + (count - zeroed) * slice, 0, zeroed * slice);
+  }
+}
+
+void RegionCopy::shiftSlices(void* values, const int dims[3],
+                             const int* shifts, int tupleSize)
+{
+  auto data = static_cast<char*>(values);
+  const size_t row = static_cast<size_t>(dims[0]) * tupleSize;
+  const size_t slice = row * dims[1];
+  vtkSMPTools::For(0, dims[2], [&](vtkIdType begin, vtkIdType end) {
+    // The slice is shifted from a copy, one per thread.
+    std::vector<char> buffer;
+    for (vtkIdType z = begin; z < end; ++z) {
+      const int dx = shifts[2 * z];
+      const int dy = shifts[2 * z + 1];
+      if (dx == 0 && dy == 0) {
+        continue;
+      }
+      char* target = data + z * slice;
+      buffer.assign(target, target + slice);
+      for (int y = 0; y < dims[1]; ++y) {
+        const int sy = y - dy;
+        if (sy < 0 || sy >= dims[1]) {
+          std::memset(target + y * row, 0, row);
+        } else {
+          copyRow(buffer.data() + sy * row, dims[0], target + y * row,
+                  dims[0], dx, Boundary::Zero, tupleSize);
+        }
+      }
+    }
+  });
+}
+
+void RegionCopy::roll(const void* input, const int dims[3],
+                      const int shift[3], void* output, int tupleSize)
+{
+  copy(input, dims, output, dims, shift, Boundary::Wrap, tupleSize);
+}
+
+bool RegionCopy::crop(vtkImageData* image, const int extent[6])
+{
+  if (!image || image->GetCellData()->GetNumberOfArrays() > 0) {
+    return false;
+  }
+
+  int imageExtent[6];
+  image->GetExtent(imageExtent);
+  int dims[3];
+  image->GetDimensions(dims);
+  int voi[6];
+  int local[6];
+  for (int i = 0; i < 3; ++i) {
+    voi[2 * i] = std::max(extent[2 * i], imageExtent[2 * i]);
+    voi[2 * i + 1] = std::min(extent[2 * i + 1], imageExtent[2 * i + 1]);
+    if (voi[2 * i] > voi[2 * i + 1]) {
+      return false;
+    }
+    local[2 * i] = voi[2 * i] - imageExtent[2 * i];
+    local[2 * i + 1] = voi[2 * i + 1] - imageExtent[2 * i];
+  }
+
+  auto pointData = image->GetPointData();
+  const vtkIdType numPoints = image->GetNumberOfPoints();
+  for (int i = 0; i < pointData->GetNumberOfArrays(); ++i) {
+    auto array = pointData->GetArray(i);
+    if (!array || !array->HasStandardMemoryLayout() ||
+        array->GetNumberOfTuples() != numPoints) {
+      return false;
+    }
+  }
+
+  const vtkIdType numTuples =
+    static_cast<vtkIdType>(voi[1] - voi[0] + 1) * (voi[3] - voi[2] + 1) *
+    (voi[5] - voi[4] + 1);
+  for (int i = 0; i < pointData->GetNumberOfArrays(); ++i) {
+    auto array = pointData->GetArray(i);
+    if (numTuples != numPoints) {
+      crop(array->GetVoidPointer(0), dims, local,
+           array->GetDataTypeSize() * array->GetNumberOfComponents());
+      // The cropped volume is at the start of the buffer, release the rest.
+      array->SetNumberOfTuples(numTuples);
+      array->Squeeze();
+    }
+    array->Modified();
+  }
+  image->SetExtent(voi);
+
+  return true;
+}
+
+} // namespace tomviz
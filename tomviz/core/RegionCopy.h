@@ -0,0 +1,152 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizRegionCopy_h
+#define tomvizRegionCopy_h
+
+#include "tomvizcore_export.h"
+
+#include <vtkSMPTools.h>
+#include <vtkType.h>
+
+#include <cmath>
+#include <type_traits>
+
+class vtkImageData;
+
+namespace tomviz {
+
+/// Copies of regions of volumes: crops, pads and shifts. The volumes are
+/// arrays of tuples of \p tupleSize bytes, x varying fastest, so the regions
+/// are copied as runs of bytes whatever the type of the values is. The rows
+/// are copied in parallel.
+///
+/// Crops and shifts are done in place, the other copies allocate nothing
+/// but their output.
+class TOMVIZCORE_EXPORT RegionCopy
+{
+public:
+  /// The value of the tuples of the output which are outside of the input.
+  enum class Boundary
+  {
+    Zero,
+    Edge,
+    Wrap
+  };
+
+  /// Copy \p input to \p output, which must not overlap, with
+  /// output[o] = input[o - offset] along each axis. Tuples outside of the
+  /// input are set according to \p boundary.
+  static void copy(const void* input, const int inputDims[3], void* output,
+                   const int outputDims[3], const int offset[3],
+                   Boundary boundary, int tupleSize);
+
+  /// Crop \p values to \p extent, the first and last index along each axis,
+  /// in place. The cropped volume is at the start of \p values.
+  static void crop(void* values, const int dims[3], const int extent[6],
+                   int tupleSize);
+
+  /// Pad \p input with \p before and \p after tuples along each axis.
+  static void pad(const void* input, const int dims[3], const int before[3],
+                  const int after[3], Boundary boundary, void* output,
+                  int tupleSize);
+
+  /// Shift \p values by \p shift tuples along each axis, in place. Tuples
+  /// shifted in are zero.
+  static void shift(void* values, const int dims[3], const int shift[3],
+                    int tupleSize);
+
+  /// Shift each z slice of \p values by its own x and y shift, in place.
+  /// \p shifts holds two values for each slice. Tuples shifted in are zero.
+  static void shiftSlices(void* values, const int dims[3], const int* shifts,
+                          int tupleSize);
+
+  /// Shift \p input by \p shift tuples along each axis, tuples shifted out
+  /// of the volume reentering it on the other side.
+  static void roll(const void* input, const int dims[3], const int shift[3],
+                   void* output, int tupleSize);
+
+  /// Shift \p input by a fraction of a voxel, interpolating linearly. Values
+  /// outside of the input are zero, integer values are rounded.
+  template <typename T>
+  static void shiftLinear(const T* input, const int dims[3],
+                          int numComponents, const double shift[3],
+                          T* output);
+
+  /// Crop the point data of \p image to \p extent, clamped to the extent of
+  /// the image, like vtkExtractVOI does but in place. Returns false, leaving
+  /// the image unchanged, if the extent is empty or the arrays can not be
+  /// cropped in place.
+  static bool crop(vtkImageData* image, const int extent[6]);
+
+private:
+  template <typename T>
+  static T rounded(double value, std::true_type)
+  {
+    return static_cast<T>(std::floor(value + 0.5));
+  }
+
+  template <typename T>
+  static T rounded(double value, std::false_type)
+  {
+    return static_cast<T>(value);
+  }
+};
+
+template <typename T>
+void RegionCopy::shiftLinear(const T* input, const int dims[3],
+                             int numComponents, const double shift[3],
+                             T* output)
+{
+  // The sample of output[o] is at o - shift, between the tuples o + base and
+  // o + base + 1 along each axis, the weights are the same for every tuple.
+  int base[3];
+  double weights[3][2];
+  for (int i = 0; i < 3; ++i) {
+    const double position = -shift[i];
+    base[i] = static_cast<int>(std::floor(position));
+    weights[i][1] = position - base[i];
+    weights[i][0] = 1.0 - weights[i][1];
+  }
+
+  const vtkIdType rowSize = static_cast<vtkIdType>(dims[0]) * numComponents;
+  const vtkIdType sliceSize = rowSize * dims[1];
+  const vtkIdType numRows = static_cast<vtkIdType>(dims[1]) * dims[2];
+  vtkSMPTools::For(0, numRows, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType row = begin; row < end; ++row) {
+      const int y = static_cast<int>(row % dims[1]);
+      const int z = static_cast<int>(row / dims[1]);
+      T* out = output + row * rowSize;
+      for (int x = 0; x < dims[0]; ++x) {
+        for (int c = 0; c < numComponents; ++c) {
+          double value = 0.0;
+          for (int k = 0; k < 2; ++k) {
+            const int sz = z + base[2] + k;
+            if (sz < 0 || sz >= dims[2] || weights[2][k] == 0.0) {
+              continue;
+            }
+            for (int j = 0; j < 2; ++j) {
+              const int sy = y + base[1] + j;
+              if (sy < 0 || sy >= dims[1] || weights[1][j] == 0.0) {
+                continue;
+              }
+              const T* in = input + sz * sliceSize + sy * rowSize + c;
+              for (int i = 0; i < 2; ++i) {
+                const int sx = x + base[0] + i;
+                if (sx >= 0 && sx < dims[0]) {
+                  value += weights[2][k] * weights[1][j] * weights[0][i] *
+                           in[static_cast<vtkIdType>(sx) * numComponents];
+                }
+              }
+            }
+          }
+          out[x * numComponents + c] =
+            rounded<T>(value, typename std::is_integral<T>::type());
+        }
+      }
+    }
+  });
+}
+} // namespace tomviz
+
+#endif
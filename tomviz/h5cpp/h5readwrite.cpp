@@ -167,27 +167,71 @@ public:
     return H5Awrite(attributeId, typeId, value) >= 0;
   }
 
-  bool writeData(const string& path, const string& name,
-                 const std::vector<int>& dims, const void* data,
-                 hid_t dataTypeId, hid_t memTypeId)
+  // Returns the id of the new data set, to be closed by the caller, or a
+  // negative value on failure.
+  hid_t createDataSet(const string& path, const string& name,
+                      const std::vector<int>& dims, hid_t dataTypeId,
+                      const std::vector<int>& chunkDims = std::vector<int>(),
+                      int compressionLevel = 0)
   {
     if (!fileIsValid()) {
       cerr << "File is invalid\n";
-      return false;
+      return -1;
     }
 
     std::vector<hsize_t> h5dim;
     for (size_t i = 0; i < dims.size(); ++i) {
       h5dim.push_back(static_cast<hsize_t>(dims[i]));
     }
+
+    // Set up the chunking and compression, if requested
+    hid_t createPropsId = H5P_DEFAULT;
+    HIDCloser createPropsCloser(-1, H5Pclose);
+    if (!chunkDims.empty()) {
+      if (chunkDims.size() != dims.size()) {
+        cerr << "Chunk dimensions do not match the data dimensions\n";
+        return -1;
+      }
+
+      std::vector<hsize_t> h5chunk;
+      for (size_t i = 0; i < dims.size(); ++i) {
+        int chunk = std::max(1, std::min(chunkDims[i], dims[i]));
+        h5chunk.push_back(static_cast<hsize_t>(chunk));
+      }
+
+      createPropsId = H5Pcreate(H5P_DATASET_CREATE);
+      createPropsCloser.reset(createPropsId);
+      H5Pset_chunk(createPropsId, static_cast<int>(h5chunk.size()),
+                   h5chunk.data());
+      if (compressionLevel > 0) {
+        H5Pset_deflate(createPropsId,
+                       static_cast<unsigned>(std::min(compressionLevel, 9)));
+      }
+    }
+
     hid_t groupId = H5Gopen(m_fileId, path.c_str(), H5P_DEFAULT);
     hid_t dataSpaceId =
       H5Screate_simple(static_cast<int>(dims.size()), &h5dim[0], nullptr);
-    hid_t dataId = H5Dcreate(groupId, name.c_str(), dataTypeId, dataSpaceId,
-                             H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
 
     HIDCloser groupCloser(groupId, H5Gclose);
     HIDCloser spaceCloser(dataSpaceId, H5Sclose);
+
+    return H5Dcreate(groupId, name.c_str(), dataTypeId, dataSpaceId,
+                     H5P_DEFAULT, createPropsId, H5P_DEFAULT);
+  }
+
+  bool writeData(const string& path, const string& name,
+                 const std::vector<int>& dims, const void* data,
+                 hid_t dataTypeId, hid_t memTypeId,
+                 const std::vector<int>& chunkDims = std::vector<int>(),
+                 int compressionLevel = 0)
+  {
+    hid_t dataId = createDataSet(path, name, dims, dataTypeId, chunkDims,
+                                 compressionLevel);
+    if (dataId < 0) {
+      return false;
+    }
+
     HIDCloser dataCloser(dataId, H5Dclose);
 
     hid_t status =
@@ -196,6 +240,31 @@ public:
     return status >= 0;
   }
 
+  bool writeChunk(const string& path, const std::vector<int>& offset,
+                  const void* data, size_t size)
+  {
+#if H5_VERSION_GE(1, 10, 3)
+    hid_t dataSetId = H5Dopen(m_fileId, path.c_str(), H5P_DEFAULT);
+    if (dataSetId < 0) {
+      cerr << "Failed to get dataSetId\n";
+      return false;
+    }
+
+    HIDCloser dataSetCloser(dataSetId, H5Dclose);
+
+    std::vector<hsize_t> h5offset(offset.begin(), offset.end());
+    return H5Dwrite_chunk(dataSetId, H5P_DEFAULT, 0, h5offset.data(), size,
+                          data) >= 0;
+#else
+    (void)path;
+    (void)offset;
+    (void)data;
+    (void)size;
+    cerr << "Writing chunks requires HDF5 1.10.3 or later\n";
+    return false;
+#endif
+  }
+
   vector<int> getDimensions(const string& path)
   {
     vector<int> result;
@@ -688,6 +757,48 @@ vector<int> H5ReadWrite::getDimensions(const string& path)
   return m_impl->getDimensions(path);
 }
 
+bool H5ReadWrite::contiguousOffset(const string& path, size_t& offset)
+{
+  DataType type = dataType(path);
+  auto memIt = DataTypeToH5MemType.find(type);
+  if (memIt == DataTypeToH5MemType.end()) {
+    return false;
+  }
+
+  hid_t dataSetId = H5Dopen(m_impl->fileId(), path.c_str(), H5P_DEFAULT);
+  if (dataSetId < 0) {
+    cerr << "Failed to get data set id\n";
+    return false;
+  }
+
+  hid_t dataTypeId = H5Dget_type(dataSetId);
+  hid_t propertiesId = H5Dget_create_plist(dataSetId);
+
+  // Automatically close
+  HIDCloser dataSetCloser(dataSetId, H5Dclose);
+  HIDCloser dataTypeCloser(dataTypeId, H5Tclose);
+  HIDCloser propertiesCloser(propertiesId, H5Pclose);
+
+  if (H5Pget_layout(propertiesId) != H5D_CONTIGUOUS ||
+      H5Pget_nfilters(propertiesId) != 0) {
+    return false;
+  }
+
+  // The values must not need any conversion
+  if (H5Tequal(dataTypeId, memIt->second) <= 0) {
+    return false;
+  }
+
+  // The data may not have been written
+  haddr_t address = H5Dget_offset(dataSetId);
+  if (address == HADDR_UNDEF) {
+    return false;
+  }
+
+  offset = static_cast<size_t>(address);
+  return true;
+}
+
 int H5ReadWrite::dimensionCount(const string& path)
 {
   vector<int> dims = getDimensions(path);
@@ -819,6 +930,67 @@ bool H5ReadWrite::writeData(const string& path, const string& name,
   return m_impl->writeData(path, name, dims, data, dataTypeId, memTypeId);
 }
 
+bool H5ReadWrite::writeData(const string& path, const string& name,
+                            const vector<int>& dims, const DataType& type,
+                            const void* data, const vector<int>& chunkDims,
+                            int compressionLevel)
+{
+  auto it = DataTypeToH5DataType.find(type);
+  if (it == DataTypeToH5DataType.end()) {
+    cerr << "Failed to get H5 data type for " << dataTypeToString(type) << "\n";
+    return false;
+  }
+
+  hid_t dataTypeId = it->second;
+
+  auto memIt = DataTypeToH5MemType.find(type);
+  if (memIt == DataTypeToH5MemType.end()) {
+    cerr << "Failed to get H5 mem type for " << dataTypeToString(type) << "\n";
+    return false;
+  }
+
+  hid_t memTypeId = memIt->second;
+
+  return m_impl->writeData(path, name, dims, data, dataTypeId, memTypeId,
+                           chunkDims, compressionLevel);
+}
+
+bool H5ReadWrite::createDataSet(const string& path, const string& name,
+                                const vector<int>& dims, const DataType& type,
+                                const vector<int>& chunkDims,
+                                int compressionLevel)
+{
+  auto it = DataTypeToH5DataType.find(type);
+  if (it == DataTypeToH5DataType.end()) {
+    cerr << "Failed to get H5 data type for " << dataTypeToString(type) << "\n";
+    return false;
+  }
+
+  hid_t dataId = m_impl->createDataSet(path, name, dims, it->second, chunkDims,
+                                       compressionLevel);
+  if (dataId < 0) {
+    return false;
+  }
+
+  H5Dclose(dataId);
+  return true;
+}
+
+bool H5ReadWrite::canWriteChunks()
+{
+#if H5_VERSION_GE(1, 10, 3)
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool H5ReadWrite::writeChunk(const string& path, const vector<int>& offset,
+                             const void* data, size_t size)
+{
+  return m_impl->writeChunk(path, offset, data, size);
+}
+
 template <typename T>
 bool H5ReadWrite::setAttribute(const string& path, const string& name, T value)
 {
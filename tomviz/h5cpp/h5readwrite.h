@@ -155,6 +155,16 @@ public:
    */
   std::vector<int> getDimensions(const std::string& path);
 
+  /**
+   * Get the offset in the file of a data set that is stored contiguously,
+   * without compression or other filters, and whose values are in the
+   * native byte order, so that the data can be memory mapped.
+   * @param path The path to the data set.
+   * @param offset Will be set to the offset of the data in the file.
+   * @return True if the data set can be memory mapped, false otherwise.
+   */
+  bool contiguousOffset(const std::string& path, size_t& offset);
+
   /**
    * Read a 1-dimensional data set and interpret it as type T. If @p path
    * is not a data set, @p path is not a 1-dimensional data set, or T is
@@ -253,6 +263,65 @@ public:
                  const std::vector<int>& dimensions, const DataType& type,
                  const void* data);
 
+  /**
+   * Write data to a specified path, stored in chunks that are compressed
+   * with deflate. Chunked data sets can be read a hyperslab at a time
+   * without reading the rest of the data set.
+   * @param path The path where the data will be written.
+   * @param name The name of the data.
+   * @param dimensions The dimensions of the data.
+   * @param type The type of data to write.
+   * @param data The data to write.
+   * @param chunkDimensions The dimensions of the chunks. They are clamped
+   *                        to the dimensions of the data.
+   * @param compressionLevel The deflate compression level, from 1 to 9.
+   *                         If it is 0, the chunks are not compressed.
+   * @return True on success, false on failure.
+   */
+  bool writeData(const std::string& path, const std::string& name,
+                 const std::vector<int>& dimensions, const DataType& type,
+                 const void* data, const std::vector<int>& chunkDimensions,
+                 int compressionLevel);
+
+  /**
+   * Create a data set, stored in chunks that are compressed with deflate,
+   * without writing any data. Its chunks may then be written with
+   * writeChunk().
+   * @param path The path where the data set will be created.
+   * @param name The name of the data set.
+   * @param dimensions The dimensions of the data set.
+   * @param type The type of the data set.
+   * @param chunkDimensions The dimensions of the chunks. They are clamped
+   *                        to the dimensions of the data set.
+   * @param compressionLevel The deflate compression level, from 1 to 9.
+   *                         If it is 0, the chunks are not compressed.
+   * @return True on success, false on failure.
+   */
+  bool createDataSet(const std::string& path, const std::string& name,
+                     const std::vector<int>& dimensions, const DataType& type,
+                     const std::vector<int>& chunkDimensions,
+                     int compressionLevel);
+
+  /**
+   * Check whether writeChunk() is supported, it requires HDF5 1.10.3.
+   */
+  static bool canWriteChunks();
+
+  /**
+   * Write a chunk of a chunked data set as it is stored in the file,
+   * bypassing the filters of the data set. This allows chunks to be
+   * compressed beforehand, e.g. on other threads. Chunks at the edges of
+   * the data set must be padded to the full size of a chunk before they
+   * are compressed.
+   * @param path The path to the data set.
+   * @param offset The position of the first element of the chunk.
+   * @param data The chunk, filtered as the data set specifies.
+   * @param size The size of @p data, in bytes.
+   * @return True on success, false on failure.
+   */
+  bool writeChunk(const std::string& path, const std::vector<int>& offset,
+                  const void* data, size_t size);
+
   /**
    * Set an attribute on a specified path.
    * @param path The path where the attribute will be written.
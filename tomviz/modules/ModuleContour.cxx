@@ -4,18 +4,22 @@
 #include "ModuleContour.h"
 #include "ModuleContourWidget.h"
 
+#include "ArrayStatistics.h"
+#include "BrickRangeIndex.h"
 #include "DataSource.h"
 
 #include "vtkActiveScalarsProducer.h"
 #include "vtkActor.h"
 #include "vtkColorTransferFunction.h"
 #include "vtkDataSetMapper.h"
+#include "vtkExtractVOI.h"
 #include "vtkFlyingEdges3D.h"
 #include "vtkPVRenderView.h"
 #include "vtkPointData.h"
 #include "vtkProbeFilter.h"
 #include "vtkProperty.h"
 #include "vtkSMViewProxy.h"
+#include "vtkSmartPointer.h"
 
 #include <QJsonObject>
 #include <QLayout>
@@ -31,8 +35,11 @@ public:
   bool ColorByArray = false;
   bool UseSolidColor = false;
   QString ColorArrayName;
-  vtkNew<vtkActiveScalarsProducer> ColorArrayProducer;
-  vtkNew<vtkActiveScalarsProducer> ContourArrayProducer;
+  // Shared with the other modules on the data source
+  vtkSmartPointer<vtkActiveScalarsProducer> ColorArrayProducer;
+  vtkSmartPointer<vtkActiveScalarsProducer> ContourArrayProducer;
+  // Restricts the contour to the bricks that can contain the iso value
+  vtkNew<vtkExtractVOI> ActiveBricks;
 };
 
 ModuleContour::ModuleContour(QObject* parentObject) : Module(parentObject)
@@ -62,8 +69,6 @@ bool ModuleContour::initialize(DataSource* data, vtkSMViewProxy* vtkView)
   d->ColorArrayName = data->activeScalars();
 
   updateContourArrayProducer();
-
-  m_flyingEdges->SetInputConnection(d->ContourArrayProducer->GetOutputPort());
   resetIsoValue();
 
   m_mapper->SetInputConnection(m_flyingEdges->GetOutputPort());
@@ -99,9 +104,8 @@ bool ModuleContour::finalize()
 
 void ModuleContour::onDataChanged()
 {
-  // FIXME: Implementing the vtkActiveScalarsProducer as a producer breaks the
-  // vtk pipeline, requiring manual updates to keep in sync like here.
-  // It really should be implemented as a filter.
+  // The array producers update with the pipeline, but the brick index and the
+  // array options may have changed.
   onDataPropertiesChanged();
 }
 
@@ -128,9 +132,35 @@ void ModuleContour::onActiveScalarsChanged()
 
 void ModuleContour::updateContourArrayProducer()
 {
-  d->ContourArrayProducer->SetOutput(dataSource()->dataObject());
-  auto name = contourByArrayName().toStdString();
-  d->ContourArrayProducer->SetActiveScalars(name.c_str());
+  d->ContourArrayProducer =
+    dataSource()->activeScalarsProducer(contourByArrayName());
+  updateActiveBricks();
+}
+
+void ModuleContour::updateActiveBricks()
+{
+  auto index = dataSource()->brickRangeIndex(contourByArrayName());
+  double value = iso();
+  int extent[6];
+  if (!index) {
+    m_flyingEdges->SetInputConnection(d->ContourArrayProducer->GetOutputPort());
+    return;
+  }
+
+  if (!index->activeExtent(value, value, extent)) {
+    // No brick contains the iso value, a single point yields an empty contour.
+    dataSource()->getExtent(extent);
+    extent[1] = extent[0];
+    extent[3] = extent[2];
+    extent[5] = extent[4];
+  } else if (index->coversMostOfImage(extent)) {
+    m_flyingEdges->SetInputConnection(d->ContourArrayProducer->GetOutputPort());
+    return;
+  }
+
+  d->ActiveBricks->SetInputConnection(d->ContourArrayProducer->GetOutputPort());
+  d->ActiveBricks->SetVOI(extent);
+  m_flyingEdges->SetInputConnection(d->ActiveBricks->GetOutputPort());
 }
 
 void ModuleContour::updateColorArrayProducer()
@@ -140,14 +170,14 @@ void ModuleContour::updateColorArrayProducer()
     return;
   }
 
-  d->ColorArrayProducer->SetOutput(dataSource()->dataObject());
-  auto activeName = colorByArrayName().toStdString();
-  d->ColorArrayProducer->SetActiveScalars(activeName.c_str());
+  d->ColorArrayProducer =
+    dataSource()->activeScalarsProducer(colorByArrayName());
+  m_probeFilter->SetSourceConnection(d->ColorArrayProducer->GetOutputPort());
 }
 
 void ModuleContour::clearColorArrayProducer()
 {
-  d->ColorArrayProducer->SetOutput(nullptr);
+  d->ColorArrayProducer = nullptr;
 }
 
 void ModuleContour::updateColorMap()
@@ -257,23 +287,14 @@ void ModuleContour::updatePanel()
 
 namespace {
 
-void getRange(vtkAlgorithm* alg, double range[2])
+void getRange(DataSource* dataSource, const QString& arrayName,
+              double range[2])
 {
   for (int i = 0; i < 2; ++i)
     range[i] = 0.0;
 
-  if (!alg)
-    return;
-
-  auto* data = vtkDataSet::SafeDownCast(alg->GetOutputDataObject(0));
-  if (!data)
-    return;
-
-  auto* arrayPtr = data->GetPointData()->GetScalars();
-  if (!arrayPtr)
-    return;
-
-  arrayPtr->GetFiniteRange(range, -1);
+  if (auto stats = dataSource->statistics(arrayName))
+    stats->finiteRange(range, -1);
 }
 
 } // namespace
@@ -284,7 +305,7 @@ void ModuleContour::updateIsoRange()
     return;
 
   double range[2];
-  getRange(d->ContourArrayProducer, range);
+  getRange(dataSource(), contourByArrayName(), range);
   m_controllers->setIsoRange(range);
 }
 
@@ -315,7 +336,7 @@ void ModuleContour::updateColorByArrayOptions()
 void ModuleContour::resetIsoValue()
 {
   double range[2];
-  getRange(d->ContourArrayProducer, range);
+  getRange(dataSource(), contourByArrayName(), range);
 
   // Use 2/3 of the range by default
   double val = (range[1] - range[0]) * 2 / 3 + range[0];
@@ -509,6 +530,7 @@ void ModuleContour::onSpecularPowerChanged(const double value)
 void ModuleContour::onIsoChanged(const double value)
 {
   m_flyingEdges->SetValue(0, value);
+  updateActiveBricks();
   emit renderNeeded();
 }
 
@@ -560,7 +582,6 @@ void ModuleContour::onColorByArrayToggled(const bool state)
   updateColorArrayProducer();
   if (state) {
     m_probeFilter->SetInputConnection(m_flyingEdges->GetOutputPort());
-    m_probeFilter->SetSourceConnection(d->ColorArrayProducer->GetOutputPort());
     m_mapper->SetInputConnection(m_probeFilter->GetOutputPort());
   } else {
     m_probeFilter->RemoveAllInputs();
@@ -68,6 +68,7 @@ protected:
   void updateColorMap() override;
   void updateColorArray();
   void updateContourArrayProducer();
+  void updateActiveBricks();
   void updateColorArrayProducer();
   void clearColorArrayProducer();
   void updateIsoRange();
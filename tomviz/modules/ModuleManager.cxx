@@ -10,6 +10,7 @@
 #include "MoleculeSource.h"
 #include "Pipeline.h"
 #include "PythonGeneratedDatasetReaction.h"
+#include "Tvh5Multiscale.h"
 #include "Utilities.h"
 #include "tomvizConfig.h"
 
@@ -469,6 +470,12 @@ QJsonArray jsonArrayFromXmlDouble(pugi::xml_node node)
 bool ModuleManager::serialize(QJsonObject& doc, const QDir& stateDir,
                               bool interactive) const
 {
+  // The state describes the full resolution data of the data sources
+  if (!Tvh5Multiscale::finishAll()) {
+    qCritical("The data could not all be read, the state can't be saved.");
+    return false;
+  }
+
   QJsonObject tvObj;
   tvObj["version"] = QString(TOMVIZ_VERSION);
   if (QString(TOMVIZ_VERSION_EXTRA).size() > 0) {
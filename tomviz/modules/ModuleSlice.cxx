@@ -114,8 +114,10 @@ bool ModuleSlice::setupWidget(vtkSMViewProxy* vtkView)
     vtkScalarsToColors::SafeDownCast(lut->GetClientSideObject());
   m_widget->SetLookupTable(stc);
 
-  // Lastly we set up the input connection.
-  m_producer->SetOutput(dataSource()->producer()->GetOutputDataObject(0));
+  // Lastly we set up the input connection, the widget needs the data to
+  // place itself.
+  m_producer = dataSource()->activeScalarsProducer(scalarsArrayName());
+  m_producer->Update();
   m_widget->SetInputConnection(m_producer->GetOutputPort());
 
   Q_ASSERT(rwi);
@@ -362,10 +364,8 @@ void ModuleSlice::dataUpdated()
 
 void ModuleSlice::dataChanged()
 {
-  // FIXME: Implementing the vtkActiveScalarsProducer as a producer breaks the
-  // vtk pipeline, requiring manual updates to keep in sync like here.
-  // It really should be implemented as a filter.
-  m_producer->SetOutput(dataSource()->dataObject());
+  // The slice widget reads the new dimensions from the producer output.
+  m_producer->Update();
   dataPropertiesChanged();
   dataUpdated();
 }
@@ -618,16 +618,34 @@ void ModuleSlice::onScalarArrayChanged()
     m_scalarsCombo->setOptions(dataSource(), this);
   }
 
-  QString arrayName;
-  if (activeScalars() == Module::defaultScalarsIdx()) {
-    arrayName = dataSource()->activeScalars();
-  } else {
-    arrayName = dataSource()->scalarsName(activeScalars());
+  auto producer = dataSource()->activeScalarsProducer(scalarsArrayName());
+  if (producer != m_producer) {
+    // Connecting a new input places the plane again, keep it where it was.
+    double origin[3], point1[3], point2[3];
+    m_widget->GetOrigin(origin);
+    m_widget->GetPoint1(point1);
+    m_widget->GetPoint2(point2);
+
+    m_producer = producer;
+    m_producer->Update();
+    m_widget->SetInputConnection(m_producer->GetOutputPort());
+
+    m_widget->SetOrigin(origin);
+    m_widget->SetPoint1(point1);
+    m_widget->SetPoint2(point2);
+    m_widget->UpdatePlacement();
   }
-  m_producer->SetActiveScalars(arrayName.toLatin1().data());
   emit renderNeeded();
 }
 
+QString ModuleSlice::scalarsArrayName() const
+{
+  if (activeScalars() == Module::defaultScalarsIdx()) {
+    return dataSource()->activeScalars();
+  }
+  return dataSource()->scalarsName(activeScalars());
+}
+
 void ModuleSlice::onDirectionChanged(Direction direction)
 {
   m_direction = direction;
@@ -119,6 +119,7 @@ private slots:
 
 private:
   bool setupWidget(vtkSMViewProxy* view);
+  QString scalarsArrayName() const;
 
   Q_DISABLE_COPY(ModuleSlice)
 
@@ -150,7 +151,8 @@ private:
   QPointer<pqLineEdit> m_pointInputs[3];
   QPointer<pqLineEdit> m_normalInputs[3];
 
-  vtkNew<vtkActiveScalarsProducer> m_producer;
+  // Shared with the other modules on the data source
+  vtkSmartPointer<vtkActiveScalarsProducer> m_producer;
 };
 } // namespace tomviz
 
@@ -3,6 +3,7 @@
 
 #include "ModuleThreshold.h"
 
+#include "BrickRangeIndex.h"
 #include "DataSource.h"
 #include "DoubleSliderWidget.h"
 #include "Utilities.h"
@@ -53,14 +54,25 @@ bool ModuleThreshold::initialize(DataSource* data, vtkSMViewProxy* vtkView)
 
   vtkSMSessionProxyManager* pxm = producer->GetSessionProxyManager();
 
-  // Create the contour filter.
+  // Create the subset filter, it limits the threshold to the active bricks.
+  vtkSmartPointer<vtkSMProxy> subsetProxy;
+  subsetProxy.TakeReference(pxm->NewProxy("filters", "ExtractSubset"));
+
+  m_subsetFilter = vtkSMSourceProxy::SafeDownCast(subsetProxy);
+  Q_ASSERT(m_subsetFilter);
+  controller->PreInitializeProxy(m_subsetFilter);
+  vtkSMPropertyHelper(m_subsetFilter, "Input").Set(producer);
+  controller->PostInitializeProxy(m_subsetFilter);
+  controller->RegisterPipelineProxy(m_subsetFilter);
+
+  // Create the threshold filter.
   vtkSmartPointer<vtkSMProxy> proxy;
   proxy.TakeReference(pxm->NewProxy("filters", "Threshold"));
 
   m_thresholdFilter = vtkSMSourceProxy::SafeDownCast(proxy);
   Q_ASSERT(m_thresholdFilter);
   controller->PreInitializeProxy(m_thresholdFilter);
-  vtkSMPropertyHelper(m_thresholdFilter, "Input").Set(producer);
+  vtkSMPropertyHelper(m_thresholdFilter, "Input").Set(m_subsetFilter);
   controller->PostInitializeProxy(m_thresholdFilter);
   controller->RegisterPipelineProxy(m_thresholdFilter);
 
@@ -74,6 +86,7 @@ bool ModuleThreshold::initialize(DataSource* data, vtkSMViewProxy* vtkView)
   newRange[1] = mid + 0.1 * delta;
   rangeProperty.Set(newRange, 2);
   m_thresholdFilter->UpdateVTKObjects();
+  updateActiveBricks();
 
   // Create the representation for it.
   m_thresholdRepresentation = controller->Show(m_thresholdFilter, 0, vtkView);
@@ -91,6 +104,8 @@ bool ModuleThreshold::initialize(DataSource* data, vtkSMViewProxy* vtkView)
   }
 
   connect(data, SIGNAL(activeScalarsChanged()), SLOT(onScalarArrayChanged()));
+  connect(data, &DataSource::dataChanged, this,
+          &ModuleThreshold::updateActiveBricks);
   onScalarArrayChanged();
 
   return true;
@@ -113,7 +128,9 @@ bool ModuleThreshold::finalize()
   vtkNew<vtkSMParaViewPipelineControllerWithRendering> controller;
   controller->UnRegisterProxy(m_thresholdRepresentation);
   controller->UnRegisterProxy(m_thresholdFilter);
+  controller->UnRegisterProxy(m_subsetFilter);
   m_thresholdFilter = nullptr;
+  m_subsetFilter = nullptr;
   m_thresholdRepresentation = nullptr;
   return true;
 }
@@ -210,10 +227,14 @@ void ModuleThreshold::addToPanel(QWidget* panel)
 
   connect(arraySelection, &pqPropertyWidget::changeFinished, arraySelection,
           &pqPropertyWidget::apply);
+  connect(arraySelection, &pqPropertyWidget::changeFinished, this,
+          &ModuleThreshold::updateActiveBricks);
   connect(arraySelection, &pqPropertyWidget::changeFinished, this,
           &Module::renderNeeded);
   connect(range, &pqPropertyWidget::changeFinished, range,
           &pqPropertyWidget::apply);
+  connect(range, &pqPropertyWidget::changeFinished, this,
+          &ModuleThreshold::updateActiveBricks);
   connect(range, &pqPropertyWidget::changeFinished, this,
           &Module::renderNeeded);
   connect(representations, &QComboBox::currentTextChanged, this,
@@ -243,6 +264,49 @@ void ModuleThreshold::onScalarArrayChanged()
   emit renderNeeded();
 }
 
+void ModuleThreshold::updateActiveBricks()
+{
+  if (!m_subsetFilter || !m_thresholdFilter) {
+    return;
+  }
+
+  int extent[6];
+  dataSource()->getExtent(extent);
+  bool extract = false;
+
+  QString arrayName =
+    vtkSMPropertyHelper(m_thresholdFilter, "SelectInputScalars")
+      .GetInputArrayNameToProcess();
+  auto index = dataSource()->brickRangeIndex(arrayName);
+  if (index) {
+    double range[2];
+    vtkSMPropertyHelper(m_thresholdFilter, "ThresholdBetween").Get(range, 2);
+    if (!index->activeExtent(range[0], range[1], extent)) {
+      // Nothing is in range, a single point yields an empty threshold.
+      extent[1] = extent[0];
+      extent[3] = extent[2];
+      extent[5] = extent[4];
+      extract = true;
+    } else {
+      extract = !index->coversMostOfImage(extent);
+    }
+  }
+
+  // Threshold the data directly unless the active bricks are a small part
+  // of it, the subset is a copy.
+  vtkSMProxy* input = dataSource()->proxy();
+  if (extract) {
+    vtkSMPropertyHelper(m_subsetFilter, "VOI").Set(extent, 6);
+    m_subsetFilter->UpdateVTKObjects();
+    input = m_subsetFilter;
+  }
+  vtkSMPropertyHelper inputHelper(m_thresholdFilter, "Input");
+  if (inputHelper.GetAsProxy() != input) {
+    inputHelper.Set(input);
+    m_thresholdFilter->UpdateVTKObjects();
+  }
+}
+
 QJsonObject ModuleThreshold::serialize() const
 {
   auto json = Module::serialize();
@@ -294,6 +358,7 @@ bool ModuleThreshold::deserialize(const QJsonObject& json)
     mapScalars.Set(props["mapScalars"].toBool() ? 1 : 0);
     m_thresholdFilter->UpdateVTKObjects();
     rep->UpdateVTKObjects();
+    updateActiveBricks();
     return true;
   }
   return false;
@@ -43,10 +43,14 @@ private slots:
 
   void onScalarArrayChanged();
 
+  /// Restrict the threshold to the bricks that intersect the threshold range.
+  void updateActiveBricks();
+
 private:
   Q_DISABLE_COPY(ModuleThreshold)
 
   pqPropertyLinks m_links;
+  vtkWeakPointer<vtkSMSourceProxy> m_subsetFilter;
   vtkWeakPointer<vtkSMSourceProxy> m_thresholdFilter;
   vtkWeakPointer<vtkSMProxy> m_thresholdRepresentation;
 };
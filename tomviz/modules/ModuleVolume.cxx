@@ -4,14 +4,17 @@
 #include "ModuleVolume.h"
 #include "ModuleVolumeWidget.h"
 
+#include "ArrayStatistics.h"
 #include "DataSource.h"
 #include "HistogramManager.h"
+#include "ImagePyramid.h"
 #include "ScalarsComboBox.h"
 #include "VolumeManager.h"
 #include "vtkTransferFunctionBoxItem.h"
 #include "vtkTriangleBar.h"
 
 #include <vtkColorTransferFunction.h>
+#include <vtkCommand.h>
 #include <vtkDataArray.h>
 #include <vtkGPUVolumeRayCastMapper.h>
 #include <vtkImageClip.h>
@@ -20,6 +23,8 @@
 #include <vtkObjectFactory.h>
 #include <vtkPiecewiseFunction.h>
 #include <vtkPlane.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
 #include <vtkSmartPointer.h>
 #include <vtkSmartVolumeMapper.h>
 #include <vtkTrivialProducer.h>
@@ -28,14 +33,21 @@
 #include <vtkVolume.h>
 #include <vtkVolumeProperty.h>
 
+#include <pqApplicationCore.h>
+#include <pqSettings.h>
 #include <vtkPVRenderView.h>
 #include <vtkPointData.h>
+#include <vtkSMProxy.h>
 #include <vtkSMViewProxy.h>
 
 #include <QCheckBox>
 #include <QFormLayout>
+#include <QFutureWatcher>
 #include <QSignalBlocker>
+#include <QSpinBox>
+#include <QTimer>
 #include <QVBoxLayout>
+#include <QtConcurrent>
 
 #include <cmath>
 
@@ -57,6 +69,12 @@ public:
 
 vtkStandardNewMacro(SmartVolumeMapper)
 
+static vtkSmartPointer<vtkImageData> buildPyramidLevel(
+  QSharedPointer<ImagePyramid> pyramid, int level)
+{
+  return pyramid->level(level);
+}
+
   ModuleVolume::ModuleVolume(QObject* parentObject)
   : Module(parentObject)
 {
@@ -81,6 +99,13 @@ vtkStandardNewMacro(SmartVolumeMapper)
             this->updateColorMap();
             emit this->renderNeeded();
           });
+
+  // Full resolution is restored once interaction has been idle for a while.
+  m_lodIdleTimer = new QTimer(this);
+  m_lodIdleTimer->setSingleShot(true);
+  m_lodIdleTimer->setInterval(500);
+  connect(m_lodIdleTimer, &QTimer::timeout, this,
+          &ModuleVolume::endLevelOfDetail);
 }
 
 ModuleVolume::~ModuleVolume()
@@ -138,6 +163,16 @@ bool ModuleVolume::initialize(DataSource* data, vtkSMViewProxy* vtkView)
   connect(data, &DataSource::componentNamesModified, this,
           &ModuleVolume::onComponentNamesModified);
 
+  m_interactor = vtkView->GetRenderWindow()->GetInteractor();
+  if (m_interactor) {
+    m_startInteractionObserver = m_interactor->AddObserver(
+      vtkCommand::StartInteractionEvent, this,
+      &ModuleVolume::onStartInteraction);
+    m_endInteractionObserver = m_interactor->AddObserver(
+      vtkCommand::EndInteractionEvent, this, &ModuleVolume::onEndInteraction);
+  }
+  updateLevelOfDetail();
+
   // Work around mapper bug on the mac, see the following issue for details:
   // https://github.com/OpenChemistry/tomviz/issues/1776
   // Should be removed when this is fixed.
@@ -151,7 +186,7 @@ bool ModuleVolume::initialize(DataSource* data, vtkSMViewProxy* vtkView)
 void ModuleVolume::resetRgbaMappingRanges()
 {
   // Combined range
-  computeRange(dataSource()->scalars(), m_rgbaMappingRangeAll.data());
+  computeCombinedRange(m_rgbaMappingRangeAll.data());
 
   // Individual ranges
   m_rgbaMappingRanges.clear();
@@ -171,7 +206,10 @@ std::array<double, 2> ModuleVolume::computeRange(const QString& component) const
 {
   std::array<double, 2> result;
   auto index = m_componentNames.indexOf(component);
-  dataSource()->scalars()->GetRange(result.data(), index);
+  result.fill(0.0);
+  if (auto stats = dataSource()->statistics()) {
+    stats->range(result.data(), index);
+  }
   return result;
 }
 
@@ -226,6 +264,7 @@ void ModuleVolume::onDataChanged()
   if (useRgbaMapping()) {
     updateRgbaMappingDataObject();
   }
+  updateLevelOfDetail();
   updatePanel();
 }
 
@@ -269,12 +308,17 @@ void ModuleVolume::updateMapperInput(DataSource* data)
   }
 }
 
-void ModuleVolume::computeRange(vtkDataArray* array, double range[2])
+void ModuleVolume::computeCombinedRange(double range[2]) const
 {
   range[0] = DBL_MAX;
   range[1] = -DBL_MAX;
-  for (int i = 0; i < array->GetNumberOfComponents(); ++i) {
-    auto* tmp = array->GetRange(i);
+  auto stats = dataSource()->statistics();
+  if (!stats) {
+    return;
+  }
+  for (int i = 0; i < stats->numberOfComponents(); ++i) {
+    double tmp[2];
+    stats->range(tmp, i);
     range[0] = std::min(range[0], tmp[0]);
     range[1] = std::max(range[1], tmp[1]);
   }
@@ -383,8 +427,8 @@ void ModuleVolume::updateColorMap()
           vtkImageData::SafeDownCast(dataSource()->dataObject());
         // See if the histogram is done, if it is then update the transfer
         // function.
-        if (auto histogram2D =
-              HistogramManager::instance().getHistogram2D(image)) {
+        if (auto histogram2D = HistogramManager::instance().getHistogram2D(
+              image, dataSource()->statistics())) {
           auto colorMap = vtkColorTransferFunction::SafeDownCast(
             this->colorMap()->GetClientSideObject());
           auto opacityMap = vtkPiecewiseFunction::SafeDownCast(
@@ -406,11 +450,17 @@ void ModuleVolume::updateColorMap()
 
   // BUG: volume mappers don't update property when LUT is changed and has an
   // older Mtime. Fix for now by forcing the LUT to update.
+  m_updatingColorMap = true;
   vtkObject::SafeDownCast(colorMap()->GetClientSideObject())->Modified();
+  m_updatingColorMap = false;
+
+  observeTransferFunctions();
 }
 
 bool ModuleVolume::finalize()
 {
+  removeObservers();
+  ++m_lodRequest;
   if (m_view) {
     m_view->RemovePropFromRenderer(m_volume);
     m_view->RemovePropFromRenderer(m_triangleBar);
@@ -501,6 +551,19 @@ void ModuleVolume::addToPanel(QWidget* panel)
   m_scalarsCombo->setOptions(dataSource(), this);
   m_controllers->formLayout()->insertRow(0, "Active Scalars", m_scalarsCombo);
 
+  m_lodBudgetSpinBox = new QSpinBox();
+  m_lodBudgetSpinBox->setRange(0, 1 << 20);
+  m_lodBudgetSpinBox->setSingleStep(64);
+  m_lodBudgetSpinBox->setSuffix(" MB");
+  m_lodBudgetSpinBox->setSpecialValueText("Off");
+  m_lodBudgetSpinBox->setToolTip(
+    "Volumes larger than this are rendered at a reduced resolution while "
+    "interacting with the view or editing the transfer function.");
+  m_lodBudgetSpinBox->setValue(
+    static_cast<int>(interactiveMemoryBudget() / (1024 * 1024)));
+  m_controllers->formLayout()->insertRow(1, "Interactive Budget",
+                                         m_lodBudgetSpinBox);
+
   QVBoxLayout* layout = new QVBoxLayout;
   panel->setLayout(layout);
 
@@ -546,6 +609,9 @@ void ModuleVolume::addToPanel(QWidget* panel)
           SLOT(setSolidity(const double)));
   connect(m_controllers, &ModuleVolumeWidget::allowMultiVolumeToggled, this,
           &ModuleVolume::onAllowMultiVolumeToggled);
+  connect(m_lodBudgetSpinBox, &QSpinBox::editingFinished, this, [this]() {
+    onInteractiveMemoryBudgetChanged(m_lodBudgetSpinBox->value());
+  });
 }
 
 void ModuleVolume::updatePanel()
@@ -587,7 +653,7 @@ void ModuleVolume::updatePanel()
     std::array<double, 2> minmax, sliderRange;
     if (allComponents) {
       minmax = m_rgbaMappingRangeAll;
-      computeRange(dataSource()->scalars(), sliderRange.data());
+      computeCombinedRange(sliderRange.data());
     } else {
       minmax = rangeForComponent(component);
       sliderRange = computeRange(component);
@@ -777,4 +843,176 @@ vtkVolume* ModuleVolume::getVolume()
   return m_volume;
 }
 
+vtkIdType ModuleVolume::interactiveMemoryBudget()
+{
+  auto settings = pqApplicationCore::instance()->settings();
+  auto megabytes =
+    settings->value("VolumeSettings.InteractiveMemoryBudget", 512).toInt();
+  return static_cast<vtkIdType>(megabytes) * 1024 * 1024;
+}
+
+void ModuleVolume::onInteractiveMemoryBudgetChanged(int megabytes)
+{
+  auto settings = pqApplicationCore::instance()->settings();
+  settings->setValue("VolumeSettings.InteractiveMemoryBudget", megabytes);
+  updateLevelOfDetail();
+}
+
+bool ModuleVolume::levelOfDetailAllowed()
+{
+  // The multi-volume renders the inputs of the volume mappers directly, and
+  // the Rgba mapping data object is not part of the pyramid.
+  auto& volumeManager = VolumeManager::instance();
+  bool multiVolume = volumeManager.allowMultiVolume(view()) &&
+                     volumeManager.volumeCount(view()) >= MULTI_VOLUME_SWITCH;
+  return !multiVolume && !useRgbaMapping() && visibility();
+}
+
+void ModuleVolume::updateLevelOfDetail()
+{
+  endLevelOfDetail();
+  m_lodImage = nullptr;
+  m_lodMapper->RemoveAllInputConnections(0);
+  ++m_lodRequest;
+
+  auto budget = interactiveMemoryBudget();
+  auto data = dataSource();
+  if (budget <= 0 || !data) {
+    return;
+  }
+
+  auto pyramid = data->imagePyramid();
+  if (!pyramid) {
+    return;
+  }
+
+  int level = pyramid->levelForBudget(budget);
+  if (level == 0) {
+    // The full resolution volume is small enough.
+    return;
+  } else if (level < 0) {
+    level = pyramid->numberOfLevels() - 1;
+  }
+  pyramid->setMemoryBudget(budget);
+
+  // Build the level in the background, from the snapshot of the data held by
+  // the pyramid. The full resolution volume is used until it is ready.
+  int request = m_lodRequest;
+  auto watcher = new QFutureWatcher<vtkSmartPointer<vtkImageData>>(this);
+  connect(watcher, &QFutureWatcherBase::finished, this,
+          [this, watcher, request]() {
+            // Levels of data modified while they were built are dropped.
+            if (request == m_lodRequest && watcher->result()) {
+              m_lodImage = watcher->result();
+              m_lodMapper->SetInputDataObject(m_lodImage);
+            }
+            watcher->deleteLater();
+          });
+  watcher->setFuture(QtConcurrent::run(buildPyramidLevel, pyramid, level));
+}
+
+void ModuleVolume::startLevelOfDetail()
+{
+  m_lodIdleTimer->stop();
+  if (m_lodActive || !m_lodImage || !levelOfDetailAllowed()) {
+    return;
+  }
+
+  m_lodMapper->SetScalarModeToUsePointFieldData();
+  m_lodMapper->SelectScalarArray(scalarsIndex());
+  m_lodMapper->SetBlendMode(m_volumeMapper->GetBlendMode());
+  m_lodMapper->SetVectorMode(m_volumeMapper->GetVectorMode());
+  m_lodMapper->SetUseJittering(m_volumeMapper->GetUseJittering());
+  m_lodMapper->SetClippingPlanes(m_volumeMapper->GetClippingPlanes());
+
+  // Swapping mappers rather than inputs keeps the full resolution volume
+  // uploaded, so switching back is cheap.
+  m_volume->SetMapper(m_lodMapper);
+  m_lodActive = true;
+}
+
+void ModuleVolume::endLevelOfDetail()
+{
+  m_lodIdleTimer->stop();
+  if (!m_lodActive) {
+    return;
+  }
+
+  m_volume->SetMapper(m_volumeMapper);
+  m_lodActive = false;
+  emit renderNeeded();
+}
+
+void ModuleVolume::onStartInteraction()
+{
+  startLevelOfDetail();
+}
+
+void ModuleVolume::onEndInteraction()
+{
+  if (m_lodActive) {
+    m_lodIdleTimer->start();
+  }
+}
+
+void ModuleVolume::onTransferFunctionModified()
+{
+  if (m_updatingColorMap) {
+    return;
+  }
+
+  startLevelOfDetail();
+  if (m_lodActive) {
+    m_lodIdleTimer->start();
+  }
+}
+
+void ModuleVolume::observeTransferFunctions()
+{
+  vtkObject* lut = colorMap() ? colorMap()->GetClientSideObject() : nullptr;
+  vtkObject* opacity =
+    opacityMap() ? opacityMap()->GetClientSideObject() : nullptr;
+
+  if (lut != m_observedColorMap) {
+    if (m_observedColorMap) {
+      m_observedColorMap->RemoveObserver(m_colorMapObserver);
+    }
+    m_observedColorMap = lut;
+    if (lut) {
+      m_colorMapObserver =
+        lut->AddObserver(vtkCommand::ModifiedEvent, this,
+                         &ModuleVolume::onTransferFunctionModified);
+    }
+  }
+
+  if (opacity != m_observedOpacityMap) {
+    if (m_observedOpacityMap) {
+      m_observedOpacityMap->RemoveObserver(m_opacityMapObserver);
+    }
+    m_observedOpacityMap = opacity;
+    if (opacity) {
+      m_opacityMapObserver =
+        opacity->AddObserver(vtkCommand::ModifiedEvent, this,
+                             &ModuleVolume::onTransferFunctionModified);
+    }
+  }
+}
+
+void ModuleVolume::removeObservers()
+{
+  if (m_interactor) {
+    m_interactor->RemoveObserver(m_startInteractionObserver);
+    m_interactor->RemoveObserver(m_endInteractionObserver);
+    m_interactor = nullptr;
+  }
+  if (m_observedColorMap) {
+    m_observedColorMap->RemoveObserver(m_colorMapObserver);
+    m_observedColorMap = nullptr;
+  }
+  if (m_observedOpacityMap) {
+    m_observedOpacityMap->RemoveObserver(m_opacityMapObserver);
+    m_observedOpacityMap = nullptr;
+  }
+}
+
 } // end of namespace tomviz
@@ -7,6 +7,7 @@
 #include "Module.h"
 
 #include <vtkNew.h>
+#include <vtkSmartPointer.h>
 #include <vtkWeakPointer.h>
 
 #include <QMap>
@@ -14,12 +15,16 @@
 
 #include <array>
 
+class QSpinBox;
+class QTimer;
+
 class vtkPVRenderView;
 
 class vtkImageClip;
 class vtkImageData;
 class vtkPiecewiseFunction;
 class vtkPlane;
+class vtkRenderWindowInteractor;
 class vtkTriangleBar;
 class vtkVolumeProperty;
 class vtkVolume;
@@ -85,11 +90,21 @@ private:
     return m_rgbaMappingCombineComponents;
   }
   std::array<double, 2> computeRange(const QString& component) const;
-  static void computeRange(vtkDataArray* array, double range[2]);
+  // Union of the ranges of all the components.
+  void computeCombinedRange(double range[2]) const;
   std::array<double, 2>& rangeForComponent(const QString& component);
   std::vector<std::array<double, 2>> activeRgbaRanges();
   void resetComponentNames();
 
+  // Level of detail, a coarse level of the data source pyramid is rendered
+  // during camera interaction and transfer function edits.
+  static vtkIdType interactiveMemoryBudget();
+  bool levelOfDetailAllowed();
+  void updateLevelOfDetail();
+  void startLevelOfDetail();
+  void observeTransferFunctions();
+  void removeObservers();
+
   vtkWeakPointer<vtkPVRenderView> m_view;
   vtkNew<vtkVolume> m_volume;
   vtkNew<SmartVolumeMapper> m_volumeMapper;
@@ -113,6 +128,22 @@ private:
   // Keep track of the component names for renaming...
   QStringList m_componentNames;
 
+  vtkNew<SmartVolumeMapper> m_lodMapper;
+  vtkSmartPointer<vtkImageData> m_lodImage;
+  bool m_lodActive = false;
+  bool m_updatingColorMap = false;
+  // Identifies the latest pyramid level request, stale results are dropped.
+  int m_lodRequest = 0;
+  QTimer* m_lodIdleTimer = nullptr;
+  QPointer<QSpinBox> m_lodBudgetSpinBox;
+  vtkWeakPointer<vtkRenderWindowInteractor> m_interactor;
+  unsigned long m_startInteractionObserver = 0;
+  unsigned long m_endInteractionObserver = 0;
+  vtkWeakPointer<vtkObject> m_observedColorMap;
+  vtkWeakPointer<vtkObject> m_observedOpacityMap;
+  unsigned long m_colorMapObserver = 0;
+  unsigned long m_opacityMapObserver = 0;
+
 private slots:
   /**
    * Actuator methods for m_volumeMapper.  These slots should be connected to
@@ -139,6 +170,12 @@ private slots:
 
   void onDataChanged();
   void onComponentNamesModified();
+
+  void onStartInteraction();
+  void onEndInteraction();
+  void onTransferFunctionModified();
+  void endLevelOfDetail();
+  void onInteractiveMemoryBudgetChanged(int megabytes);
 };
 } // namespace tomviz
 
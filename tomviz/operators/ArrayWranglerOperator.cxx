@@ -3,14 +3,12 @@
 
 #include "ArrayWranglerOperator.h"
 
+#include "ArrayConversion.h"
 #include "EditOperatorWidget.h"
 
-#include <vtkFloatArray.h>
+#include <vtkDataArray.h>
 #include <vtkImageData.h>
-#include <vtkNew.h>
 #include <vtkPointData.h>
-#include <vtkTypeUInt16Array.h>
-#include <vtkTypeUInt8Array.h>
 
 #include <QComboBox>
 #include <QDebug>
@@ -96,69 +94,6 @@ private:
 
 #include "ArrayWranglerOperator.moc"
 
-namespace {
-
-// This is specifically designed for unsigned integer output types
-// The template is disabled for other output types
-template <typename vtkInputDataType, typename vtkOutputArrayType,
-          typename = std::enable_if<std::is_unsigned<
-            decltype(vtkOutputArrayType::GetDataTypeValueMax())>::value>>
-void wrangleVtkArrayTypeUnsigned(vtkOutputArrayType* array, int nComps,
-                                 int componentToKeep, int nTuples, void* data,
-                                 double oldrange[2])
-{
-  // We can't divide by zero...
-  // assert(oldrange[1] != oldrange[0]);
-
-  // GetDataTypeValueMax() is supposed to return the native data type
-  auto newmax = vtkOutputArrayType::GetDataTypeValueMax();
-  using outputType = decltype(newmax);
-
-  // We will adjust the old range to the new range as follows:
-  // new = ((old - oldmin) / oldrange * newrange) + newmin
-  // For unsigned ints, newrange == newmax, and newmin == 0
-
-  // Can be simplified to:
-  // new = ((old - oldmin) * multiplier;
-  // where multiplier is newmax / oldrange
-
-  double multiplier = newmax / (oldrange[1] - oldrange[0]);
-
-  auto d = static_cast<vtkInputDataType*>(data);
-  auto a = static_cast<outputType*>(array->GetVoidPointer(0));
-  for (vtkIdType i = 0; i < nTuples; ++i) {
-    // Add 0.5 before casting to ensure flooring rounds correctly
-    // We use a stride here to skip unwanted components in the source
-    a[i] = static_cast<outputType>(
-      (d[i * nComps + componentToKeep] - oldrange[0]) * multiplier + 0.5);
-  }
-}
-
-template <typename vtkOutputArrayType>
-void applyGenericTransform(vtkImageData* imageData, int componentToKeep)
-{
-  auto scalars = imageData->GetPointData()->GetScalars();
-
-  // Get the range to input into the wrangle function
-  double range[2];
-  scalars->GetFiniteRange(range);
-
-  vtkNew<vtkOutputArrayType> outputArray;
-  outputArray->SetNumberOfComponents(1); // We will always use one component
-  outputArray->SetNumberOfTuples(scalars->GetNumberOfTuples());
-  outputArray->SetName(scalars->GetName());
-
-  switch (scalars->GetDataType()) {
-    vtkTemplateMacro(wrangleVtkArrayTypeUnsigned<VTK_TT>(
-      outputArray.Get(), scalars->GetNumberOfComponents(), componentToKeep,
-      scalars->GetNumberOfTuples(), scalars->GetVoidPointer(0), range));
-  }
-
-  imageData->GetPointData()->RemoveArray(scalars->GetName());
-  imageData->GetPointData()->SetScalars(outputArray);
-}
-} // namespace
-
 namespace tomviz {
 
 ArrayWranglerOperator::ArrayWranglerOperator(QObject* p) : Operator(p)
@@ -189,19 +124,30 @@ bool ArrayWranglerOperator::applyTransform(vtkDataObject* data)
     return false;
   }
 
-  // Use a template to make it easier to add other types...
+  int type;
   switch (m_outputType) {
     case OutputType::UInt8:
-      applyGenericTransform<vtkTypeUInt8Array>(imageData, m_componentToKeep);
+      type = VTK_TYPE_UINT8;
       break;
     case OutputType::UInt16:
-      applyGenericTransform<vtkTypeUInt16Array>(imageData, m_componentToKeep);
+      type = VTK_TYPE_UINT16;
       break;
     default:
       qDebug() << "Error in" << __FUNCTION__ << ": unknown output type!";
       return false;
   }
 
+  // The component is rescaled from its finite range to the full range of the
+  // output type. The data is our own copy, its buffer can hold the output.
+  auto outputArray =
+    ArrayConversion::rescaleComponent(scalars, m_componentToKeep, type, true);
+  if (!outputArray) {
+    qDebug() << "Error in" << __FUNCTION__ << ": unable to convert the array!";
+    return false;
+  }
+  imageData->GetPointData()->RemoveArray(scalars->GetName());
+  imageData->GetPointData()->SetScalars(outputArray);
+
   return true;
 }
 
@@ -3,24 +3,12 @@
 
 #include "ConvertToFloatOperator.h"
 
-#include <vtkFloatArray.h>
+#include "ArrayConversion.h"
+
+#include <vtkDataArray.h>
 #include <vtkImageData.h>
-#include <vtkNew.h>
 #include <vtkPointData.h>
 
-namespace {
-
-template <typename T>
-void convertToFloat(vtkFloatArray* fArray, int nComps, int nTuples, void* data)
-{
-  auto d = static_cast<T*>(data);
-  auto a = static_cast<float*>(fArray->GetVoidPointer(0));
-  for (int i = 0; i < nComps * nTuples; ++i) {
-    a[i] = static_cast<float>(d[i]);
-  }
-}
-} // namespace
-
 namespace tomviz {
 
 ConvertToFloatOperator::ConvertToFloatOperator(QObject* p) : Operator(p) {}
@@ -38,14 +26,13 @@ bool ConvertToFloatOperator::applyTransform(vtkDataObject* data)
     return false;
   }
   auto scalars = imageData->GetPointData()->GetScalars();
-  vtkNew<vtkFloatArray> floatArray;
-  floatArray->SetNumberOfComponents(scalars->GetNumberOfComponents());
-  floatArray->SetNumberOfTuples(scalars->GetNumberOfTuples());
-  floatArray->SetName(scalars->GetName());
-  switch (scalars->GetDataType()) {
-    vtkTemplateMacro(convertToFloat<VTK_TT>(
-      floatArray.Get(), scalars->GetNumberOfComponents(),
-      scalars->GetNumberOfTuples(), scalars->GetVoidPointer(0)));
+  // The data is our own copy, its buffer can hold the output.
+  auto floatArray = ArrayConversion::toFloat(scalars, true);
+  if (!floatArray) {
+    return false;
+  }
+  if (floatArray == scalars) {
+    return true;
   }
   imageData->GetPointData()->RemoveArray(scalars->GetName());
   imageData->GetPointData()->SetScalars(floatArray);
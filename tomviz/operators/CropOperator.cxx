@@ -4,6 +4,7 @@
 #include "CropOperator.h"
 
 #include "EditOperatorWidget.h"
+#include "RegionCopy.h"
 #include "SelectVolumeWidget.h"
 
 #include <vtkExtractVOI.h>
@@ -84,6 +85,12 @@ QIcon CropOperator::icon() const
 
 bool CropOperator::applyTransform(vtkDataObject* data)
 {
+  // The arrays are cropped in place, without a copy of the volume, when they
+  // can be.
+  if (RegionCopy::crop(vtkImageData::SafeDownCast(data), m_bounds)) {
+    return true;
+  }
+
   vtkNew<vtkExtractVOI> extractor;
   extractor->SetVOI(m_bounds);
   extractor->SetInputDataObject(data);
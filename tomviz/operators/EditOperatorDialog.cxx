@@ -9,6 +9,7 @@
 #include "ModuleManager.h"
 #include "Operator.h"
 #include "Pipeline.h"
+#include "Tvh5Multiscale.h"
 #include "Utilities.h"
 
 #include <pqApplicationCore.h>
@@ -61,6 +62,8 @@ EditOperatorDialog::EditOperatorDialog(Operator* op, DataSource* dataSource,
   : Superclass(p), Internals(new EditOperatorDialog::EODInternals())
 {
   Q_ASSERT(op);
+  // Editors are set up from the data, which must be at full resolution.
+  Tvh5Multiscale::finishAll();
   this->Internals->Op = op;
   this->Internals->dataSource = dataSource;
   this->Internals->needsToBeAdded = needToAddOperator;
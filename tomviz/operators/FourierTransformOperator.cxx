@@ -0,0 +1,207 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "FourierTransformOperator.h"
+
+#include "EditOperatorWidget.h"
+#include "FourierTransform.h"
+
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+#include <QDebug>
+#include <QDoubleSpinBox>
+#include <QFormLayout>
+#include <QPointer>
+
+#include <vector>
+
+namespace {
+
+class BandPassWidget : public tomviz::EditOperatorWidget
+{
+  Q_OBJECT
+
+public:
+  BandPassWidget(tomviz::FourierTransformOperator* source, QWidget* p)
+    : tomviz::EditOperatorWidget(p), m_operator(source)
+  {
+    // The corners of the spectrum are at sqrt(3) times the Nyquist frequency.
+    m_low = new QDoubleSpinBox(this);
+    m_low->setRange(0.0, 1.8);
+    m_low->setSingleStep(0.05);
+    m_low->setDecimals(3);
+    m_low->setValue(source->lowFrequency());
+
+    m_high = new QDoubleSpinBox(this);
+    m_high->setRange(0.0, 1.8);
+    m_high->setSingleStep(0.05);
+    m_high->setDecimals(3);
+    m_high->setValue(source->highFrequency());
+
+    auto* layout = new QFormLayout(this);
+    layout->addRow("Low frequency (fraction of Nyquist):", m_low);
+    layout->addRow("High frequency (fraction of Nyquist):", m_high);
+    setLayout(layout);
+  }
+
+  void applyChangesToOperator() override
+  {
+    if (m_operator) {
+      m_operator->setBand(m_low->value(), m_high->value());
+    }
+  }
+
+private:
+  QPointer<tomviz::FourierTransformOperator> m_operator;
+  QDoubleSpinBox* m_low;
+  QDoubleSpinBox* m_high;
+};
+} // namespace
+
+#include "FourierTransformOperator.moc"
+
+namespace tomviz {
+
+FourierTransformOperator::FourierTransformOperator(QObject* p) : Operator(p)
+{
+  setSupportsCancel(true);
+}
+
+QString FourierTransformOperator::label() const
+{
+  switch (m_filter) {
+    case Filter::HannWindow:
+      return "Hann Window";
+    case Filter::BandPass:
+      return "Band Pass Filter";
+    default:
+      return "FFT (abs log)";
+  }
+}
+
+QIcon FourierTransformOperator::icon() const
+{
+  return QIcon();
+}
+
+void FourierTransformOperator::setBand(double low, double high)
+{
+  m_lowFrequency = low;
+  m_highFrequency = high;
+}
+
+bool FourierTransformOperator::applyTransform(vtkDataObject* data)
+{
+  auto imageData = vtkImageData::SafeDownCast(data);
+  // sanity check
+  if (!imageData) {
+    return false;
+  }
+  auto pointData = imageData->GetPointData();
+  auto scalars = pointData->GetScalars();
+  if (!scalars || scalars->GetNumberOfComponents() != 1) {
+    qCritical() << label() << "requires single component scalars";
+    return false;
+  }
+
+  int dims[3];
+  imageData->GetDimensions(dims);
+
+  if (m_filter == Filter::HannWindow) {
+    return FourierTransform::hannWindow(scalars, dims);
+  }
+
+  // The progress is updated, and the cancelation checked, after each axis of
+  // the transforms.
+  const int numAxes = 3;
+  setTotalProgressSteps(m_filter == Filter::BandPass ? 2 * numAxes
+                                                     : numAxes + 1);
+  setProgressMessage("Forward transform");
+  int step = 0;
+  auto axisDone = [this, &step](int) {
+    setProgressStep(++step);
+    return !isCanceled();
+  };
+
+  std::vector<FourierTransform::Complex> spectrum(
+    FourierTransform::spectrumSize(dims));
+  if (!FourierTransform::forward(scalars, dims, spectrum.data(), axisDone)) {
+    return false;
+  }
+
+  // The scalars are not needed anymore, the result is written into them if
+  // they are float. Otherwise they are replaced by the result before it is
+  // allocated, which releases them.
+  vtkSmartPointer<vtkFloatArray> result = vtkFloatArray::FastDownCast(scalars);
+  if (!result) {
+    result = vtkSmartPointer<vtkFloatArray>::New();
+    result->SetName(scalars->GetName());
+    pointData->SetScalars(result);
+    scalars = nullptr;
+    result->SetNumberOfTuples(imageData->GetNumberOfPoints());
+  }
+
+  auto values = static_cast<float*>(result->GetVoidPointer(0));
+  if (m_filter == Filter::BandPass) {
+    FourierTransform::bandPass(spectrum.data(), dims, m_lowFrequency,
+                               m_highFrequency);
+    setProgressMessage("Inverse transform");
+    if (!FourierTransform::inverse(spectrum.data(), dims, values, axisDone)) {
+      return false;
+    }
+  } else {
+    FourierTransform::absLog(spectrum.data(), dims, values);
+    setProgressStep(++step);
+  }
+
+  result->Modified();
+  pointData->SetScalars(result);
+  return true;
+}
+
+QJsonObject FourierTransformOperator::serialize() const
+{
+  auto json = Operator::serialize();
+  json["filter"] = static_cast<int>(m_filter);
+  if (m_filter == Filter::BandPass) {
+    json["lowFrequency"] = m_lowFrequency;
+    json["highFrequency"] = m_highFrequency;
+  }
+  return json;
+}
+
+bool FourierTransformOperator::deserialize(const QJsonObject& json)
+{
+  if (json.contains("filter")) {
+    m_filter = static_cast<Filter>(json["filter"].toInt());
+  }
+  if (json.contains("lowFrequency")) {
+    m_lowFrequency = json["lowFrequency"].toDouble();
+  }
+  if (json.contains("highFrequency")) {
+    m_highFrequency = json["highFrequency"].toDouble();
+  }
+  return true;
+}
+
+Operator* FourierTransformOperator::clone() const
+{
+  auto* other = new FourierTransformOperator();
+  other->setFilter(m_filter);
+  other->setBand(m_lowFrequency, m_highFrequency);
+  return other;
+}
+
+EditOperatorWidget* FourierTransformOperator::getEditorContentsWithData(
+  QWidget* p, vtkSmartPointer<vtkImageData>)
+{
+  if (m_filter != Filter::BandPass) {
+    return nullptr;
+  }
+  return new BandPassWidget(this, p);
+}
+
+} // namespace tomviz
@@ -0,0 +1,56 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizFourierTransformOperator_h
+#define tomvizFourierTransformOperator_h
+
+#include "Operator.h"
+
+namespace tomviz {
+
+/// The Fourier transform based filters, see FourierTransform.
+class FourierTransformOperator : public Operator
+{
+  Q_OBJECT
+
+public:
+  enum class Filter
+  {
+    AbsLog,
+    HannWindow,
+    BandPass
+  };
+
+  FourierTransformOperator(QObject* parent = nullptr);
+
+  QString label() const override;
+  QIcon icon() const override;
+  Operator* clone() const override;
+
+  bool applyTransform(vtkDataObject* data) override;
+
+  EditOperatorWidget* getEditorContentsWithData(
+    QWidget* parent, vtkSmartPointer<vtkImageData> data) override;
+  bool hasCustomUI() const override { return m_filter == Filter::BandPass; }
+
+  QJsonObject serialize() const override;
+  bool deserialize(const QJsonObject& json) override;
+
+  void setFilter(Filter filter) { m_filter = filter; }
+  Filter filter() const { return m_filter; }
+
+  /// The band of the band pass filter, as fractions of the Nyquist frequency.
+  void setBand(double low, double high);
+  double lowFrequency() const { return m_lowFrequency; }
+  double highFrequency() const { return m_highFrequency; }
+
+private:
+  Filter m_filter = Filter::AbsLog;
+  double m_lowFrequency = 0.0;
+  double m_highFrequency = 0.5;
+
+  Q_DISABLE_COPY(FourierTransformOperator)
+};
+} // namespace tomviz
+
+#endif
@@ -0,0 +1,159 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "LabelStatisticsOperator.h"
+
+#include "LabelStatistics.h"
+#include "OperatorResult.h"
+
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkTable.h>
+
+#include <QDebug>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Slices accumulated between progress updates.
+const int ProgressSteps = 100;
+
+vtkDoubleArray* addColumn(vtkTable* table, const std::string& name)
+{
+  vtkNew<vtkDoubleArray> column;
+  column->SetName(name.c_str());
+  table->AddColumn(column);
+  return column;
+}
+
+void fillTable(const std::vector<tomviz::LabelStatistics::Object>& objects,
+               double voxelVolume, vtkTable* table)
+{
+  const std::string axes[3] = { "X", "Y", "Z" };
+  vtkNew<vtkIdTypeArray> labels;
+  labels->SetName("Label");
+  table->AddColumn(labels);
+  vtkNew<vtkIdTypeArray> voxels;
+  voxels->SetName("VoxelCount");
+  table->AddColumn(voxels);
+  auto volume = addColumn(table, "Volume");
+
+  vtkDoubleArray* centroid[3];
+  vtkDoubleArray* bounds[6];
+  vtkDoubleArray* moments[3];
+  vtkDoubleArray* principalAxes[3][3];
+  for (int i = 0; i < 3; ++i) {
+    centroid[i] = addColumn(table, "Centroid" + axes[i]);
+  }
+  for (int i = 0; i < 3; ++i) {
+    bounds[2 * i] = addColumn(table, "Min" + axes[i]);
+    bounds[2 * i + 1] = addColumn(table, "Max" + axes[i]);
+  }
+  for (int k = 0; k < 3; ++k) {
+    const std::string n = std::to_string(k + 1);
+    moments[k] = addColumn(table, "PrincipalMoment" + n);
+    for (int i = 0; i < 3; ++i) {
+      principalAxes[k][i] = addColumn(table, "PrincipalAxis" + n + axes[i]);
+    }
+  }
+
+  table->SetNumberOfRows(static_cast<vtkIdType>(objects.size()));
+  for (size_t r = 0; r < objects.size(); ++r) {
+    const auto& object = objects[r];
+    const vtkIdType row = static_cast<vtkIdType>(r);
+    labels->SetValue(row, object.label);
+    voxels->SetValue(row, object.voxels);
+    volume->SetValue(row, object.voxels * voxelVolume);
+    for (int i = 0; i < 3; ++i) {
+      centroid[i]->SetValue(row, object.centroid[i]);
+    }
+    for (int i = 0; i < 6; ++i) {
+      bounds[i]->SetValue(row, object.bounds[i]);
+    }
+    for (int k = 0; k < 3; ++k) {
+      moments[k]->SetValue(row, object.moments[k]);
+      for (int i = 0; i < 3; ++i) {
+        principalAxes[k][i]->SetValue(row, object.axes[k][i]);
+      }
+    }
+  }
+}
+} // namespace
+
+namespace tomviz {
+
+LabelStatisticsOperator::LabelStatisticsOperator(QObject* p) : Operator(p)
+{
+  setNumberOfResults(1);
+  auto res = resultAt(0);
+  res->setName("label_statistics");
+  res->setLabel("Label Statistics");
+  vtkNew<vtkTable> table;
+  setResult(0, table);
+  setSupportsCancel(true);
+}
+
+QIcon LabelStatisticsOperator::icon() const
+{
+  return QIcon();
+}
+
+bool LabelStatisticsOperator::applyTransform(vtkDataObject* data)
+{
+  auto imageData = vtkImageData::SafeDownCast(data);
+  // sanity check
+  if (!imageData) {
+    return false;
+  }
+  auto scalars = imageData->GetPointData()->GetScalars();
+  if (!scalars) {
+    return false;
+  }
+
+  int dims[3];
+  imageData->GetDimensions(dims);
+  LabelStatistics statistics(dims);
+  const int slabSize = std::max(1, dims[2] / ProgressSteps);
+  setTotalProgressSteps(dims[2]);
+  setProgressMessage("Computing label object statistics");
+  for (int first = 0; first < dims[2]; first += slabSize) {
+    if (isCanceled()) {
+      return false;
+    }
+    const int count = std::min(slabSize, dims[2] - first);
+    if (!statistics.accumulate(scalars, first, count)) {
+      qCritical() << label()
+                  << "works only on single component, integral label maps";
+      return false;
+    }
+    setProgressStep(first + count);
+  }
+
+  double* spacing = imageData->GetSpacing();
+  double origin[3];
+  imageData->GetOrigin(origin);
+  const int* extent = imageData->GetExtent();
+  for (int i = 0; i < 3; ++i) {
+    origin[i] += spacing[i] * extent[2 * i];
+  }
+
+  vtkNew<vtkTable> table;
+  fillTable(statistics.objects(origin, spacing),
+            spacing[0] * spacing[1] * spacing[2], table);
+  setResult(0, table);
+  return true;
+}
+
+Operator* LabelStatisticsOperator::clone() const
+{
+  return new LabelStatisticsOperator();
+}
+
+} // namespace tomviz
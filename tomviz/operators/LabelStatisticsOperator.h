@@ -0,0 +1,32 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizLabelStatisticsOperator_h
+#define tomvizLabelStatisticsOperator_h
+
+#include "Operator.h"
+
+namespace tomviz {
+
+/// Tabulates the voxel count, volume, centroid, bounding box and principal
+/// axes of every object of a label map, see LabelStatistics. The label map
+/// itself is left unchanged.
+class LabelStatisticsOperator : public Operator
+{
+  Q_OBJECT
+
+public:
+  LabelStatisticsOperator(QObject* parent = nullptr);
+
+  QString label() const override { return "Label Object Statistics"; }
+  QIcon icon() const override;
+  Operator* clone() const override;
+
+  bool applyTransform(vtkDataObject* data) override;
+
+private:
+  Q_DISABLE_COPY(LabelStatisticsOperator)
+};
+} // namespace tomviz
+
+#endif
@@ -7,10 +7,16 @@
 #include "ConvertToFloatOperator.h"
 #include "ConvertToVolumeOperator.h"
 #include "CropOperator.h"
+#include "FourierTransformOperator.h"
+#include "LabelStatisticsOperator.h"
 #include "OperatorPython.h"
+#include "PoreSizeDistributionOperator.h"
 #include "ReconstructionOperator.h"
 #include "SetTiltAnglesOperator.h"
 #include "SnapshotOperator.h"
+#include "TiltSeriesPreprocessingOperator.h"
+#include "TortuosityOperator.h"
+#include "TotalVariationOperator.h"
 #include "TranslateAlignOperator.h"
 #include "TransposeDataOperator.h"
 #include <QDebug>
@@ -38,9 +44,15 @@ QList<QString> OperatorFactory::operatorTypes()
         << "ConvertToVolume"
         << "Crop"
         << "CxxReconstruction"
+        << "FourierTransform"
+        << "LabelStatistics"
+        << "PoreSizeDistribution"
         << "Python"
         << "SetTiltAngles"
         << "Snapshot"
+        << "TiltSeriesPreprocessing"
+        << "Tortuosity"
+        << "TotalVariation"
         << "TranslateAlign"
         << "TransposeData";
   return reply;
@@ -73,6 +85,12 @@ Operator* OperatorFactory::createOperator(const QString& type, DataSource* ds)
     op = new CropOperator(ds);
   } else if (type == "CxxReconstruction") {
     op = new ReconstructionOperator(ds);
+  } else if (type == "FourierTransform") {
+    op = new FourierTransformOperator(ds);
+  } else if (type == "LabelStatistics") {
+    op = new LabelStatisticsOperator(ds);
+  } else if (type == "PoreSizeDistribution") {
+    op = new PoreSizeDistributionOperator(ds);
   } else if (type == "SetTiltAngles") {
     op = new SetTiltAnglesOperator(ds);
   } else if (type == "TranslateAlign") {
@@ -81,6 +99,12 @@ Operator* OperatorFactory::createOperator(const QString& type, DataSource* ds)
     op = new TransposeDataOperator(ds);
   } else if (type == "Snapshot") {
     op = new SnapshotOperator(ds);
+  } else if (type == "TiltSeriesPreprocessing") {
+    op = new TiltSeriesPreprocessingOperator(ds);
+  } else if (type == "Tortuosity") {
+    op = new TortuosityOperator(ds);
+  } else if (type == "TotalVariation") {
+    op = new TotalVariationOperator(ds);
   }
   return op;
 }
@@ -105,6 +129,15 @@ const char* OperatorFactory::operatorType(const Operator* op)
   if (qobject_cast<const ReconstructionOperator*>(op)) {
     return "CxxReconstruction";
   }
+  if (qobject_cast<const FourierTransformOperator*>(op)) {
+    return "FourierTransform";
+  }
+  if (qobject_cast<const LabelStatisticsOperator*>(op)) {
+    return "LabelStatistics";
+  }
+  if (qobject_cast<const PoreSizeDistributionOperator*>(op)) {
+    return "PoreSizeDistribution";
+  }
   if (qobject_cast<const SetTiltAnglesOperator*>(op)) {
     return "SetTiltAngles";
   }
@@ -117,6 +150,15 @@ const char* OperatorFactory::operatorType(const Operator* op)
   if (qobject_cast<const SnapshotOperator*>(op)) {
     return "Snapshot";
   }
+  if (qobject_cast<const TiltSeriesPreprocessingOperator*>(op)) {
+    return "TiltSeriesPreprocessing";
+  }
+  if (qobject_cast<const TortuosityOperator*>(op)) {
+    return "Tortuosity";
+  }
+  if (qobject_cast<const TotalVariationOperator*>(op)) {
+    return "TotalVariation";
+  }
   return nullptr;
 }
 
@@ -3,6 +3,7 @@
 
 #include "OperatorPython.h"
 
+#include <QCryptographicHash>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -331,12 +332,19 @@ void OperatorPython::setScript(const QString& str)
         return;
       }
 
+      // The lookups are cached on the script, the operators with the same
+      // script find their transform alike.
+      Python::Object key(QString(
+        QCryptographicHash::hash(m_script.toUtf8(), QCryptographicHash::Sha1)
+          .toHex()));
+
       // Create capsule to hold the pointer to the operator in the python world
-      Python::Tuple findArgs(2);
+      Python::Tuple findArgs(3);
       Python::Capsule op(this);
 
       findArgs.set(0, d->TransformModule);
       findArgs.set(1, op);
+      findArgs.set(2, key);
 
       d->TransformMethod = d->FindTransformFunction.call(findArgs);
       if (!d->TransformMethod.isValid()) {
@@ -344,8 +352,9 @@ void OperatorPython::setScript(const QString& str)
         return;
       }
 
-      Python::Tuple isArgs(1);
+      Python::Tuple isArgs(2);
       isArgs.set(0, d->TransformModule);
+      isArgs.set(1, key);
 
       result = d->IsCancelableFunction.call(isArgs);
       if (!result.isValid()) {
@@ -0,0 +1,276 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "PoreSizeDistributionOperator.h"
+
+#include "EditOperatorWidget.h"
+#include "LocalThickness.h"
+#include "OperatorResult.h"
+
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkTable.h>
+
+#include <QCheckBox>
+#include <QDebug>
+#include <QDoubleSpinBox>
+#include <QFormLayout>
+#include <QJsonObject>
+#include <QPointer>
+#include <QSpinBox>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+class PoreSizeDistributionWidget : public tomviz::EditOperatorWidget
+{
+  Q_OBJECT
+
+public:
+  PoreSizeDistributionWidget(tomviz::PoreSizeDistributionOperator* source,
+                             vtkImageData* data, QWidget* p)
+    : tomviz::EditOperatorWidget(p), m_operator(source)
+  {
+    auto* layout = new QFormLayout(this);
+    m_threshold = new QDoubleSpinBox(this);
+    m_threshold->setDecimals(3);
+    double range[2] = { 0.0, 255.0 };
+    auto scalars = data ? data->GetPointData()->GetScalars() : nullptr;
+    if (scalars) {
+      scalars->GetRange(range);
+    }
+    m_threshold->setRange(std::min(range[0], source->threshold()),
+                          std::max(range[1], source->threshold()));
+    m_threshold->setValue(source->threshold());
+    m_threshold->setToolTip("Scalars above the threshold are matter, the "
+                            "others are pores.");
+    layout->addRow("Threshold:", m_threshold);
+
+    m_radiusSpacing = new QSpinBox(this);
+    m_radiusSpacing->setRange(1, 10000);
+    m_radiusSpacing->setValue(source->radiusSpacing());
+    layout->addRow("Spacing between radii:", m_radiusSpacing);
+
+    m_thicknessMap = new QCheckBox(this);
+    m_thicknessMap->setChecked(source->thicknessMap());
+    layout->addRow("Add the local thickness map:", m_thicknessMap);
+    setLayout(layout);
+  }
+
+  void applyChangesToOperator() override
+  {
+    if (!m_operator) {
+      return;
+    }
+    m_operator->setThreshold(m_threshold->value());
+    m_operator->setRadiusSpacing(m_radiusSpacing->value());
+    m_operator->setThicknessMap(m_thicknessMap->isChecked());
+  }
+
+private:
+  QPointer<tomviz::PoreSizeDistributionOperator> m_operator;
+  QDoubleSpinBox* m_threshold;
+  QSpinBox* m_radiusSpacing;
+  QCheckBox* m_thicknessMap;
+};
+
+// 0 for the matter, infinite for the pores, the input of the distance
+// transform.
+template <typename T>
+void segment(const T* values, vtkIdType size, double threshold, float* pores)
+{
+  const float infinity = std::numeric_limits<float>::infinity();
+  vtkSMPTools::For(0, size, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i) {
+      pores[i] = values[i] > threshold ? 0.0f : infinity;
+    }
+  });
+}
+} // namespace
+
+#include "PoreSizeDistributionOperator.moc"
+
+namespace tomviz {
+
+PoreSizeDistributionOperator::PoreSizeDistributionOperator(QObject* p)
+  : Operator(p)
+{
+  setNumberOfResults(1);
+  auto res = resultAt(0);
+  res->setName("pore_size_distribution");
+  res->setLabel("Pore Size Distribution");
+  vtkNew<vtkTable> table;
+  setResult(0, table);
+  setSupportsCancel(true);
+}
+
+QIcon PoreSizeDistributionOperator::icon() const
+{
+  return QIcon();
+}
+
+bool PoreSizeDistributionOperator::applyTransform(vtkDataObject* data)
+{
+  auto imageData = vtkImageData::SafeDownCast(data);
+  // sanity check
+  if (!imageData) {
+    return false;
+  }
+  auto scalars = imageData->GetPointData()->GetScalars();
+  if (!scalars || scalars->GetNumberOfComponents() != 1) {
+    qCritical() << label() << "requires single component scalars";
+    return false;
+  }
+
+  int dims[3];
+  imageData->GetDimensions(dims);
+  const vtkIdType sliceSize = static_cast<vtkIdType>(dims[0]) * dims[1];
+  const vtkIdType size = sliceSize * dims[2];
+
+  // The squared distances are computed in the new scalars.
+  vtkNew<vtkFloatArray> distances;
+  distances->SetName(scalars->GetName());
+  distances->SetNumberOfTuples(size);
+  float* distanceValues = distances->GetPointer(0);
+  switch (scalars->GetDataType()) {
+    vtkTemplateMacro(segment(static_cast<const VTK_TT*>(
+                               scalars->GetVoidPointer(0)),
+                             size, m_threshold, distanceValues));
+    default:
+      return false;
+  }
+
+  // Each pass of the distance transform counts as many steps as the slices.
+  setTotalProgressSteps(4 * dims[2]);
+  setProgressMessage("Computing the distance map");
+  for (int axis = 0; axis < 3; ++axis) {
+    if (isCanceled()) {
+      return false;
+    }
+    LocalThickness::distanceTransform(distanceValues, dims, axis);
+    setProgressStep((axis + 1) * dims[2]);
+  }
+
+  setProgressMessage("Computing the local thickness");
+  LocalThickness localThickness(distanceValues, dims);
+  const int maximumRadius = localThickness.maximumRadius();
+  vtkNew<vtkFloatArray> thicknessMap;
+  std::vector<float> block;
+  if (m_thicknessMap) {
+    thicknessMap->SetName("LocalThickness");
+    thicknessMap->SetNumberOfTuples(size);
+  }
+
+  // The voxels of each local thickness, computed by blocks of slices so the
+  // progress can be reported.
+  std::vector<vtkIdType> counts(maximumRadius + 1, 0);
+  const int blockSize =
+    std::max(1, 4 * vtkSMPTools::GetEstimatedNumberOfThreads());
+  if (!m_thicknessMap) {
+    block.resize(std::min(blockSize, dims[2]) * sliceSize);
+  }
+  for (int first = 0; first < dims[2]; first += blockSize) {
+    if (isCanceled()) {
+      return false;
+    }
+    const int count = std::min(blockSize, dims[2] - first);
+    float* thickness = m_thicknessMap
+                         ? thicknessMap->GetPointer(first * sliceSize)
+                         : block.data();
+    localThickness.thickness(first, count, thickness);
+    const vtkIdType blockEnd = count * sliceSize;
+    for (vtkIdType i = 0; i < blockEnd; ++i) {
+      ++counts[static_cast<int>(thickness[i])];
+    }
+    setProgressStep(3 * dims[2] + first + count);
+  }
+
+  vtkSMPTools::For(0, size, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i) {
+      distanceValues[i] = std::sqrt(distanceValues[i]);
+    }
+  });
+  imageData->GetPointData()->SetScalars(distances);
+  if (m_thicknessMap) {
+    imageData->GetPointData()->AddArray(thicknessMap);
+  }
+
+  // The fraction of the volume within balls of at least each radius, for
+  // the radii of the Python operator.
+  std::vector<int> radii;
+  for (int r = 1; r < maximumRadius; r += std::max(1, m_radiusSpacing)) {
+    radii.push_back(r);
+  }
+  if (maximumRadius > 0) {
+    radii.push_back(maximumRadius);
+  }
+  std::vector<vtkIdType> filled(maximumRadius + 2, 0);
+  for (int r = maximumRadius; r >= 0; --r) {
+    filled[r] = filled[r + 1] + counts[r];
+  }
+
+  vtkNew<vtkTable> table;
+  vtkNew<vtkDoubleArray> radiusColumn;
+  radiusColumn->SetName("Pore radius");
+  table->AddColumn(radiusColumn);
+  vtkNew<vtkDoubleArray> volumeColumn;
+  volumeColumn->SetName("Pore volume");
+  table->AddColumn(volumeColumn);
+  table->SetNumberOfRows(static_cast<vtkIdType>(radii.size()));
+  for (size_t i = 0; i < radii.size(); ++i) {
+    radiusColumn->SetValue(i, radii[i]);
+    volumeColumn->SetValue(i, static_cast<double>(filled[radii[i]]) / size);
+  }
+  setResult(0, table);
+  return true;
+}
+
+QJsonObject PoreSizeDistributionOperator::serialize() const
+{
+  auto json = Operator::serialize();
+  json["threshold"] = m_threshold;
+  json["radiusSpacing"] = m_radiusSpacing;
+  json["thicknessMap"] = m_thicknessMap;
+  return json;
+}
+
+bool PoreSizeDistributionOperator::deserialize(const QJsonObject& json)
+{
+  if (json.contains("threshold")) {
+    m_threshold = json["threshold"].toDouble();
+  }
+  if (json.contains("radiusSpacing")) {
+    m_radiusSpacing = json["radiusSpacing"].toInt();
+  }
+  if (json.contains("thicknessMap")) {
+    m_thicknessMap = json["thicknessMap"].toBool();
+  }
+  return true;
+}
+
+Operator* PoreSizeDistributionOperator::clone() const
+{
+  auto* other = new PoreSizeDistributionOperator();
+  other->setThreshold(m_threshold);
+  other->setRadiusSpacing(m_radiusSpacing);
+  other->setThicknessMap(m_thicknessMap);
+  return other;
+}
+
+EditOperatorWidget* PoreSizeDistributionOperator::getEditorContentsWithData(
+  QWidget* p, vtkSmartPointer<vtkImageData> data)
+{
+  return new PoreSizeDistributionWidget(this, data, p);
+}
+
+} // namespace tomviz
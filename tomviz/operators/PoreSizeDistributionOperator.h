@@ -0,0 +1,60 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizPoreSizeDistributionOperator_h
+#define tomvizPoreSizeDistributionOperator_h
+
+#include "Operator.h"
+
+class vtkImageData;
+
+namespace tomviz {
+
+/// Continuous pore size distribution, from the local thickness of the pores,
+/// see LocalThickness. It replaces the PoreSizeDistribution Python operator:
+/// the scalars become the distance of the pores to the matter, and the
+/// fraction of the volume that balls of each radius fill is tabulated.
+class PoreSizeDistributionOperator : public Operator
+{
+  Q_OBJECT
+
+public:
+  PoreSizeDistributionOperator(QObject* parent = nullptr);
+
+  QString label() const override { return "Pore Size Distribution"; }
+  QIcon icon() const override;
+  Operator* clone() const override;
+
+  bool applyTransform(vtkDataObject* data) override;
+
+  EditOperatorWidget* getEditorContentsWithData(
+    QWidget* parent, vtkSmartPointer<vtkImageData> data) override;
+  bool hasCustomUI() const override { return true; }
+
+  QJsonObject serialize() const override;
+  bool deserialize(const QJsonObject& json) override;
+
+  /// Scalars above the threshold are matter, the others are pores.
+  void setThreshold(double threshold) { m_threshold = threshold; }
+  double threshold() const { return m_threshold; }
+
+  /// The distribution is tabulated for the radii 1, 1 + spacing, ... and the
+  /// largest radius.
+  void setRadiusSpacing(int spacing) { m_radiusSpacing = spacing; }
+  int radiusSpacing() const { return m_radiusSpacing; }
+
+  /// Also add the local thickness of every voxel, as a "LocalThickness"
+  /// array.
+  void setThicknessMap(bool thicknessMap) { m_thicknessMap = thicknessMap; }
+  bool thicknessMap() const { return m_thicknessMap; }
+
+private:
+  double m_threshold = 127.0;
+  int m_radiusSpacing = 1;
+  bool m_thicknessMap = false;
+
+  Q_DISABLE_COPY(PoreSizeDistributionOperator)
+};
+} // namespace tomviz
+
+#endif
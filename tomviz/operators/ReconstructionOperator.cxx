@@ -4,6 +4,7 @@
 #include "ReconstructionOperator.h"
 
 #include "DataSource.h"
+#include "DirectFourierReconstruction.h"
 #include "Pipeline.h"
 #include "ReconstructionWidget.h"
 #include "TomographyReconstruction.h"
@@ -21,6 +22,9 @@
 
 #include <QCoreApplication>
 #include <QDebug>
+#include <QJsonObject>
+
+#include <algorithm>
 
 namespace tomviz {
 ReconstructionOperator::ReconstructionOperator(DataSource* source, QObject* p)
@@ -49,6 +53,14 @@ ReconstructionOperator::ReconstructionOperator(DataSource* source, QObject* p)
     });
 }
 
+QString ReconstructionOperator::label() const
+{
+  if (m_method == Method::DirectFourier) {
+    return "Direct Fourier Reconstruction";
+  }
+  return "Reconstruction";
+}
+
 QIcon ReconstructionOperator::icon() const
 {
   return QIcon(":/pqWidgets/Icons/pqExtractGrid.svg");
@@ -56,7 +68,24 @@ QIcon ReconstructionOperator::icon() const
 
 Operator* ReconstructionOperator::clone() const
 {
-  return new ReconstructionOperator(m_dataSource);
+  auto* other = new ReconstructionOperator(m_dataSource);
+  other->setMethod(m_method);
+  return other;
+}
+
+QJsonObject ReconstructionOperator::serialize() const
+{
+  auto json = Operator::serialize();
+  json["method"] = static_cast<int>(m_method);
+  return json;
+}
+
+bool ReconstructionOperator::deserialize(const QJsonObject& json)
+{
+  if (json.contains("method")) {
+    m_method = static_cast<Method>(json["method"].toInt());
+  }
+  return true;
 }
 
 QWidget* ReconstructionOperator::getCustomProgressWidget(QWidget* p) const
@@ -126,20 +155,40 @@ bool ReconstructionOperator::applyTransform(vtkDataObject* dataObject)
 
   // TODO: talk to Dave Lonie about how to do this in new data array API
   float* reconstruction = (float*)darray->GetVoidPointer(0);
-  for (int i = 0; i < numXSlices && !isCanceled(); ++i) {
-    QCoreApplication::processEvents();
-    TomographyTiltSeries::getSinogram(imageData, i, &sinogramPtr[0]);
-    TomographyReconstruction::unweightedBackProjection2(
-      &sinogramPtr[0], tiltAngles.data(), &reconstructionPtr[0], numZSlices,
-      numYSlices);
-    for (int j = 0; j < numYSlices; ++j) {
-      for (int k = 0; k < numYSlices; ++k) {
-        reconstruction[j * (numYSlices * numXSlices) + k * numXSlices + i] =
-          reconstructionPtr[k * numYSlices + j];
+  if (m_method == Method::DirectFourier) {
+    std::vector<double> angles(tiltAngles.begin(),
+                               tiltAngles.begin() + numZSlices);
+    DirectFourierReconstruction dfm(numYSlices, angles);
+    int dims[3] = { numXSlices, numYSlices, numZSlices };
+    auto scalars = imageData->GetPointData()->GetScalars();
+    int slab = dfm.slabSize(numXSlices);
+    for (int i = 0; i < numXSlices && !isCanceled(); i += slab) {
+      QCoreApplication::processEvents();
+      int count = std::min(slab, numXSlices - i);
+      if (!dfm.reconstruct(scalars, dims, i, count, reconstruction,
+                           &reconstructionPtr)) {
+        qCritical() << label() << "requires single component scalars";
+        return false;
+      }
+      emit intermediateResults(reconstructionPtr);
+      setProgressStep(i + count - 1);
+    }
+  } else {
+    for (int i = 0; i < numXSlices && !isCanceled(); ++i) {
+      QCoreApplication::processEvents();
+      TomographyTiltSeries::getSinogram(imageData, i, &sinogramPtr[0]);
+      TomographyReconstruction::unweightedBackProjection2(
+        &sinogramPtr[0], tiltAngles.data(), &reconstructionPtr[0], numZSlices,
+        numYSlices);
+      for (int j = 0; j < numYSlices; ++j) {
+        for (int k = 0; k < numYSlices; ++k) {
+          reconstruction[j * (numYSlices * numXSlices) + k * numXSlices + i] =
+            reconstructionPtr[k * numYSlices + j];
+        }
       }
+      emit intermediateResults(reconstructionPtr);
+      setProgressStep(i);
     }
-    emit intermediateResults(reconstructionPtr);
-    setProgressStep(i);
   }
   if (isCanceled()) {
     return false;
@@ -14,9 +14,17 @@ class ReconstructionOperator : public Operator
   Q_OBJECT
 
 public:
+  /// The direct Fourier method reconstructs in slabs of slices, see
+  /// DirectFourierReconstruction, the back projection one slice at a time.
+  enum class Method
+  {
+    BackProjection,
+    DirectFourier
+  };
+
   ReconstructionOperator(DataSource* source, QObject* parent = nullptr);
 
-  QString label() const override { return "Reconstruction"; }
+  QString label() const override;
 
   QIcon icon() const override;
 
@@ -24,6 +32,12 @@ public:
 
   QWidget* getCustomProgressWidget(QWidget*) const override;
 
+  QJsonObject serialize() const override;
+  bool deserialize(const QJsonObject& json) override;
+
+  void setMethod(Method method) { m_method = method; }
+  Method method() const { return m_method; }
+
 protected:
   bool applyTransform(vtkDataObject* data) override;
 
@@ -36,6 +50,7 @@ signals:
 private:
   DataSource* m_dataSource;
   int m_extent[6];
+  Method m_method = Method::BackProjection;
   Q_DISABLE_COPY(ReconstructionOperator)
 };
 } // namespace tomviz
@@ -0,0 +1,331 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "TiltSeriesPreprocessingOperator.h"
+
+#include "ArrayConversion.h"
+#include "DataSource.h"
+#include "EditOperatorWidget.h"
+
+#include <vtkDataArray.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDebug>
+#include <QDoubleSpinBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QPointer>
+#include <QSpinBox>
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+using tomviz::TiltSeriesPreprocessing;
+
+class TiltSeriesPreprocessingWidget : public tomviz::EditOperatorWidget
+{
+  Q_OBJECT
+
+public:
+  TiltSeriesPreprocessingWidget(tomviz::TiltSeriesPreprocessingOperator* source,
+                                vtkImageData* data, QWidget* p)
+    : tomviz::EditOperatorWidget(p), m_operator(source)
+  {
+    int dims[3] = { 1, 1, 1 };
+    if (data) {
+      data->GetDimensions(dims);
+    }
+    const auto& parameters = source->parameters();
+    auto* layout = new QFormLayout(this);
+
+    m_flatField = addStep("Dark and white correction:",
+                          TiltSeriesPreprocessing::FlatField, layout);
+    m_flatField->setToolTip("(projection - dark) / (white - dark), with the "
+                            "dark and white images of the data.");
+
+    m_badPixels = addStep("Remove bad pixels:",
+                          TiltSeriesPreprocessing::BadPixels, layout);
+    m_threshold = new QDoubleSpinBox(this);
+    m_threshold->setRange(0.0, 1000.0);
+    m_threshold->setValue(parameters.badPixelThreshold);
+    m_threshold->setToolTip("Pixels further than this many standard "
+                            "deviations of their 3 x 3 neighbourhood from its "
+                            "median are replaced by the median.");
+    layout->addRow("Bad pixel threshold:", m_threshold);
+
+    m_background = addStep("Subtract background:",
+                           TiltSeriesPreprocessing::Background, layout);
+    m_backgroundMethod = new QComboBox(this);
+    m_backgroundMethod->addItems(
+      { "Histogram peak (auto)", "Mean of a region (manual)" });
+    m_backgroundMethod->setCurrentIndex(
+      static_cast<int>(parameters.backgroundMethod));
+    layout->addRow("Background level:", m_backgroundMethod);
+    for (int i = 0; i < 4; ++i) {
+      m_region[i] = new QSpinBox(this);
+      m_region[i]->setRange(0, dims[i / 2] - 1);
+      m_region[i]->setValue(parameters.backgroundRegion[i]);
+    }
+    layout->addRow("Background region x:", rangeRow(m_region[0], m_region[1]));
+    layout->addRow("Background region y:", rangeRow(m_region[2], m_region[3]));
+
+    m_normalize = addStep("Normalize intensity:",
+                          TiltSeriesPreprocessing::Normalize, layout);
+    m_normalize->setToolTip("Scale the projections to the same total "
+                            "intensity.");
+
+    m_clipEdges = addStep("Clip edges:", TiltSeriesPreprocessing::ClipEdges,
+                          layout);
+    m_clipWidth = new QSpinBox(this);
+    m_clipWidth->setRange(0, std::max(dims[0], dims[1]));
+    m_clipWidth->setValue(parameters.clipWidth);
+    m_clipWidth->setSuffix(" pixels");
+    m_clipWidth->setToolTip("The border set to the minimum of the series.");
+    layout->addRow("Clipped border:", m_clipWidth);
+
+    updateEnabled();
+    connect(m_badPixels, &QCheckBox::toggled, this,
+            &TiltSeriesPreprocessingWidget::updateEnabled);
+    connect(m_background, &QCheckBox::toggled, this,
+            &TiltSeriesPreprocessingWidget::updateEnabled);
+    connect(m_backgroundMethod,
+            QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+            &TiltSeriesPreprocessingWidget::updateEnabled);
+    connect(m_clipEdges, &QCheckBox::toggled, this,
+            &TiltSeriesPreprocessingWidget::updateEnabled);
+    setLayout(layout);
+  }
+
+  void applyChangesToOperator() override
+  {
+    if (!m_operator) {
+      return;
+    }
+    TiltSeriesPreprocessing::Parameters parameters;
+    parameters.steps = 0;
+    const QCheckBox* steps[5] = { m_flatField, m_badPixels, m_background,
+                                  m_normalize, m_clipEdges };
+    for (auto step : steps) {
+      if (step->isChecked()) {
+        parameters.steps |= step->property("step").toInt();
+      }
+    }
+    parameters.badPixelThreshold = m_threshold->value();
+    parameters.backgroundMethod =
+      static_cast<TiltSeriesPreprocessing::BackgroundMethod>(
+        m_backgroundMethod->currentIndex());
+    for (int i = 0; i < 4; ++i) {
+      parameters.backgroundRegion[i] = m_region[i]->value();
+    }
+    parameters.clipWidth = m_clipWidth->value();
+    m_operator->setParameters(parameters);
+  }
+
+private:
+  QCheckBox* addStep(const QString& label, int step, QFormLayout* layout)
+  {
+    auto* checkBox = new QCheckBox(this);
+    checkBox->setProperty("step", step);
+    checkBox->setChecked(m_operator->parameters().steps & step);
+    layout->addRow(label, checkBox);
+    return checkBox;
+  }
+
+  QWidget* rangeRow(QSpinBox* first, QSpinBox* last)
+  {
+    auto* row = new QWidget(this);
+    auto* rowLayout = new QHBoxLayout(row);
+    rowLayout->setContentsMargins(0, 0, 0, 0);
+    rowLayout->addWidget(first);
+    rowLayout->addWidget(last);
+    return row;
+  }
+
+  void updateEnabled()
+  {
+    m_threshold->setEnabled(m_badPixels->isChecked());
+    m_backgroundMethod->setEnabled(m_background->isChecked());
+    const bool region = m_background->isChecked() &&
+                        m_backgroundMethod->currentIndex() ==
+                          static_cast<int>(
+                            TiltSeriesPreprocessing::BackgroundMethod::Region);
+    for (auto spinBox : m_region) {
+      spinBox->setEnabled(region);
+    }
+    m_clipWidth->setEnabled(m_clipEdges->isChecked());
+  }
+
+  QPointer<tomviz::TiltSeriesPreprocessingOperator> m_operator;
+  QCheckBox* m_flatField;
+  QCheckBox* m_badPixels;
+  QDoubleSpinBox* m_threshold;
+  QCheckBox* m_background;
+  QComboBox* m_backgroundMethod;
+  QSpinBox* m_region[4];
+  QCheckBox* m_normalize;
+  QCheckBox* m_clipEdges;
+  QSpinBox* m_clipWidth;
+};
+
+// The mean of the frames of the dark or white \p image, which must have the
+// size of the projections.
+bool averageFrames(vtkImageData* image, const int dims[3],
+                   std::vector<float>& average)
+{
+  if (!image) {
+    return false;
+  }
+  int frameDims[3];
+  image->GetDimensions(frameDims);
+  auto scalars = image->GetPointData()->GetScalars();
+  if (!scalars || scalars->GetNumberOfComponents() != 1 ||
+      frameDims[0] != dims[0] || frameDims[1] != dims[1]) {
+    return false;
+  }
+  average.resize(static_cast<size_t>(dims[0]) * dims[1]);
+  switch (scalars->GetDataType()) {
+    vtkTemplateMacro(TiltSeriesPreprocessing::averageFrames(
+      static_cast<const VTK_TT*>(scalars->GetVoidPointer(0)), frameDims,
+      average.data()));
+    default:
+      return false;
+  }
+  return true;
+}
+} // namespace
+
+#include "TiltSeriesPreprocessingOperator.moc"
+
+namespace tomviz {
+
+TiltSeriesPreprocessingOperator::TiltSeriesPreprocessingOperator(QObject* p)
+  : Operator(p)
+{
+  setSupportsCancel(true);
+}
+
+QIcon TiltSeriesPreprocessingOperator::icon() const
+{
+  return QIcon();
+}
+
+bool TiltSeriesPreprocessingOperator::applyTransform(vtkDataObject* data)
+{
+  auto imageData = vtkImageData::SafeDownCast(data);
+  // sanity check
+  if (!imageData) {
+    return false;
+  }
+  auto scalars = imageData->GetPointData()->GetScalars();
+  if (!scalars || scalars->GetNumberOfComponents() != 1) {
+    qCritical() << label() << "requires single component scalars";
+    return false;
+  }
+
+  int dims[3];
+  imageData->GetDimensions(dims);
+  std::vector<float> dark;
+  std::vector<float> white;
+  if (m_parameters.steps & TiltSeriesPreprocessing::FlatField) {
+    auto source = dataSource();
+    if (!source || !averageFrames(source->darkData(), dims, dark) ||
+        !averageFrames(source->whiteData(), dims, white)) {
+      qCritical() << label()
+                  << "requires dark and white images the size of the "
+                     "projections for the dark and white correction";
+      return false;
+    }
+  }
+
+  // The data is our own copy, its buffer can hold the float values.
+  auto floatArray = ArrayConversion::toFloat(scalars, true);
+  if (!floatArray) {
+    return false;
+  }
+  if (floatArray != scalars) {
+    imageData->GetPointData()->RemoveArray(scalars->GetName());
+    imageData->GetPointData()->SetScalars(floatArray);
+  }
+
+  std::mutex progressMutex;
+  setTotalProgressSteps(dims[2]);
+  setProgressMessage("Processing the projections");
+  TiltSeriesPreprocessing preprocessing(dims, m_parameters);
+  bool completed = preprocessing.apply(
+    static_cast<float*>(floatArray->GetVoidPointer(0)),
+    dark.empty() ? nullptr : dark.data(),
+    white.empty() ? nullptr : white.data(), [&](int done) {
+      std::lock_guard<std::mutex> lock(progressMutex);
+      setProgressStep(done);
+      return !isCanceled();
+    });
+  floatArray->Modified();
+  return completed && !isCanceled();
+}
+
+QJsonObject TiltSeriesPreprocessingOperator::serialize() const
+{
+  auto json = Operator::serialize();
+  json["steps"] = m_parameters.steps;
+  json["badPixelThreshold"] = m_parameters.badPixelThreshold;
+  json["backgroundMethod"] = static_cast<int>(m_parameters.backgroundMethod);
+  QJsonArray region;
+  for (int value : m_parameters.backgroundRegion) {
+    region.append(value);
+  }
+  json["backgroundRegion"] = region;
+  json["clipWidth"] = m_parameters.clipWidth;
+  return json;
+}
+
+bool TiltSeriesPreprocessingOperator::deserialize(const QJsonObject& json)
+{
+  if (json.contains("steps")) {
+    m_parameters.steps = json["steps"].toInt();
+  }
+  if (json.contains("badPixelThreshold")) {
+    m_parameters.badPixelThreshold = json["badPixelThreshold"].toDouble();
+  }
+  if (json.contains("backgroundMethod")) {
+    m_parameters.backgroundMethod =
+      static_cast<TiltSeriesPreprocessing::BackgroundMethod>(
+        json["backgroundMethod"].toInt());
+  }
+  if (json.contains("backgroundRegion")) {
+    auto region = json["backgroundRegion"].toArray();
+    if (region.size() == 4) {
+      for (int i = 0; i < 4; ++i) {
+        m_parameters.backgroundRegion[i] = region[i].toInt();
+      }
+    }
+  }
+  if (json.contains("clipWidth")) {
+    m_parameters.clipWidth = json["clipWidth"].toInt();
+  }
+  return true;
+}
+
+Operator* TiltSeriesPreprocessingOperator::clone() const
+{
+  auto* other = new TiltSeriesPreprocessingOperator();
+  other->setParameters(m_parameters);
+  return other;
+}
+
+EditOperatorWidget* TiltSeriesPreprocessingOperator::getEditorContentsWithData(
+  QWidget* p, vtkSmartPointer<vtkImageData> data)
+{
+  return new TiltSeriesPreprocessingWidget(this, data, p);
+}
+
+} // namespace tomviz
@@ -0,0 +1,56 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizTiltSeriesPreprocessingOperator_h
+#define tomvizTiltSeriesPreprocessingOperator_h
+
+#include "Operator.h"
+
+#include "TiltSeriesPreprocessing.h"
+
+class vtkImageData;
+
+namespace tomviz {
+
+/// The corrections of the projections of a tilt series before alignment,
+/// see TiltSeriesPreprocessing. It replaces the chain of the
+/// RemoveBadPixelsTiltSeries, Subtract_TiltSer_Background and
+/// NormalizeTiltSeries Python operators, and adds the dark and white
+/// correction of the data source. The scalars become floats.
+class TiltSeriesPreprocessingOperator : public Operator
+{
+  Q_OBJECT
+
+public:
+  TiltSeriesPreprocessingOperator(QObject* parent = nullptr);
+
+  QString label() const override { return "Preprocess Tilt Series"; }
+  QIcon icon() const override;
+  Operator* clone() const override;
+
+  bool applyTransform(vtkDataObject* data) override;
+
+  EditOperatorWidget* getEditorContentsWithData(
+    QWidget* parent, vtkSmartPointer<vtkImageData> data) override;
+  bool hasCustomUI() const override { return true; }
+
+  QJsonObject serialize() const override;
+  bool deserialize(const QJsonObject& json) override;
+
+  void setParameters(const TiltSeriesPreprocessing::Parameters& parameters)
+  {
+    m_parameters = parameters;
+  }
+  const TiltSeriesPreprocessing::Parameters& parameters() const
+  {
+    return m_parameters;
+  }
+
+private:
+  TiltSeriesPreprocessing::Parameters m_parameters;
+
+  Q_DISABLE_COPY(TiltSeriesPreprocessingOperator)
+};
+} // namespace tomviz
+
+#endif
@@ -0,0 +1,322 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "TortuosityOperator.h"
+
+#include "EditOperatorWidget.h"
+#include "OperatorResult.h"
+
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkTable.h>
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDebug>
+#include <QFormLayout>
+#include <QJsonObject>
+#include <QPointer>
+#include <QSpinBox>
+
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+// The bins of the tortuosity distribution.
+const int DistributionBins = 100;
+
+// The names of the directions in the Python operator.
+const char* DirectionNames[6] = { "Xpos", "Xneg", "Ypos",
+                                  "Yneg", "Zpos", "Zneg" };
+
+class TortuosityWidget : public tomviz::EditOperatorWidget
+{
+  Q_OBJECT
+
+public:
+  TortuosityWidget(tomviz::TortuosityOperator* source, QWidget* p)
+    : tomviz::EditOperatorWidget(p), m_operator(source)
+  {
+    auto* layout = new QFormLayout(this);
+    m_phase = new QSpinBox(this);
+    m_phase->setRange(0, std::numeric_limits<int>::max());
+    m_phase->setValue(source->phase());
+    layout->addRow("Phase:", m_phase);
+
+    m_metric = new QComboBox(this);
+    m_metric->addItems({ "Euclidean", "City block", "Chessboard" });
+    m_metric->setCurrentIndex(static_cast<int>(source->metric()));
+    layout->addRow("Distance method:", m_metric);
+
+    m_direction = new QComboBox(this);
+    m_direction->addItems({ "X +", "X -", "Y +", "Y -", "Z +", "Z -" });
+    m_direction->setCurrentIndex(source->direction());
+    layout->addRow("Propagation direction:", m_direction);
+
+    m_allDirections = new QCheckBox(this);
+    m_allDirections->setChecked(source->allDirections());
+    m_allDirections->setToolTip(
+      "Also add the distance maps from the other faces, and their "
+      "tortuosity.");
+    layout->addRow("Propagate along all directions:", m_allDirections);
+    setLayout(layout);
+  }
+
+  void applyChangesToOperator() override
+  {
+    if (!m_operator) {
+      return;
+    }
+    m_operator->setPhase(m_phase->value());
+    m_operator->setMetric(
+      static_cast<tomviz::Tortuosity::Metric>(m_metric->currentIndex()));
+    m_operator->setDirection(
+      static_cast<tomviz::Tortuosity::Direction>(m_direction->currentIndex()));
+    m_operator->setAllDirections(m_allDirections->isChecked());
+  }
+
+private:
+  QPointer<tomviz::TortuosityOperator> m_operator;
+  QSpinBox* m_phase;
+  QComboBox* m_metric;
+  QComboBox* m_direction;
+  QCheckBox* m_allDirections;
+};
+
+template <typename T>
+void findPhase(const T* values, vtkIdType size, int phase,
+               unsigned char* mask)
+{
+  vtkSMPTools::For(0, size, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i) {
+      mask[i] = values[i] == phase;
+    }
+  });
+}
+
+vtkDoubleArray* addColumn(vtkTable* table, const char* name)
+{
+  vtkNew<vtkDoubleArray> column;
+  column->SetName(name);
+  table->AddColumn(column);
+  return column;
+}
+} // namespace
+
+#include "TortuosityOperator.moc"
+
+namespace tomviz {
+
+TortuosityOperator::TortuosityOperator(QObject* p) : Operator(p)
+{
+  setNumberOfResults(3);
+  const char* names[3] = { "tortuosity", "path_length",
+                           "tortuosity_distribution" };
+  const char* labels[3] = { "Tortuosity", "Path Length",
+                            "Tortuosity Distribution" };
+  for (int i = 0; i < 3; ++i) {
+    auto res = resultAt(i);
+    res->setName(names[i]);
+    res->setLabel(labels[i]);
+    vtkNew<vtkTable> table;
+    setResult(i, table);
+  }
+  setSupportsCancel(true);
+}
+
+QIcon TortuosityOperator::icon() const
+{
+  return QIcon();
+}
+
+bool TortuosityOperator::applyTransform(vtkDataObject* data)
+{
+  auto imageData = vtkImageData::SafeDownCast(data);
+  // sanity check
+  if (!imageData) {
+    return false;
+  }
+  auto scalars = imageData->GetPointData()->GetScalars();
+  if (!scalars || scalars->GetNumberOfComponents() != 1) {
+    qCritical() << label() << "requires single component scalars";
+    return false;
+  }
+
+  int dims[3];
+  imageData->GetDimensions(dims);
+  const vtkIdType size = static_cast<vtkIdType>(dims[0]) * dims[1] * dims[2];
+  std::vector<unsigned char> phase(size);
+  switch (scalars->GetDataType()) {
+    vtkTemplateMacro(findPhase(
+      static_cast<const VTK_TT*>(scalars->GetVoidPointer(0)), size, m_phase,
+      phase.data()));
+    default:
+      return false;
+  }
+  vtkIdType phaseSize = 0;
+  for (auto value : phase) {
+    phaseSize += value;
+  }
+
+  std::vector<Tortuosity::Direction> directions;
+  for (int d = Tortuosity::XPositive; d <= Tortuosity::ZNegative; ++d) {
+    if (m_allDirections || d == m_direction) {
+      directions.push_back(static_cast<Tortuosity::Direction>(d));
+    }
+  }
+  const int numDirections = static_cast<int>(directions.size());
+  std::vector<vtkSmartPointer<vtkFloatArray>> distances(numDirections);
+  for (int k = 0; k < numDirections; ++k) {
+    distances[k] = vtkSmartPointer<vtkFloatArray>::New();
+    distances[k]->SetNumberOfTuples(size);
+    if (directions[k] == m_direction) {
+      distances[k]->SetName(scalars->GetName());
+    } else {
+      distances[k]->SetName(
+        (std::string("distance_map_") + DirectionNames[directions[k]])
+          .c_str());
+    }
+  }
+
+  // The directions are propagated in parallel, each one on a thread.
+  Tortuosity tortuosity(dims, m_metric);
+  std::atomic<vtkIdType> settled(0);
+  std::mutex progressMutex;
+  const double total = static_cast<double>(phaseSize) * numDirections;
+  setTotalProgressSteps(100);
+  setProgressMessage("Propagating the distances");
+  auto progress = [&](vtkIdType count) {
+    // Each call reports the voxels settled since the previous one.
+    const vtkIdType done = settled += count;
+    std::lock_guard<std::mutex> lock(progressMutex);
+    setProgressStep(static_cast<int>(100.0 * done / total));
+    return !isCanceled();
+  };
+  std::vector<char> completed(numDirections, 0);
+  vtkSMPTools::For(0, numDirections, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType k = begin; k < end; ++k) {
+      vtkIdType reported = 0;
+      completed[k] = tortuosity.propagate(
+        phase.data(), directions[k], distances[k]->GetPointer(0),
+        [&](vtkIdType count) {
+          const vtkIdType delta = count - reported;
+          reported = count;
+          return progress(delta);
+        });
+    }
+  });
+  for (char done : completed) {
+    if (!done || isCanceled()) {
+      return false;
+    }
+  }
+
+  // The tables of the propagation direction, and the tortuosity of every
+  // direction.
+  vtkNew<vtkTable> tortuosityTable;
+  auto scale = addColumn(tortuosityTable, "Scale");
+  auto end = addColumn(tortuosityTable, "End");
+  auto average = addColumn(tortuosityTable, "Average");
+  auto slope = addColumn(tortuosityTable, "Slope");
+  tortuosityTable->SetNumberOfRows(numDirections);
+  for (int k = 0; k < numDirections; ++k) {
+    const float* values = distances[k]->GetPointer(0);
+    auto pathLength = tortuosity.averagePathLength(values, directions[k]);
+    auto summary = Tortuosity::tortuosity(pathLength);
+    scale->SetValue(k, summary.scale);
+    end->SetValue(k, summary.end);
+    average->SetValue(k, summary.average);
+    slope->SetValue(k, summary.slope);
+    if (directions[k] != m_direction) {
+      continue;
+    }
+
+    vtkNew<vtkTable> pathLengthTable;
+    auto linear = addColumn(pathLengthTable, "Linear Distance");
+    auto actual = addColumn(pathLengthTable, "Actual Distance");
+    const int numSlices = static_cast<int>(pathLength.size());
+    pathLengthTable->SetNumberOfRows(numSlices);
+    for (int s = 0; s < numSlices; ++s) {
+      linear->SetValue(s, s + 1.0);
+      actual->SetValue(s, pathLength[s]);
+    }
+    setResult(1, pathLengthTable);
+
+    auto histogram = tortuosity.tortuosityDistribution(values, directions[k],
+                                                       DistributionBins);
+    vtkNew<vtkTable> distributionTable;
+    auto bins = addColumn(distributionTable, "Tortuosity");
+    auto occurrence = addColumn(distributionTable, "Occurrence");
+    distributionTable->SetNumberOfRows(DistributionBins);
+    for (int i = 0; i < DistributionBins; ++i) {
+      bins->SetValue(i, 1.0 + i * 5.0 / DistributionBins);
+      occurrence->SetValue(i, static_cast<double>(histogram[i]));
+    }
+    setResult(2, distributionTable);
+  }
+  setResult(0, tortuosityTable);
+
+  for (int k = 0; k < numDirections; ++k) {
+    if (directions[k] == m_direction) {
+      imageData->GetPointData()->SetScalars(distances[k]);
+    } else {
+      imageData->GetPointData()->AddArray(distances[k]);
+    }
+  }
+  return true;
+}
+
+QJsonObject TortuosityOperator::serialize() const
+{
+  auto json = Operator::serialize();
+  json["phase"] = m_phase;
+  json["metric"] = static_cast<int>(m_metric);
+  json["direction"] = static_cast<int>(m_direction);
+  json["allDirections"] = m_allDirections;
+  return json;
+}
+
+bool TortuosityOperator::deserialize(const QJsonObject& json)
+{
+  if (json.contains("phase")) {
+    m_phase = json["phase"].toInt();
+  }
+  if (json.contains("metric")) {
+    m_metric = static_cast<Tortuosity::Metric>(json["metric"].toInt());
+  }
+  if (json.contains("direction")) {
+    m_direction = static_cast<Tortuosity::Direction>(json["direction"].toInt());
+  }
+  if (json.contains("allDirections")) {
+    m_allDirections = json["allDirections"].toBool();
+  }
+  return true;
+}
+
+Operator* TortuosityOperator::clone() const
+{
+  auto* other = new TortuosityOperator();
+  other->setPhase(m_phase);
+  other->setMetric(m_metric);
+  other->setDirection(m_direction);
+  other->setAllDirections(m_allDirections);
+  return other;
+}
+
+EditOperatorWidget* TortuosityOperator::getEditorContentsWithData(
+  QWidget* p, vtkSmartPointer<vtkImageData>)
+{
+  return new TortuosityWidget(this, p);
+}
+
+} // namespace tomviz
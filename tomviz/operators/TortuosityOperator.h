@@ -0,0 +1,69 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizTortuosityOperator_h
+#define tomvizTortuosityOperator_h
+
+#include "Operator.h"
+
+#include "Tortuosity.h"
+
+class vtkImageData;
+
+namespace tomviz {
+
+/// Tortuosity by distance propagation through a phase, see Tortuosity. It
+/// replaces the Tortuosity Python operator: the scalars become the distances
+/// from the face of the propagation direction, and the tortuosity, the
+/// average path length of each slice and the tortuosity distribution of the
+/// last slice are tabulated.
+class TortuosityOperator : public Operator
+{
+  Q_OBJECT
+
+public:
+  TortuosityOperator(QObject* parent = nullptr);
+
+  QString label() const override { return "Tortuosity"; }
+  QIcon icon() const override;
+  Operator* clone() const override;
+
+  bool applyTransform(vtkDataObject* data) override;
+
+  EditOperatorWidget* getEditorContentsWithData(
+    QWidget* parent, vtkSmartPointer<vtkImageData> data) override;
+  bool hasCustomUI() const override { return true; }
+
+  QJsonObject serialize() const override;
+  bool deserialize(const QJsonObject& json) override;
+
+  /// The voxels with this scalar value are the pores the paths go through.
+  void setPhase(int phase) { m_phase = phase; }
+  int phase() const { return m_phase; }
+
+  void setMetric(Tortuosity::Metric metric) { m_metric = metric; }
+  Tortuosity::Metric metric() const { return m_metric; }
+
+  void setDirection(Tortuosity::Direction direction)
+  {
+    m_direction = direction;
+  }
+  Tortuosity::Direction direction() const { return m_direction; }
+
+  /// Also propagate from the other five faces, in parallel. Their distance
+  /// maps are added as arrays, and the tortuosity table has a row for each
+  /// direction, in the order of Tortuosity::Direction.
+  void setAllDirections(bool all) { m_allDirections = all; }
+  bool allDirections() const { return m_allDirections; }
+
+private:
+  int m_phase = 1;
+  Tortuosity::Metric m_metric = Tortuosity::Metric::Euclidean;
+  Tortuosity::Direction m_direction = Tortuosity::XPositive;
+  bool m_allDirections = false;
+
+  Q_DISABLE_COPY(TortuosityOperator)
+};
+} // namespace tomviz
+
+#endif
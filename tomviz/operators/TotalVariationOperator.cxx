@@ -0,0 +1,589 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "TotalVariationOperator.h"
+
+#include "EditOperatorWidget.h"
+#include "FourierTransform.h"
+#include "TomographyReconstruction.h"
+#include "TotalVariation.h"
+
+#include <vtkDataArray.h>
+#include <vtkFieldData.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+
+#include <QDebug>
+#include <QDoubleSpinBox>
+#include <QElapsedTimer>
+#include <QFormLayout>
+#include <QJsonObject>
+#include <QPointer>
+#include <QSpinBox>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+// TV descents after each ART sweep of the reconstruction, and the parameters
+// of their line search, as in the Python operator.
+const int DescentSteps = 5;
+const double LineSearchReduction = 0.8;
+const int MaxLineSearchSteps = 100;
+// TV descents after each data constraint of the artifact removal.
+const int ArtifactDescentSteps = 20;
+
+class TotalVariationWidget : public tomviz::EditOperatorWidget
+{
+  Q_OBJECT
+
+public:
+  TotalVariationWidget(tomviz::TotalVariationOperator* source, QWidget* p)
+    : tomviz::EditOperatorWidget(p), m_operator(source)
+  {
+    auto* layout = new QFormLayout(this);
+    m_iterations = new QSpinBox(this);
+    m_iterations->setRange(1, 100000);
+    m_iterations->setValue(source->iterations());
+    layout->addRow("Number of iterations:", m_iterations);
+
+    if (source->mode() ==
+        tomviz::TotalVariationOperator::Mode::Reconstruction) {
+      m_updates = new QSpinBox(this);
+      m_updates->setRange(0, 100);
+      m_updates->setSuffix("%");
+      m_updates->setValue(source->updatePercentage());
+      m_updates->setToolTip("0% means no updates, 100% means an update after "
+                            "every iteration.");
+      layout->addRow("Live reconstruction updates:", m_updates);
+    } else {
+      m_wedgeSize = new QDoubleSpinBox(this);
+      m_wedgeSize->setRange(0.0, 360.0);
+      m_wedgeSize->setValue(source->wedgeSize());
+      layout->addRow("Angular range of the missing wedge (degrees):",
+                     m_wedgeSize);
+
+      m_minimumFrequency = new QDoubleSpinBox(this);
+      m_minimumFrequency->setRange(0.0, 2000.0);
+      m_minimumFrequency->setValue(source->minimumFrequency());
+      layout->addRow("Minimum frequency of the missing wedge:",
+                     m_minimumFrequency);
+
+      m_wedgeAngle = new QDoubleSpinBox(this);
+      m_wedgeAngle->setRange(0.0, 360.0);
+      m_wedgeAngle->setValue(source->wedgeAngle());
+      m_wedgeAngle->setToolTip("0 is horizontal and 90 vertical.");
+      layout->addRow("Orientation of the missing wedge (degrees):",
+                     m_wedgeAngle);
+
+      m_stepSize = new QDoubleSpinBox(this);
+      m_stepSize->setRange(0.0, 1.0);
+      m_stepSize->setSingleStep(0.05);
+      m_stepSize->setDecimals(3);
+      m_stepSize->setValue(source->stepSize());
+      layout->addRow("TV descent parameter:", m_stepSize);
+    }
+    setLayout(layout);
+  }
+
+  void applyChangesToOperator() override
+  {
+    if (!m_operator) {
+      return;
+    }
+    m_operator->setIterations(m_iterations->value());
+    if (m_updates) {
+      m_operator->setUpdatePercentage(m_updates->value());
+    } else {
+      m_operator->setWedge(m_wedgeSize->value(), m_wedgeAngle->value(),
+                           m_minimumFrequency->value());
+      m_operator->setStepSize(m_stepSize->value());
+    }
+  }
+
+private:
+  QPointer<tomviz::TotalVariationOperator> m_operator;
+  QSpinBox* m_iterations;
+  QSpinBox* m_updates = nullptr;
+  QDoubleSpinBox* m_wedgeSize = nullptr;
+  QDoubleSpinBox* m_wedgeAngle = nullptr;
+  QDoubleSpinBox* m_minimumFrequency = nullptr;
+  QDoubleSpinBox* m_stepSize = nullptr;
+};
+
+// The iterations between live updates, like calc_Nupdates() of the Python
+// operator.
+int updateInterval(int percentage, int iterations)
+{
+  if (percentage <= 0) {
+    return 0;
+  }
+  if (percentage >= 100) {
+    return 1;
+  }
+  return static_cast<int>(
+    std::round(iterations * (1.0 - percentage / 100.0)));
+}
+
+// The sinogram of an x slice, stored as tilt * numOfRays + ray.
+template <typename T>
+void readSinogram(const T* values, const int dims[3], int slice,
+                  float* sinogram)
+{
+  const vtkIdType numRows = static_cast<vtkIdType>(dims[1]) * dims[2];
+  for (vtkIdType r = 0; r < numRows; ++r) {
+    sinogram[r] = static_cast<float>(values[r * dims[0] + slice]);
+  }
+}
+} // namespace
+
+#include "TotalVariationOperator.moc"
+
+namespace tomviz {
+
+TotalVariationOperator::TotalVariationOperator(QObject* p) : Operator(p)
+{
+  setSupportsCancel(true);
+  connect(
+    this,
+    static_cast<void (Operator::*)(const QString&,
+                                   vtkSmartPointer<vtkDataObject>)>(
+      &Operator::newChildDataSource),
+    this,
+    [this](const QString& label, vtkSmartPointer<vtkDataObject> childData) {
+      this->createNewChildDataSource(label, childData, DataSource::Volume,
+                                     DataSource::PersistenceState::Transient);
+    });
+  setMode(Mode::Reconstruction);
+}
+
+QString TotalVariationOperator::label() const
+{
+  if (m_mode == Mode::ArtifactRemoval) {
+    return "TV Artifact Removal";
+  }
+  return "TV Minimization Reconstruction";
+}
+
+QIcon TotalVariationOperator::icon() const
+{
+  return QIcon();
+}
+
+void TotalVariationOperator::setMode(Mode mode)
+{
+  m_mode = mode;
+  m_iterations = mode == Mode::Reconstruction ? 1 : 50;
+  setHasChildDataSource(mode == Mode::Reconstruction);
+}
+
+void TotalVariationOperator::setWedge(double wedgeSize, double wedgeAngle,
+                                      double minimumFrequency)
+{
+  m_wedgeSize = wedgeSize;
+  m_wedgeAngle = wedgeAngle;
+  m_minimumFrequency = minimumFrequency;
+}
+
+bool TotalVariationOperator::applyTransform(vtkDataObject* data)
+{
+  auto imageData = vtkImageData::SafeDownCast(data);
+  // sanity check
+  if (!imageData) {
+    return false;
+  }
+  auto scalars = imageData->GetPointData()->GetScalars();
+  if (!scalars || scalars->GetNumberOfComponents() != 1) {
+    qCritical() << label() << "requires single component scalars";
+    return false;
+  }
+
+  if (m_mode == Mode::ArtifactRemoval) {
+    return removeArtifacts(imageData);
+  }
+  return reconstruct(imageData);
+}
+
+bool TotalVariationOperator::reconstruct(vtkImageData* tiltSeries)
+{
+  int dims[3];
+  tiltSeries->GetDimensions(dims);
+  const int numSlices = dims[0];
+  const int numRays = dims[1];
+  const int numTilts = dims[2];
+
+  auto tiltAnglesArray = tiltSeries->GetFieldData()->GetArray("tilt_angles");
+  if (!tiltAnglesArray || tiltAnglesArray->GetNumberOfTuples() < numTilts) {
+    qCritical() << label() << "requires a tilt angle for every projection";
+    return false;
+  }
+  std::vector<double> angles(numTilts);
+  bool zeroAngle = false;
+  for (int i = 0; i < numTilts; ++i) {
+    angles[i] = tiltAnglesArray->GetTuple1(i);
+    zeroAngle = zeroAngle || angles[i] == 0.0;
+  }
+  // Rays along the grid lines are left out by the ray tracing.
+  if (zeroAngle) {
+    for (auto& angle : angles) {
+      angle += 0.001;
+    }
+  }
+
+  TomographyReconstruction::SystemMatrix matrix;
+  TomographyReconstruction::parallelRayMatrix(numRays, angles.data(),
+                                              numTilts, matrix);
+
+  auto scalars = tiltSeries->GetPointData()->GetScalars();
+  void* values = scalars->GetVoidPointer(0);
+  const int dataType = scalars->GetDataType();
+  const int reconDims[3] = { numSlices, numRays, numRays };
+  const vtkIdType size = static_cast<vtkIdType>(numSlices) * numRays * numRays;
+  const vtkIdType sliceStride = static_cast<vtkIdType>(numSlices) * numRays;
+  std::vector<float> recon(size, 0.0f);
+  std::vector<float> previous(size);
+  std::vector<float> direction(size);
+  std::vector<float> candidate(size);
+
+  // The output, like the child datasets of the Python operators, has the x
+  // spacing along z.
+  auto makeReconstruction = [&]() {
+    vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+    int extent[6];
+    double spacing[3];
+    tiltSeries->GetExtent(extent);
+    tiltSeries->GetSpacing(spacing);
+    image->SetExtent(extent[0], extent[1], extent[2], extent[3], extent[2],
+                     extent[3]);
+    image->SetOrigin(tiltSeries->GetOrigin());
+    image->SetSpacing(spacing[0], spacing[1], spacing[0]);
+    vtkNew<vtkFloatArray> array;
+    array->SetName("scalars");
+    array->SetNumberOfTuples(size);
+    std::copy(recon.begin(), recon.end(),
+              static_cast<float*>(array->GetVoidPointer(0)));
+    image->GetPointData()->SetScalars(array);
+    return image;
+  };
+
+  // Slices are swept in parallel, in blocks so the progress can be reported.
+  const int blockSize =
+    std::max(1, 4 * vtkSMPTools::GetEstimatedNumberOfThreads());
+  const int interval = updateInterval(m_updatePercentage, m_iterations);
+  setTotalProgressSteps(m_iterations * numSlices);
+  QString timing;
+  QElapsedTimer timer;
+  for (int i = 0; i < m_iterations; ++i) {
+    timer.start();
+    previous = recon;
+    setProgressMessage(QString("ART, iteration %1/%2. %3")
+                         .arg(i + 1)
+                         .arg(m_iterations)
+                         .arg(timing));
+
+    for (int first = 0; first < numSlices; first += blockSize) {
+      if (isCanceled()) {
+        return false;
+      }
+      const int last = std::min(numSlices, first + blockSize);
+      vtkSMPTools::For(first, last, [&](vtkIdType begin, vtkIdType end) {
+        std::vector<float> sinogram(numRays * numTilts);
+        std::vector<float> image(numRays * numRays);
+        for (vtkIdType x = begin; x < end; ++x) {
+          const int slice = static_cast<int>(x);
+          switch (dataType) {
+            vtkTemplateMacro(readSinogram(static_cast<const VTK_TT*>(values),
+                                          dims, slice, sinogram.data()));
+            default:
+              break;
+          }
+          for (int y = 0; y < numRays; ++y) {
+            for (int z = 0; z < numRays; ++z) {
+              image[y * numRays + z] =
+                recon[z * sliceStride + y * numSlices + slice];
+            }
+          }
+          TomographyReconstruction::artSweep(matrix, sinogram.data(),
+                                             image.data());
+          // Positivity constraint
+          for (int y = 0; y < numRays; ++y) {
+            for (int z = 0; z < numRays; ++z) {
+              recon[z * sliceStride + y * numSlices + slice] =
+                std::max(image[y * numRays + z], 0.0f);
+            }
+          }
+        }
+      });
+      setProgressStep(i * numSlices + last);
+    }
+
+    if (interval != 0 && (i + 1) % interval == 0) {
+      emit newChildDataSource("Reconstruction", makeReconstruction());
+    }
+
+    if (i != m_iterations - 1) {
+      setProgressMessage(QString("Minimizing the TV, iteration %1/%2. %3")
+                           .arg(i + 1)
+                           .arg(m_iterations)
+                           .arg(timing));
+
+      // The change made by the ART sweep bounds the TV descent.
+      const double change =
+        TotalVariation::distance(previous.data(), recon.data(), size);
+      previous = recon;
+      for (int j = 0; j < DescentSteps && !isCanceled(); ++j) {
+        const double tv = TotalVariation::value(recon.data(), reconDims);
+        const double norm =
+          TotalVariation::gradient(recon.data(), reconDims, direction.data());
+        if (norm == 0.0) {
+          break;
+        }
+
+        // Projected line search
+        double step = change / norm;
+        TotalVariation::descend(recon.data(), direction.data(), step, size,
+                                candidate.data(), true);
+        for (int k = 0; k < MaxLineSearchSteps &&
+                        TotalVariation::value(candidate.data(), reconDims) > tv;
+             ++k) {
+          step *= LineSearchReduction;
+          TotalVariation::descend(recon.data(), direction.data(), step, size,
+                                  candidate.data(), true);
+        }
+        std::swap(recon, candidate);
+      }
+
+      const double descent =
+        TotalVariation::distance(recon.data(), previous.data(), size);
+      if (descent > change) {
+        const float scale = static_cast<float>(change / descent);
+        vtkSMPTools::For(0, size, [&](vtkIdType begin, vtkIdType end) {
+          for (vtkIdType k = begin; k < end; ++k) {
+            recon[k] = previous[k] + scale * (recon[k] - previous[k]);
+          }
+        });
+      }
+    }
+
+    timing = QString("Last iteration took %1 s.")
+               .arg(timer.elapsed() / 1000.0, 0, 'f', 1);
+  }
+  if (isCanceled()) {
+    return false;
+  }
+
+  emit newChildDataSource("Reconstruction", makeReconstruction());
+  return true;
+}
+
+bool TotalVariationOperator::removeArtifacts(vtkImageData* image)
+{
+  int dims[3];
+  image->GetDimensions(dims);
+  auto scalars = image->GetPointData()->GetScalars();
+  bool result = false;
+  switch (scalars->GetDataType()) {
+    vtkTemplateMacro(result = removeArtifacts(
+                       static_cast<VTK_TT*>(scalars->GetVoidPointer(0)), dims));
+    default:
+      return false;
+  }
+  scalars->Modified();
+  return result;
+}
+
+template <typename T>
+bool TotalVariationOperator::removeArtifacts(T* values, const int dims[3])
+{
+  const int imageDims[3] = { dims[0], dims[1], 1 };
+  const vtkIdType sliceSize = static_cast<vtkIdType>(dims[0]) * dims[1];
+  const vtkIdType spectrumSize = FourierTransform::spectrumSize(imageDims);
+  const int half = dims[0] / 2 + 1;
+
+  // The frequencies kept from the image: outside of the missing wedge, or
+  // below the minimum frequency. The wedge is symmetric, the mask of the half
+  // spectrum covers the whole spectrum.
+  const double wedgeAngle = vtkMath::RadiansFromDegrees(m_wedgeAngle + 90.0);
+  const double wedgeSize = vtkMath::RadiansFromDegrees(m_wedgeSize);
+  std::vector<char> keep(spectrumSize);
+  for (int v = 0; v < dims[1]; ++v) {
+    const double fy = v <= dims[1] / 2 ? v : v - dims[1];
+    for (int u = 0; u < half; ++u) {
+      const double fx = u;
+      double angle = std::fmod(std::atan2(fx, fy) - wedgeAngle, vtkMath::Pi());
+      angle = std::min(std::abs(angle), vtkMath::Pi() - std::abs(angle));
+      keep[v * half + u] =
+        angle > wedgeSize / 2.0 ||
+        fx * fx + fy * fy < m_minimumFrequency * m_minimumFrequency;
+    }
+  }
+
+  // Each slice is processed by a single thread, from the data constraint to
+  // the result, so the buffers are per range of slices.
+  std::atomic<bool> canceled(false);
+  auto processSlices = [&](vtkIdType begin, vtkIdType end) {
+    std::vector<FourierTransform::Complex> imageSpectrum(spectrumSize);
+    std::vector<FourierTransform::Complex> spectrum(spectrumSize);
+    std::vector<float> slice(sliceSize);
+    std::vector<float> current(sliceSize);
+    std::vector<float> constrained(sliceSize);
+    std::vector<float> minimized(sliceSize);
+    std::vector<float> direction(sliceSize);
+    for (vtkIdType k = begin; k < end && !canceled; ++k) {
+      T* sliceValues = values + k * sliceSize;
+      for (vtkIdType i = 0; i < sliceSize; ++i) {
+        slice[i] = static_cast<float>(sliceValues[i]);
+      }
+      FourierTransform::forward(slice.data(), imageDims,
+                                imageSpectrum.data());
+
+      // The reconstruction starts as a random image, seeded by the slice so
+      // the results are reproducible.
+      std::mt19937 generator(static_cast<unsigned int>(k));
+      std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+      for (auto& value : current) {
+        value = distribution(generator);
+      }
+
+      for (int j = 0; j < m_iterations; ++j) {
+        if (canceled || isCanceled()) {
+          canceled = true;
+          return;
+        }
+
+        // Impose the data constraint
+        FourierTransform::forward(current.data(), imageDims, spectrum.data());
+        for (vtkIdType i = 0; i < spectrumSize; ++i) {
+          if (keep[i]) {
+            spectrum[i] = imageSpectrum[i];
+          }
+        }
+        FourierTransform::inverse(spectrum.data(), imageDims,
+                                  constrained.data());
+        // Positivity constraint
+        for (auto& value : constrained) {
+          value = std::max(value, 0.0f);
+        }
+
+        // TV minimization, stepping by the change of the data constraint.
+        const double change = TotalVariation::distance(
+          constrained.data(), current.data(), sliceSize);
+        minimized = constrained;
+        for (int s = 0; s < ArtifactDescentSteps; ++s) {
+          const double norm = TotalVariation::imageGradient(
+            minimized.data(), imageDims, direction.data());
+          if (norm == 0.0) {
+            break;
+          }
+          TotalVariation::descend(minimized.data(), direction.data(),
+                                  m_stepSize * change / norm, sliceSize,
+                                  minimized.data());
+        }
+        std::swap(current, minimized);
+      }
+
+      // The last data constrained image is the result.
+      for (vtkIdType i = 0; i < sliceSize; ++i) {
+        sliceValues[i] = static_cast<T>(constrained[i]);
+      }
+    }
+  };
+
+  // Slices are processed in parallel, in blocks so the progress can be
+  // reported.
+  const int blockSize =
+    std::max(1, 4 * vtkSMPTools::GetEstimatedNumberOfThreads());
+  setTotalProgressSteps(dims[2] * m_iterations);
+  QString timing;
+  QElapsedTimer timer;
+  for (int first = 0; first < dims[2]; first += blockSize) {
+    if (isCanceled()) {
+      return false;
+    }
+    const int last = std::min(dims[2], first + blockSize);
+    setProgressMessage(QString("Processing images %1-%2/%3. %4")
+                         .arg(first + 1)
+                         .arg(last)
+                         .arg(dims[2])
+                         .arg(timing));
+    timer.start();
+    vtkSMPTools::For(first, last, processSlices);
+    if (canceled) {
+      return false;
+    }
+    setProgressStep(last * m_iterations);
+    timing = QString("%1 ms per image.")
+               .arg(timer.elapsed() / (last - first));
+  }
+  return true;
+}
+
+QJsonObject TotalVariationOperator::serialize() const
+{
+  auto json = Operator::serialize();
+  json["mode"] = static_cast<int>(m_mode);
+  json["iterations"] = m_iterations;
+  if (m_mode == Mode::Reconstruction) {
+    json["updatePercentage"] = m_updatePercentage;
+  } else {
+    json["wedgeSize"] = m_wedgeSize;
+    json["wedgeAngle"] = m_wedgeAngle;
+    json["minimumFrequency"] = m_minimumFrequency;
+    json["stepSize"] = m_stepSize;
+  }
+  return json;
+}
+
+bool TotalVariationOperator::deserialize(const QJsonObject& json)
+{
+  if (json.contains("mode")) {
+    setMode(static_cast<Mode>(json["mode"].toInt()));
+  }
+  if (json.contains("iterations")) {
+    m_iterations = json["iterations"].toInt();
+  }
+  if (json.contains("updatePercentage")) {
+    m_updatePercentage = json["updatePercentage"].toInt();
+  }
+  if (json.contains("wedgeSize")) {
+    m_wedgeSize = json["wedgeSize"].toDouble();
+  }
+  if (json.contains("wedgeAngle")) {
+    m_wedgeAngle = json["wedgeAngle"].toDouble();
+  }
+  if (json.contains("minimumFrequency")) {
+    m_minimumFrequency = json["minimumFrequency"].toDouble();
+  }
+  if (json.contains("stepSize")) {
+    m_stepSize = json["stepSize"].toDouble();
+  }
+  return true;
+}
+
+Operator* TotalVariationOperator::clone() const
+{
+  auto* other = new TotalVariationOperator();
+  other->setMode(m_mode);
+  other->setIterations(m_iterations);
+  other->setUpdatePercentage(m_updatePercentage);
+  other->setWedge(m_wedgeSize, m_wedgeAngle, m_minimumFrequency);
+  other->setStepSize(m_stepSize);
+  return other;
+}
+
+EditOperatorWidget* TotalVariationOperator::getEditorContentsWithData(
+  QWidget* p, vtkSmartPointer<vtkImageData>)
+{
+  return new TotalVariationWidget(this, p);
+}
+
+} // namespace tomviz
@@ -0,0 +1,86 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizTotalVariationOperator_h
+#define tomvizTotalVariationOperator_h
+
+#include "Operator.h"
+
+class vtkImageData;
+
+namespace tomviz {
+
+/// Total variation minimization operators, see TotalVariation. They replace
+/// the Recon_TV_minimization and TV_Filter Python operators.
+class TotalVariationOperator : public Operator
+{
+  Q_OBJECT
+
+public:
+  enum class Mode
+  {
+    /// Reconstruct a tilt series, alternating ART sweeps with TV descents,
+    /// into a child data source.
+    Reconstruction,
+    /// Remove structured artifacts, which span an angular range of the
+    /// spectrum, from each xy slice.
+    ArtifactRemoval
+  };
+
+  TotalVariationOperator(QObject* parent = nullptr);
+
+  QString label() const override;
+  QIcon icon() const override;
+  Operator* clone() const override;
+
+  bool applyTransform(vtkDataObject* data) override;
+
+  EditOperatorWidget* getEditorContentsWithData(
+    QWidget* parent, vtkSmartPointer<vtkImageData> data) override;
+  bool hasCustomUI() const override { return true; }
+
+  QJsonObject serialize() const override;
+  bool deserialize(const QJsonObject& json) override;
+
+  /// Also resets the number of iterations to the default of the mode.
+  void setMode(Mode mode);
+  Mode mode() const { return m_mode; }
+
+  void setIterations(int iterations) { m_iterations = iterations; }
+  int iterations() const { return m_iterations; }
+
+  /// The percentage of the iterations followed by an update of the
+  /// reconstruction, 0 for none and 100 for every iteration.
+  void setUpdatePercentage(int percentage) { m_updatePercentage = percentage; }
+  int updatePercentage() const { return m_updatePercentage; }
+
+  /// The artifacts are removed from the frequencies within half of
+  /// \p wedgeSize of \p wedgeAngle, both in degrees, beyond
+  /// \p minimumFrequency. The TV descent steps by \p stepSize times the
+  /// change made by the data constraint.
+  void setWedge(double wedgeSize, double wedgeAngle, double minimumFrequency);
+  double wedgeSize() const { return m_wedgeSize; }
+  double wedgeAngle() const { return m_wedgeAngle; }
+  double minimumFrequency() const { return m_minimumFrequency; }
+  void setStepSize(double step) { m_stepSize = step; }
+  double stepSize() const { return m_stepSize; }
+
+private:
+  bool reconstruct(vtkImageData* tiltSeries);
+  bool removeArtifacts(vtkImageData* image);
+  template <typename T>
+  bool removeArtifacts(T* values, const int dims[3]);
+
+  Mode m_mode = Mode::Reconstruction;
+  int m_iterations = 1;
+  int m_updatePercentage = 0;
+  double m_wedgeSize = 5.0;
+  double m_wedgeAngle = 0.0;
+  double m_minimumFrequency = 5.0;
+  double m_stepSize = 0.1;
+
+  Q_DISABLE_COPY(TotalVariationOperator)
+};
+} // namespace tomviz
+
+#endif
@@ -6,71 +6,18 @@
 #include "AlignWidget.h"
 #include "DataSource.h"
 #include "OperatorResult.h"
+#include "RegionCopy.h"
 
+#include "vtkDataArray.h"
 #include "vtkImageData.h"
 #include "vtkIntArray.h"
 #include "vtkNew.h"
+#include "vtkPointData.h"
 #include "vtkTable.h"
 
 #include <QJsonArray>
 
-namespace {
-
-// We are assuming an image that begins at 0, 0, 0.
-vtkIdType imageIndex(const vtkVector3i& incs, const vtkVector3i& pos)
-{
-  return pos[0] * incs[0] + pos[1] * incs[1] + pos[2] * incs[2];
-}
-
-template <typename T>
-void applyImageOffsets(T* in, T* out, vtkImageData* image,
-                       const QVector<vtkVector2i>& offsets)
-{
-  // We know that the input and output images are the same size, with the
-  // supplied offsets applied to each slice. Copy the pixels, applying offsets.
-  int* extents = image->GetExtent();
-  vtkVector3i extent(extents[1] - extents[0] + 1, extents[3] - extents[2] + 1,
-                     extents[5] - extents[4] + 1);
-  vtkVector3i incs(1, 1 * extent[0], 1 * extent[0] * extent[1]);
-
-  // Zero out our output array, we should do this more intelligently in future.
-  T* ptr = out;
-  for (int i = 0; i < extent[0] * extent[1] * extent[2]; ++i) {
-    *ptr++ = 0;
-  }
-
-  // We need to go slice by slice, applying the pixel offsets to the new image.
-  for (int i = 0; i < extent[2]; ++i) {
-    vtkVector2i offset = offsets[i];
-    int idx = imageIndex(incs, vtkVector3i(0, 0, i));
-    T* inPtr = in + idx;
-    T* outPtr = out + idx;
-    for (int y = 0; y < extent[1]; ++y) {
-      if (y + offset[1] >= extent[1]) {
-        break;
-      } else if (y + offset[1] < 0) {
-        inPtr += incs[1];
-        outPtr += incs[1];
-        continue;
-      }
-      for (int x = 0; x < extent[0]; ++x) {
-        if (x + offset[0] >= extent[0]) {
-          inPtr += offset[0];
-          outPtr += offset[0];
-          break;
-        } else if (x + offset[0] < 0) {
-          ++inPtr;
-          ++outPtr;
-          continue;
-        }
-        *(outPtr + offset[0] + incs[1] * offset[1]) = *inPtr;
-        ++inPtr;
-        ++outPtr;
-      }
-    }
-  }
-}
-} // namespace
+#include <vector>
 
 namespace tomviz {
 TranslateAlignOperator::TranslateAlignOperator(DataSource* ds, QObject* p)
@@ -96,18 +43,24 @@ void TranslateAlignOperator::initializeResults()
 
 bool TranslateAlignOperator::applyTransform(vtkDataObject* data)
 {
-  vtkNew<vtkImageData> outImage;
-  vtkImageData* inImage = vtkImageData::SafeDownCast(data);
-  assert(inImage);
-  outImage->DeepCopy(data);
-  switch (inImage->GetScalarType()) {
-    vtkTemplateMacro(
-      applyImageOffsets(reinterpret_cast<VTK_TT*>(inImage->GetScalarPointer()),
-                        reinterpret_cast<VTK_TT*>(outImage->GetScalarPointer()),
-                        inImage, offsets));
+  vtkImageData* image = vtkImageData::SafeDownCast(data);
+  assert(image);
+  int dims[3];
+  image->GetDimensions(dims);
+  std::vector<int> shifts(2 * static_cast<size_t>(dims[2]), 0);
+  for (int i = 0; i < dims[2] && i < offsets.size(); ++i) {
+    shifts[2 * i] = offsets[i][0];
+    shifts[2 * i + 1] = offsets[i][1];
   }
+
+  // Each slice is shifted in place, only a slice per thread is copied.
+  auto scalars = image->GetPointData()->GetScalars();
+  RegionCopy::shiftSlices(
+    scalars->GetVoidPointer(0), dims, shifts.data(),
+    scalars->GetDataTypeSize() * scalars->GetNumberOfComponents());
+  scalars->Modified();
+
   offsetsToResult();
-  data->ShallowCopy(outImage);
   return true;
 }
 
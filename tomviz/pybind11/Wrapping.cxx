@@ -3,20 +3,277 @@
 
 #include "OperatorPythonWrapper.h"
 #include "PybindVTKTypeCaster.h"
+#include <pybind11/complex.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include "FourierTransform.h"
+#include "RegionCopy.h"
 #include "core/DataSourceBase.h"
 
 #include "PipelineStateManager.h"
 #include "vtkImageData.h"
 
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace py = pybind11;
 
 using tomviz::DataSourceBase;
+using tomviz::FourierTransform;
+using tomviz::RegionCopy;
 
 PYBIND11_VTK_TYPECASTER(vtkImageData)
 
+namespace {
+
+using FloatArray =
+  py::array_t<float, py::array::c_style | py::array::forcecast>;
+using ComplexArray = py::array_t<std::complex<float>,
+                                 py::array::c_style | py::array::forcecast>;
+
+// The arrays are C ordered, their last axis is the first, contiguous, one of
+// FourierTransform and RegionCopy.
+void arrayDimensions(const std::vector<ssize_t>& shape, int dims[3])
+{
+  if (shape.empty() || shape.size() > 3) {
+    throw std::invalid_argument("Only 1, 2 and 3 dimensional arrays are "
+                                "supported");
+  }
+  dims[0] = dims[1] = dims[2] = 1;
+  for (size_t i = 0; i < shape.size(); ++i) {
+    dims[i] = static_cast<int>(shape[shape.size() - 1 - i]);
+  }
+}
+
+std::vector<ssize_t> shapeOf(const py::array& array)
+{
+  return std::vector<ssize_t>(array.shape(), array.shape() + array.ndim());
+}
+
+ComplexArray rfftn(FloatArray values)
+{
+  int dims[3];
+  auto shape = shapeOf(values);
+  arrayDimensions(shape, dims);
+  shape.back() = dims[0] / 2 + 1;
+
+  ComplexArray spectrum(shape);
+  auto* output = spectrum.mutable_data();
+  {
+    py::gil_scoped_release release;
+    FourierTransform::forward(values.data(), dims, output);
+  }
+  return spectrum;
+}
+
+FloatArray irfftn(ComplexArray spectrum, std::vector<ssize_t> shape)
+{
+  int dims[3];
+  arrayDimensions(shape, dims);
+  auto expected = shape;
+  expected.back() = dims[0] / 2 + 1;
+  if (shapeOf(spectrum) != expected) {
+    throw std::invalid_argument("The spectrum does not match the shape");
+  }
+
+  // The inverse transform overwrites its input
+  std::vector<std::complex<float>> work(spectrum.data(),
+                                        spectrum.data() + spectrum.size());
+  FloatArray values(shape);
+  auto* output = values.mutable_data();
+  {
+    py::gil_scoped_release release;
+    FourierTransform::inverse(work.data(), dims, output);
+  }
+  return values;
+}
+
+FloatArray absLog(FloatArray values)
+{
+  int dims[3];
+  auto shape = shapeOf(values);
+  arrayDimensions(shape, dims);
+
+  FloatArray result(shape);
+  auto* output = result.mutable_data();
+  {
+    py::gil_scoped_release release;
+    std::vector<std::complex<float>> spectrum(
+      FourierTransform::spectrumSize(dims));
+    FourierTransform::forward(values.data(), dims, spectrum.data());
+    FourierTransform::absLog(spectrum.data(), dims, output);
+  }
+  return result;
+}
+
+FloatArray bandPass(FloatArray values, double low, double high)
+{
+  int dims[3];
+  auto shape = shapeOf(values);
+  arrayDimensions(shape, dims);
+
+  FloatArray result(shape);
+  auto* output = result.mutable_data();
+  {
+    py::gil_scoped_release release;
+    std::vector<std::complex<float>> spectrum(
+      FourierTransform::spectrumSize(dims));
+    FourierTransform::forward(values.data(), dims, spectrum.data());
+    FourierTransform::bandPass(spectrum.data(), dims, low, high);
+    FourierTransform::inverse(spectrum.data(), dims, output);
+  }
+  return result;
+}
+
+// In place, so the array is not converted.
+void hannWindow(py::array_t<float, py::array::c_style> values)
+{
+  int dims[3];
+  arrayDimensions(shapeOf(values), dims);
+  auto* data = values.mutable_data();
+  py::gil_scoped_release release;
+  FourierTransform::hannWindow(data, dims);
+}
+
+// The values given for each axis of an array, in the order of
+// arrayDimensions().
+void axisValues(const std::vector<int>& values, size_t ndim, int result[3])
+{
+  if (values.size() != ndim) {
+    throw std::invalid_argument("Expected a value for each axis");
+  }
+  result[0] = result[1] = result[2] = 0;
+  for (size_t i = 0; i < ndim; ++i) {
+    result[i] = values[ndim - 1 - i];
+  }
+}
+
+// The region copies move bytes, any type of array is supported.
+void regionDimensions(const py::array& array, int dims[3])
+{
+  if (!(array.flags() & py::array::c_style)) {
+    throw std::invalid_argument("The array must be C contiguous");
+  }
+  arrayDimensions(shapeOf(array), dims);
+}
+
+RegionCopy::Boundary boundary(const std::string& mode)
+{
+  if (mode == "constant") {
+    return RegionCopy::Boundary::Zero;
+  } else if (mode == "edge") {
+    return RegionCopy::Boundary::Edge;
+  } else if (mode == "wrap") {
+    return RegionCopy::Boundary::Wrap;
+  }
+  throw std::invalid_argument("Unsupported pad mode " + mode);
+}
+
+py::array pad(py::array values, std::vector<int> before,
+              std::vector<int> after, const std::string& mode)
+{
+  int dims[3];
+  regionDimensions(values, dims);
+  auto shape = shapeOf(values);
+  int padBefore[3];
+  int padAfter[3];
+  axisValues(before, shape.size(), padBefore);
+  axisValues(after, shape.size(), padAfter);
+  for (size_t i = 0; i < shape.size(); ++i) {
+    if (before[i] < 0 || after[i] < 0) {
+      throw std::invalid_argument("The pad sizes must not be negative");
+    }
+    shape[i] += before[i] + after[i];
+  }
+  auto padBoundary = boundary(mode);
+
+  py::array result(values.dtype(), shape);
+  auto* output = result.mutable_data();
+  {
+    py::gil_scoped_release release;
+    RegionCopy::pad(values.data(), dims, padBefore, padAfter, padBoundary,
+                    output, static_cast<int>(values.itemsize()));
+  }
+  return result;
+}
+
+py::array roll(py::array values, std::vector<int> shift)
+{
+  int dims[3];
+  regionDimensions(values, dims);
+  auto shape = shapeOf(values);
+  int offset[3];
+  axisValues(shift, shape.size(), offset);
+
+  py::array result(values.dtype(), shape);
+  auto* output = result.mutable_data();
+  {
+    py::gil_scoped_release release;
+    RegionCopy::roll(values.data(), dims, offset, output,
+                     static_cast<int>(values.itemsize()));
+  }
+  return result;
+}
+
+void shiftInPlace(py::array values, std::vector<int> shift)
+{
+  int dims[3];
+  regionDimensions(values, dims);
+  int offset[3];
+  axisValues(shift, values.ndim(), offset);
+  auto* data = values.mutable_data();
+  py::gil_scoped_release release;
+  RegionCopy::shift(data, dims, offset, static_cast<int>(values.itemsize()));
+}
+
+// The slices are along the first axis, the shifts along the last two.
+void shiftSlices(py::array values, std::vector<std::pair<int, int>> shifts)
+{
+  int dims[3];
+  regionDimensions(values, dims);
+  if (values.ndim() != 3 || shifts.size() != static_cast<size_t>(dims[2])) {
+    throw std::invalid_argument("Expected a 3 dimensional array and a shift "
+                                "for each of its slices");
+  }
+  std::vector<int> offsets;
+  for (auto& s : shifts) {
+    offsets.push_back(s.second);
+    offsets.push_back(s.first);
+  }
+  auto* data = values.mutable_data();
+  py::gil_scoped_release release;
+  RegionCopy::shiftSlices(data, dims, offsets.data(),
+                          static_cast<int>(values.itemsize()));
+}
+
+FloatArray shiftLinear(FloatArray values, std::vector<double> shift)
+{
+  int dims[3];
+  auto shape = shapeOf(values);
+  arrayDimensions(shape, dims);
+  if (shift.size() != shape.size()) {
+    throw std::invalid_argument("Expected a value for each axis");
+  }
+  double offset[3] = { 0.0, 0.0, 0.0 };
+  for (size_t i = 0; i < shape.size(); ++i) {
+    offset[i] = shift[shape.size() - 1 - i];
+  }
+
+  FloatArray result(shape);
+  auto* output = result.mutable_data();
+  {
+    py::gil_scoped_release release;
+    RegionCopy::shiftLinear(values.data(), dims, 1, offset, output);
+  }
+  return result;
+}
+} // namespace
+
 PYBIND11_PLUGIN(_wrapping)
 {
   py::module m("_wrapping", "tomviz wrapped classes");
@@ -66,5 +323,18 @@ PYBIND11_PLUGIN(_wrapping)
     .def("execute_pipeline", &PipelineStateManager::executePipeline)
     .def("pipeline_paused", &PipelineStateManager::pipelinePaused);
 
+  m.def("rfftn", &rfftn, "Real to complex forward transform");
+  m.def("irfftn", &irfftn, "Complex to real inverse transform");
+  m.def("abs_log", &absLog, "Shifted log magnitude of the transform");
+  m.def("band_pass", &bandPass, "Radial band pass filter");
+  m.def("hann_window", &hannWindow, "Hann window, in place");
+  m.def("clear_fft_plans", &FourierTransform::clearPlans,
+        "Release the cached transform plans");
+  m.def("pad", &pad, "Pad with zeros, the edges or wrapping around");
+  m.def("roll", &roll, "Shift, wrapping around");
+  m.def("shift", &shiftInPlace, "Integer shift, in place");
+  m.def("shift_slices", &shiftSlices, "Shift each slice, in place");
+  m.def("shift_linear", &shiftLinear, "Shift, interpolating linearly");
+
   return m.ptr();
 }
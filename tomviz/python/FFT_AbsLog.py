@@ -8,20 +8,15 @@
 
 def transform(dataset):
 
-    import numpy as np
+    import tomviz.fft
 
     data_py = dataset.active_scalars
 
     if data_py is None: # Check if data exists.
         raise RuntimeError("No data array found!")
 
-    offset = np.finfo(float).eps #add a small offset to avoid log(0)
-
-    # Take log abs FFT
-    output = np.fft.fftshift(np.log(np.abs(np.fft.fftn(data_py)) + offset))
-    # Normalize log abs FFT
-    output = output / np.max(output)
-    output = np.asfortranarray(output)
+    # Take log abs FFT, shifted and normalized
+    output = tomviz.fft.abs_log(data_py)
 
     # Set the result as the new scalars.
     dataset.active_scalars = output
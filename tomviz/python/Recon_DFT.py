@@ -1,5 +1,5 @@
-import pyfftw
 import numpy as np
+import tomviz.fft
 import tomviz.operators
 import time
 
@@ -30,13 +30,7 @@ class ReconDFMOperator(tomviz.operators.CancelableOperator):
         self.progress.message = 'Initialization'
         Nz = Ny
         w = np.zeros((Nx, Ny, Nz // 2 + 1)) #store weighting factors
-        v = pyfftw.empty_aligned(
-            (Nx, Ny, Nz // 2 + 1), dtype='complex64', n=16)
-
-        p = pyfftw.empty_aligned((Nx, Npad), dtype='float32', n=16)
-        pF = pyfftw.empty_aligned(
-            (Nx, Npad // 2 + 1), dtype='complex64', n=16)
-        p_fftw_object = pyfftw.FFTW(p, pF, axes=(0, 1))
+        v = np.zeros((Nx, Ny, Nz // 2 + 1), dtype=np.complex64)
 
         dk = np.double(Ny) / np.double(Npad)
 
@@ -57,8 +51,7 @@ class ReconDFMOperator(tomviz.operators.CancelableOperator):
             p = np.lib.pad(projection, ((0, 0), (pad_pre, pad_post)),
                            'constant', constant_values=(0, 0)) #pad zeros
             p = np.float32(np.fft.ifftshift(p))
-            p_fftw_object.update_arrays(p, pF)
-            p_fftw_object()
+            pF = tomviz.fft.rfftn(p)
             p = None #Garbage collector (gc)
 
             if ang < 0:
@@ -92,16 +85,10 @@ class ReconDFMOperator(tomviz.operators.CancelableOperator):
         p = pF = None #gc
 
         self.progress.message = 'Inverse Fourier transform'
-        v_temp = v.copy()
-        recon = pyfftw.empty_aligned(
-            (Nx, Ny, Nz), dtype='float32', order='F', n=16)
-        recon_fftw_object = pyfftw.FFTW(
-            v_temp, recon, direction='FFTW_BACKWARD', axes=(0, 1, 2))
         v[w != 0] = v[w != 0] / w[w != 0]
-        recon_fftw_object.update_arrays(v, recon)
-        v = v_temp = []    #gc
-        recon_fftw_object()
-        recon[:] = np.fft.fftshift(recon)
+        recon = tomviz.fft.irfftn(v, (Nx, Ny, Nz))
+        v = []    #gc
+        recon = np.asfortranarray(np.fft.fftshift(recon))
 
         step += 1
         self.progress.value = step
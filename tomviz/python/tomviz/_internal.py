@@ -8,7 +8,7 @@ import inspect
 import sys
 import os
 import fnmatch
-import imp
+import importlib.util
 import json
 import traceback
 
@@ -36,8 +36,10 @@ def delete_module(name):
         del sys.modules[name]
 
 
-def find_operator_class(transform_module):
-    operator_class = None
+def _find_operator_member(transform_module):
+    # Returns the name the operator class is bound to in the module, and the
+    # class, or (None, None)
+    operator_name, operator_class = None, None
     classes = inspect.getmembers(transform_module, inspect.isclass)
     for (name, cls) in classes:
         if issubclass(cls, tomviz.operators.Operator):
@@ -45,9 +47,13 @@ def find_operator_class(transform_module):
                 raise Exception('Multiple operators define in module, only '
                                 'one operator can be defined per module.')
 
-            operator_class = cls
+            operator_name, operator_class = name, cls
+
+    return (operator_name, operator_class)
 
-    return operator_class
+
+def find_operator_class(transform_module):
+    return _find_operator_member(transform_module)[1]
 
 
 def _find_function(module, function_name):
@@ -68,7 +74,17 @@ def find_transform_from_module(transform_module):
     return f
 
 
-def is_cancelable(transform_module):
+# How the transform of a module is found, and whether it can be canceled,
+# keyed on the hash of the module's script. The modules executed from the same
+# script each have their own namespace, but they are alike.
+_transform_lookups = {}
+_cancelable = {}
+
+
+def is_cancelable(transform_module, key=None):
+    if key is not None and key in _cancelable:
+        return _cancelable[key]
+
     cls = find_operator_class(transform_module)
 
     if cls is None:
@@ -77,43 +93,66 @@ def is_cancelable(transform_module):
     if cls is None and function is None:
         raise Exception('Unable to locate function or operator class.')
 
-    return cls is not None and issubclass(cls,
-                                          tomviz.operators.CancelableOperator)
+    cancelable = cls is not None and issubclass(
+        cls, tomviz.operators.CancelableOperator)
+    if key is not None:
+        _cancelable[key] = cancelable
 
+    return cancelable
 
-def find_transform_function(transform_module, op=None):
 
-    transform_function = find_transform_from_module(transform_module)
-    if transform_function is None:
-        cls = find_operator_class(transform_module)
-        if cls is None:
-            raise Exception('Unable to locate transform function.')
+def _find_transform_lookup(transform_module):
+    # Returns the name of the module attribute the transform function was
+    # found as, or the names of the operator class attribute and of its
+    # transform method. The attribute names are kept rather than __name__,
+    # which differs for decorated, aliased or lambda transforms.
+    for name in ('transform', 'transform_scalars'):
+        if _find_function(transform_module, name) is not None:
+            return (name, None)
 
-        # We call __new__ and __init__ manually here so we can inject the
-        # wrapper OperatorPython instance before __init__ is called so that
-        # any code in __init__ can access the wrapper.
-        o = cls.__new__(cls)
-        if op is not None:
-            # Set the wrapped OperatorPython instance
-            o._operator_wrapper = tomviz._wrapping.OperatorPythonWrapper(op)
-        cls.__init__(o)
+    (name, cls) = _find_operator_member(transform_module)
+    if cls is None:
+        raise Exception('Unable to locate transform function.')
 
-        transform_function = None
-        if _operator_method_was_implemented(o, 'transform'):
-            transform_function = o.transform
-        elif _operator_method_was_implemented(o, 'transform_scalars'):
-            transform_function = o.transform_scalars
+    for method in ('transform', 'transform_scalars'):
+        if _operator_method_was_implemented(cls, method):
+            return (name, method)
 
-    if transform_function is None:
-        raise Exception('Unable to locate transform function.')
+    raise Exception('Unable to locate transform function.')
+
+
+def find_transform_function(transform_module, op=None, key=None):
+
+    lookup = _transform_lookups.get(key) if key is not None else None
+    if lookup is None:
+        lookup = _find_transform_lookup(transform_module)
+        if key is not None:
+            _transform_lookups[key] = lookup
 
-    return transform_function
+    (name, method) = lookup
+    if method is None:
+        return getattr(transform_module, name)
+
+    cls = getattr(transform_module, name)
+    # We call __new__ and __init__ manually here so we can inject the
+    # wrapper OperatorPython instance before __init__ is called so that
+    # any code in __init__ can access the wrapper.
+    o = cls.__new__(cls)
+    if op is not None:
+        # Set the wrapped OperatorPython instance
+        o._operator_wrapper = tomviz._wrapping.OperatorPythonWrapper(op)
+    cls.__init__(o)
+
+    return getattr(o, method)
 
 
 def _load_module(operator_dir, python_file):
     module_name, _ = os.path.splitext(python_file)
-    fp, pathname, description = imp.find_module(module_name, [operator_dir])
-    module = imp.load_module(module_name, fp, pathname, description)
+    path = os.path.join(operator_dir, python_file)
+    spec = importlib.util.spec_from_file_location(module_name, path)
+    module = importlib.util.module_from_spec(spec)
+    sys.modules[module_name] = module
+    spec.loader.exec_module(module)
 
     return module
 
@@ -156,22 +195,84 @@ def _operator_description(operator_dir, filename):
     return description
 
 
-def find_operators(operator_dir):
+def _file_stamp(path):
+    # The modification time and size of a file, None if it doesn't exist.
+    try:
+        stat = os.stat(path)
+    except OSError:
+        return None
+
+    return [stat.st_mtime, stat.st_size]
+
+
+def find_operators(operator_dir, cache=None):
+    """Describe the operators of the Python files of operator_dir.
+
+    cache is a dictionary, keyed on the paths of the Python files, of the
+    descriptions found before. A file is only imported again if it, or its
+    JSON file, changed since then, or if it failed to load. The cache is
+    updated in place.
+    """
+    if cache is None:
+        cache = {}
+
     # First look for the python files
     python_files = fnmatch.filter(os.listdir(operator_dir), '*.py')
+    python_paths = set()
     operator_descriptions = []
     for python_file in python_files:
-        operator_descriptions.append(
-            _operator_description(operator_dir, python_file)
-        )
+        python_path = os.path.join(operator_dir, python_file)
+        name, _ = os.path.splitext(python_file)
+        json_path = os.path.join(operator_dir, '%s.json' % name)
+        stamp = {
+            'python': _file_stamp(python_path),
+            'json': _file_stamp(json_path)
+        }
+        python_paths.add(python_path)
+
+        entry = cache.get(python_path)
+        if entry is None or entry['stamp'] != stamp:
+            entry = {
+                'stamp': stamp,
+                'description': _operator_description(operator_dir,
+                                                     python_file)
+            }
+            # A file that failed to load may depend on modules installed
+            # since, which the stamps don't track. It is imported again.
+            if 'loadError' in entry['description']:
+                cache.pop(python_path, None)
+            else:
+                cache[python_path] = entry
+
+        operator_descriptions.append(dict(entry['description']))
+
+    # Forget the files that were removed.
+    for python_path in list(cache):
+        if os.path.dirname(python_path) == operator_dir and \
+                python_path not in python_paths:
+            del cache[python_path]
 
     return operator_descriptions
 
 
-def _operator_method_was_implemented(obj, method):
+def find_operators_cached(operator_dir, cache_json):
+    """find_operators() with the cache as a JSON document, for the
+    application to keep between sessions. Returns the operators and the
+    updated document."""
+    try:
+        cache = json.loads(cache_json) if cache_json else {}
+    except ValueError:
+        cache = {}
+
+    operators = find_operators(operator_dir, cache)
+
+    return (operators, json.dumps(cache))
+
+
+def _operator_method_was_implemented(cls, method):
     # It would be nice if there were an easier way to do this, but
     # I am not currently aware of an easier way.
-    bases = list(inspect.getmro(type(obj)))
+    bases = list(inspect.getmro(cls))
     # We know operator has this attribute, remove it
     bases.remove(tomviz.operators.Operator)
 
@@ -0,0 +1,300 @@
+"""Run a pipeline on many files at once.
+
+The files are processed concurrently by worker processes. Each worker reads
+the next file while it runs the pipeline on the current one, and writes the
+output of the previous one in the background. The files are handed to the
+workers only while the memory they are estimated to need fits in the budget.
+"""
+import json
+import logging
+import multiprocessing
+import multiprocessing.connection
+import os
+import queue
+import threading
+import time
+import traceback
+
+import h5py
+
+from tomviz import executor
+
+logger = logging.getLogger('tomviz')
+
+# The memory used by a file being processed, as a multiple of the size of its
+# arrays: the input, the output and the temporary arrays of the operators.
+MEMORY_FACTOR = 3
+
+# The files handed to a worker at once: one being written, one running the
+# pipeline and one being read.
+FILES_PER_WORKER = 3
+
+SIZE_UNITS = {'': 1, 'K': 1 << 10, 'M': 1 << 20, 'G': 1 << 30, 'T': 1 << 40}
+
+
+class QuietProgress(executor.ProgressBase):
+    """Progress that is not reported, the workers would garble each other's
+    progress bars."""
+    maximum = None
+    value = None
+    message = None
+
+
+def parse_size(text):
+    """Parse a number of bytes, such as 2048, 512M or 16GB."""
+    text = text.strip().upper()
+    if text.endswith('B'):
+        text = text[:-1]
+    unit = text[-1:] if text[-1:] in SIZE_UNITS else ''
+    return int(float(text[:len(text) - len(unit)]) * SIZE_UNITS[unit])
+
+
+def estimate_size(path):
+    """The size of the datasets of an HDF5 file, once read into memory."""
+    sizes = []
+
+    def visit(name, obj):
+        if isinstance(obj, h5py.Dataset):
+            sizes.append(obj.size * obj.dtype.itemsize)
+
+    try:
+        with h5py.File(path, 'r') as f:
+            f.visititems(visit)
+    except (IOError, OSError):
+        return os.path.getsize(path)
+
+    return sum(sizes)
+
+
+def _child_data_path(output_file_path):
+    # Each file gets its own directory of child data, so the workers don't
+    # write to the same files.
+    (root, _) = os.path.splitext(output_file_path)
+    return root
+
+
+def _worker(operators, start_at, read_options, tasks, results):
+    inputs = queue.Queue(maxsize=1)
+    outputs = queue.Queue(maxsize=1)
+
+    def read():
+        while True:
+            job = tasks.recv()
+            if job is None:
+                inputs.put(None)
+                return
+
+            start = time.perf_counter()
+            loaded = None
+            error = None
+            try:
+                loaded = executor._read_input(job['input'], read_options)
+            except Exception:
+                error = traceback.format_exc()
+            job['read_seconds'] = time.perf_counter() - start
+            inputs.put((job, loaded, error))
+
+    def write():
+        while True:
+            item = outputs.get()
+            if item is None:
+                return
+
+            (job, output, dims, error) = item
+            if error is None:
+                start = time.perf_counter()
+                try:
+                    executor._write_emd(job['output'], output, dims)
+                except Exception:
+                    error = traceback.format_exc()
+                job['write_seconds'] = time.perf_counter() - start
+            job['error'] = error
+            del output
+            results.send(job)
+
+    reader = threading.Thread(target=read, daemon=True)
+    writer = threading.Thread(target=write, daemon=True)
+    reader.start()
+    writer.start()
+
+    while True:
+        item = inputs.get()
+        if item is None:
+            break
+
+        (job, loaded, error) = item
+        output = None
+        dims = None
+        if error is None:
+            (data, dims) = loaded
+            start = time.perf_counter()
+            try:
+                transforms = executor._load_transform_functions(
+                    operators[start_at:])
+                output = executor._run_pipeline(
+                    transforms, start_at, data, dims, job['output'],
+                    QuietProgress(), _child_data_path(job['output']))
+            except Exception:
+                error = traceback.format_exc()
+            job['compute_seconds'] = time.perf_counter() - start
+            del data
+        # Release the input before waiting for the writer.
+        del loaded, item
+        outputs.put((job, output, dims, error))
+        del output
+
+    outputs.put(None)
+    writer.join()
+
+
+def _record(job, start):
+    seconds = sum(job.get(key, 0.0) for key in
+                  ('read_seconds', 'compute_seconds', 'write_seconds'))
+    record = {
+        'input': str(job['input']),
+        'output': str(job['output']),
+        'status': 'failed' if job.get('error') else 'ok',
+        'error': job.get('error'),
+        'bytes': job['size'],
+        'read_seconds': job.get('read_seconds'),
+        'compute_seconds': job.get('compute_seconds'),
+        'write_seconds': job.get('write_seconds'),
+        'started_at_seconds': job['admitted'] - start,
+        'elapsed_seconds': time.perf_counter() - job['admitted'],
+        'throughput_bytes_per_second':
+            job['size'] / seconds if seconds > 0 else None
+    }
+    return record
+
+
+def run(operators, start_at, file_paths, read_options=None, workers=1,
+        memory_budget=None, report_path=None):
+    """Run the pipeline on each (input, output) pair of file_paths with
+    workers processes, within memory_budget bytes if given. Returns the
+    report, a dictionary with a record of the timing of each file, which is
+    also written as JSON to report_path if given."""
+    start = time.perf_counter()
+    pending = []
+    for (index, (input_path, output_path)) in enumerate(file_paths):
+        pending.append({
+            'index': index,
+            'input': str(input_path),
+            'output': str(output_path),
+            'size': estimate_size(input_path)
+        })
+    pending.reverse()
+
+    # Each worker has its own pipes, so the files it holds are known even if
+    # it dies.
+    context = multiprocessing.get_context('spawn')
+    pool = []
+    for _ in range(workers):
+        (task_reader, task_writer) = context.Pipe(duplex=False)
+        (result_reader, result_writer) = context.Pipe(duplex=False)
+        process = context.Process(target=_worker,
+                                  args=(operators, start_at, read_options,
+                                        task_reader, result_writer))
+        process.start()
+        task_reader.close()
+        result_writer.close()
+        pool.append({
+            'process': process,
+            'tasks': task_writer,
+            'results': result_reader,
+            'jobs': {}
+        })
+
+    records = {}
+    used = [0]
+
+    def in_flight():
+        return sum(len(w['jobs']) for w in pool)
+
+    def admit():
+        while pending and pool:
+            worker = min(pool, key=lambda w: len(w['jobs']))
+            if len(worker['jobs']) >= FILES_PER_WORKER:
+                return
+            job = pending[-1]
+            memory = job['size'] * MEMORY_FACTOR
+            if memory_budget is not None and used[0] + memory > memory_budget:
+                if in_flight():
+                    return
+                logger.warning('%s is estimated to use more than the memory'
+                               ' budget.' % job['input'])
+            pending.pop()
+            job['admitted'] = time.perf_counter()
+            worker['jobs'][job['index']] = job
+            used[0] += memory
+            worker['tasks'].send(job)
+
+    def finish(worker, job):
+        worker['jobs'].pop(job['index'])
+        used[0] -= job['size'] * MEMORY_FACTOR
+        record = _record(job, start)
+        records[job['index']] = record
+        if record['error']:
+            logger.error('Failed on %s:\n%s' % (job['input'], record['error']))
+        else:
+            logger.info('Processed %s in %.1f s.' %
+                        (job['input'], record['elapsed_seconds']))
+
+    def receive(worker):
+        try:
+            job = worker['results'].recv()
+        except EOFError:
+            return False
+        finish(worker, job)
+        return True
+
+    admit()
+    while in_flight():
+        connections = [w['results'] for w in pool]
+        sentinels = [w['process'].sentinel for w in pool]
+        ready = multiprocessing.connection.wait(connections + sentinels)
+        for worker in list(pool):
+            if worker['results'] in ready:
+                receive(worker)
+            if worker['process'].sentinel in ready:
+                # The files that the worker holds are lost.
+                while worker['results'].poll() and receive(worker):
+                    pass
+                worker['process'].join()
+                for job in list(worker['jobs'].values()):
+                    job['error'] = ('The worker process exited with code %s.'
+                                    % worker['process'].exitcode)
+                    finish(worker, job)
+                pool.remove(worker)
+        admit()
+
+    for job in pending:
+        job['admitted'] = time.perf_counter()
+        job['error'] = 'No worker process left.'
+        records[job['index']] = _record(job, start)
+
+    for worker in pool:
+        worker['tasks'].send(None)
+    for worker in pool:
+        worker['process'].join()
+
+    seconds = time.perf_counter() - start
+    total_bytes = sum(r['bytes'] for r in records.values())
+    report = {
+        'workers': workers,
+        'memory_budget': memory_budget,
+        'files': [records[index] for index in sorted(records)],
+        'summary': {
+            'files': len(records),
+            'failed': sum(r['status'] != 'ok' for r in records.values()),
+            'bytes': total_bytes,
+            'seconds': seconds,
+            'throughput_bytes_per_second':
+                total_bytes / seconds if seconds > 0 else None
+        }
+    }
+
+    if report_path is not None:
+        with open(report_path, 'w') as f:
+            json.dump(report, f, indent=2)
+
+    return report
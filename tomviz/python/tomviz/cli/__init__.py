@@ -4,6 +4,7 @@ import os
 import logging
 from pathlib import Path
 
+from tomviz import batch
 from tomviz import executor
 
 logger = logging.getLogger('tomviz')
@@ -54,8 +55,19 @@ def _extract_pipeline(state):
 @click.option('-i', '--operator-index',
               help='The operator to start at.',
               type=int, default=0)
+@click.option('-j', '--jobs',
+              help='The number of worker processes, each processing the files'
+              ' one after the other, so up to this many files at once.',
+              type=click.IntRange(min=1), default=1)
+@click.option('-m', '--memory-budget',
+              help='The memory that the files processed at once may use, such'
+              ' as 16G. A file is estimated to use %d times the size of its'
+              ' arrays.' % batch.MEMORY_FACTOR)
+@click.option('-r', '--report-path',
+              help='Path to write a JSON report of the timing and throughput'
+              ' of each file.', type=click.Path())
 def main(data_path, state_file_path, output_file_path, progress_method,
-         socket_path, operator_index):
+         socket_path, operator_index, jobs, memory_budget, report_path):
 
     # Extract the pipeline
     with open(state_file_path) as fp:
@@ -114,6 +126,25 @@ def main(data_path, state_file_path, output_file_path, progress_method,
     elif number_of_files > 1:
         logger.info('Executing pipeline on %d files.' % number_of_files)
 
+    if jobs > 1 or report_path is not None:
+        # The progress of the operators is not reported in the batch mode.
+        output_file_paths = [
+            executor._default_output_file_path(str(data_file_path))
+            if output_file_path is None else output_file_path
+            for (data_file_path, output_file_path) in zip(data_file_paths,
+                                                          output_file_paths)
+        ]
+        if memory_budget is not None:
+            memory_budget = batch.parse_size(memory_budget)
+        report = batch.run(operators, operator_index,
+                           list(zip(data_file_paths, output_file_paths)),
+                           read_options, jobs, memory_budget, report_path)
+        summary = report['summary']
+        if summary['failed'] > 0:
+            raise click.ClickException('The pipeline failed on %d of %d files.'
+                                       % (summary['failed'], summary['files']))
+        return
+
     for (data_file_path, output_file_path) in zip(data_file_paths,
                                                   output_file_paths):
         logger.info('Executing pipeline on %s' % data_file_path)
@@ -683,11 +683,15 @@ def _load_transform_functions(operators):
     return transform_functions
 
 
-def _write_child_data(result, operator_index, output_file_path, dims):
+def _write_child_data(result, operator_index, output_file_path, dims,
+                      child_data_path=None):
     for (label, dataobject) in six.iteritems(result):
         # Only need write out data if the operator made updates.
         output_path = '.'
-        if output_file_path is not None:
+        if child_data_path is not None:
+            output_path = child_data_path
+            os.makedirs(output_path, exist_ok=True)
+        elif output_file_path is not None:
             output_path = os.path.dirname(output_file_path)
 
         # Make a directory with the operator index
@@ -709,9 +713,7 @@ def _write_child_data(result, operator_index, output_file_path, dims):
         _write_emd(child_data_path, dataobject, dims)
 
 
-def execute(operators, start_at, data_file_path, output_file_path,
-            progress_method, progress_path, read_options=None):
-
+def _read_input(data_file_path, read_options=None):
     if _is_data_exchange(data_file_path):
         output = _read_data_exchange(data_file_path, read_options)
     else:
@@ -739,37 +741,60 @@ def execute(operators, start_at, data_file_path, output_file_path,
         # Convert to native type, as is required by itk
         data.spacing = [float(d.values[1] - d.values[0]) for d in dims]
 
+    return (data, dims)
+
+
+def _run_pipeline(transforms, start_at, data, dims, output_file_path,
+                  progress, child_data_path=None):
+    """Run the transforms on data, and return the dataset to write out. The
+    child data is written next to the output file, or in child_data_path."""
+    result = None
+    operator_index = start_at
+    for (label, transform, arguments) in transforms:
+        progress.started(operator_index)
+        result = _execute_transform(label, transform,
+                                    arguments, data,
+                                    progress)
+
+        # Do we have any child data sources we need to write out?
+        if result is not None:
+            _write_child_data(result, operator_index,
+                              output_file_path, dims, child_data_path)
+
+        progress.finished(operator_index)
+        operator_index += 1
+
+    logger.info('Execution complete.')
+    if result is None:
+        return data
+
+    [(_, child_data)] = result.items()
+    return child_data
+
+
+def _default_output_file_path(data_file_path):
+    return '%s_transformed.emd' % \
+        os.path.splitext(os.path.basename(data_file_path))[0]
+
+
+def execute(operators, start_at, data_file_path, output_file_path,
+            progress_method, progress_path, read_options=None):
+
+    (data, dims) = _read_input(data_file_path, read_options)
+
     operators = operators[start_at:]
     transforms = _load_transform_functions(operators)
     with _progress(progress_method, progress_path) as progress:
         progress.started()
-        operator_index = start_at
-        for (label, transform, arguments) in transforms:
-            progress.started(operator_index)
-            result = _execute_transform(label, transform,
-                                        arguments, data,
-                                        progress)
-
-            # Do we have any child data sources we need to write out?
-            if result is not None:
-                _write_child_data(result, operator_index,
-                                  output_file_path, dims)
-
-            progress.finished(operator_index)
-            operator_index += 1
-
-        logger.info('Execution complete.')
+        output = _run_pipeline(transforms, start_at, data, dims,
+                               output_file_path, progress)
+
         # Now write out the transformed data.
         logger.info('Writing transformed data.')
         if output_file_path is None:
-            output_file_path = '%s_transformed.emd' % \
-                os.path.splitext(os.path.basename(data_file_path))[0]
+            output_file_path = _default_output_file_path(data_file_path)
 
-        if result is None:
-            _write_emd(output_file_path, data, dims)
-        else:
-            [(_, child_data)] = result.items()
-            _write_emd(output_file_path, child_data, dims)
+        _write_emd(output_file_path, output, dims)
         logger.info('Write complete.')
         progress.finished()
 
@@ -0,0 +1,115 @@
+# -*- coding: utf-8 -*-
+
+###############################################################################
+# This source file is part of the Tomviz project, https://tomviz.org/.
+# It is released under the 3-Clause BSD License, see "LICENSE".
+###############################################################################
+"""Fourier transforms for operators.
+
+Within the application these run the multi-threaded native transforms, with
+their plans cached across runs. Elsewhere they fall back to numpy.fft.
+
+The real transforms halve the contiguous axis of the array: the last one for
+C ordered arrays, as numpy.fft.rfftn does, and the first one for Fortran
+ordered arrays such as dataset.active_scalars. Spectra are complex64 and the
+other results float32.
+"""
+import numpy as np
+
+from tomviz._internal import in_application
+
+if in_application():
+    import tomviz._wrapping as _native
+else:
+    _native = None
+
+
+def _fortran(array):
+    return array.ndim > 1 and np.isfortran(array)
+
+
+def _axes(array):
+    # The numpy axes, so that the contiguous axis is the one halved
+    if _fortran(array):
+        return tuple(reversed(range(array.ndim)))
+    return None
+
+
+def rfftn(array):
+    """Forward transform of a real array."""
+    if _native is None:
+        return np.fft.rfftn(array, axes=_axes(array)).astype(np.complex64)
+
+    if _fortran(array):
+        return _native.rfftn(array.T).T
+    return _native.rfftn(array)
+
+
+def irfftn(spectrum, shape):
+    """Inverse transform of the spectrum of a real array of the given shape,
+    normalized like numpy.fft.irfftn."""
+    shape = tuple(shape)
+    if _native is None:
+        axes = _axes(spectrum)
+        if axes is not None:
+            shape = shape[::-1]
+        return np.fft.irfftn(spectrum, shape, axes=axes).astype(np.float32)
+
+    if _fortran(spectrum):
+        return _native.irfftn(spectrum.T, shape[::-1]).T
+    return _native.irfftn(spectrum, shape)
+
+
+def abs_log(array):
+    """Log of the magnitude of the transform, shifted so that the zero
+    frequency is at the center, and divided by its maximum."""
+    if _native is None:
+        offset = np.finfo(float).eps
+        output = np.fft.fftshift(np.log(np.abs(np.fft.fftn(array)) + offset))
+        return (output / np.max(output)).astype(np.float32)
+
+    if _fortran(array):
+        return _native.abs_log(array.T).T
+    return _native.abs_log(array)
+
+
+def band_pass(array, low, high):
+    """Keep the frequencies between low and high, fractions of the Nyquist
+    frequency, along the radius of the spectrum."""
+    if _native is None:
+        spectrum = np.fft.fftn(array)
+        radius = np.zeros(array.shape)
+        for axis, size in enumerate(array.shape):
+            shape = [1] * array.ndim
+            shape[axis] = size
+            radius = radius + (2 * np.fft.fftfreq(size)).reshape(shape) ** 2
+        radius = np.sqrt(radius)
+        spectrum[(radius < low) | (radius > high)] = 0
+        return np.real(np.fft.ifftn(spectrum)).astype(np.float32)
+
+    if _fortran(array):
+        return _native.band_pass(array.T, low, high).T
+    return _native.band_pass(array, low, high)
+
+
+def hann_window(array):
+    """Multiply the array by a Hann window along each axis. The result has the
+    type of the array, integers are truncated."""
+    order = 'F' if _fortran(array) else 'C'
+    windowed = np.array(array, dtype=np.float32, order=order)
+    if _native is None:
+        for axis, size in enumerate(windowed.shape):
+            shape = [1] * windowed.ndim
+            shape[axis] = size
+            windowed *= np.hanning(size).reshape(shape)
+    elif _fortran(windowed):
+        _native.hann_window(windowed.T)
+    else:
+        _native.hann_window(windowed)
+    return windowed.astype(array.dtype, copy=False)
+
+
+def clear_plans():
+    """Release the plans cached by the native transforms."""
+    if _native is not None:
+        _native.clear_fft_plans()
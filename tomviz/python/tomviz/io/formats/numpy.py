@@ -35,13 +35,22 @@ class NumpyWriter(Writer, NumpyBase):
 class NumpyReader(Reader, NumpyBase):
 
     def read(self, path):
-        with open(path, "rb") as f:
-            data = np.load(f)
+        # Memory map the file, copy on write. Arrays stored in Fortran order,
+        # as some tools write them, are used straight from the mapping and
+        # their pages are only read when they are accessed. Arrays stored in
+        # C order, as tomviz writes them, are copied to Fortran order below:
+        # mapping them only avoids holding a second copy while converting.
+        try:
+            data = np.load(path, mmap_mode='c')
+        except ValueError:
+            # Object arrays can't be mapped
+            with open(path, "rb") as f:
+                data = np.load(f)
 
         if len(data.shape) != 3:
             return vtkImageData()
 
-        # Convert to Fortran ordering
+        # Convert to Fortran ordering, this copies C ordered arrays
         data = np.asfortranarray(data)
 
         image_data = vtkImageData()
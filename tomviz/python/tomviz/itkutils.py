@@ -240,16 +240,9 @@ def get_python_voxel_type(dataset):
 @with_vtk_dataobject
 def convert_vtk_to_itk_image(vtk_image_data, itk_pixel_type=None):
     """Get an ITK image from the provided vtkImageData object.
-    This image can be passed to ITK filters."""
-
-    # Save the VTKGlue optimization for later
-    #------------------------------------------
-    #itk_import = itk.VTKImageToImageFilter[image_type].New()
-    #itk_import.SetInput(vtk_image_data)
-    #itk_import.Update()
-    #itk_image = itk_import.GetOutput()
-    #itk_image.DisconnectPipeline()
-    #------------------------------------------
+    This image can be passed to ITK filters. The image views the scalars of
+    vtk_image_data, unless they need a cast to a type wrapped in ITK."""
+
     import itk
     import itkTypes
     from vtkmodules.util import vtkConstants
@@ -290,7 +283,7 @@ def convert_vtk_to_itk_image(vtk_image_data, itk_pixel_type=None):
 
     image_type = _get_itk_image_type(vtk_image_data)
     itk_converter = itk.PyBuffer[image_type]
-    itk_image = itk_converter.GetImageFromArray(array)
+    itk_image = itk_converter.GetImageViewFromArray(array)
     spacing = vtk_image_data.GetSpacing()
     origin = vtk_image_data.GetOrigin()
     itk_image.SetSpacing(spacing)
@@ -305,34 +298,59 @@ def convert_vtk_to_itk_image(vtk_image_data, itk_pixel_type=None):
 
 @with_vtk_dataobject
 def set_array_from_itk_image(dataobject, itk_image):
-    """Set dataobject array from an ITK image."""
-    itk_output_image_type = type(itk_image)
-
-    # Save the VTKGlue optimization for later
-    #------------------------------------------
-    # Export the ITK image to a VTK image. No copying should take place.
-    #export_filter = itk.ImageToVTKImageFilter[itk_output_image_type].New()
-    #export_filter.SetInput(itk_image_data)
-    #export_filter.Update()
-
-    # Get scalars from the temporary image and copy them to the data set
-    #result_image = export_filter.GetOutput()
-    #filter_array = result_image.GetPointData().GetArray(0)
-
-    # Make a new instance of the array that will stick around after this
-    # filters in this script are garbage collected
-    #new_array = filter_array.NewInstance()
-    #new_array.DeepCopy(filter_array) # Should be able to shallow copy?
-    #new_array.SetName(name)
-    #------------------------------------------
-    import itk
+    """Set dataobject array from an ITK image. The array views the buffer of
+    the image when possible, see get_array_view_from_itk_image()."""
     from . import utils
-    result = itk.PyBuffer[
-        itk_output_image_type].GetArrayFromImage(itk_image)
-    result = result.copy()
+
+    current = None
+    if dataobject.GetPointData().GetScalars() is not None:
+        current = utils.get_array(dataobject, order='C')
+    result = get_array_view_from_itk_image(itk_image, current)
     utils.set_array(dataobject, result, isFortran=False)
 
 
+class _ImageBuffer(object):
+    """Exposes the pixel buffer of an ITK image to NumPy. Arrays made from it
+    reference it, which keeps the image, and so its buffer, alive."""
+
+    def __init__(self, itk_image, array):
+        self.itk_image = itk_image
+        self.__array_interface__ = array.__array_interface__
+
+
+def _same_buffer(a, b):
+    return (a.__array_interface__['data'][0] ==
+            b.__array_interface__['data'][0] and
+            a.dtype == b.dtype and a.shape == b.shape and
+            a.strides == b.strides)
+
+
+def get_array_view_from_itk_image(itk_image, current=None,
+                                  itk_image_type=None):
+    """Get a C ordered NumPy array of the pixels of itk_image, without
+    copying them when possible.
+
+    If the image owns its buffer, as the outputs of ITK filters do, the array
+    views the buffer and keeps the image alive. Otherwise the image views an
+    array, which is returned if it is current, the C ordered array the result
+    replaces: a filter ran in place on a view of current. The buffer of any
+    other array is copied, since nothing would keep it alive.
+    """
+    import itk
+    import numpy as np
+
+    if itk_image_type is None:
+        view = itk.GetArrayViewFromImage(itk_image)
+    else:
+        view = itk.PyBuffer[itk_image_type].GetArrayViewFromImage(itk_image)
+
+    if itk_image.GetPixelContainer().GetContainerManageMemory():
+        return np.asarray(_ImageBuffer(itk_image, view))
+    if current is not None and _same_buffer(view, current):
+        return current
+    return view.copy()
+
+
 @with_dataset
 def get_label_object_attributes(dataset, progress_callback=None):
     """Compute shape attributes of integer-labeled objects in a dataset. Returns
@@ -425,26 +443,38 @@ def observe_filter_progress(transform, filter, start_pct, end_pct):
 
 @with_dataset
 def dataset_to_itk_image(dataset):
+    """Get an ITK image viewing the active scalars of the dataset."""
 
     import itk
+    import numpy as np
+
+    array = dataset.active_scalars
 
-    itk_image = itk.GetImageViewFromArray(dataset.active_scalars)
+    # The transpose of the Fortran ordered (x, y, z) scalars is a C ordered
+    # (z, y, x) view of the same buffer, which ITK views as an (x, y, z) image
+    # without copying it.
+    itk_image = itk.GetImageViewFromArray(
+        np.ascontiguousarray(np.transpose(array)))
 
     if dataset.spacing is not None:
         itk_image.SetSpacing(dataset.spacing)
 
+    # Persist a reference to the scalars, which the image views
+    itk_image.tomviz_array = array
+
     return itk_image
 
 
 def set_itk_image_on_dataset(itk_image, dataset, dtype=None):
-    # Write the itk image data to the dataset
+    # Write the itk image data to the dataset, viewing the buffer of the image
+    # when possible, see get_array_view_from_itk_image().
 
-    import itk
+    import numpy as np
 
-    if dtype is None:
-        array = itk.GetArrayFromImage(itk_image)
-    else:
-        array = itk.PyBuffer[dtype].GetArrayFromImage(itk_image)
+    current = None
+    if dataset.scalars_names:
+        current = np.transpose(dataset.active_scalars)
+    array = get_array_view_from_itk_image(itk_image, current, dtype)
 
     # Transpose the data to Fortran indexing
     dataset.active_scalars = array.transpose([2, 1, 0])
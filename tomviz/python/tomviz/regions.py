@@ -0,0 +1,123 @@
+# -*- coding: utf-8 -*-
+
+###############################################################################
+# This source file is part of the Tomviz project, https://tomviz.org/.
+# It is released under the 3-Clause BSD License, see "LICENSE".
+###############################################################################
+"""Pad and shift arrays for operators.
+
+Within the application these run the multi-threaded native region copies:
+shifts are done in place, and pads and rolls allocate nothing but their
+result. Elsewhere, or for arrays that are not contiguous, they fall back to
+numpy and scipy.
+
+The results have the order of the array, Fortran ordered arrays such as
+dataset.active_scalars stay Fortran ordered.
+"""
+import math
+
+import numpy as np
+
+from tomviz._internal import in_application
+
+if in_application():
+    import tomviz._wrapping as _native
+else:
+    _native = None
+
+# The pad modes of numpy.pad that are native.
+NATIVE_PAD_MODES = ('constant', 'edge', 'wrap')
+
+
+def _native_view(array, values):
+    # A C ordered view of the array for the native functions, with the values
+    # given for each axis in the order of the view.
+    values = list(values)
+    if _native is None or not 1 <= array.ndim <= 3:
+        return (None, None)
+    if array.flags.c_contiguous:
+        return (array, values)
+    if array.flags.f_contiguous:
+        return (array.T, values[::-1])
+    return (None, None)
+
+
+def _in_order_of(result, array):
+    if np.isfortran(array):
+        return np.asfortranarray(result)
+    return result
+
+
+def pad(array, before, after, mode='constant'):
+    """Pad the array with before and after elements along each axis, like
+    numpy.pad with constant zeros, or any of its other modes."""
+    if mode in NATIVE_PAD_MODES:
+        (view, sizes) = _native_view(array, zip(before, after))
+        if view is not None:
+            (view_before, view_after) = zip(*sizes)
+            result = _native.pad(view, list(view_before), list(view_after),
+                                 mode)
+            return result if view is array else result.T
+
+    pad_width = list(zip(before, after))
+    return _in_order_of(np.pad(array, pad_width, mode), array)
+
+
+def roll(array, shift):
+    """Shift the array by shift elements along each axis, elements shifted
+    out of the array reentering it on the other side, like numpy.roll."""
+    (view, view_shift) = _native_view(array, shift)
+    if view is None:
+        axes = tuple(range(array.ndim))
+        return _in_order_of(np.roll(array, tuple(shift), axis=axes), array)
+
+    result = _native.roll(view, view_shift)
+    return result if view is array else result.T
+
+
+def shift(array, shift, order=0):
+    """Shift the array in place by shift elements along each axis, filling
+    with zeros. Fractional shifts are rounded to the nearest element with
+    order 0, like scipy.ndimage.shift, and interpolated linearly with order
+    1."""
+    if order == 0:
+        # The element of the input nearest to the sample of each output one.
+        integers = [-int(math.floor(0.5 - s)) for s in shift]
+        (view, view_shift) = _native_view(array, integers)
+        if view is not None:
+            _native.shift(view, view_shift)
+            return
+    elif order == 1 and array.dtype.itemsize <= 4:
+        # The native interpolation is in single precision.
+        (view, view_shift) = _native_view(array, shift)
+        if view is not None:
+            result = _native.shift_linear(view, view_shift)
+            if np.issubdtype(array.dtype, np.integer):
+                result = np.rint(result)
+            view[...] = result
+            return
+
+    from scipy import ndimage
+    array[...] = ndimage.shift(array, shift, order=order)
+
+
+def shift_slices(array, shifts):
+    """Shift each slice array[:, :, i] of a 3D array in place, by shifts[i]
+    elements along the first two axes, filling with zeros."""
+    if array.ndim != 3 or len(shifts) != array.shape[2]:
+        raise ValueError('Expected a 3D array and a shift for each slice')
+
+    shifts = [(int(s[0]), int(s[1])) for s in shifts]
+    if _native is not None and array.flags.f_contiguous:
+        # The slices are along the first axis of the C ordered view.
+        _native.shift_slices(array.T, shifts)
+        return
+
+    for (i, (dx, dy)) in enumerate(shifts):
+        image = array[:, :, i].copy()
+        array[:, :, i] = 0
+        (nx, ny) = image.shape
+        if abs(dx) >= nx or abs(dy) >= ny:
+            continue
+        array[max(dx, 0):nx + min(dx, 0), max(dy, 0):ny + min(dy, 0), i] = \
+            image[max(-dx, 0):nx - max(dx, 0), max(-dy, 0):ny - max(dy, 0)]
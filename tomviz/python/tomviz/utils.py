@@ -211,6 +211,7 @@ def connected_components(dataset, background_value=0, progress_callback=None):
     try:
         import numpy as np
         import itk
+        from tomviz import itkutils
     except Exception as exc:
         print("Could not import necessary module(s)")
         print(exc)
@@ -228,8 +229,9 @@ def connected_components(dataset, background_value=0, progress_callback=None):
         # to 65,535 connected components (the number of connected components
         # is limited to the maximum representable number in the voxel type
         # of the input image in the ConnectedComponentsFilter).
-        array = dataset.active_scalars.astype(np.uint16)
-        itk_image = itk.GetImageViewFromArray(array)
+        array = dataset.active_scalars.astype(np.uint16, copy=False)
+        itk_image = itk.GetImageViewFromArray(
+            np.ascontiguousarray(np.transpose(array)))
         itk_image.SetSpacing(dataset.spacing)
         itk_image_type = type(itk_image)
 
@@ -278,8 +280,8 @@ def connected_components(dataset, background_value=0, progress_callback=None):
             return
 
         itk_image_data = relabel_filter.GetOutput()
-        label_buffer = itk.PyBuffer[
-            itk_image_type].GetArrayFromImage(itk_image_data)
+        label_buffer = itkutils.get_array_view_from_itk_image(
+            itk_image_data, itk_image_type=itk_image_type)
 
         # Flip the labels so that the largest component has the highest label
         # value, e.g., the labeling ordering by size goes from [1, 2, ... N] to
@@ -4,9 +4,9 @@
 #include "vtkActiveScalarsProducer.h"
 
 #include <vtkDataArray.h>
-#include <vtkExecutive.h>
-#include <vtkGarbageCollector.h>
 #include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
 
@@ -18,80 +18,44 @@ vtkActiveScalarsProducer::vtkActiveScalarsProducer()
 
 vtkActiveScalarsProducer::~vtkActiveScalarsProducer()
 {
-  this->SetOutput(nullptr);
+  this->SetActiveScalars(nullptr);
 }
 
 //----------------------------------------------------------------------------
-void vtkActiveScalarsProducer::SetOutput(vtkDataObject* newOutput)
+int vtkActiveScalarsProducer::RequestInformation(
+  vtkInformation*, vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
 {
-  auto oldOutput = this->OriginalOutput;
-  if (newOutput != oldOutput) {
-    if (newOutput) {
-      newOutput->Register(this);
-      this->Output = vtkImageData::New();
-      this->Output->ShallowCopy(newOutput);
-    } else {
-      this->Output->Delete();
-      this->Output = nullptr;
-    }
-
-    this->OriginalOutput = newOutput;
-
-    this->GetExecutive()->SetOutputData(0, this->Output);
-    if (oldOutput) {
-      oldOutput->UnRegister(this);
-    }
-    this->Modified();
-  }
-}
-
-void vtkActiveScalarsProducer::SetActiveScalars(const char* name)
-{
-  auto data = vtkImageData::SafeDownCast(this->Output);
-  if (data) {
-    data->GetPointData()->SetActiveScalars(name);
-    data->Modified();
-  }
-}
-
-vtkMTimeType vtkActiveScalarsProducer::GetMTime()
-{
-  auto mtime = this->Superclass::GetMTime();
-  if (this->OriginalOutput) {
-    auto omtime = this->OriginalOutput->GetMTime();
-    if (omtime > mtime) {
-      mtime = omtime;
-    }
-  }
-  if (this->Output) {
-    auto omtime = this->Output->GetMTime();
-    if (omtime >= mtime) {
-      mtime = omtime;
-    } else {
-      this->ReSync();
+  // The input is normally the output of a trivial producer, so its data is
+  // already available. Advertise the type of the selected array rather than
+  // the one of the input active scalars, filters like vtkImageReslice rely on
+  // it to allocate their output.
+  auto input = vtkImageData::GetData(inputVector[0]);
+  if (input && this->ActiveScalars) {
+    auto array = input->GetPointData()->GetArray(this->ActiveScalars);
+    if (array) {
+      vtkDataObject::SetPointDataActiveScalarInfo(
+        outputVector->GetInformationObject(0), array->GetDataType(),
+        array->GetNumberOfComponents());
     }
   }
-  return mtime;
+  return 1;
 }
 
 //----------------------------------------------------------------------------
-void vtkActiveScalarsProducer::ReSync()
+int vtkActiveScalarsProducer::RequestData(vtkInformation*,
+                                          vtkInformationVector** inputVector,
+                                          vtkInformationVector* outputVector)
 {
-  auto data = vtkImageData::SafeDownCast(this->Output);
-  auto originalData = vtkImageData::SafeDownCast(this->OriginalOutput);
-  if (data && originalData) {
-    auto originalActiveScalars =
-      std::string(originalData->GetPointData()->GetScalars()->GetName());
-    auto currenActiveScalars =
-      std::string(data->GetPointData()->GetScalars()->GetName());
-    data->ShallowCopy(originalData);
-    data->GetPointData()->SetActiveScalars(currenActiveScalars.c_str());
+  auto input = vtkImageData::GetData(inputVector[0]);
+  auto output = vtkImageData::GetData(outputVector);
+  if (!input || !output) {
+    return 0;
   }
-}
 
-//----------------------------------------------------------------------------
-void vtkActiveScalarsProducer::ReportReferences(vtkGarbageCollector* collector)
-{
-  this->Superclass::ReportReferences(collector);
-  vtkGarbageCollectorReport(collector, this->OriginalOutput, "OriginalOutput");
+  output->ShallowCopy(input);
+  if (this->ActiveScalars) {
+    output->GetPointData()->SetActiveScalars(this->ActiveScalars);
+  }
+  return 1;
 }
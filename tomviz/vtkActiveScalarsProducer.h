@@ -4,34 +4,32 @@
 #ifndef vtkActiveScalarsProducer_h
 #define vtkActiveScalarsProducer_h
 
-#include <vtkTrivialProducer.h>
-
-class vtkGarbageCollector;
-
-class vtkActiveScalarsProducer : public vtkTrivialProducer
+#include <vtkImageAlgorithm.h>
+
+// Shallow copies its input image and selects ActiveScalars as the active point
+// scalars of the output. Being a regular filter it only executes when its
+// input or the selected array change, so it can be shared by all the modules
+// that need the same array of a data source, see
+// DataSource::activeScalarsProducer().
+class vtkActiveScalarsProducer : public vtkImageAlgorithm
 {
-  // FIXME: Implementing the vtkActiveScalarsProducer as a producer breaks the
-  // vtk pipeline, requiring manual updates to keep in sync like here.
-  // It really should be implemented as a filter.
 public:
   static vtkActiveScalarsProducer* New();
-  vtkTypeMacro(vtkActiveScalarsProducer, vtkTrivialProducer)
-
-  vtkMTimeType GetMTime() override;
-
-  void SetOutput(vtkDataObject* newOutput) override;
-
-  void SetActiveScalars(const char* name);
+  vtkTypeMacro(vtkActiveScalarsProducer, vtkImageAlgorithm)
 
-  void ReSync();
+  vtkSetStringMacro(ActiveScalars);
+  vtkGetStringMacro(ActiveScalars);
 
 protected:
   vtkActiveScalarsProducer();
   ~vtkActiveScalarsProducer() override;
 
-  vtkDataObject* OriginalOutput = nullptr;
+  int RequestInformation(vtkInformation*, vtkInformationVector**,
+                         vtkInformationVector*) override;
+  int RequestData(vtkInformation*, vtkInformationVector**,
+                  vtkInformationVector*) override;
 
-  void ReportReferences(vtkGarbageCollector*) override;
+  char* ActiveScalars = nullptr;
 
 private:
   vtkActiveScalarsProducer(const vtkActiveScalarsProducer&) = delete;
@@ -0,0 +1,345 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#include "vtkAxisAlignedSlabFilter.h"
+
+#include <vtkDataArray.h>
+#include <vtkDataObject.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+// Describes a plane normal to the slab axis as a set of rows, each row is a
+// contiguous run of Length values in memory.
+struct PlaneLayout
+{
+  vtkIdType Rows;
+  vtkIdType Length;
+  vtkIdType RowStride;
+  vtkIdType PlaneStride;
+
+  PlaneLayout(int axis, const int dims[3], int numComps)
+  {
+    const vtkIdType nc = numComps;
+    const vtkIdType nx = dims[0], ny = dims[1], nz = dims[2];
+    if (axis == 0) {
+      Rows = ny * nz;
+      Length = nc;
+      RowStride = nx * nc;
+      PlaneStride = nc;
+    } else if (axis == 1) {
+      Rows = nz;
+      Length = nx * nc;
+      RowStride = nx * ny * nc;
+      PlaneStride = nx * nc;
+    } else {
+      Rows = ny;
+      Length = nx * nc;
+      RowStride = nx * nc;
+      PlaneStride = nx * ny * nc;
+    }
+  }
+};
+
+template <typename TIn, typename TOut>
+void minMaxPlane(const TIn* in, const PlaneLayout& inLayout, int lo, int hi,
+                 bool max, TOut* out, const PlaneLayout& outLayout)
+{
+  vtkSMPTools::For(0, inLayout.Rows, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType r = begin; r < end; ++r) {
+      const TIn* row = in + r * inLayout.RowStride;
+      TOut* outRow = out + r * outLayout.RowStride;
+      const TIn* first = row + lo * inLayout.PlaneStride;
+      for (vtkIdType l = 0; l < inLayout.Length; ++l) {
+        outRow[l] = static_cast<TOut>(first[l]);
+      }
+      for (int p = lo + 1; p <= hi; ++p) {
+        const TIn* plane = row + p * inLayout.PlaneStride;
+        if (max) {
+          for (vtkIdType l = 0; l < inLayout.Length; ++l) {
+            outRow[l] = std::max(outRow[l], static_cast<TOut>(plane[l]));
+          }
+        } else {
+          for (vtkIdType l = 0; l < inLayout.Length; ++l) {
+            outRow[l] = std::min(outRow[l], static_cast<TOut>(plane[l]));
+          }
+        }
+      }
+    }
+  });
+}
+
+// Add (sign = 1) or remove (sign = -1) plane p of the input to the running sum.
+template <typename TIn>
+void accumulatePlane(const TIn* in, const PlaneLayout& layout, int p,
+                     double sign, double* sum)
+{
+  vtkSMPTools::For(0, layout.Rows, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType r = begin; r < end; ++r) {
+      const TIn* plane = in + r * layout.RowStride + p * layout.PlaneStride;
+      double* sumRow = sum + r * layout.Length;
+      for (vtkIdType l = 0; l < layout.Length; ++l) {
+        sumRow[l] += sign * static_cast<double>(plane[l]);
+      }
+    }
+  });
+}
+
+template <typename TOut>
+void writeSum(const double* sum, const PlaneLayout& layout, double scale,
+              TOut* out, const PlaneLayout& outLayout)
+{
+  vtkSMPTools::For(0, layout.Rows, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType r = begin; r < end; ++r) {
+      const double* sumRow = sum + r * layout.Length;
+      TOut* outRow = out + r * outLayout.RowStride;
+      for (vtkIdType l = 0; l < layout.Length; ++l) {
+        outRow[l] = static_cast<TOut>(sumRow[l] * scale);
+      }
+    }
+  });
+}
+
+struct SlabWindow
+{
+  int Min;
+  int Max;
+  int Thickness;
+
+  // The planes reduced for the output plane p, clamped to [Min, Max].
+  void get(int p, int& lo, int& hi) const
+  {
+    const int half = (Thickness - 1) / 2;
+    lo = std::max(p - half, Min);
+    hi = std::min(p - half + Thickness - 1, Max);
+  }
+};
+} // namespace
+
+vtkStandardNewMacro(vtkAxisAlignedSlabFilter)
+
+vtkAxisAlignedSlabFilter::vtkAxisAlignedSlabFilter() = default;
+
+vtkAxisAlignedSlabFilter::~vtkAxisAlignedSlabFilter() = default;
+
+int vtkAxisAlignedSlabFilter::RequestInformation(
+  vtkInformation*, vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  auto inInfo = inputVector[0]->GetInformationObject(0);
+  auto outInfo = outputVector->GetInformationObject(0);
+
+  int scalarType = VTK_DOUBLE;
+  int numComps = 1;
+  auto scalarInfo = vtkDataObject::GetActiveFieldInformation(
+    inInfo, vtkDataObject::FIELD_ASSOCIATION_POINTS,
+    vtkDataSetAttributes::SCALARS);
+  if (scalarInfo) {
+    if (scalarInfo->Has(vtkDataObject::FIELD_ARRAY_TYPE())) {
+      scalarType = scalarInfo->Get(vtkDataObject::FIELD_ARRAY_TYPE());
+    }
+    if (scalarInfo->Has(vtkDataObject::FIELD_NUMBER_OF_COMPONENTS())) {
+      numComps = scalarInfo->Get(vtkDataObject::FIELD_NUMBER_OF_COMPONENTS());
+    }
+  }
+
+  // Sums of integer types would overflow, the accumulation modes output floats
+  if (this->SlabMode == Mean || this->SlabMode == Sum) {
+    scalarType = VTK_FLOAT;
+  }
+  vtkDataObject::SetPointDataActiveScalarInfo(outInfo, scalarType, numComps);
+  return 1;
+}
+
+int vtkAxisAlignedSlabFilter::RequestUpdateExtent(
+  vtkInformation*, vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  auto inInfo = inputVector[0]->GetInformationObject(0);
+  auto outInfo = outputVector->GetInformationObject(0);
+
+  int wholeExtent[6], updateExtent[6];
+  inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent);
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+               updateExtent);
+
+  // The whole plane is always computed, along the axis we need the slabs of
+  // the first and last requested planes.
+  int inExtent[6];
+  std::copy(wholeExtent, wholeExtent + 6, inExtent);
+  const int a = this->Axis;
+  SlabWindow window{ wholeExtent[2 * a], wholeExtent[2 * a + 1],
+                     this->SlabThickness };
+  const int first = std::max(updateExtent[2 * a], wholeExtent[2 * a]);
+  int lo, hi;
+  window.get(first, lo, hi);
+  inExtent[2 * a] = lo;
+  window.get(std::min(updateExtent[2 * a + 1], wholeExtent[2 * a + 1]), lo,
+             hi);
+  inExtent[2 * a + 1] = hi;
+
+  // The cached sum is slid from its center, the planes leaving its slab must
+  // be in memory to be removed.
+  if (this->CacheUsable(wholeExtent + 2 * a, first)) {
+    window.get(this->CachedCenter, lo, hi);
+    inExtent[2 * a] = std::min(inExtent[2 * a], lo);
+    inExtent[2 * a + 1] = std::max(inExtent[2 * a + 1], hi);
+  }
+
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), inExtent, 6);
+  return 1;
+}
+
+int vtkAxisAlignedSlabFilter::RequestData(vtkInformation*,
+                                          vtkInformationVector** inputVector,
+                                          vtkInformationVector* outputVector)
+{
+  auto inInfo = inputVector[0]->GetInformationObject(0);
+  auto outInfo = outputVector->GetInformationObject(0);
+  auto input = vtkImageData::GetData(inInfo);
+  auto output = vtkImageData::GetData(outInfo);
+  auto inScalars = input ? input->GetPointData()->GetScalars() : nullptr;
+  if (!inScalars) {
+    return 1;
+  }
+
+  const int a = this->Axis;
+  int wholeExtent[6], inExtent[6], updateExtent[6];
+  inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent);
+  input->GetExtent(inExtent);
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+               updateExtent);
+
+  // Compute complete planes over the requested range along the axis.
+  int outExtent[6];
+  std::copy(inExtent, inExtent + 6, outExtent);
+  outExtent[2 * a] = std::max(updateExtent[2 * a], inExtent[2 * a]);
+  outExtent[2 * a + 1] = std::min(updateExtent[2 * a + 1], inExtent[2 * a + 1]);
+  this->AllocateOutputData(output, outInfo, outExtent);
+  auto outScalars = output->GetPointData()->GetScalars();
+  outScalars->SetName(inScalars->GetName());
+
+  const int numComps = inScalars->GetNumberOfComponents();
+  int inDims[3], outDims[3];
+  input->GetDimensions(inDims);
+  output->GetDimensions(outDims);
+  const PlaneLayout inLayout(a, inDims, numComps);
+  const PlaneLayout outLayout(a, outDims, numComps);
+
+  // The slabs are clamped to the whole extent, the input extent holds the
+  // planes of the requested slabs. Plane indices are absolute along the axis,
+  // offset is the first plane in memory.
+  const int offset = inExtent[2 * a];
+  SlabWindow window{ wholeExtent[2 * a], wholeExtent[2 * a + 1],
+                     this->SlabThickness };
+  const int first = outExtent[2 * a];
+  const int last = outExtent[2 * a + 1];
+
+  if (this->SlabMode == Min || this->SlabMode == Max) {
+    const bool max = this->SlabMode == Max;
+    for (int p = first; p <= last; ++p) {
+      int lo, hi;
+      window.get(p, lo, hi);
+      void* outPtr = static_cast<char*>(outScalars->GetVoidPointer(0)) +
+                     (p - first) * outLayout.PlaneStride *
+                       outScalars->GetDataTypeSize();
+      switch (inScalars->GetDataType()) {
+        vtkTemplateMacro(minMaxPlane(
+          static_cast<const VTK_TT*>(inScalars->GetVoidPointer(0)), inLayout,
+          lo - offset, hi - offset, max, static_cast<VTK_TT*>(outPtr),
+          outLayout));
+      }
+    }
+    return 1;
+  }
+
+  // Running sum, reuse the cached plane if the input and slab are unchanged
+  // and we are close enough that shifting is cheaper than a full reduction.
+  const vtkIdType planeSize = inLayout.Rows * inLayout.Length;
+  const vtkMTimeType inputTime = inScalars->GetMTime();
+  int center = this->CachedCenter;
+  int cachedLo, cachedHi;
+  window.get(center, cachedLo, cachedHi);
+  const bool cacheValid =
+    this->CacheUsable(wholeExtent + 2 * a, first) &&
+    this->CachedInputTime == inputTime &&
+    static_cast<vtkIdType>(this->CachedSum.size()) == planeSize &&
+    cachedLo >= inExtent[2 * a] && cachedHi <= inExtent[2 * a + 1];
+  const int type = inScalars->GetDataType();
+  void* inPtr = inScalars->GetVoidPointer(0);
+
+  if (!cacheValid) {
+    this->CachedSum.assign(planeSize, 0.0);
+    int lo, hi;
+    window.get(first, lo, hi);
+    for (int p = lo; p <= hi; ++p) {
+      switch (type) {
+        vtkTemplateMacro(accumulatePlane(static_cast<const VTK_TT*>(inPtr),
+                                         inLayout, p - offset, 1.0,
+                                         this->CachedSum.data()));
+      }
+    }
+    center = first;
+  }
+  double* sum = this->CachedSum.data();
+
+  for (int p = first; p <= last; ++p) {
+    // Slide the window one plane at a time towards p, removing the planes
+    // that leave it and adding the ones that enter it.
+    while (center != p) {
+      const int step = p > center ? 1 : -1;
+      int oldLo, oldHi, newLo, newHi;
+      window.get(center, oldLo, oldHi);
+      window.get(center + step, newLo, newHi);
+      for (int q = std::min(oldLo, newLo); q <= std::max(oldHi, newHi); ++q) {
+        const bool inOld = q >= oldLo && q <= oldHi;
+        const bool inNew = q >= newLo && q <= newHi;
+        if (inOld == inNew) {
+          continue;
+        }
+        const double sign = inNew ? 1.0 : -1.0;
+        switch (type) {
+          vtkTemplateMacro(accumulatePlane(static_cast<const VTK_TT*>(inPtr),
+                                           inLayout, q - offset, sign, sum));
+        }
+      }
+      center += step;
+    }
+
+    int lo, hi;
+    window.get(p, lo, hi);
+    double scale = this->SlabMode == Mean ? 1.0 / (hi - lo + 1) : 1.0;
+    auto outPtr = static_cast<float*>(outScalars->GetVoidPointer(0)) +
+                  (p - first) * outLayout.PlaneStride;
+    writeSum(sum, inLayout, scale, outPtr, outLayout);
+  }
+
+  this->CachedCenter = center;
+  this->CachedInputTime = inputTime;
+  this->CachedFilterTime = this->GetMTime();
+  std::copy(wholeExtent + 2 * a, wholeExtent + 2 * a + 2,
+            this->CachedWholeExtent);
+  return 1;
+}
+
+bool vtkAxisAlignedSlabFilter::CacheUsable(const int wholeExtent[2],
+                                           int first)
+{
+  return !this->CachedSum.empty() &&
+         this->CachedFilterTime == this->GetMTime() &&
+         this->CachedWholeExtent[0] == wholeExtent[0] &&
+         this->CachedWholeExtent[1] == wholeExtent[1] &&
+         this->CachedCenter >= wholeExtent[0] &&
+         this->CachedCenter <= wholeExtent[1] &&
+         std::abs(this->CachedCenter - first) < this->SlabThickness;
+}
@@ -0,0 +1,79 @@
+/* This source file is part of the Tomviz project, https://tomviz.org/.
+   It is released under the 3-Clause BSD License, see "LICENSE". */
+
+#ifndef tomvizvtkAxisAlignedSlabFilter_h
+#define tomvizvtkAxisAlignedSlabFilter_h
+
+#include <vtkImageAlgorithm.h>
+
+#include <vector>
+
+// Thick slice reduction for axis-aligned planes. The output has the same
+// geometry as the input, each output point along Axis holds the min, max,
+// mean or sum of the input points within the slab of SlabThickness points
+// centered on it. Only the planes in the requested update extent are computed,
+// so a downstream vtkImageReslice only pays for the planes it samples.
+//
+// The rows of each plane are reduced directly from the input memory in
+// parallel. For the sum and mean modes the reduced plane is cached, moving
+// the slab by a few planes adds and removes the planes entering and leaving
+// it instead of reducing the whole slab again.
+class vtkAxisAlignedSlabFilter : public vtkImageAlgorithm
+{
+public:
+  static vtkAxisAlignedSlabFilter* New();
+  vtkTypeMacro(vtkAxisAlignedSlabFilter, vtkImageAlgorithm)
+
+  // The modes match the vtkImageReslice slab modes.
+  enum
+  {
+    Min = 0,
+    Max = 1,
+    Mean = 2,
+    Sum = 3
+  };
+
+  // Axis normal to the slab, 0 for x, 1 for y and 2 for z.
+  vtkSetClampMacro(Axis, int, 0, 2);
+  vtkGetMacro(Axis, int);
+
+  // Number of planes reduced for each output plane.
+  vtkSetClampMacro(SlabThickness, int, 1, VTK_INT_MAX);
+  vtkGetMacro(SlabThickness, int);
+
+  vtkSetClampMacro(SlabMode, int, Min, Sum);
+  vtkGetMacro(SlabMode, int);
+
+protected:
+  vtkAxisAlignedSlabFilter();
+  ~vtkAxisAlignedSlabFilter() override;
+
+  int RequestInformation(vtkInformation*, vtkInformationVector**,
+                         vtkInformationVector*) override;
+  int RequestUpdateExtent(vtkInformation*, vtkInformationVector**,
+                          vtkInformationVector*) override;
+  int RequestData(vtkInformation*, vtkInformationVector**,
+                  vtkInformationVector*) override;
+
+  int Axis = 2;
+  int SlabThickness = 1;
+  int SlabMode = Sum;
+
+  // Whether the running sum can be slid to the plane first, given the whole
+  // extent along the axis. The input time is checked once the data is there.
+  bool CacheUsable(const int wholeExtent[2], int first);
+
+  // Running sum of the slab centered on CachedCenter, an absolute index along
+  // the axis, with the slabs clamped to CachedWholeExtent.
+  std::vector<double> CachedSum;
+  int CachedCenter = 0;
+  int CachedWholeExtent[2] = { 0, -1 };
+  vtkMTimeType CachedInputTime = 0;
+  vtkMTimeType CachedFilterTime = 0;
+
+private:
+  vtkAxisAlignedSlabFilter(const vtkAxisAlignedSlabFilter&) = delete;
+  void operator=(const vtkAxisAlignedSlabFilter&) = delete;
+};
+
+#endif
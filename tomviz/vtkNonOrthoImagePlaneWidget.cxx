@@ -7,6 +7,7 @@
 #include "vtkAlgorithmOutput.h"
 #include "vtkAssemblyNode.h"
 #include "vtkAssemblyPath.h"
+#include "vtkAxisAlignedSlabFilter.h"
 #include "vtkBoundingBox.h"
 #include "vtkCallbackCommand.h"
 #include "vtkCamera.h"
@@ -114,6 +115,8 @@ vtkNonOrthoImagePlaneWidget::vtkNonOrthoImagePlaneWidget()
   this->Reslice->AutoCropOutputOff();
   this->Reslice->MirrorOff();
   this->Reslice->SetSlabModeToSum();
+  this->SlabFilter = vtkAxisAlignedSlabFilter::New();
+  this->ThickSliceMode = VTK_IMAGE_SLAB_SUM;
 
   this->ResliceAxes = vtkMatrix4x4::New();
   this->Texture = vtkTexture::New();
@@ -220,6 +223,7 @@ vtkNonOrthoImagePlaneWidget::~vtkNonOrthoImagePlaneWidget()
   this->ResliceAxes->Delete();
   this->Transform->Delete();
   this->Reslice->Delete();
+  this->SlabFilter->Delete();
 
   if (this->LookupTable) {
     this->LookupTable->UnRegister(this);
@@ -1082,9 +1086,11 @@ void vtkNonOrthoImagePlaneWidget::SetInputConnection(vtkAlgorithmOutput* aout)
     // If NULL is passed, remove any reference that Reslice had
     // on the old ImageData
     this->Reslice->SetInputData(nullptr);
+    this->SlabFilter->SetInputData(nullptr);
     return;
   }
 
+  this->SlabFilter->SetInputConnection(aout);
   this->Reslice->SetInputConnection(aout);
   int interpolate = this->ResliceInterpolate;
   this->ResliceInterpolate = -1; // Force change
@@ -1182,6 +1188,46 @@ void vtkNonOrthoImagePlaneWidget::UpdatePlane()
   this->Reslice->SetOutputSpacing(outputSpacingX, outputSpacingY, 1);
   this->Reslice->SetOutputOrigin(0.5 * outputSpacingX, 0.5 * outputSpacingY, 0);
   this->Reslice->SetOutputExtent(0, extentX - 1, 0, extentY - 1, 0, 0);
+
+  this->UpdateSlabPipeline();
+}
+
+void vtkNonOrthoImagePlaneWidget::UpdateSlabPipeline()
+{
+  auto input = this->SlabFilter->GetNumberOfInputConnections(0) > 0
+                 ? this->SlabFilter->GetInputConnection(0, 0)
+                 : nullptr;
+  if (!input) {
+    return;
+  }
+
+  // Find the axis if the plane is normal to one.
+  double normal[3];
+  this->PlaneSource->GetNormal(normal);
+  int axis = -1;
+  for (int i = 0; i < 3; ++i) {
+    if (fabs(normal[(i + 1) % 3]) < 1e-6 &&
+        fabs(normal[(i + 2) % 3]) < 1e-6) {
+      axis = i;
+    }
+  }
+
+  vtkAlgorithmOutput* resliceInput = input;
+  if (axis >= 0 && this->SliceThickness > 1) {
+    this->SlabFilter->SetAxis(axis);
+    this->SlabFilter->SetSlabThickness(this->SliceThickness);
+    this->SlabFilter->SetSlabMode(this->ThickSliceMode);
+    this->Reslice->SetSlabNumberOfSlices(1);
+    resliceInput = this->SlabFilter->GetOutputPort();
+  } else {
+    // As many slices as the axis aligned slabs.
+    this->Reslice->SetSlabNumberOfSlices(this->SliceThickness);
+    this->Reslice->SetSlabMode(this->ThickSliceMode);
+  }
+
+  if (this->Reslice->GetInputConnection(0, 0) != resliceInput) {
+    this->Reslice->SetInputConnection(resliceInput);
+  }
 }
 
 void vtkNonOrthoImagePlaneWidget::FindPlaneBounds(vtkInformation* outInfo,
@@ -1867,7 +1913,8 @@ void vtkNonOrthoImagePlaneWidget::SetSliceThickness(int slices)
   if (!this->Reslice) {
     return;
   }
-  this->Reslice->SetSlabNumberOfSlices(slices-1);
+  this->SliceThickness = slices;
+  this->UpdateSlabPipeline();
 }
 
 void vtkNonOrthoImagePlaneWidget::SetThickSliceMode(int mode)
@@ -1875,7 +1922,8 @@ void vtkNonOrthoImagePlaneWidget::SetThickSliceMode(int mode)
   if (!this->Reslice) {
     return;
   }
-  this->Reslice->SetSlabMode(mode);
+  this->ThickSliceMode = mode;
+  this->UpdateSlabPipeline();
 }
 
 vtkVector3d vtkNonOrthoImagePlaneWidget::PickPointOnSlice(
@@ -1924,7 +1972,7 @@ void vtkNonOrthoImagePlaneWidget::VoxelTimerFired(vtkObject*, unsigned long,
     bool onSlice;
     vtkVector2i displayPos(self->Interactor->GetEventPosition());
     auto pickPoint = self->PickPointOnSlice(displayPos, onSlice);
-    auto data = vtkImageData::SafeDownCast(self->Reslice->GetInput());
+    auto data = self->ImageData;
     if (onSlice && data) {
       vtkVector3i ijk;
       double scalar = tomviz::getVoxelValue(data, pickPoint, ijk, onSlice);
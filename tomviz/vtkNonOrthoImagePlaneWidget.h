@@ -79,6 +79,7 @@
 
 class vtkAbstractPropPicker;
 class vtkActor;
+class vtkAxisAlignedSlabFilter;
 class vtkConeSource;
 class vtkDataSetMapper;
 class vtkImageData;
@@ -349,7 +350,8 @@ public:
   // Set the thickness of the slice and the mode for viewing the thick slice.
   // Selecting a thickness of N will select the (N - 1)/2 slices on either side
   // of the Reslice and create a composite of those slices. The mode is then
-  // applied to that composite.
+  // applied to that composite. Axis aligned planes use a dedicated slab
+  // filter, arbitrary planes use the slab mode of the reslice.
   void SetSliceThickness(int slices);
   void SetThickSliceMode(int mode);
 
@@ -473,6 +475,13 @@ protected:
 
   vtkImageData* ImageData;
   vtkImageReslice* Reslice;
+  vtkAxisAlignedSlabFilter* SlabFilter;
+  int SliceThickness = 1;
+  int ThickSliceMode;
+
+  // Route the reslice input through the slab filter for thick axis aligned
+  // slices, or straight to the input otherwise.
+  void UpdateSlabPipeline();
   vtkMatrix4x4* ResliceAxes;
   vtkTransform* Transform;
   vtkActor* TexturePlaneActor;